@@ -124,7 +124,7 @@ static void *i2c_thread(void *data)
     .nmsgs = 2
   };
 
-  get_rt_prio(I2C_THREAD_PRIO);
+  rt_thread_setup("i2c", RT_THREAD_FIFO, I2C_THREAD_PRIO);
 
   struct i2c_periph *p = (struct i2c_periph *)data;
   pthread_mutex_t *mutex = &(((struct i2c_thread_t *)(p->init_struct))->mutex);
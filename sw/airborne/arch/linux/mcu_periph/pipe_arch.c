@@ -192,7 +192,7 @@ void pipe_send_raw(struct pipe_periph *p, long fd __attribute__((unused)), uint8
  */
 static void *pipe_thread(void *data __attribute__((unused)))
 {
-  get_rt_prio(PIPE_THREAD_PRIO);
+  rt_thread_setup("pipe", RT_THREAD_FIFO, PIPE_THREAD_PRIO);
 
   /* file descriptor list */
   fd_set fds_master;
@@ -57,7 +57,7 @@ void *sys_time_thread_main(void *data)
     return NULL;
   }
 
-  get_rt_prio(SYS_TIME_THREAD_PRIO);
+  rt_thread_setup("sys_time", RT_THREAD_FIFO, SYS_TIME_THREAD_PRIO);
 
   /* Make the timer periodic */
   struct itimerspec timer;
@@ -67,7 +67,7 @@ void uart_arch_init(void)
 
 static void *uart_thread(void *data __attribute__((unused)))
 {
-  get_rt_prio(UART_THREAD_PRIO);
+  rt_thread_setup("uart", RT_THREAD_FIFO, UART_THREAD_PRIO);
 
   /* file descriptor list */
   fd_set fds_master;
@@ -181,7 +181,7 @@ void udp_send_raw(struct udp_periph *p, long fd __attribute__((unused)), uint8_t
  */
 static void *udp_thread(void *data __attribute__((unused)))
 {
-  get_rt_prio(UDP_THREAD_PRIO);
+  rt_thread_setup("udp", RT_THREAD_FIFO, UDP_THREAD_PRIO);
 
   /* file descriptor list */
   fd_set socks_master;
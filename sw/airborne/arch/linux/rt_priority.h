@@ -21,6 +21,10 @@
 /**
  * @file rt_priority.h
  * Functions to obtain rt priority or set the nice level.
+ *
+ * Threads should call @ref rt_thread_setup at their start with their name
+ * and default scheduling, so that the rt_threads module can override them
+ * from the airframe file.
  */
 
 #ifndef RT_PRIORITY_H
@@ -29,15 +33,19 @@
 #include <pthread.h>
 #include <stdio.h>
 
-static inline int get_rt_prio(int prio)
+/**
+ * Set a realtime scheduling policy and priority for the calling thread
+ * @param sched SCHED_FIFO or SCHED_RR
+ * @param prio requested priority, clipped to the policy min/max
+ * @return 0 on success, -1 on failure
+ */
+static inline int set_rt_sched(int sched, int prio)
 {
   struct sched_param param;
   int policy;
   pthread_getschedparam(pthread_self(), &policy, &param);
   printf("Current schedparam: policy %d, prio %d\n", policy, param.sched_priority);
 
-  //SCHED_RR, SCHED_FIFO, SCHED_OTHER (POSIX scheduling policies)
-  int sched = SCHED_FIFO;
   int min = sched_get_priority_min(sched);
   int max = sched_get_priority_max(sched);
   param.sched_priority = prio;
@@ -62,6 +70,12 @@ static inline int get_rt_prio(int prio)
   return 0;
 }
 
+static inline int get_rt_prio(int prio)
+{
+  //SCHED_RR, SCHED_FIFO, SCHED_OTHER (POSIX scheduling policies)
+  return set_rt_sched(SCHED_FIFO, prio);
+}
+
 #include <sys/resource.h>
 #include <unistd.h>
 #include <sys/syscall.h>
@@ -74,4 +88,30 @@ static inline int set_nice_level(int level)
   return setpriority(PRIO_PROCESS, tid, level);
 }
 
+/** Thread scheduling policies for @ref rt_thread_setup */
+#define RT_THREAD_NICE  0   ///< SCHED_OTHER, the priority is a nice level
+#define RT_THREAD_FIFO  1   ///< SCHED_FIFO realtime priority
+#define RT_THREAD_RR    2   ///< SCHED_RR realtime priority
+
+#if USE_RT_THREADS
+/**
+ * Apply the scheduling of a named thread, called from the thread itself.
+ * Implemented by the rt_threads module, which can override the policy,
+ * priority and CPU affinity from the airframe file.
+ * @param name thread name
+ * @param policy default policy (RT_THREAD_NICE, RT_THREAD_FIFO or RT_THREAD_RR)
+ * @param prio default priority or nice level
+ */
+extern void rt_thread_setup(const char *name, int policy, int prio);
+#else
+static inline void rt_thread_setup(const char *name __attribute__((unused)), int policy, int prio)
+{
+  if (policy == RT_THREAD_NICE) {
+    set_nice_level(prio);
+  } else {
+    set_rt_sched(policy == RT_THREAD_RR ? SCHED_RR : SCHED_FIFO, prio);
+  }
+}
+#endif
+
 #endif /* RT_PRIORITY_H */
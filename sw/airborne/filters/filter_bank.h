@@ -0,0 +1,347 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/** @file filters/filter_bank.h
+ *  @brief Banks of low pass and notch filters updating several channels at once
+ *
+ * The filters are the same as in low_pass_filter.h and notch_filter_float.h,
+ * with the same numerical results, but the coefficients and states of all the
+ * channels are stored as separate arrays (structure of arrays). A single update
+ * call then runs one loop over contiguous data that the compiler can unroll
+ * and vectorize, instead of one call per channel on interleaved structures.
+ *
+ * A bank and its storage are declared with the corresponding macro, e.g.:
+ * @code
+ * static BUTTERWORTH_2_LOW_PASS_BANK(actuator_filters, NUM_ACT);
+ * ...
+ * init_butterworth_2_low_pass_bank(&actuator_filters, tau, sample_time, 0.f);
+ * ...
+ * update_butterworth_2_low_pass_bank(&actuator_filters, actuator_state, actuator_state_filt);
+ * @endcode
+ * Channel k of a second order bank has its last outputs in o0[k] and o1[k],
+ * like o[0] and o[1] of a single filter.
+ */
+
+#ifndef FILTER_BANK_H
+#define FILTER_BANK_H
+
+#include "std.h"
+#include "filters/low_pass_filter.h"
+#include "filters/notch_filter_float.h"
+
+/** Storage of one coefficient or state of a bank.
+ * A compound literal, so a bank is declared by a single declarator.
+ * It has static storage only at file scope, where the banks must be declared.
+ */
+#define FILTER_BANK_ARRAY(_n) ((float[_n]) { 0.f })
+
+/** Bank of first order low pass filters
+ */
+struct FirstOrderLowPassBank {
+  uint8_t n;          ///< number of channels
+  float *time_const;  ///< time constants
+  float *last_in;     ///< last inputs
+  float *last_out;    ///< last outputs
+};
+
+/** Declare a first order low pass filter bank with its storage
+ *
+ * @param _name name of the bank
+ * @param _n number of channels
+ */
+#define FIRST_ORDER_LOW_PASS_BANK(_name, _n) \
+  struct FirstOrderLowPassBank _name = { (_n), FILTER_BANK_ARRAY(_n), FILTER_BANK_ARRAY(_n), FILTER_BANK_ARRAY(_n) }
+
+/** Init a channel of a first order low pass filter bank
+ *
+ * @param bank first order low pass filter bank
+ * @param k channel index
+ * @param tau time constant of the filter
+ * @param sample_time sampling period of the signal
+ * @param value initial value of the filter
+ */
+static inline void init_first_order_low_pass_bank_channel(struct FirstOrderLowPassBank *bank, uint8_t k, float tau,
+    float sample_time, float value)
+{
+  bank->last_in[k] = value;
+  bank->last_out[k] = value;
+  bank->time_const[k] = 2.0f * tau / sample_time;
+}
+
+/** Init all channels of a first order low pass filter bank with the same time constant
+ *
+ * @param bank first order low pass filter bank
+ * @param tau time constant of the filter
+ * @param sample_time sampling period of the signal
+ * @param value initial value of the filters
+ */
+static inline void init_first_order_low_pass_bank(struct FirstOrderLowPassBank *bank, float tau, float sample_time,
+    float value)
+{
+  for (uint8_t k = 0; k < bank->n; k++) {
+    init_first_order_low_pass_bank_channel(bank, k, tau, sample_time, value);
+  }
+}
+
+/** Update all channels of a first order low pass filter bank
+ *
+ * @param bank first order low pass filter bank
+ * @param in new input values, one per channel
+ * @param out filtered values, one per channel (can be NULL)
+ */
+static inline void update_first_order_low_pass_bank(struct FirstOrderLowPassBank *bank, const float *in, float *out)
+{
+  const float *__restrict tc = bank->time_const;
+  float *__restrict li = bank->last_in;
+  float *__restrict lo = bank->last_out;
+  for (uint8_t k = 0; k < bank->n; k++) {
+    float x = in[k];
+    lo[k] = (x + li[k] + (tc[k] - 1.0f) * lo[k]) / (1.0f + tc[k]);
+    li[k] = x;
+  }
+  if (out != NULL) {
+    for (uint8_t k = 0; k < bank->n; k++) {
+      out[k] = lo[k];
+    }
+  }
+}
+
+/** Bank of second order low pass filters
+ *
+ * See struct SecondOrderLowPass for the filter definition.
+ */
+struct SecondOrderLowPassBank {
+  uint8_t n;      ///< number of channels
+  float *a0;      ///< first denominator gains
+  float *a1;      ///< second denominator gains
+  float *b0;      ///< first (and third) numerator gains
+  float *b1;      ///< second numerator gains
+  float *i0;      ///< last inputs
+  float *i1;      ///< inputs before last
+  float *o0;      ///< last outputs
+  float *o1;      ///< outputs before last
+};
+
+/** Declare a second order low pass filter bank with its storage
+ *
+ * @param _name name of the bank
+ * @param _n number of channels
+ */
+#define SECOND_ORDER_LOW_PASS_BANK(_name, _n) \
+  struct SecondOrderLowPassBank _name = { (_n), FILTER_BANK_ARRAY(_n), FILTER_BANK_ARRAY(_n), FILTER_BANK_ARRAY(_n), \
+                                           FILTER_BANK_ARRAY(_n), FILTER_BANK_ARRAY(_n), FILTER_BANK_ARRAY(_n), \
+                                           FILTER_BANK_ARRAY(_n), FILTER_BANK_ARRAY(_n) }
+
+/** Init a channel of a second order low pass filter bank
+ *
+ * @param bank second order low pass filter bank
+ * @param k channel index
+ * @param tau time constant of the filter
+ * @param Q Q value of the filter
+ * @param sample_time sampling period of the signal
+ * @param value initial value of the filter
+ */
+static inline void init_second_order_low_pass_bank_channel(struct SecondOrderLowPassBank *bank, uint8_t k, float tau,
+    float Q, float sample_time, float value)
+{
+  struct SecondOrderLowPass filter;
+  init_second_order_low_pass(&filter, tau, Q, sample_time, value);
+  bank->a0[k] = filter.a[0];
+  bank->a1[k] = filter.a[1];
+  bank->b0[k] = filter.b[0];
+  bank->b1[k] = filter.b[1];
+  bank->i0[k] = bank->i1[k] = bank->o0[k] = bank->o1[k] = value;
+}
+
+/** Update all channels of a second order low pass filter bank
+ *
+ * @param bank second order low pass filter bank
+ * @param in new input values, one per channel
+ * @param out filtered values, one per channel (can be NULL)
+ */
+static inline void update_second_order_low_pass_bank(struct SecondOrderLowPassBank *bank, const float *in, float *out)
+{
+  const float *__restrict a0 = bank->a0;
+  const float *__restrict a1 = bank->a1;
+  const float *__restrict b0 = bank->b0;
+  const float *__restrict b1 = bank->b1;
+  float *__restrict i0 = bank->i0;
+  float *__restrict i1 = bank->i1;
+  float *__restrict o0 = bank->o0;
+  float *__restrict o1 = bank->o1;
+  for (uint8_t k = 0; k < bank->n; k++) {
+    float x = in[k];
+    float y = b0[k] * x
+              + b1[k] * i0[k]
+              + b0[k] * i1[k]
+              - a0[k] * o0[k]
+              - a1[k] * o1[k];
+    i1[k] = i0[k];
+    i0[k] = x;
+    o1[k] = o0[k];
+    o0[k] = y;
+  }
+  if (out != NULL) {
+    for (uint8_t k = 0; k < bank->n; k++) {
+      out[k] = o0[k];
+    }
+  }
+}
+
+/** Bank of second order Butterworth low pass filters
+ */
+typedef struct SecondOrderLowPassBank Butterworth2LowPassBank;
+
+/** Declare a second order Butterworth low pass filter bank with its storage
+ *
+ * @param _name name of the bank
+ * @param _n number of channels
+ */
+#define BUTTERWORTH_2_LOW_PASS_BANK(_name, _n) SECOND_ORDER_LOW_PASS_BANK(_name, _n)
+
+/** Init a channel of a second order Butterworth low pass filter bank
+ *
+ * @param bank second order Butterworth low pass filter bank
+ * @param k channel index
+ * @param tau time constant of the filter
+ * @param sample_time sampling period of the signal
+ * @param value initial value of the filter
+ */
+static inline void init_butterworth_2_low_pass_bank_channel(Butterworth2LowPassBank *bank, uint8_t k, float tau,
+    float sample_time, float value)
+{
+  init_second_order_low_pass_bank_channel(bank, k, tau, 0.7071, sample_time, value);
+}
+
+/** Init all channels of a second order Butterworth low pass filter bank with the same time constant
+ *
+ * @param bank second order Butterworth low pass filter bank
+ * @param tau time constant of the filter
+ * @param sample_time sampling period of the signal
+ * @param value initial value of the filters
+ */
+static inline void init_butterworth_2_low_pass_bank(Butterworth2LowPassBank *bank, float tau, float sample_time,
+    float value)
+{
+  for (uint8_t k = 0; k < bank->n; k++) {
+    init_butterworth_2_low_pass_bank_channel(bank, k, tau, sample_time, value);
+  }
+}
+
+/** Update all channels of a second order Butterworth low pass filter bank
+ *
+ * @param bank second order Butterworth low pass filter bank
+ * @param in new input values, one per channel
+ * @param out filtered values, one per channel (can be NULL)
+ */
+static inline void update_butterworth_2_low_pass_bank(Butterworth2LowPassBank *bank, const float *in, float *out)
+{
+  update_second_order_low_pass_bank(bank, in, out);
+}
+
+/** Bank of second order notch filters
+ *
+ * See struct SecondOrderNotchFilter for the filter definition.
+ */
+struct SecondOrderNotchFilterBank {
+  uint8_t n;        ///< number of channels
+  float *d2;        ///< squared pole radius
+  float *costheta;  ///< cosine of the notch frequency
+  float *xn1;       ///< last inputs
+  float *xn2;       ///< inputs before last
+  float *yn1;       ///< last outputs
+  float *yn2;       ///< outputs before last
+};
+
+/** Declare a second order notch filter bank with its storage
+ *
+ * @param _name name of the bank
+ * @param _n number of channels
+ */
+#define SECOND_ORDER_NOTCH_FILTER_BANK(_name, _n) \
+  struct SecondOrderNotchFilterBank _name = { (_n), FILTER_BANK_ARRAY(_n), FILTER_BANK_ARRAY(_n), FILTER_BANK_ARRAY(_n), \
+                                               FILTER_BANK_ARRAY(_n), FILTER_BANK_ARRAY(_n), FILTER_BANK_ARRAY(_n) }
+
+/** Init a channel of a second order notch filter bank
+ *
+ * @param bank second order notch filter bank
+ * @param k channel index
+ * @param cutoff_frequency frequency to attenuate [Hz]
+ * @param bandwidth bandwidth of the filter [Hz]
+ * @param sample_frequency frequency at which the filter is updated
+ */
+static inline void notch_filter_bank_init_channel(struct SecondOrderNotchFilterBank *bank, uint8_t k,
+    float cutoff_frequency, float bandwidth, uint16_t sample_frequency)
+{
+  struct SecondOrderNotchFilter filter;
+  notch_filter_init(&filter, cutoff_frequency, bandwidth, sample_frequency);
+  bank->d2[k] = filter.d2;
+  bank->costheta[k] = filter.costheta;
+  bank->xn1[k] = bank->xn2[k] = bank->yn1[k] = bank->yn2[k] = 0.f;
+}
+
+/** Set notch frequency of a channel of a second order notch filter bank
+ *
+ * @param bank second order notch filter bank
+ * @param k channel index
+ * @param frequency to attenuate [Hz]
+ * @param sample_frequency frequency at which the filter is updated
+ */
+static inline void notch_filter_bank_set_filter_frequency(struct SecondOrderNotchFilterBank *bank, uint8_t k,
+    float frequency, uint16_t sample_frequency)
+{
+  // sampling period rounded to float like in struct SecondOrderNotchFilter
+  float Ts = 1.0 / sample_frequency;
+  float theta = 2.0 * M_PI * frequency * Ts;
+  bank->costheta[k] = cosf(theta);
+}
+
+/** Update all channels of a second order notch filter bank
+ *
+ * @param bank second order notch filter bank
+ * @param in new input values, one per channel
+ * @param out filtered values, one per channel (can be NULL)
+ */
+static inline void notch_filter_bank_update(struct SecondOrderNotchFilterBank *bank, const float *in, float *out)
+{
+  const float *__restrict d2 = bank->d2;
+  const float *__restrict ct = bank->costheta;
+  float *__restrict xn1 = bank->xn1;
+  float *__restrict xn2 = bank->xn2;
+  float *__restrict yn1 = bank->yn1;
+  float *__restrict yn2 = bank->yn2;
+  for (uint8_t k = 0; k < bank->n; k++) {
+    float x = in[k];
+    float a = (1 + d2[k]) * 0.5;
+    float b = (1 + d2[k]) * ct[k];
+    float y = (b * yn1[k]) - (d2[k] * yn2[k]) + (a * x) - (b * xn1[k]) + (a * xn2[k]);
+    xn2[k] = xn1[k];
+    xn1[k] = x;
+    yn2[k] = yn1[k];
+    yn1[k] = y;
+  }
+  if (out != NULL) {
+    for (uint8_t k = 0; k < bank->n; k++) {
+      out[k] = yn1[k];
+    }
+  }
+}
+
+#endif /* FILTER_BANK_H */
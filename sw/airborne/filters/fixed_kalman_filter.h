@@ -0,0 +1,429 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file filters/fixed_kalman_filter.h
+ *
+ * Compile-time sized Kalman filter (EKF or error-state EKF) without dynamic
+ * allocation.
+ *
+ * - the covariance is stored as a packed upper triangle
+ * - the prediction only multiplies the non zero elements of the Jacobian
+ * - the measurements are fused one by one (sequential scalar updates with a
+ *   diagonal measurement noise) using the Joseph form
+ * - the duration of each step is recorded
+ *
+ * C++ code uses the FixedKalmanFilter template directly. For C modules, a
+ * filter instance and its C interface are created in a small C++ file with
+ * FIXED_KF_C_WRAPPER, and declared in C with FIXED_KF_C_DECLARE:
+ * @code
+ * // my_filter.cpp
+ * #include "filters/fixed_kalman_filter.h"
+ * FIXED_KF_C_WRAPPER(my_kf, 6)
+ *
+ * // my_module.c
+ * #include "filters/fixed_kalman_filter.h"
+ * FIXED_KF_C_DECLARE(my_kf, 6)
+ * ...
+ * my_kf_predict(F, Q, true);
+ * my_kf_update_scalar(h, y - h * x, r);
+ * @endcode
+ */
+
+#ifndef FIXED_KALMAN_FILTER_H
+#define FIXED_KALMAN_FILTER_H
+
+#include "std.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Duration of the filter steps */
+struct kf_timing {
+  uint32_t predict_us;    ///< duration of the last prediction
+  uint32_t update_us;     ///< duration of all the updates since the last prediction
+  uint32_t max_us;        ///< longest prediction or update
+  uint32_t nb_predict;    ///< number of predictions
+  uint32_t nb_update;     ///< number of fused scalar measurements
+  uint32_t nb_rejected;   ///< number of measurements rejected (non positive innovation variance)
+};
+
+/**
+ * Declare the C interface of a filter instance created with FIXED_KF_C_WRAPPER
+ * @param _name prefix of the functions
+ * @param _n number of states
+ */
+#define FIXED_KF_C_DECLARE(_name, _n) \
+  extern void _name##_init(const float x0[_n], const float P0_diag[_n]); \
+  extern void _name##_predict(const float F[_n][_n], const float Q_diag[_n], bool propagate_state); \
+  extern bool _name##_update_scalar(const float h[_n], float innov, float r); \
+  extern bool _name##_update_sparse(const uint8_t idx[], const float val[], uint8_t nb, float innov, float r); \
+  extern uint8_t _name##_update(const float H[][_n], const float innov[], const float R_diag[], uint8_t m); \
+  extern void _name##_get_state(float x[_n]); \
+  extern void _name##_set_state(const float x[_n]); \
+  extern void _name##_reset_error(float dx[_n]); \
+  extern float _name##_get_cov(uint8_t i, uint8_t j); \
+  extern void _name##_set_cov(uint8_t i, uint8_t j, float v); \
+  extern struct kf_timing _name##_get_timing(void);
+
+#ifdef __cplusplus
+}
+
+/** Time source for the step durations (us) */
+#ifndef KF_TIME_USEC
+#include "mcu_periph/sys_time.h"
+#define KF_TIME_USEC() get_sys_time_usec()
+#endif
+
+/**
+ * Non zero elements of a square matrix stored by row, used for the Jacobian
+ * of the prediction. Either filled with set() by the model or extracted from
+ * a dense matrix with from_dense().
+ */
+template<uint8_t N>
+struct KfSparseRows {
+  uint8_t nb[N];          ///< number of non zero elements of each row
+  uint8_t col[N][N];      ///< column of each element
+  float val[N][N];        ///< value of each element
+
+  void clear()
+  {
+    for (uint8_t i = 0; i < N; i++) {
+      nb[i] = 0;
+    }
+  }
+
+  /** Add an element, each (i, j) must only be set once */
+  void set(uint8_t i, uint8_t j, float v)
+  {
+    col[i][nb[i]] = j;
+    val[i][nb[i]] = v;
+    nb[i]++;
+  }
+
+  void from_dense(const float F[N][N])
+  {
+    clear();
+    for (uint8_t i = 0; i < N; i++) {
+      for (uint8_t j = 0; j < N; j++) {
+        if (F[i][j] != 0.f) {
+          set(i, j, F[i][j]);
+        }
+      }
+    }
+  }
+};
+
+/**
+ * Symmetric matrix stored as its upper triangle, row by row
+ */
+template<uint8_t N>
+struct KfSymMatrix {
+  float data[N * (N + 1) / 2];
+
+  static inline uint16_t index(uint8_t i, uint8_t j)
+  {
+    if (i > j) {
+      uint8_t t = i;
+      i = j;
+      j = t;
+    }
+    return i * N - (i * (i - 1)) / 2 + (j - i);
+  }
+
+  inline float &operator()(uint8_t i, uint8_t j) { return data[index(i, j)]; }
+  inline float operator()(uint8_t i, uint8_t j) const { return data[index(i, j)]; }
+
+  void setZero()
+  {
+    for (uint16_t k = 0; k < N * (N + 1) / 2; k++) {
+      data[k] = 0.f;
+    }
+  }
+};
+
+/**
+ * Kalman filter with N states
+ *
+ * For an EKF, x is the state. For an error-state EKF, x is the error state:
+ * it stays zero during the predictions (propagate_state = false) and the
+ * corrections accumulated by the updates are taken with reset_error() to be
+ * injected in the nominal state.
+ *
+ * Only the first nb_est states are corrected by the updates, the others are
+ * considered states: their gain is zero but their covariance is still updated
+ * (the Joseph form is valid for any gain).
+ */
+template<uint8_t N>
+class FixedKalmanFilter
+{
+public:
+  float x[N];             ///< state (or error state)
+  KfSymMatrix<N> P;       ///< state covariance
+  uint8_t nb_est;         ///< number of corrected states, N after init()
+  struct kf_timing timing;
+
+  void init(const float x0[N], const float P0_diag[N])
+  {
+    P.setZero();
+    nb_est = N;
+    for (uint8_t i = 0; i < N; i++) {
+      x[i] = x0 != NULL ? x0[i] : 0.f;
+      P(i, i) = P0_diag[i];
+    }
+    timing = {};
+  }
+
+  /**
+   * Prediction step
+   * x = F x (if propagate_state)
+   * P = F P F' + diag(Q)
+   * @param F non zero elements of the state transition Jacobian
+   * @param Q_diag process noise variance of each state
+   * @param propagate_state also propagate x with F (linear filter or error state),
+   * false when the caller propagates its own (non linear) state
+   */
+  void predict(const KfSparseRows<N> &F, const float Q_diag[N], bool propagate_state)
+  {
+    uint32_t tic = KF_TIME_USEC();
+
+    if (propagate_state) {
+      float xn[N];
+      for (uint8_t i = 0; i < N; i++) {
+        xn[i] = 0.f;
+        for (uint8_t a = 0; a < F.nb[i]; a++) {
+          xn[i] += F.val[i][a] * x[F.col[i][a]];
+        }
+      }
+      for (uint8_t i = 0; i < N; i++) {
+        x[i] = xn[i];
+      }
+    }
+
+    // PFt = P * F'
+    float PFt[N][N];
+    for (uint8_t k = 0; k < N; k++) {
+      for (uint8_t j = 0; j < N; j++) {
+        float s = 0.f;
+        for (uint8_t a = 0; a < F.nb[j]; a++) {
+          s += P(k, F.col[j][a]) * F.val[j][a];
+        }
+        PFt[k][j] = s;
+      }
+    }
+
+    // P = F * PFt + Q, upper triangle only
+    for (uint8_t i = 0; i < N; i++) {
+      for (uint8_t j = i; j < N; j++) {
+        float s = (i == j) ? Q_diag[i] : 0.f;
+        for (uint8_t a = 0; a < F.nb[i]; a++) {
+          s += F.val[i][a] * PFt[F.col[i][a]][j];
+        }
+        P(i, j) = s;
+      }
+    }
+
+    uint32_t dt = KF_TIME_USEC() - tic;
+    timing.predict_us = dt;
+    timing.update_us = 0;
+    timing.max_us = Max(timing.max_us, dt);
+    timing.nb_predict++;
+  }
+
+  /**
+   * Fuse a scalar measurement with a sparse observation row
+   * @param idx index of the observed states
+   * @param val observation coefficients of these states
+   * @param nb number of observed states
+   * @param innov innovation (measurement - prediction)
+   * @param r measurement noise variance
+   * @return false if the measurement was rejected
+   */
+  bool update_sparse(const uint8_t idx[], const float val[], uint8_t nb, float innov, float r)
+  {
+    uint32_t tic = KF_TIME_USEC();
+    bool ret = fuse(idx, val, nb, innov, r, NULL);
+    end_update(tic);
+    return ret;
+  }
+
+  /**
+   * Fuse a scalar measurement, zero elements of h are skipped
+   * @param h observation row
+   * @param innov innovation (measurement - prediction)
+   * @param r measurement noise variance
+   * @return false if the measurement was rejected
+   */
+  bool update_scalar(const float h[N], float innov, float r)
+  {
+    uint32_t tic = KF_TIME_USEC();
+    uint8_t idx[N];
+    float val[N];
+    uint8_t nb = sparse_row(h, idx, val);
+    bool ret = fuse(idx, val, nb, innov, r, NULL);
+    end_update(tic);
+    return ret;
+  }
+
+  /**
+   * Fuse a vector measurement with diagonal noise as M sequential scalar updates.
+   * The innovations are given for the state before the update and corrected
+   * for the previous scalar updates (exact for a linear observation model).
+   * @param H observation matrix
+   * @param innov innovation vector
+   * @param R_diag measurement noise variances
+   * @param m number of measurements
+   * @return number of fused measurements
+   */
+  uint8_t update(const float H[][N], const float innov[], const float R_diag[], uint8_t m)
+  {
+    uint32_t tic = KF_TIME_USEC();
+    float dx[N] = {0.f};
+    uint8_t nb_fused = 0;
+    for (uint8_t k = 0; k < m; k++) {
+      uint8_t idx[N];
+      float val[N];
+      uint8_t nb = sparse_row(H[k], idx, val);
+      float y = innov[k];
+      for (uint8_t a = 0; a < nb; a++) {
+        y -= val[a] * dx[idx[a]];
+      }
+      if (fuse(idx, val, nb, y, R_diag[k], dx)) {
+        nb_fused++;
+      }
+    }
+    end_update(tic);
+    return nb_fused;
+  }
+
+  /** Take the error state to inject it in the nominal state, and zero it */
+  void reset_error(float dx[N])
+  {
+    for (uint8_t i = 0; i < N; i++) {
+      dx[i] = x[i];
+      x[i] = 0.f;
+    }
+  }
+
+private:
+  /** Indices and values of the non zero elements of a dense row */
+  static uint8_t sparse_row(const float h[N], uint8_t idx[N], float val[N])
+  {
+    uint8_t nb = 0;
+    for (uint8_t i = 0; i < N; i++) {
+      if (h[i] != 0.f) {
+        idx[nb] = i;
+        val[nb] = h[i];
+        nb++;
+      }
+    }
+    return nb;
+  }
+
+  /**
+   * Scalar Joseph form update
+   * P = (I - k h) P (I - k h)' + k r k'
+   * with Ph = P h', S = h P h' + r, k = Ph / S and Ah = (I - k h) Ph:
+   * P = P - k Ph' - Ah k' + r k k'
+   * @param dx if not NULL, accumulates the correction
+   */
+  bool fuse(const uint8_t idx[], const float val[], uint8_t nb, float innov, float r, float dx[N])
+  {
+    float Ph[N];
+    for (uint8_t i = 0; i < N; i++) {
+      float s = 0.f;
+      for (uint8_t a = 0; a < nb; a++) {
+        s += P(i, idx[a]) * val[a];
+      }
+      Ph[i] = s;
+    }
+    float hPh = 0.f;
+    for (uint8_t a = 0; a < nb; a++) {
+      hPh += val[a] * Ph[idx[a]];
+    }
+    const float S = hPh + r;
+    if (!(S > 0.f)) {
+      timing.nb_rejected++;
+      return false;
+    }
+
+    float k[N], Ah[N];
+    const float S_inv = 1.f / S;
+    for (uint8_t i = 0; i < N; i++) {
+      k[i] = i < nb_est ? Ph[i] * S_inv : 0.f;
+      Ah[i] = Ph[i] - k[i] * hPh;
+      x[i] += k[i] * innov;
+      if (dx != NULL) {
+        dx[i] += k[i] * innov;
+      }
+    }
+    for (uint8_t i = 0; i < N; i++) {
+      for (uint8_t j = i; j < N; j++) {
+        P(i, j) += r * k[i] * k[j] - k[i] * Ph[j] - Ah[i] * k[j];
+      }
+    }
+    timing.nb_update++;
+    return true;
+  }
+
+  void end_update(uint32_t tic)
+  {
+    uint32_t dt = KF_TIME_USEC() - tic;
+    timing.update_us += dt;
+    timing.max_us = Max(timing.max_us, dt);
+  }
+};
+
+/**
+ * Create a filter instance with N states and its C interface
+ * (see FIXED_KF_C_DECLARE), to be used once in a C++ file
+ */
+#define FIXED_KF_C_WRAPPER(_name, _n) \
+  static FixedKalmanFilter<_n> _name##_kf; \
+  extern "C" { \
+    FIXED_KF_C_DECLARE(_name, _n) \
+  } \
+  void _name##_init(const float x0[_n], const float P0_diag[_n]) { _name##_kf.init(x0, P0_diag); } \
+  void _name##_predict(const float F[_n][_n], const float Q_diag[_n], bool propagate_state) \
+  { \
+    KfSparseRows<_n> Fs; \
+    Fs.from_dense(F); \
+    _name##_kf.predict(Fs, Q_diag, propagate_state); \
+  } \
+  bool _name##_update_scalar(const float h[_n], float innov, float r) { return _name##_kf.update_scalar(h, innov, r); } \
+  bool _name##_update_sparse(const uint8_t idx[], const float val[], uint8_t nb, float innov, float r) \
+  { \
+    return _name##_kf.update_sparse(idx, val, nb, innov, r); \
+  } \
+  uint8_t _name##_update(const float H[][_n], const float innov[], const float R_diag[], uint8_t m) \
+  { \
+    return _name##_kf.update(H, innov, R_diag, m); \
+  } \
+  void _name##_get_state(float x[_n]) { for (uint8_t i = 0; i < _n; i++) { x[i] = _name##_kf.x[i]; } } \
+  void _name##_set_state(const float x[_n]) { for (uint8_t i = 0; i < _n; i++) { _name##_kf.x[i] = x[i]; } } \
+  void _name##_reset_error(float dx[_n]) { _name##_kf.reset_error(dx); } \
+  float _name##_get_cov(uint8_t i, uint8_t j) { return _name##_kf.P(i, j); } \
+  void _name##_set_cov(uint8_t i, uint8_t j, float v) { _name##_kf.P(i, j) = v; } \
+  struct kf_timing _name##_get_timing(void) { return _name##_kf.timing; }
+
+#endif /* __cplusplus */
+
+#endif /* FIXED_KALMAN_FILTER_H */
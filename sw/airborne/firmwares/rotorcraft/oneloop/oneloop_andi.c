@@ -87,6 +87,7 @@
 #endif
 #include "modules/core/abi.h"
 #include "filters/low_pass_filter.h"
+#include "filters/filter_bank.h"
 #include "math/wls/wls_alloc.h"
 #include "modules/nav/nav_rotorcraft_hybrid.h"
 #include "firmwares/rotorcraft/navigation.h"
@@ -471,11 +472,11 @@ float ratio_u_un[ANDI_NUM_ACT_TOT];
 float ratio_vn_v[ANDI_NUM_ACT_TOT];
 
 /*Filters Initialization*/
-static struct FirstOrderLowPass filt_accel_ned[3];
-static struct FirstOrderLowPass rates_filt_fo[3];
-static struct FirstOrderLowPass model_pred_a_filt[3];
-static Butterworth2LowPass att_dot_meas_lowpass_filters[3];
-static Butterworth2LowPass model_pred_filt[ANDI_OUTPUTS];
+static FIRST_ORDER_LOW_PASS_BANK(filt_accel_ned, 3);
+static FIRST_ORDER_LOW_PASS_BANK(rates_filt_fo, 3);
+static FIRST_ORDER_LOW_PASS_BANK(model_pred_a_filt, 3);
+static BUTTERWORTH_2_LOW_PASS_BANK(att_dot_meas_lowpass_filters, 3);
+static BUTTERWORTH_2_LOW_PASS_BANK(model_pred_filt, ANDI_OUTPUTS);
 
 
 /** @brief Function to make sure that inputs are positive non zero vaues*/
@@ -1017,27 +1018,21 @@ void init_filter(void)
   float sample_time = 1.0 / PERIODIC_FREQUENCY;
 
   // Filtering of the Inputs with 3 dimensions (e.g. rates and accelerations)
-  int8_t i;
-  for (i = 0; i < 3; i++) {
-    init_butterworth_2_low_pass(&att_dot_meas_lowpass_filters[i], tau, sample_time, 0.0);
-    init_first_order_low_pass(&filt_accel_ned[i], tau_a, sample_time, 0.0 );
-  }
+  init_butterworth_2_low_pass_bank(&att_dot_meas_lowpass_filters, tau, sample_time, 0.0);
+  init_first_order_low_pass_bank(&filt_accel_ned, tau_a, sample_time, 0.0);
 
   // Init rate filter for feedback
   float time_constants[3] = {1.0 / (2 * M_PI * ONELOOP_ANDI_FILT_CUTOFF_P), 1.0 / (2 * M_PI * ONELOOP_ANDI_FILT_CUTOFF_Q), 1.0 / (2 * M_PI * ONELOOP_ANDI_FILT_CUTOFF_R)};
-  init_first_order_low_pass(&rates_filt_fo[0], time_constants[0], sample_time, stateGetBodyRates_f()->p);
-  init_first_order_low_pass(&rates_filt_fo[1], time_constants[1], sample_time, stateGetBodyRates_f()->q);
-  init_first_order_low_pass(&rates_filt_fo[2], time_constants[2], sample_time, stateGetBodyRates_f()->r);
-  
+  init_first_order_low_pass_bank_channel(&rates_filt_fo, 0, time_constants[0], sample_time, stateGetBodyRates_f()->p);
+  init_first_order_low_pass_bank_channel(&rates_filt_fo, 1, time_constants[1], sample_time, stateGetBodyRates_f()->q);
+  init_first_order_low_pass_bank_channel(&rates_filt_fo, 2, time_constants[2], sample_time, stateGetBodyRates_f()->r);
+
   // Remember to change the time constant if you provide different P Q R filters
+  int8_t i;
   for (i = 0; i < ANDI_OUTPUTS; i++){
-    if (i < 3){
-       init_butterworth_2_low_pass(&model_pred_filt[i], tau_a, sample_time, 0.0);
-       init_first_order_low_pass(&model_pred_a_filt[i], tau_a, sample_time, 0.0);      
-    } else {
-    init_butterworth_2_low_pass(&model_pred_filt[i], tau, sample_time, 0.0);
-    }
+    init_butterworth_2_low_pass_bank_channel(&model_pred_filt, i, (i < 3) ? tau_a : tau, sample_time, 0.0);
   }
+  init_first_order_low_pass_bank(&model_pred_a_filt, tau_a, sample_time, 0.0);
 }
 
 
@@ -1046,25 +1041,21 @@ void oneloop_andi_propagate_filters(void) {
   struct  NedCoor_f *accel = stateGetAccelNed_f();
   struct  FloatRates *body_rates = stateGetBodyRates_f();
   float   rate_vect[3] = {body_rates->p, body_rates->q, body_rates->r};
-  update_first_order_low_pass(&filt_accel_ned[0], accel->x);
-  update_first_order_low_pass(&filt_accel_ned[1], accel->y);
-  update_first_order_low_pass(&filt_accel_ned[2], accel->z);
+  float   accel_vect[3] = {accel->x, accel->y, accel->z};
+  update_first_order_low_pass_bank(&filt_accel_ned, accel_vect, NULL);
 
-  
   calc_model();
+  update_butterworth_2_low_pass_bank(&model_pred_filt, model_pred, NULL);
+  update_first_order_low_pass_bank(&model_pred_a_filt, model_pred, NULL);
+  update_butterworth_2_low_pass_bank(&att_dot_meas_lowpass_filters, rate_vect, NULL);
+  update_first_order_low_pass_bank(&rates_filt_fo, rate_vect, NULL);
+
   int8_t i;
-  for (i = 0; i < ANDI_OUTPUTS; i++){
-    update_butterworth_2_low_pass(&model_pred_filt[i], model_pred[i]);
-  }
-  
   for (i = 0; i < 3; i++) {
-    update_first_order_low_pass(&model_pred_a_filt[i], model_pred[i]);
-    update_butterworth_2_low_pass(&att_dot_meas_lowpass_filters[i], rate_vect[i]);
-    update_first_order_low_pass(&rates_filt_fo[i], rate_vect[i]);
- 
-    ang_acc[i] = (att_dot_meas_lowpass_filters[i].o[0]- att_dot_meas_lowpass_filters[i].o[1]) * PERIODIC_FREQUENCY + model_pred[3+i] - model_pred_filt[3+i].o[0];
-    lin_acc[i] = filt_accel_ned[i].last_out + model_pred[i] - model_pred_a_filt[i].last_out;     
-}}
+    ang_acc[i] = (att_dot_meas_lowpass_filters.o0[i]- att_dot_meas_lowpass_filters.o1[i]) * PERIODIC_FREQUENCY + model_pred[3+i] - model_pred_filt.o0[3+i];
+    lin_acc[i] = filt_accel_ned.last_out[i] + model_pred[i] - model_pred_a_filt.last_out[i];
+  }
+}
 
 /** @brief Init function of Oneloop ANDI controller  */
 void oneloop_andi_init(void)
@@ -1279,9 +1270,9 @@ void oneloop_andi_run(bool in_flight, bool half_loop, struct FloatVect3 PSA_des,
   oneloop_andi.sta_state.att[1] = eulers_zxy.theta                      * use_increment;
   oneloop_andi.sta_state.att[2] = eulers_zxy.psi                        * use_increment;
   oneloop_andi_propagate_filters();   //needs to be after update of attitude vector
-  oneloop_andi.sta_state.att_d[0]  = rates_filt_fo[0].last_out             * use_increment;
-  oneloop_andi.sta_state.att_d[1]  = rates_filt_fo[1].last_out             * use_increment;
-  oneloop_andi.sta_state.att_d[2]  = rates_filt_fo[2].last_out             * use_increment;
+  oneloop_andi.sta_state.att_d[0]  = rates_filt_fo.last_out[0]             * use_increment;
+  oneloop_andi.sta_state.att_d[1]  = rates_filt_fo.last_out[1]             * use_increment;
+  oneloop_andi.sta_state.att_d[2]  = rates_filt_fo.last_out[2]             * use_increment;
   oneloop_andi.sta_state.att_2d[0] = ang_acc[0]                            * use_increment;
   oneloop_andi.sta_state.att_2d[1] = ang_acc[1]                            * use_increment;
   oneloop_andi.sta_state.att_2d[2] = ang_acc[2]                            * use_increment;
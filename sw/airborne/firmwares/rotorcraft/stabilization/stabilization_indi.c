@@ -42,6 +42,7 @@
 #include "modules/actuators/actuators.h"
 #include "modules/core/abi.h"
 #include "filters/low_pass_filter.h"
+#include "filters/filter_bank.h"
 #include "math/wls/wls_alloc.h"
 #include <stdio.h>
 
@@ -272,10 +273,10 @@ float g2_est[INDI_NUM_ACT];
 float g1_init[INDI_OUTPUTS][INDI_NUM_ACT];
 float g2_init[INDI_NUM_ACT];
 
-Butterworth2LowPass actuator_lowpass_filters[INDI_NUM_ACT];
-Butterworth2LowPass estimation_input_lowpass_filters[INDI_NUM_ACT];
-Butterworth2LowPass measurement_lowpass_filters[3];
-Butterworth2LowPass estimation_output_lowpass_filters[3];
+BUTTERWORTH_2_LOW_PASS_BANK(actuator_lowpass_filters, INDI_NUM_ACT);
+BUTTERWORTH_2_LOW_PASS_BANK(estimation_input_lowpass_filters, INDI_NUM_ACT);
+BUTTERWORTH_2_LOW_PASS_BANK(measurement_lowpass_filters, 3);
+BUTTERWORTH_2_LOW_PASS_BANK(estimation_output_lowpass_filters, 3);
 Butterworth2LowPass acceleration_lowpass_filter;
 #if STABILIZATION_INDI_FILTER_RATES_SECOND_ORDER
 Butterworth2LowPass rates_filt_so[3];
@@ -436,17 +437,12 @@ void init_filters(void)
   float tau_est = 1.0 / (2.0 * M_PI * STABILIZATION_INDI_ESTIMATION_FILT_CUTOFF);
   float sample_time = 1.0 / PERIODIC_FREQUENCY;
   // Filtering of the gyroscope
-  int8_t i;
-  for (i = 0; i < 3; i++) {
-    init_butterworth_2_low_pass(&measurement_lowpass_filters[i], tau, sample_time, 0.0);
-    init_butterworth_2_low_pass(&estimation_output_lowpass_filters[i], tau_est, sample_time, 0.0);
-  }
+  init_butterworth_2_low_pass_bank(&measurement_lowpass_filters, tau, sample_time, 0.0);
+  init_butterworth_2_low_pass_bank(&estimation_output_lowpass_filters, tau_est, sample_time, 0.0);
 
   // Filtering of the actuators
-  for (i = 0; i < INDI_NUM_ACT; i++) {
-    init_butterworth_2_low_pass(&actuator_lowpass_filters[i], tau, sample_time, 0.0);
-    init_butterworth_2_low_pass(&estimation_input_lowpass_filters[i], tau_est, sample_time, 0.0);
-  }
+  init_butterworth_2_low_pass_bank(&actuator_lowpass_filters, tau, sample_time, 0.0);
+  init_butterworth_2_low_pass_bank(&estimation_input_lowpass_filters, tau_est, sample_time, 0.0);
 
   // Filtering of the accel body z
   init_butterworth_2_low_pass(&acceleration_lowpass_filter, tau_est, sample_time, 0.0);
@@ -553,18 +549,17 @@ void stabilization_indi_rate_run(struct FloatRates rate_sp, bool in_flight)
   /* Propagate the filter on the gyroscopes */
   struct FloatRates *body_rates = stateGetBodyRates_f();
   float rate_vect[3] = {body_rates->p, body_rates->q, body_rates->r};
+  update_butterworth_2_low_pass_bank(&measurement_lowpass_filters, rate_vect, NULL);
+  update_butterworth_2_low_pass_bank(&estimation_output_lowpass_filters, rate_vect, NULL);
   int8_t i;
   for (i = 0; i < 3; i++) {
-    update_butterworth_2_low_pass(&measurement_lowpass_filters[i], rate_vect[i]);
-    update_butterworth_2_low_pass(&estimation_output_lowpass_filters[i], rate_vect[i]);
-
     //Calculate the angular acceleration via finite difference
-    angular_acceleration[i] = (measurement_lowpass_filters[i].o[0]
-                               - measurement_lowpass_filters[i].o[1]) * PERIODIC_FREQUENCY;
+    angular_acceleration[i] = (measurement_lowpass_filters.o0[i]
+                               - measurement_lowpass_filters.o1[i]) * PERIODIC_FREQUENCY;
 
     // Calculate derivatives for estimation
     float estimation_rate_d_prev = estimation_rate_d[i];
-    estimation_rate_d[i] = (estimation_output_lowpass_filters[i].o[0] - estimation_output_lowpass_filters[i].o[1]) *
+    estimation_rate_d[i] = (estimation_output_lowpass_filters.o0[i] - estimation_output_lowpass_filters.o1[i]) *
                            PERIODIC_FREQUENCY;
     estimation_rate_dd[i] = (estimation_rate_d[i] - estimation_rate_d_prev) * PERIODIC_FREQUENCY;
   }
@@ -704,14 +699,12 @@ void stabilization_indi_rate_run(struct FloatRates rate_sp, bool in_flight)
 
   // Propagate actuator filters
   get_actuator_state();
+  update_butterworth_2_low_pass_bank(&actuator_lowpass_filters, actuator_state, actuator_state_filt_vect);
+  update_butterworth_2_low_pass_bank(&estimation_input_lowpass_filters, actuator_state, NULL);
   for (i = 0; i < INDI_NUM_ACT; i++) {
-    update_butterworth_2_low_pass(&actuator_lowpass_filters[i], actuator_state[i]);
-    update_butterworth_2_low_pass(&estimation_input_lowpass_filters[i], actuator_state[i]);
-    actuator_state_filt_vect[i] = actuator_lowpass_filters[i].o[0];
-
     // calculate derivatives for estimation
     float actuator_state_filt_vectd_prev = actuator_state_filt_vectd[i];
-    actuator_state_filt_vectd[i] = (estimation_input_lowpass_filters[i].o[0] - estimation_input_lowpass_filters[i].o[1]) *
+    actuator_state_filt_vectd[i] = (estimation_input_lowpass_filters.o0[i] - estimation_input_lowpass_filters.o1[i]) *
                                    PERIODIC_FREQUENCY;
     actuator_state_filt_vectdd[i] = (actuator_state_filt_vectd[i] - actuator_state_filt_vectd_prev) * PERIODIC_FREQUENCY;
   }
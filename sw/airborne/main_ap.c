@@ -36,6 +36,9 @@
 #include "generated/airframe.h"
 #include "generated/modules.h"
 #include "modules/core/abi.h"
+#include "modules/core/task_timing.h"
+#include "mcu_periph/sys_time.h"
+#include "state.h"
 
 #ifdef USE_NPS
 #include "nps_autopilot.h"
@@ -119,27 +122,39 @@ void main_ap_init(void)
 void main_ap_periodic(void)
 {
   if (sys_time_check_and_ack_timer(modules_sensors_tid)) {
+    TASK_TIMING_GROUP_START(TASK_TIMING_SENSORS);
     modules_sensors_periodic_task();
+    TASK_TIMING_GROUP_STOP(TASK_TIMING_SENSORS);
   }
 
   if (sys_time_check_and_ack_timer(modules_radio_control_tid)) {
+    TASK_TIMING_GROUP_START(TASK_TIMING_RADIO_CONTROL);
     modules_radio_control_periodic_task();
+    TASK_TIMING_GROUP_STOP(TASK_TIMING_RADIO_CONTROL);
   }
 
   if (sys_time_check_and_ack_timer(modules_gnc_tid)) {
+    TASK_TIMING_GROUP_START(TASK_TIMING_GNC);
     modules_estimation_periodic_task();
+    // make the new estimation available to the other threads
+    stateSnapshotPublish(get_sys_time_usec());
     modules_control_periodic_task();
     modules_default_periodic_task();
     modules_actuators_periodic_task();
+    TASK_TIMING_GROUP_STOP(TASK_TIMING_GNC);
   }
 
   if (sys_time_check_and_ack_timer(modules_mcu_core_tid)) {
+    TASK_TIMING_GROUP_START(TASK_TIMING_CORE);
     modules_mcu_periodic_task();
     modules_core_periodic_task();
+    TASK_TIMING_GROUP_STOP(TASK_TIMING_CORE);
   }
 
   if (sys_time_check_and_ack_timer(modules_datalink_tid)) {
+    TASK_TIMING_GROUP_START(TASK_TIMING_DATALINK);
     modules_datalink_periodic_task();
+    TASK_TIMING_GROUP_STOP(TASK_TIMING_DATALINK);
   }
 }
 
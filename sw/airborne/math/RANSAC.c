@@ -36,7 +36,9 @@
 #include "RANSAC.h"
 #include "math/pprz_matrix_decomp_float.h"
 #include "math/pprz_algebra_float.h"
+#include "math/pprz_matrix_decomp_fixed_float.h"
 #include <math.h>
+#include <float.h>
 #include <string.h>
 #include <stdlib.h>
 #include "stdio.h"
@@ -123,6 +125,148 @@ void RANSAC_linear_model(int n_samples, int n_iterations, float error_threshold,
 
 }
 
+/** Capped error of a hypothesis on the samples, in the given order.
+ *
+ * @param[in] order The order in which the samples are scored
+ * @param[in] max_err Stop at the end of a block as soon as the error is larger
+ * @param[out] n_inliers Number of samples with an error below the threshold
+ * @return The sum of the capped errors, or a value >= max_err if the scoring stopped early
+ */
+static float RANSAC_score(float *weights, float error_threshold, float *targets, int D, float (*samples)[D],
+                          uint16_t *order, uint16_t count, bool use_bias, float max_err, int *n_inliers)
+{
+  float err_sum = 0.0f;
+  *n_inliers = 0;
+  for (int j = 0; j < count; j++) {
+    int idx = order[j];
+    float err = fabsf(predict_value(samples[idx], weights, D, use_bias) - targets[idx]);
+    if (err < error_threshold) {
+      err_sum += err;
+      (*n_inliers)++;
+    } else {
+      err_sum += error_threshold;
+    }
+    if ((j + 1) % RANSAC_BLOCK_SIZE == 0 && err_sum >= max_err) {
+      break;
+    }
+  }
+  return err_sum;
+}
+
+int RANSAC_linear_model_adaptive(int n_samples, int max_iterations, float confidence, float error_threshold,
+                                 float *targets, int D, float (*samples)[D], uint16_t count, bool use_bias,
+                                 float *params, float *fit_error, int *n_inliers)
+{
+  int D_1 = D + 1;
+  int n_min = use_bias ? D_1 : D;
+  int it, j, d;
+
+  // ensure that n_samples is high enough to ensure a result for a single fit:
+  n_samples = (n_samples < n_min) ? n_min : n_samples;
+  // n_samples should not be higher than count:
+  n_samples = (n_samples < count) ? n_samples : count;
+
+  for (d = 0; d < D_1; d++) {
+    params[d] = 0.0f;
+  }
+  *fit_error = error_threshold;
+  if (n_inliers != NULL) {
+    *n_inliers = 0;
+  }
+  if (count == 0 || n_samples == 0) {
+    return 0;
+  }
+
+  // random order in which the samples are scored
+  uint16_t order[count];
+  for (j = 0; j < count; j++) {
+    order[j] = j;
+  }
+  for (j = count - 1; j > 0; j--) {
+    int k = rand() % (j + 1);
+    uint16_t tmp = order[j];
+    order[j] = order[k];
+    order[k] = tmp;
+  }
+
+  int indices_subset[n_samples];
+  float subset_targets[n_samples];
+  float subset_samples[n_samples][D];
+  float hypothesis[D_1];
+  float err;
+  float best_err = FLT_MAX;
+  int best_inliers = 0;
+  int required = max_iterations;
+
+  for (it = 0; it < required; it++) {
+    // fit a hypothesis on a random subset
+    get_indices_without_replacement(indices_subset, n_samples, count);
+    for (j = 0; j < n_samples; j++) {
+      subset_targets[j] = targets[indices_subset[j]];
+      for (d = 0; d < D; d++) {
+        subset_samples[j][d] = samples[indices_subset[j]][d];
+      }
+    }
+    fit_linear_model(subset_targets, D, subset_samples, n_samples, use_bias, hypothesis, &err);
+
+    // score it, stopping as soon as it can not beat the best one
+    int inliers;
+    float err_sum = RANSAC_score(hypothesis, error_threshold, targets, D, samples, order, count, use_bias,
+                                 best_err, &inliers);
+    if (err_sum >= best_err) {
+      continue;
+    }
+    best_err = err_sum;
+    best_inliers = inliers;
+    memcpy(params, hypothesis, D_1 * sizeof(float));
+
+    // update the number of hypotheses needed from the inlier ratio
+    float w_n = powf((float)inliers / count, n_samples);
+    if (w_n > 1.0f - FLT_EPSILON) {
+      required = it + 1;
+    } else if (w_n > FLT_EPSILON) {
+      float n = logf(1.0f - confidence) / logf(1.0f - w_n);
+      if (n < required) {
+        required = (int)ceilf(n);
+      }
+    }
+  }
+
+  // refit the best hypothesis on its inliers
+  if (best_inliers >= n_min && D_1 <= PPRZ_MATRIX_DECOMP_FIXED_MAX) {
+    float R[PPRZ_MATRIX_DECOMP_FIXED_MAX * PPRZ_MATRIX_DECOMP_FIXED_MAX];
+    float z[PPRZ_MATRIX_DECOMP_FIXED_MAX];
+    float row[PPRZ_MATRIX_DECOMP_FIXED_MAX];
+    pprz_lsq_init_float(R, z, D_1);
+    for (j = 0; j < count; j++) {
+      if (fabsf(predict_value(samples[j], params, D, use_bias) - targets[j]) < error_threshold) {
+        for (d = 0; d < D; d++) {
+          row[d] = samples[j][d];
+        }
+        row[D] = use_bias ? 1.0f : 0.0f;
+        pprz_lsq_add_row_float(R, z, row, targets[j], D_1);
+      }
+    }
+    pprz_lsq_solve_float(hypothesis, R, z, D_1);
+
+    // keep the refit only if it is at least as good
+    int inliers;
+    float err_sum = RANSAC_score(hypothesis, error_threshold, targets, D, samples, order, count, use_bias,
+                                 FLT_MAX, &inliers);
+    if (err_sum <= best_err) {
+      best_err = err_sum;
+      best_inliers = inliers;
+      memcpy(params, hypothesis, D_1 * sizeof(float));
+    }
+  }
+
+  *fit_error = best_err / count;
+  if (n_inliers != NULL) {
+    *n_inliers = best_inliers;
+  }
+  return it;
+}
+
 /** Predict the value of a sample with linear weights.
  *
  * @param[in] sample The sample vector of size D
@@ -57,6 +57,43 @@ extern "C" {
 void RANSAC_linear_model(int n_samples, int n_iterations, float error_threshold, float *targets, int D,
                          float (*samples)[D], uint16_t count, bool use_bias, float *params, float *fit_error);
 
+/** Default confidence of the adaptive RANSAC */
+#ifndef RANSAC_CONFIDENCE
+#define RANSAC_CONFIDENCE 0.99f
+#endif
+
+/** Number of samples scored between two early rejection checks in the adaptive RANSAC */
+#ifndef RANSAC_BLOCK_SIZE
+#define RANSAC_BLOCK_SIZE 16
+#endif
+
+/** Perform an adaptive RANSAC to fit a linear model.
+ *
+ * The number of hypotheses is updated from the inlier ratio of the best one,
+ * so that a hypothesis with only inliers is drawn with the given confidence,
+ * and is bounded by max_iterations.
+ * The samples are scored in a random order, by blocks of RANSAC_BLOCK_SIZE, and a
+ * hypothesis is rejected as soon as its capped error exceeds the one of the best hypothesis.
+ * Finally the best hypothesis is refit on all its inliers.
+ *
+ * @param[in] n_samples The number of samples to use for a single fit
+ * @param[in] max_iterations The maximum number of hypotheses
+ * @param[in] confidence The probability to draw at least one subset without outliers (e.g. RANSAC_CONFIDENCE)
+ * @param[in] error_threshold The threshold used to cap errors and to select the inliers
+ * @param[in] targets The target values
+ * @param[in] samples The samples / feature vectors
+ * @param[in] D The dimensionality of the samples
+ * @param[in] count The number of samples
+ * @param[in] use_bias Whether the RANSAC procedure should add a bias. If 0 it does not.
+ * @param[out] params Parameters of the linear fit, of size D + 1
+ * @param[out] fit_error Mean capped error of the fit
+ * @param[out] n_inliers Number of inliers of the fit (can be NULL)
+ * @return The number of hypotheses evaluated
+ */
+int RANSAC_linear_model_adaptive(int n_samples, int max_iterations, float confidence, float error_threshold,
+                                 float *targets, int D, float (*samples)[D], uint16_t count, bool use_bias,
+                                 float *params, float *fit_error, int *n_inliers);
+
 /** Get indices without replacement.
  *
  * @param[out] indices_subset This will be filled with the sampled indices
@@ -231,32 +231,6 @@ void float_rmat_of_eulers_312(struct FloatRMat *rm, struct FloatEulers *e)
   RMAT_ELMT(*rm, 2, 2) =  cphi * ctheta;
 }
 
-
-/* C n->b rotation matrix */
-void float_rmat_of_quat(struct FloatRMat *rm, struct FloatQuat *q)
-{
-  const float _a = M_SQRT2 * q->qi;
-  const float _b = M_SQRT2 * q->qx;
-  const float _c = M_SQRT2 * q->qy;
-  const float _d = M_SQRT2 * q->qz;
-  const float a2_1 = _a * _a - 1;
-  const float ab = _a * _b;
-  const float ac = _a * _c;
-  const float ad = _a * _d;
-  const float bc = _b * _c;
-  const float bd = _b * _d;
-  const float cd = _c * _d;
-  RMAT_ELMT(*rm, 0, 0) = a2_1 + _b * _b;
-  RMAT_ELMT(*rm, 0, 1) = bc + ad;
-  RMAT_ELMT(*rm, 0, 2) = bd - ac;
-  RMAT_ELMT(*rm, 1, 0) = bc - ad;
-  RMAT_ELMT(*rm, 1, 1) = a2_1 + _c * _c;
-  RMAT_ELMT(*rm, 1, 2) = cd + ab;
-  RMAT_ELMT(*rm, 2, 0) = bd + ac;
-  RMAT_ELMT(*rm, 2, 1) = cd - ab;
-  RMAT_ELMT(*rm, 2, 2) = a2_1 + _d * _d;
-}
-
 /** in place first order integration of a rotation matrix */
 void float_rmat_integrate_fi(struct FloatRMat *rm, struct FloatRates *omega, float dt)
 {
@@ -317,14 +291,6 @@ float float_rmat_reorthogonalize(struct FloatRMat *rm)
  *
  */
 
-void float_quat_comp(struct FloatQuat *a2c, struct FloatQuat *a2b, struct FloatQuat *b2c)
-{
-  a2c->qi = a2b->qi * b2c->qi - a2b->qx * b2c->qx - a2b->qy * b2c->qy - a2b->qz * b2c->qz;
-  a2c->qx = a2b->qi * b2c->qx + a2b->qx * b2c->qi + a2b->qy * b2c->qz - a2b->qz * b2c->qy;
-  a2c->qy = a2b->qi * b2c->qy - a2b->qx * b2c->qz + a2b->qy * b2c->qi + a2b->qz * b2c->qx;
-  a2c->qz = a2b->qi * b2c->qz + a2b->qx * b2c->qy - a2b->qy * b2c->qx + a2b->qz * b2c->qi;
-}
-
 void float_quat_comp_inv(struct FloatQuat *a2b, struct FloatQuat *a2c, struct FloatQuat *b2c)
 {
   a2b->qi =  a2c->qi * b2c->qi + a2c->qx * b2c->qx + a2c->qy * b2c->qy + a2c->qz * b2c->qz;
@@ -396,52 +362,6 @@ void float_quat_integrate_fi(struct FloatQuat *q, struct FloatRates *omega, floa
   q->qz = dr * qi + dq * qx - dp * qy +    qz;
 }
 
-/** in place quaternion integration with constant rotational velocity */
-void float_quat_integrate(struct FloatQuat *q, struct FloatRates *omega, float dt)
-{
-  const float no = FLOAT_RATES_NORM(*omega);
-  if (no > FLT_MIN) {
-    const float a  = 0.5 * no * dt;
-    const float ca = cosf(a);
-    const float sa_ov_no = sinf(a) / no;
-    const float dp = sa_ov_no * omega->p;
-    const float dq = sa_ov_no * omega->q;
-    const float dr = sa_ov_no * omega->r;
-    const float qi = q->qi;
-    const float qx = q->qx;
-    const float qy = q->qy;
-    const float qz = q->qz;
-    q->qi = ca * qi - dp * qx - dq * qy - dr * qz;
-    q->qx = dp * qi + ca * qx + dr * qy - dq * qz;
-    q->qy = dq * qi - dr * qx + ca * qy + dp * qz;
-    q->qz = dr * qi + dq * qx - dp * qy + ca * qz;
-  }
-}
-
-void float_quat_vmult(struct FloatVect3 *v_out, struct FloatQuat *q, const struct FloatVect3 *v_in)
-{
-  const float qi2_M1_2  = q->qi * q->qi - 0.5;
-  const float qiqx = q->qi * q->qx;
-  const float qiqy = q->qi * q->qy;
-  const float qiqz = q->qi * q->qz;
-  float m01  = q->qx * q->qy; /* aka qxqy */
-  float m02  = q->qx * q->qz; /* aka qxqz */
-  float m12  = q->qy * q->qz; /* aka qyqz */
-
-  const float m00  = qi2_M1_2 + q->qx * q->qx;
-  const float m10  = m01 - qiqz;
-  const float m20  = m02 + qiqy;
-  const float m21  = m12 - qiqx;
-  m01 += qiqz;
-  m02 -= qiqy;
-  m12 += qiqx;
-  const float m11  = qi2_M1_2 + q->qy * q->qy;
-  const float m22  = qi2_M1_2 + q->qz * q->qz;
-  v_out->x = 2 * (m00 * v_in->x + m01 * v_in->y + m02 * v_in->z);
-  v_out->y = 2 * (m10 * v_in->x + m11 * v_in->y + m12 * v_in->z);
-  v_out->z = 2 * (m20 * v_in->x + m21 * v_in->y + m22 * v_in->z);
-}
-
 /** Quaternion derivative from rotational velocity.
  * qd = -0.5*omega(r) * q
  * or equally:
@@ -656,6 +576,39 @@ void float_quat_tilt_twist(struct FloatQuat *tilt, struct FloatQuat *twist, stru
   float_quat_inv_comp_norm_shortest(twist, tilt, quat);
 }
 
+/**
+ * Spherical linear interpolation between two unit quaternions
+ */
+void float_quat_slerp(struct FloatQuat *q, struct FloatQuat *q0, struct FloatQuat *q1, float t)
+{
+  float cos_theta = q0->qi * q1->qi + q0->qx * q1->qx + q0->qy * q1->qy + q0->qz * q1->qz;
+  float sign = 1.f;
+  // q and -q are the same rotation, interpolate along the shortest arc
+  if (cos_theta < 0.f) {
+    cos_theta = -cos_theta;
+    sign = -1.f;
+  }
+
+  float k0, k1;
+  if (cos_theta > 0.9995f) {
+    // quaternions are very close, sin(theta) -> 0, use linear interpolation
+    k0 = 1.f - t;
+    k1 = t;
+  } else {
+    const float theta = acosf(cos_theta);
+    const float sin_theta = sinf(theta);
+    k0 = sinf((1.f - t) * theta) / sin_theta;
+    k1 = sinf(t * theta) / sin_theta;
+  }
+  k1 *= sign;
+
+  q->qi = k0 * q0->qi + k1 * q1->qi;
+  q->qx = k0 * q0->qx + k1 * q1->qx;
+  q->qy = k0 * q0->qy + k1 * q1->qy;
+  q->qz = k0 * q0->qz + k1 * q1->qz;
+  float_quat_normalize(q);
+}
+
 
 /*
  *
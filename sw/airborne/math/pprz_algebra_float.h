@@ -46,6 +46,24 @@ extern "C" {
 #define M_SQRT2         1.41421356237309504880
 #endif
 
+/** Precision of the intermediate results of the inline rotation kernels
+ * (float_quat_comp, float_quat_vmult, float_rmat_of_quat, float_quat_integrate).
+ * Inputs and outputs stay in float. Set FLOAT_KERNELS_DOUBLE to TRUE to compute
+ * them in double, e.g. to check the rounding errors of an estimator in
+ * simulation; on single precision FPUs this is emulated and much slower.
+ */
+#if FLOAT_KERNELS_DOUBLE
+typedef double float_kernel_t;
+#define FLOAT_KERNEL_SIN(_x) sin(_x)
+#define FLOAT_KERNEL_COS(_x) cos(_x)
+#define FLOAT_KERNEL_SQRT(_x) sqrt(_x)
+#else
+typedef float float_kernel_t;
+#define FLOAT_KERNEL_SIN(_x) sinf(_x)
+#define FLOAT_KERNEL_COS(_x) cosf(_x)
+#define FLOAT_KERNEL_SQRT(_x) sqrtf(_x)
+#endif
+
 struct FloatVect2 {
   float x;
   float y;
@@ -332,7 +350,35 @@ extern void float_rmat_of_eulers_321(struct FloatRMat *rm, struct FloatEulers *e
 extern void float_rmat_of_eulers_312(struct FloatRMat *rm, struct FloatEulers *e);
 #define float_rmat_of_eulers float_rmat_of_eulers_321
 
-extern void float_rmat_of_quat(struct FloatRMat *rm, struct FloatQuat *q);
+/** Rotation matrix from quaternion.
+ * Inline as it is called at every AHRS propagation.
+ * @param[out] rm pointer to rotation matrix
+ * @param[in]  q  pointer to quaternion
+ */
+static inline void float_rmat_of_quat(struct FloatRMat *rm, struct FloatQuat *q)
+{
+  const float_kernel_t _a = (float_kernel_t)M_SQRT2 * q->qi;
+  const float_kernel_t _b = (float_kernel_t)M_SQRT2 * q->qx;
+  const float_kernel_t _c = (float_kernel_t)M_SQRT2 * q->qy;
+  const float_kernel_t _d = (float_kernel_t)M_SQRT2 * q->qz;
+  const float_kernel_t a2_1 = _a * _a - 1;
+  const float_kernel_t ab = _a * _b;
+  const float_kernel_t ac = _a * _c;
+  const float_kernel_t ad = _a * _d;
+  const float_kernel_t bc = _b * _c;
+  const float_kernel_t bd = _b * _d;
+  const float_kernel_t cd = _c * _d;
+  RMAT_ELMT(*rm, 0, 0) = a2_1 + _b * _b;
+  RMAT_ELMT(*rm, 0, 1) = bc + ad;
+  RMAT_ELMT(*rm, 0, 2) = bd - ac;
+  RMAT_ELMT(*rm, 1, 0) = bc - ad;
+  RMAT_ELMT(*rm, 1, 1) = a2_1 + _c * _c;
+  RMAT_ELMT(*rm, 1, 2) = cd + ab;
+  RMAT_ELMT(*rm, 2, 0) = bd + ac;
+  RMAT_ELMT(*rm, 2, 1) = cd - ab;
+  RMAT_ELMT(*rm, 2, 2) = a2_1 + _d * _d;
+}
+
 /** in place first order integration of a rotation matrix */
 extern void float_rmat_integrate_fi(struct FloatRMat *rm, struct FloatRates *omega, float dt);
 extern float float_rmat_reorthogonalize(struct FloatRMat *rm);
@@ -395,7 +441,7 @@ static inline void float_quat_invert(struct FloatQuat *qo, struct FloatQuat *qi)
 
 static inline void float_quat_wrap_shortest(struct FloatQuat *q)
 {
-  if (q->qi < 0.) {
+  if (q->qi < 0.f) {
     QUAT_EXPLEMENTARY(*q, *q);
   }
 }
@@ -405,8 +451,17 @@ static inline void float_quat_wrap_shortest(struct FloatQuat *q)
 
 /** Composition (multiplication) of two quaternions.
  * a2c = a2b comp b2c , aka  a2c = a2b * b2c
+ * The inputs are loaded first, so a2c can be the same as a2b or b2c.
  */
-extern void float_quat_comp(struct FloatQuat *a2c, struct FloatQuat *a2b, struct FloatQuat *b2c);
+static inline void float_quat_comp(struct FloatQuat *a2c, struct FloatQuat *a2b, struct FloatQuat *b2c)
+{
+  const float_kernel_t ai = a2b->qi, ax = a2b->qx, ay = a2b->qy, az = a2b->qz;
+  const float_kernel_t bi = b2c->qi, bx = b2c->qx, by = b2c->qy, bz = b2c->qz;
+  a2c->qi = ai * bi - ax * bx - ay * by - az * bz;
+  a2c->qx = ai * bx + ax * bi + ay * bz - az * by;
+  a2c->qy = ai * by - ax * bz + ay * bi + az * bx;
+  a2c->qz = ai * bz + ax * by - ay * bx + az * bi;
+}
 
 /** Composition (multiplication) of two quaternions.
  * a2b = a2c comp_inv b2c , aka  a2b = a2c * inv(b2c)
@@ -455,12 +510,56 @@ extern void float_quat_differential(struct FloatQuat *q_out, struct FloatRates *
 extern void float_quat_integrate_fi(struct FloatQuat *q, struct FloatRates *omega, float dt);
 
 /** in place quaternion integration with constant rotational velocity */
-extern void float_quat_integrate(struct FloatQuat *q, struct FloatRates *omega, float dt);
+static inline void float_quat_integrate(struct FloatQuat *q, struct FloatRates *omega, float dt)
+{
+  const float_kernel_t wp = omega->p, wq = omega->q, wr = omega->r;
+  const float_kernel_t no = FLOAT_KERNEL_SQRT(wp * wp + wq * wq + wr * wr);
+  if (no > FLT_MIN) {
+    const float_kernel_t a  = 0.5f * no * dt;
+    const float_kernel_t ca = FLOAT_KERNEL_COS(a);
+    const float_kernel_t sa_ov_no = FLOAT_KERNEL_SIN(a) / no;
+    const float_kernel_t dp = sa_ov_no * wp;
+    const float_kernel_t dq = sa_ov_no * wq;
+    const float_kernel_t dr = sa_ov_no * wr;
+    const float_kernel_t qi = q->qi;
+    const float_kernel_t qx = q->qx;
+    const float_kernel_t qy = q->qy;
+    const float_kernel_t qz = q->qz;
+    q->qi = ca * qi - dp * qx - dq * qy - dr * qz;
+    q->qx = dp * qi + ca * qx + dr * qy - dq * qz;
+    q->qy = dq * qi - dr * qx + ca * qy + dp * qz;
+    q->qz = dr * qi + dq * qx - dp * qy + ca * qz;
+  }
+}
 
 /** rotate 3D vector by quaternion.
  * vb = q_a2b * va * q_a2b^-1
  */
-extern void float_quat_vmult(struct FloatVect3 *v_out, struct FloatQuat *q, const struct FloatVect3 *v_in);
+static inline void float_quat_vmult(struct FloatVect3 *v_out, struct FloatQuat *q, const struct FloatVect3 *v_in)
+{
+  const float_kernel_t qi = q->qi, qx = q->qx, qy = q->qy, qz = q->qz;
+  const float_kernel_t vx = v_in->x, vy = v_in->y, vz = v_in->z;
+  const float_kernel_t qi2_M1_2  = qi * qi - 0.5f;
+  const float_kernel_t qiqx = qi * qx;
+  const float_kernel_t qiqy = qi * qy;
+  const float_kernel_t qiqz = qi * qz;
+  const float_kernel_t qxqy = qx * qy;
+  const float_kernel_t qxqz = qx * qz;
+  const float_kernel_t qyqz = qy * qz;
+
+  const float_kernel_t m00 = qi2_M1_2 + qx * qx;
+  const float_kernel_t m01 = qxqy + qiqz;
+  const float_kernel_t m02 = qxqz - qiqy;
+  const float_kernel_t m10 = qxqy - qiqz;
+  const float_kernel_t m11 = qi2_M1_2 + qy * qy;
+  const float_kernel_t m12 = qyqz + qiqx;
+  const float_kernel_t m20 = qxqz + qiqy;
+  const float_kernel_t m21 = qyqz - qiqx;
+  const float_kernel_t m22 = qi2_M1_2 + qz * qz;
+  v_out->x = 2 * (m00 * vx + m01 * vy + m02 * vz);
+  v_out->y = 2 * (m10 * vx + m11 * vy + m12 * vz);
+  v_out->z = 2 * (m20 * vx + m21 * vy + m22 * vz);
+}
 
 /// Quaternion from Euler angles.
 extern void float_quat_of_eulers(struct FloatQuat *q, struct FloatEulers *e);
@@ -484,6 +583,15 @@ extern void float_quat_of_rmat(struct FloatQuat *q, struct FloatRMat *rm);
 /// Tilt twist decomposition of quaternion
 extern void float_quat_tilt_twist(struct FloatQuat *tilt, struct FloatQuat *twist, struct FloatQuat *quat);
 
+/** Spherical linear interpolation between two unit quaternions.
+ * Takes the shortest path, falls back to normalized linear interpolation for close quaternions.
+ * @param q output quaternion
+ * @param q0 quaternion at t = 0
+ * @param q1 quaternion at t = 1
+ * @param t interpolation factor in [0, 1]
+ */
+extern void float_quat_slerp(struct FloatQuat *q, struct FloatQuat *q0, struct FloatQuat *q1, float t);
+
 
 /* defines for backwards compatibility */
 #define FLOAT_QUAT_ZERO(_q) WARNING("FLOAT_QUAT_ZERO macro is deprecated, use the lower case function instead") float_quat_identity(&(_q))
@@ -110,6 +110,10 @@ extern void ned_of_ecef_vect_f(struct NedCoor_f *ned, struct LtpDef_f *def, stru
 extern void enu_of_lla_point_f(struct EnuCoor_f *enu, struct LtpDef_f *def, struct LlaCoor_f *lla);
 extern void ned_of_lla_point_f(struct NedCoor_f *ned, struct LtpDef_f *def, struct LlaCoor_f *lla);
 
+/* direct local to LLA conversions, without ECEF */
+extern void lla_of_enu_point_f(struct LlaCoor_f *lla, struct LtpDef_f *def, struct EnuCoor_f *enu);
+extern void lla_of_ned_point_f(struct LlaCoor_f *lla, struct LtpDef_f *def, struct NedCoor_f *ned);
+
 /*  not enough precision with floats - used the double version */
 extern void ecef_of_enu_point_f(struct EcefCoor_f *ecef, struct LtpDef_f *def, struct EnuCoor_f *enu);
 extern void ecef_of_ned_point_f(struct EcefCoor_f *ecef, struct LtpDef_f *def, struct NedCoor_f *ned);
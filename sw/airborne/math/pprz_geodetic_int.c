@@ -121,6 +121,47 @@ void ned_of_ecef_point_i(struct NedCoor_i *ned, struct LtpDef_i *def, struct Ece
 }
 
 
+/** Convert n points from ECEF to local ENU.
+ * @param[out] enu  n ENU points in cm
+ * @param[in]  def  local coordinate system definition
+ * @param[in]  ecef n ECEF points in cm
+ * @param[in]  n    number of points
+ */
+void enu_of_ecef_points_i(struct EnuCoor_i *enu, struct LtpDef_i *def, struct EcefCoor_i *ecef, int n)
+{
+  const struct Int32RMat R = def->ltp_of_ecef;
+  const struct EcefCoor_i o = def->ecef;
+  for (int i = 0; i < n; i++) {
+    const int64_t dx = ecef[i].x - o.x;
+    const int64_t dy = ecef[i].y - o.y;
+    const int64_t dz = ecef[i].z - o.z;
+    enu[i].x = (int32_t)((R.m[0] * dx + R.m[1] * dy) >> HIGH_RES_TRIG_FRAC);
+    enu[i].y = (int32_t)((R.m[3] * dx + R.m[4] * dy + R.m[5] * dz) >> HIGH_RES_TRIG_FRAC);
+    enu[i].z = (int32_t)((R.m[6] * dx + R.m[7] * dy + R.m[8] * dz) >> HIGH_RES_TRIG_FRAC);
+  }
+}
+
+/** Convert n points from ECEF to local NED.
+ * @param[out] ned  n NED points in cm
+ * @param[in]  def  local coordinate system definition
+ * @param[in]  ecef n ECEF points in cm
+ * @param[in]  n    number of points
+ */
+void ned_of_ecef_points_i(struct NedCoor_i *ned, struct LtpDef_i *def, struct EcefCoor_i *ecef, int n)
+{
+  const struct Int32RMat R = def->ltp_of_ecef;
+  const struct EcefCoor_i o = def->ecef;
+  for (int i = 0; i < n; i++) {
+    const int64_t dx = ecef[i].x - o.x;
+    const int64_t dy = ecef[i].y - o.y;
+    const int64_t dz = ecef[i].z - o.z;
+    ned[i].x = (int32_t)((R.m[3] * dx + R.m[4] * dy + R.m[5] * dz) >> HIGH_RES_TRIG_FRAC);
+    ned[i].y = (int32_t)((R.m[0] * dx + R.m[1] * dy) >> HIGH_RES_TRIG_FRAC);
+    ned[i].z = -(int32_t)((R.m[6] * dx + R.m[7] * dy + R.m[8] * dz) >> HIGH_RES_TRIG_FRAC);
+  }
+}
+
+
 /** Convert a ECEF position to local ENU.
  * @param[out] enu  ENU position in meter << #INT32_POS_FRAC
  * @param[in]  def  local coordinate system definition
@@ -111,6 +111,8 @@ extern void lla_of_ecef_i(struct LlaCoor_i *out, struct EcefCoor_i *in);
 extern void ecef_of_lla_i(struct EcefCoor_i *out, struct LlaCoor_i *in);
 extern void enu_of_ecef_point_i(struct EnuCoor_i *enu, struct LtpDef_i *def, struct EcefCoor_i *ecef);
 extern void ned_of_ecef_point_i(struct NedCoor_i *ned, struct LtpDef_i *def, struct EcefCoor_i *ecef);
+extern void enu_of_ecef_points_i(struct EnuCoor_i *enu, struct LtpDef_i *def, struct EcefCoor_i *ecef, int n);
+extern void ned_of_ecef_points_i(struct NedCoor_i *ned, struct LtpDef_i *def, struct EcefCoor_i *ecef, int n);
 extern void enu_of_ecef_pos_i(struct EnuCoor_i *enu, struct LtpDef_i *def, struct EcefCoor_i *ecef);
 extern void ned_of_ecef_pos_i(struct NedCoor_i *ned, struct LtpDef_i *def, struct EcefCoor_i *ecef);
 extern void enu_of_ecef_vect_i(struct EnuCoor_i *enu, struct LtpDef_i *def, struct EcefCoor_i *ecef);
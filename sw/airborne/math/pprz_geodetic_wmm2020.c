@@ -256,3 +256,202 @@ int16_t mag_calc(int16_t igdgc, double flat, double flon, double elev, int16_t n
   *geo_mag_z = *geo_mag_z * cd - aa * sd;
   return (ios);
 }
+
+void wmm2020_extrapsh_f(float *gh, float date)
+{
+  const float factor = date - (float)GEO_EPOCH;
+  gh[0] = 0.f;
+  for (int ii = 1; ii < WMM2020_NB_COEFF; ii++) {
+    gh[ii] = (float)gh1[ii] + factor * (float)gh2[ii];
+  }
+}
+
+/** Number of (n, m) terms of the expansion */
+#define WMM2020_NPQ ((NMAX_1 * (NMAX_1 + 3)) / 2)
+
+/** Recursion coefficients of the term k = (n, m), they only depend on n and m
+ *  - m == n: p[k] = p1 clat p[j] and q[k] = q1 clat q[j] + q2 slat p[j] with j = k - n - 1
+ *  - m < n: p[k] = p1 slat p[i] - p2 p[j] and q[k] = q1 slat q[i] - q2 clat p[i] - q3 q[j]
+ *    with i = k - n and j = k - 2n + 1
+ */
+struct wmm2020_recursion {
+  float p1, p2;
+  float q1, q2, q3;
+  float y;          ///< m / (n + 1), east component factor
+};
+
+static struct wmm2020_recursion wmm2020_rec[WMM2020_NPQ + 1];
+static bool wmm2020_rec_init = false;
+
+static void wmm2020_init_recursion(void)
+{
+  int k = 1;
+  for (int n = 1; n <= NMAX_1; n++) {
+    for (int m = 0; m <= n; m++, k++) {
+      const float fn = (float)n;
+      const float fm = (float)m;
+      struct wmm2020_recursion *r = &wmm2020_rec[k];
+      r->y = fm / (fn + 1.f);
+      if (k < 5) {
+        // first terms are explicit
+        r->p1 = r->p2 = r->q1 = r->q2 = r->q3 = 0.f;
+      } else if (m == n) {
+        const float aa = sqrtf(1.f - 0.5f / fm);
+        r->p1 = (1.f + 1.f / fm) * aa;
+        r->p2 = 0.f;
+        r->q1 = aa;
+        r->q2 = aa / fm;
+        r->q3 = 0.f;
+      } else {
+        const float aa = sqrtf(fn * fn - fm * fm);
+        const float bb = sqrtf((fn - 1.f) * (fn - 1.f) - fm * fm) / aa;
+        const float cc = (2.f * fn - 1.f) / aa;
+        r->p1 = (fn + 1.f) * cc / fn;
+        r->p2 = (fn + 1.f) * bb / (fn - 1.f);
+        r->q1 = cc;
+        r->q2 = cc / fn;
+        r->q3 = bb;
+      }
+    }
+  }
+  wmm2020_rec_init = true;
+}
+
+void wmm2020_mag_calc_f(struct FloatVect3 *field, const float *gh, const struct LlaCoor_f *lla)
+{
+  const float earths_radius = 6371.2f;
+  const float a2 = 40680631.59f;   /* WGS84 */
+  const float b2 = 40408299.98f;   /* WGS84 */
+  const float a2_b2 = 272331.61f;  /* a2 - b2 */
+  float p[WMM2020_NPQ + 1];
+  float q[WMM2020_NPQ + 1];
+  float sl[NMAX_1 + 1];
+  float cl[NMAX_1 + 1];
+
+  if (!wmm2020_rec_init) {
+    wmm2020_init_recursion();
+  }
+
+  const float elev = lla->alt / 1000.f;
+  const float lat = Clip(lla->lat, RadOfDeg(-89.999f), RadOfDeg(89.999f));
+  float slat = sinf(lla->lat);
+  float clat = cosf(lat);
+  sl[0] = 0.f;
+  cl[0] = 1.f;
+  sl[1] = sinf(lla->lon);
+  cl[1] = cosf(lla->lon);
+  for (int m = 2; m <= NMAX_1; m++) {
+    sl[m] = sl[m - 1] * cl[1] + cl[m - 1] * sl[1];
+    cl[m] = cl[m - 1] * cl[1] - sl[m - 1] * sl[1];
+  }
+
+  // geodetic to geocentric
+  const float aa = a2 * clat * clat;
+  const float bb = b2 * slat * slat;
+  const float cc = aa + bb;
+  const float dd = sqrtf(cc);
+  const float r = sqrtf(elev * (elev + 2.f * dd) + (a2 * aa + b2 * bb) / cc);
+  const float cd = (elev + dd) / r;
+  const float sd = a2_b2 / dd * slat * clat / r;
+  const float slat_gd = slat;
+  slat = slat * cd - clat * sd;
+  clat = clat * cd + slat_gd * sd;
+  const float inv_clat = clat > 0.f ? 1.f / clat : 0.f;
+
+  const float ratio = earths_radius / r;
+  const float sqrt3 = 1.7320508f;
+  p[1] = 2.f * slat;
+  p[2] = 2.f * clat;
+  p[3] = 4.5f * slat * slat - 1.5f;
+  p[4] = 3.f * sqrt3 * clat * slat;
+  q[1] = -clat;
+  q[2] = slat;
+  q[3] = -3.f * clat * slat;
+  q[4] = sqrt3 * (slat * slat - clat * clat);
+
+  float x = 0.f, y = 0.f, z = 0.f;
+  float rr = ratio * ratio;
+  int k = 1, l = 1;
+  for (int n = 1; n <= NMAX_1; n++) {
+    rr *= ratio; // ratio^(n + 2)
+    for (int m = 0; m <= n; m++, k++) {
+      const struct wmm2020_recursion *rec = &wmm2020_rec[k];
+      if (k >= 5) {
+        if (m == n) {
+          const int j = k - n - 1;
+          p[k] = rec->p1 * clat * p[j];
+          q[k] = rec->q1 * clat * q[j] + rec->q2 * slat * p[j];
+        } else {
+          const int i = k - n;
+          const int j = k - 2 * n + 1;
+          p[k] = rec->p1 * slat * p[i] - rec->p2 * p[j];
+          q[k] = rec->q1 * slat * q[i] - rec->q2 * clat * p[i] - rec->q3 * q[j];
+        }
+      }
+
+      const float g = rr * gh[l];
+      if (m == 0) {
+        x += g * q[k];
+        z -= g * p[k];
+        l += 1;
+      } else {
+        const float h = rr * gh[l + 1];
+        const float gc = g * cl[m] + h * sl[m];
+        x += gc * q[k];
+        z -= gc * p[k];
+        if (clat > 0.f) {
+          y += (g * sl[m] - h * cl[m]) * rec->y * p[k] * inv_clat;
+        } else {
+          y += (g * sl[m] - h * cl[m]) * q[k] * slat;
+        }
+        l += 2;
+      }
+    }
+  }
+
+  // back to geodetic
+  field->x = x * cd + z * sd;
+  field->y = y;
+  field->z = z * cd - x * sd;
+}
+
+void wmm2020_cache_init(struct Wmm2020Cache *cache, float date, float cell, float alt_tol)
+{
+  wmm2020_extrapsh_f(cache->gh, date);
+  cache->cell = cell;
+  cache->alt_tol = alt_tol;
+  cache->valid = false;
+  cache->nb_eval = 0;
+}
+
+void wmm2020_cache_get(struct Wmm2020Cache *cache, struct FloatVect3 *field, const struct LlaCoor_f *lla)
+{
+  const float lat0 = floorf(lla->lat / cache->cell) * cache->cell;
+  const float lon0 = floorf(lla->lon / cache->cell) * cache->cell;
+
+  if (!cache->valid || lat0 != cache->origin.lat || lon0 != cache->origin.lon ||
+      fabsf(lla->alt - cache->origin.alt) > cache->alt_tol) {
+    cache->origin.lat = lat0;
+    cache->origin.lon = lon0;
+    cache->origin.alt = lla->alt;
+    for (int i = 0; i < 4; i++) {
+      struct LlaCoor_f c = {
+        .lat = lat0 + (float)(i / 2) * cache->cell,
+        .lon = lon0 + (float)(i % 2) * cache->cell,
+        .alt = lla->alt
+      };
+      wmm2020_mag_calc_f(&cache->corner[i], cache->gh, &c);
+    }
+    cache->valid = true;
+    cache->nb_eval++;
+  }
+
+  // bilinear interpolation
+  const float tx = (lla->lon - lon0) / cache->cell;
+  const float ty = (lla->lat - lat0) / cache->cell;
+  const float w[4] = { (1.f - tx) * (1.f - ty), tx * (1.f - ty), (1.f - tx) * ty, tx * ty };
+  FLOAT_VECT3_ZERO(*field);
+  for (int i = 0; i < 4; i++) {
+    VECT3_ADD_SCALED(*field, cache->corner[i], w[i]);
+  }
+}
@@ -34,6 +34,9 @@
 #ifndef WMM2020_H
 #define WMM2020_H
 
+#include "std.h"
+#include "math/pprz_geodetic_float.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -74,6 +77,62 @@ int16_t mag_calc(int16_t igdgc, double flat, double flon, double elev, int16_t n
                  double *gh, double *geo_mag_x, double *geo_mag_y, double *geo_mag_z,
                  int16_t iext, double ext1, double ext2, double ext3);
 
+/** Number of coefficients of the single precision model, evaluated up to NMAX_1 */
+#define WMM2020_NB_COEFF (NMAX_1 * (NMAX_1 + 2) + 1)
+
+/**
+ * Model coefficients at a given date, in single precision
+ * @param[out] gh coefficients [WMM2020_NB_COEFF]
+ * @param[in] date date in decimal years
+ */
+extern void wmm2020_extrapsh_f(float *gh, float date);
+
+/**
+ * Geomagnetic field at a geodetic position, in single precision.
+ * Same model as @ref mag_calc without external field, with the degree fixed
+ * to NMAX_1 and the recursion coefficients computed once.
+ * @param[out] field magnetic field in NED frame (nT)
+ * @param[in] gh coefficients from @ref wmm2020_extrapsh_f
+ * @param[in] lla geodetic position (rad, rad, m)
+ */
+extern void wmm2020_mag_calc_f(struct FloatVect3 *field, const float *gh, const struct LlaCoor_f *lla);
+
+/**
+ * Cache of the geomagnetic field.
+ * The model is evaluated at the corners of the latitude/longitude cell of
+ * the position, and the field is bilinearly interpolated within the cell.
+ * The corners are evaluated again when leaving the cell or when the altitude
+ * changed by more than alt_tol.
+ * Entering a cell costs four evaluations of the model, use
+ * @ref wmm2020_mag_calc_f directly for a single calculation.
+ */
+struct Wmm2020Cache {
+  float gh[WMM2020_NB_COEFF];     ///< coefficients at the cache date
+  float cell;                     ///< cell size (rad)
+  float alt_tol;                  ///< altitude change triggering a new evaluation (m)
+  struct LlaCoor_f origin;        ///< south west corner of the current cell and altitude of the evaluation
+  struct FloatVect3 corner[4];    ///< field at the south west, south east, north west and north east corners
+  bool valid;                     ///< corners are evaluated
+  uint32_t nb_eval;               ///< number of cell evaluations
+};
+
+/**
+ * Initialize a cache
+ * @param[out] cache the cache
+ * @param[in] date date in decimal years
+ * @param[in] cell cell size (rad)
+ * @param[in] alt_tol altitude change triggering a new evaluation (m)
+ */
+extern void wmm2020_cache_init(struct Wmm2020Cache *cache, float date, float cell, float alt_tol);
+
+/**
+ * Geomagnetic field from the cache, evaluating the model when needed
+ * @param[in,out] cache the cache
+ * @param[out] field magnetic field in NED frame (nT)
+ * @param[in] lla geodetic position (rad, rad, m)
+ */
+extern void wmm2020_cache_get(struct Wmm2020Cache *cache, struct FloatVect3 *field, const struct LlaCoor_f *lla);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file pprz_matrix_decomp_fixed_float.c
+ * @brief Fixed size matrix decompositions in floating point.
+ *
+ * The algorithms are written once as always inlined functions of the size n,
+ * and instantiated for each size with a constant n. The temporary arrays have
+ * the maximum size PPRZ_MATRIX_DECOMP_FIXED_MAX.
+ */
+
+#include "math/pprz_matrix_decomp_fixed_float.h"
+#include <math.h>
+#include <float.h>
+#include <string.h>
+
+#define DECOMP_INLINE static inline __attribute__((always_inline))
+
+DECOMP_INLINE bool cholesky_n(float *L, const float *A, const int n)
+{
+  bool ok = true;
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      if (j > i) {
+        L[i * n + j] = 0.f;
+        continue;
+      }
+      float s = A[i * n + j];
+      for (int k = 0; k < j; k++) {
+        s -= L[i * n + k] * L[j * n + k];
+      }
+      if (i == j) {
+        if (s <= 0.f) {
+          ok = false;
+          s = FLT_MIN;
+        }
+        L[i * n + i] = sqrtf(s);
+      } else {
+        L[i * n + j] = s / L[j * n + j];
+      }
+    }
+  }
+  return ok;
+}
+
+DECOMP_INLINE void cholesky_solve_n(float *x, const float *L, const float *b, const int n)
+{
+  float y[PPRZ_MATRIX_DECOMP_FIXED_MAX];
+  // L*y = b
+  for (int i = 0; i < n; i++) {
+    float s = b[i];
+    for (int k = 0; k < i; k++) {
+      s -= L[i * n + k] * y[k];
+    }
+    y[i] = s / L[i * n + i];
+  }
+  // L^T*x = y
+  for (int i = n - 1; i >= 0; i--) {
+    float s = y[i];
+    for (int k = i + 1; k < n; k++) {
+      s -= L[k * n + i] * x[k];
+    }
+    x[i] = s / L[i * n + i];
+  }
+}
+
+DECOMP_INLINE bool cholesky_inv_n(float *inv, const float *A, const int n)
+{
+  float L[PPRZ_MATRIX_DECOMP_FIXED_MAX * PPRZ_MATRIX_DECOMP_FIXED_MAX];
+  float e[PPRZ_MATRIX_DECOMP_FIXED_MAX];
+  float col[PPRZ_MATRIX_DECOMP_FIXED_MAX];
+  bool ok = cholesky_n(L, A, n);
+  for (int j = 0; j < n; j++) {
+    for (int i = 0; i < n; i++) {
+      e[i] = (i == j) ? 1.f : 0.f;
+    }
+    cholesky_solve_n(col, L, e, n);
+    for (int i = 0; i < n; i++) {
+      inv[i * n + j] = col[i];
+    }
+  }
+  return ok;
+}
+
+DECOMP_INLINE void qr_n(float *Q, float *R, const float *A, const int n)
+{
+  float v[PPRZ_MATRIX_DECOMP_FIXED_MAX];
+  memcpy(R, A, n * n * sizeof(float));
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      Q[i * n + j] = (i == j) ? 1.f : 0.f;
+    }
+  }
+  for (int k = 0; k < n - 1; k++) {
+    // Householder vector of the column k below the diagonal
+    float norm = 0.f;
+    for (int i = k; i < n; i++) {
+      v[i] = R[i * n + k];
+      norm += v[i] * v[i];
+    }
+    norm = sqrtf(norm);
+    if (norm < FLT_MIN) {
+      continue;
+    }
+    float alpha = (v[k] > 0.f) ? -norm : norm;
+    v[k] -= alpha;
+    float vnorm2 = 0.f;
+    for (int i = k; i < n; i++) {
+      vnorm2 += v[i] * v[i];
+    }
+    if (vnorm2 < FLT_MIN) {
+      continue;
+    }
+    float scale = 2.f / vnorm2;
+    // R = (I - scale*v*v^T)*R
+    for (int j = 0; j < n; j++) {
+      float s = 0.f;
+      for (int i = k; i < n; i++) {
+        s += v[i] * R[i * n + j];
+      }
+      s *= scale;
+      for (int i = k; i < n; i++) {
+        R[i * n + j] -= s * v[i];
+      }
+    }
+    // Q = Q*(I - scale*v*v^T)
+    for (int i = 0; i < n; i++) {
+      float s = 0.f;
+      for (int j = k; j < n; j++) {
+        s += Q[i * n + j] * v[j];
+      }
+      s *= scale;
+      for (int j = k; j < n; j++) {
+        Q[i * n + j] -= s * v[j];
+      }
+    }
+    for (int i = k + 1; i < n; i++) {
+      R[i * n + k] = 0.f;
+    }
+  }
+}
+
+DECOMP_INLINE void lsq_init_n(float *R, float *z, const int n)
+{
+  memset(R, 0, n * n * sizeof(float));
+  memset(z, 0, n * sizeof(float));
+}
+
+DECOMP_INLINE void lsq_add_row_n(float *R, float *z, const float *row, float target, const int n)
+{
+  float r[PPRZ_MATRIX_DECOMP_FIXED_MAX];
+  memcpy(r, row, n * sizeof(float));
+  // rotate the new row into the triangular matrix R
+  for (int k = 0; k < n; k++) {
+    if (r[k] == 0.f) {
+      continue;
+    }
+    float h = hypotf(R[k * n + k], r[k]);
+    float c = R[k * n + k] / h;
+    float s = r[k] / h;
+    for (int j = k; j < n; j++) {
+      float tmp = c * R[k * n + j] + s * r[j];
+      r[j] = -s * R[k * n + j] + c * r[j];
+      R[k * n + j] = tmp;
+    }
+    float tmp = c * z[k] + s * target;
+    target = -s * z[k] + c * target;
+    z[k] = tmp;
+  }
+}
+
+DECOMP_INLINE void lsq_solve_n(float *x, const float *R, const float *z, const int n)
+{
+  float r_max = 0.f;
+  for (int k = 0; k < n; k++) {
+    r_max = fmaxf(r_max, fabsf(R[k * n + k]));
+  }
+  float r_min = n * FLT_EPSILON * r_max;
+  for (int i = n - 1; i >= 0; i--) {
+    if (fabsf(R[i * n + i]) <= r_min) {
+      x[i] = 0.f;
+      continue;
+    }
+    float s = z[i];
+    for (int j = i + 1; j < n; j++) {
+      s -= R[i * n + j] * x[j];
+    }
+    x[i] = s / R[i * n + i];
+  }
+}
+
+#define PPRZ_MATRIX_DECOMP_FIXED_DEFINE(_n) \
+  bool pprz_cholesky_float_##_n(float *L, const float *A) { return cholesky_n(L, A, _n); } \
+  void pprz_cholesky_solve_float_##_n(float *x, const float *L, const float *b) { cholesky_solve_n(x, L, b, _n); } \
+  bool pprz_cholesky_inv_float_##_n(float *inv, const float *A) { return cholesky_inv_n(inv, A, _n); } \
+  void pprz_qr_float_##_n(float *Q, float *R, const float *A) { qr_n(Q, R, A, _n); } \
+  void pprz_lsq_init_float_##_n(float *R, float *z) { lsq_init_n(R, z, _n); } \
+  void pprz_lsq_add_row_float_##_n(float *R, float *z, const float *row, float target) { lsq_add_row_n(R, z, row, target, _n); } \
+  void pprz_lsq_solve_float_##_n(float *x, const float *R, const float *z) { lsq_solve_n(x, R, z, _n); }
+
+PPRZ_MATRIX_DECOMP_FIXED_DEFINE(2)
+PPRZ_MATRIX_DECOMP_FIXED_DEFINE(3)
+PPRZ_MATRIX_DECOMP_FIXED_DEFINE(4)
+PPRZ_MATRIX_DECOMP_FIXED_DEFINE(5)
+PPRZ_MATRIX_DECOMP_FIXED_DEFINE(6)
+PPRZ_MATRIX_DECOMP_FIXED_DEFINE(7)
+PPRZ_MATRIX_DECOMP_FIXED_DEFINE(8)
+
+#define LSQ_DISPATCH(_fun, _n, ...) \
+  switch (_n) { \
+    case 2: _fun##_2(__VA_ARGS__); return true; \
+    case 3: _fun##_3(__VA_ARGS__); return true; \
+    case 4: _fun##_4(__VA_ARGS__); return true; \
+    case 5: _fun##_5(__VA_ARGS__); return true; \
+    case 6: _fun##_6(__VA_ARGS__); return true; \
+    case 7: _fun##_7(__VA_ARGS__); return true; \
+    case 8: _fun##_8(__VA_ARGS__); return true; \
+    default: return false; \
+  }
+
+bool pprz_lsq_init_float(float *R, float *z, int n)
+{
+  LSQ_DISPATCH(pprz_lsq_init_float, n, R, z)
+}
+
+bool pprz_lsq_add_row_float(float *R, float *z, const float *row, float target, int n)
+{
+  LSQ_DISPATCH(pprz_lsq_add_row_float, n, R, z, row, target)
+}
+
+bool pprz_lsq_solve_float(float *x, const float *R, const float *z, int n)
+{
+  LSQ_DISPATCH(pprz_lsq_solve_float, n, x, R, z)
+}
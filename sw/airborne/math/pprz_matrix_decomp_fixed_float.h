@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file pprz_matrix_decomp_fixed_float.h
+ * @brief Fixed size matrix decompositions in floating point.
+ *
+ * Same decompositions as pprz_matrix_decomp_float.h, for square matrices of
+ * a size known at compile time, from 2x2 to 8x8. The matrices are contiguous
+ * row major arrays (a float[N][N] can be passed with &m[0][0]) instead of
+ * arrays of row pointers, and no VLA is used, so the stack usage does not
+ * depend on the data. Each size has its own function (suffix _N), in which
+ * all the loop bounds are constant, so that the compiler can unroll and
+ * vectorize them.
+ *
+ * The streaming least squares (pprz_lsq_*) accumulate the rows of an
+ * overdetermined system one at a time with Givens rotations, so the number
+ * of rows does not need to be known and is not stored.
+ */
+
+#ifndef PPRZ_MATRIX_DECOMP_FIXED_FLOAT_H
+#define PPRZ_MATRIX_DECOMP_FIXED_FLOAT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "std.h"
+
+/** Largest size of the fixed size decompositions */
+#define PPRZ_MATRIX_DECOMP_FIXED_MAX 8
+
+/**
+ * Declare the functions for matrices of size _n x _n
+ *
+ * pprz_cholesky_float_N(L, A): Cholesky decomposition A = L*L^T of a symmetric
+ *   positive definite matrix, L is lower triangular. Returns false if A is not positive definite.
+ * pprz_cholesky_solve_float_N(x, L, b): solve A*x = b from the Cholesky factor L of A
+ * pprz_cholesky_inv_float_N(inv, A): inverse of a symmetric positive definite matrix,
+ *   returns false if A is not positive definite
+ * pprz_qr_float_N(Q, R, A): QR decomposition A = Q*R with Householder reflections
+ * pprz_lsq_init_float_N(R, z): reset a streaming least squares problem
+ * pprz_lsq_add_row_float_N(R, z, row, target): add one equation row*x = target
+ * pprz_lsq_solve_float_N(x, R, z): least squares solution of the equations added so far,
+ *   the parameters that are not observable are set to 0
+ */
+#define PPRZ_MATRIX_DECOMP_FIXED_DECLARE(_n) \
+  extern bool pprz_cholesky_float_##_n(float *L, const float *A); \
+  extern void pprz_cholesky_solve_float_##_n(float *x, const float *L, const float *b); \
+  extern bool pprz_cholesky_inv_float_##_n(float *inv, const float *A); \
+  extern void pprz_qr_float_##_n(float *Q, float *R, const float *A); \
+  extern void pprz_lsq_init_float_##_n(float *R, float *z); \
+  extern void pprz_lsq_add_row_float_##_n(float *R, float *z, const float *row, float target); \
+  extern void pprz_lsq_solve_float_##_n(float *x, const float *R, const float *z);
+
+PPRZ_MATRIX_DECOMP_FIXED_DECLARE(2)
+PPRZ_MATRIX_DECOMP_FIXED_DECLARE(3)
+PPRZ_MATRIX_DECOMP_FIXED_DECLARE(4)
+PPRZ_MATRIX_DECOMP_FIXED_DECLARE(5)
+PPRZ_MATRIX_DECOMP_FIXED_DECLARE(6)
+PPRZ_MATRIX_DECOMP_FIXED_DECLARE(7)
+PPRZ_MATRIX_DECOMP_FIXED_DECLARE(8)
+
+/**
+ * Streaming least squares for a size n only known at run time,
+ * dispatched to the fixed size functions.
+ * R is a [n x n] array and z a [n] array, with n <= PPRZ_MATRIX_DECOMP_FIXED_MAX.
+ * @return false if n is not supported
+ */
+extern bool pprz_lsq_init_float(float *R, float *z, int n);
+extern bool pprz_lsq_add_row_float(float *R, float *z, const float *row, float target, int n);
+extern bool pprz_lsq_solve_float(float *x, const float *R, const float *z, int n);
+
+/**
+ * Name of the function for a size given by a macro,
+ * e.g. PPRZ_MATRIX_DECOMP_FIXED(pprz_cholesky_inv_float, EKF_NUM_OUTPUTS)
+ */
+#define PPRZ_MATRIX_DECOMP_FIXED(_fun, _n) _PPRZ_MATRIX_DECOMP_FIXED(_fun, _n)
+#define _PPRZ_MATRIX_DECOMP_FIXED(_fun, _n) _fun##_##_n
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* PPRZ_MATRIX_DECOMP_FIXED_FLOAT_H */
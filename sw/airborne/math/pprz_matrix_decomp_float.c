@@ -26,6 +26,7 @@
 
 #include "math/pprz_simple_matrix.h"
 #include "math/pprz_matrix_decomp_float.h"
+#include "math/pprz_matrix_decomp_fixed_float.h"
 #include "math/pprz_algebra_float.h"
 #include <math.h>
 #include <string.h>
@@ -514,9 +515,56 @@ void pprz_svd_solve_float(float **x, float **u, float *w, float **v, float **b,
 }
 
 
+/**
+ * Mean absolute error of a linear model on the samples
+ */
+static float fit_linear_model_error(float *targets, int D, float (*samples)[D], uint16_t count, bool use_bias,
+                                    float *params)
+{
+  float error = 0.f;
+  for (int sam = 0; sam < count; sam++) {
+    float y = use_bias ? params[D] : 0.0f;
+    for (int d = 0; d < D; d++) {
+      y += params[d] * samples[sam][d];
+    }
+    error += fabsf(y - targets[sam]);
+  }
+  return count > 0 ? error / count : 0.f;
+}
+
+/**
+ * Fit a linear model with the fixed size streaming least squares,
+ * without storing the samples in a matrix.
+ *
+ * @return false if the size (D+1) is not supported
+ */
+static bool fit_linear_model_fixed(float *targets, int D, float (*samples)[D], uint16_t count, bool use_bias,
+                                   float *params)
+{
+  float R[PPRZ_MATRIX_DECOMP_FIXED_MAX * PPRZ_MATRIX_DECOMP_FIXED_MAX];
+  float z[PPRZ_MATRIX_DECOMP_FIXED_MAX];
+  float row[PPRZ_MATRIX_DECOMP_FIXED_MAX];
+  int sam, d;
+
+  if (!pprz_lsq_init_float(R, z, D + 1)) {
+    return false;
+  }
+  for (sam = 0; sam < count; sam++) {
+    for (d = 0; d < D; d++) {
+      row[d] = samples[sam][d];
+    }
+    row[D] = use_bias ? 1.0f : 0.0f;
+    pprz_lsq_add_row_float(R, z, row, targets[sam], D + 1);
+  }
+  pprz_lsq_solve_float(params, R, z, D + 1);
+  return true;
+}
+
 /**
  * Fit a linear model from samples to target values.
- * Effectively a wrapper for the pprz_svd_float and pprz_svd_solve_float functions.
+ * Up to D = 7, the samples are accumulated one by one with the fixed size
+ * streaming least squares (pprz_lsq_*_float_N), otherwise it is a wrapper
+ * for the pprz_svd_float and pprz_svd_solve_float functions.
  *
  * @param[in] targets The target values
  * @param[in] samples The samples / feature vectors
@@ -524,11 +572,16 @@ void pprz_svd_solve_float(float **x, float **u, float *w, float **v, float **b,
  * @param[in] count The number of samples
  * @param[in] use_bias Whether to use the bias. Please note that params should always be of size D+1, but in case of no bias, the bias value is set to 0.
  * @param[out] parameters* Parameters of the linear fit
- * @param[out] fit_error* Total error of the fit
+ * @param[out] fit_error* Mean absolute error of the fit on the samples
  */
 void fit_linear_model(float *targets, int D, float (*samples)[D], uint16_t count, bool use_bias, float *params,
                       float *fit_error)
 {
+  // up to 7 dimensions, solve with the fixed size kernels
+  if (fit_linear_model_fixed(targets, D, samples, count, use_bias, params)) {
+    *fit_error = fit_linear_model_error(targets, D, samples, count, use_bias, params);
+    return;
+  }
 
   // We will solve systems of the form A x = b,
   // where A = [nx(D+1)] matrix with entries [s1, ..., sD, 1] for each sample (1 is the bias)
@@ -575,29 +628,12 @@ void fit_linear_model(float *targets, int D, float (*samples)[D], uint16_t count
   pprz_svd_float(AA, w, v, count, D_1);
   pprz_svd_solve_float(parameters, AA, w, v, targets_all, count, D_1, 1);
 
-  // used to determine the error of a set of parameters on the whole set:
-  float _bb[count][1];
-  MAKE_MATRIX_PTR(bb, _bb, count);
-  float _C[count][1];
-  MAKE_MATRIX_PTR(C, _C, count);
-
-  // error is determined on the entire set
-  // bb = AA * parameters:
-  // TODO: error: AA has been replaced in the pprz_svd_float procedure by U!!!
-  MAT_MUL(count, D_1, 1, bb, AA, parameters);
-  // subtract bu_all: C = 0 in case of perfect fit:
-  MAT_SUB(count, 1, C, bb, targets_all);
-  *fit_error = 0;
-  for (sam = 0; sam < count; sam++) {
-    *fit_error += fabsf(C[sam][0]);
-  }
-  if (count > 0) {
-    *fit_error /= count;
-  }
-
   for (d = 0; d < D_1; d++) {
     params[d] = parameters[d][0];
   }
+
+  // error is determined on the entire set (AA has been replaced by U in pprz_svd_float)
+  *fit_error = fit_linear_model_error(targets, D, samples, count, use_bias, params);
 }
 
 
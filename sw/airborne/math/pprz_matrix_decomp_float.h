@@ -105,14 +105,16 @@ void pprz_svd_solve_float(float **x, float **u, float *w, float **v, float **b,
 
 /**
  * Fit a linear model from samples to target values.
- * Effectively a wrapper for the pprz_svd_float and pprz_svd_solve_float functions.
+ * Up to D = 7, the samples are accumulated one by one with the fixed size
+ * streaming least squares (pprz_lsq_*_float_N), otherwise it is a wrapper
+ * for the pprz_svd_float and pprz_svd_solve_float functions.
  *
  * @param[in] targets The target values
  * @param[in] samples The samples / feature vectors
  * @param[in] D The dimensionality of the samples
  * @param[in] count The number of samples
  * @param[out] parameters* Parameters of the linear fit
- * @param[out] fit_error* Total error of the fit
+ * @param[out] fit_error* Mean absolute error of the fit on the samples
  */
 void fit_linear_model(float *targets, int D, float (*samples)[D], uint16_t count, bool use_bias, float *params,
                       float *fit_error);
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file pprz_rls_float.c
+ * @brief Recursive least squares.
+ *
+ */
+
+#include "math/pprz_rls_float.h"
+#include <math.h>
+
+void rls_float_init(struct RlsFloat *rls, uint8_t n, float lambda, float p0)
+{
+  rls->n = n < RLS_FLOAT_MAX_N ? n : RLS_FLOAT_MAX_N;
+  rls->lambda = lambda;
+  rls->p_max = p0;
+  rls->nb_update = 0;
+  for (uint8_t i = 0; i < RLS_FLOAT_MAX_N; i++) {
+    rls->theta[i] = 0.f;
+    for (uint8_t j = 0; j < RLS_FLOAT_MAX_N; j++) {
+      rls->P[i][j] = 0.f;
+    }
+    rls->P[i][i] = p0;
+  }
+}
+
+float rls_float_predict(const struct RlsFloat *rls, const float *phi)
+{
+  float y = 0.f;
+  for (uint8_t i = 0; i < rls->n; i++) {
+    y += phi[i] * rls->theta[i];
+  }
+  return y;
+}
+
+float rls_float_update(struct RlsFloat *rls, const float *phi, float y)
+{
+  const uint8_t n = rls->n;
+  float Pphi[RLS_FLOAT_MAX_N];
+
+  // P.phi and phi'.P.phi (P is symmetric)
+  float s = 0.f;
+  for (uint8_t i = 0; i < n; i++) {
+    Pphi[i] = 0.f;
+    for (uint8_t j = 0; j < n; j++) {
+      Pphi[i] += rls->P[i][j] * phi[j];
+    }
+    s += phi[i] * Pphi[i];
+  }
+
+  // only forget while the covariance is bounded
+  float lambda = rls->lambda;
+  for (uint8_t i = 0; i < n; i++) {
+    if (rls->P[i][i] > rls->p_max) {
+      lambda = 1.f;
+      break;
+    }
+  }
+
+  const float err = y - rls_float_predict(rls, phi);
+  const float inv = 1.f / (lambda + s);
+
+  // theta += K.err with K = P.phi / (lambda + phi'.P.phi)
+  for (uint8_t i = 0; i < n; i++) {
+    rls->theta[i] += Pphi[i] * inv * err;
+  }
+  // P = (P - K.phi'.P) / lambda, upper triangle mirrored to stay symmetric
+  const float inv_lambda = 1.f / lambda;
+  for (uint8_t i = 0; i < n; i++) {
+    for (uint8_t j = i; j < n; j++) {
+      rls->P[i][j] = (rls->P[i][j] - Pphi[i] * Pphi[j] * inv) * inv_lambda;
+      rls->P[j][i] = rls->P[i][j];
+    }
+  }
+  rls->nb_update++;
+  return err;
+}
+
+float rls_float_ellipsoid_update(struct RlsFloat *rls, const struct FloatVect3 *v)
+{
+  const float phi[6] = { v->x * v->x, v->y * v->y, v->z * v->z, v->x, v->y, v->z };
+  return rls_float_update(rls, phi, 1.f);
+}
+
+bool rls_float_ellipsoid_get(const struct RlsFloat *rls, struct FloatVect3 *center, struct FloatVect3 *radii)
+{
+  const float *t = rls->theta;
+  if (rls->n < 6 || t[0] <= 0.f || t[1] <= 0.f || t[2] <= 0.f) {
+    return false;
+  }
+  // a (x - cx)^2 + b (y - cy)^2 + c (z - cz)^2 = g
+  center->x = -t[3] / (2.f * t[0]);
+  center->y = -t[4] / (2.f * t[1]);
+  center->z = -t[5] / (2.f * t[2]);
+  const float g = 1.f + t[0] * center->x * center->x + t[1] * center->y * center->y + t[2] * center->z * center->z;
+  radii->x = sqrtf(g / t[0]);
+  radii->y = sqrtf(g / t[1]);
+  radii->z = sqrtf(g / t[2]);
+  return true;
+}
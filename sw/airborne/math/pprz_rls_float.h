@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file math/pprz_rls_float.h
+ * @brief Recursive least squares.
+ *
+ */
+
+#ifndef PPRZ_RLS_FLOAT_H
+#define PPRZ_RLS_FLOAT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "std.h"
+#include "math/pprz_algebra_float.h"
+
+/** Maximum number of estimated parameters */
+#ifndef RLS_FLOAT_MAX_N
+#define RLS_FLOAT_MAX_N 6
+#endif
+
+/** Recursive least squares estimator
+ *
+ * Estimates the parameters @f$ \theta @f$ of the linear model
+ *  @f[
+ *  y_k = \phi_k^T \theta + \epsilon_k
+ *  @f]
+ * one measurement at a time, with an exponential forgetting factor
+ * @f$ \lambda @f$ so that slowly varying parameters can be tracked.
+ */
+struct RlsFloat {
+  uint8_t n;                                      ///< number of parameters
+  float lambda;                                   ///< forgetting factor, 1 for no forgetting
+  float p_max;                                    ///< no forgetting when a covariance diagonal element exceeds it
+  float theta[RLS_FLOAT_MAX_N];                   ///< estimated parameters
+  float P[RLS_FLOAT_MAX_N][RLS_FLOAT_MAX_N];      ///< parameters covariance
+  uint32_t nb_update;                             ///< number of updates since init
+};
+
+/** Initialize the estimator
+ * @param[out] rls the estimator
+ * @param[in] n number of parameters (at most RLS_FLOAT_MAX_N)
+ * @param[in] lambda forgetting factor in ]0,1]
+ * @param[in] p0 initial covariance diagonal, also the covariance bound with forgetting
+ */
+extern void rls_float_init(struct RlsFloat *rls, uint8_t n, float lambda, float p0);
+
+/** Update the estimate with a new measurement
+ *
+ *  @f[
+ *  K = \frac{P \phi}{\lambda + \phi^T P \phi} \quad
+ *  \theta = \theta + K (y - \phi^T \theta) \quad
+ *  P = \frac{P - K \phi^T P}{\lambda}
+ *  @f]
+ *
+ * Without excitation the forgetting makes P grow, so it is only applied
+ * while the covariance diagonal stays below p_max.
+ *
+ * @param[in,out] rls the estimator
+ * @param[in] phi regressor [n]
+ * @param[in] y measurement
+ * @return a priori error @f$ y - \phi^T \theta @f$
+ */
+extern float rls_float_update(struct RlsFloat *rls, const float *phi, float y);
+
+/** Model output for a regressor
+ * @param[in] rls the estimator
+ * @param[in] phi regressor [n]
+ * @return @f$ \phi^T \theta @f$
+ */
+extern float rls_float_predict(const struct RlsFloat *rls, const float *phi);
+
+/** Update an axis aligned ellipsoid fit with a new sample
+ *
+ * The samples lie on the ellipsoid
+ *  @f[
+ *  a x^2 + b y^2 + c z^2 + d x + e y + f z = 1
+ *  @f]
+ * which is linear in the parameters, so rls must be initialized with n = 6.
+ * Samples should be normalized around unit length to keep the problem
+ * well conditioned in single precision.
+ *
+ * @param[in,out] rls the estimator
+ * @param[in] v sample
+ * @return a priori error
+ */
+extern float rls_float_ellipsoid_update(struct RlsFloat *rls, const struct FloatVect3 *v);
+
+/** Center and radii of the fitted ellipsoid
+ *
+ * A sample v is mapped on the unit sphere by (v - center) / radii.
+ *
+ * @param[in] rls the estimator
+ * @param[out] center ellipsoid center
+ * @param[out] radii ellipsoid radii along each axis
+ * @return false if the parameters do not describe an ellipsoid (yet)
+ */
+extern bool rls_float_ellipsoid_get(const struct RlsFloat *rls, struct FloatVect3 *center, struct FloatVect3 *radii);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* PPRZ_RLS_FLOAT_H */
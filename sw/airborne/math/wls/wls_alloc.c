@@ -44,6 +44,11 @@
 #include "math/qr_solve/qr_solve.h"
 #include "math/qr_solve/r8lib_min.h"
 
+// use the incremental QR solver of wls_alloc_qr.c for wls_alloc
+#ifndef WLS_QR_UPDATE
+#define WLS_QR_UPDATE FALSE
+#endif
+
 // provide loop feedback
 #ifndef WLS_VERBOSE
 #define WLS_VERBOSE FALSE
@@ -58,6 +63,7 @@ static void print_in_and_outputs(int n_c, int n_free, float** A_free_ptr, float*
 
 #define WLS_N_C ((WLS_N_U)+(WLS_N_V))
 
+#if !WLS_QR_UPDATE
 /**
  * @brief Wrapper for qr solve
  *
@@ -79,6 +85,7 @@ static void qr_solve_wrapper(int m, int n, float** A, float* b, float* x) {
   // use solver
   qr_solve(m, n, in, b, x);
 }
+#endif
 
 /**
  * @brief active set algorithm for control allocation
@@ -108,6 +115,9 @@ static void qr_solve_wrapper(int m, int n, float** A, float* b, float* x) {
 int wls_alloc(float* u, float* v, float* umin, float* umax, float** B,
     float* u_guess, float* W_init, float* Wv, float* Wu, float* up,
     float gamma_sq, int imax,  int n_u, int n_v) {
+#if WLS_QR_UPDATE
+  return wls_alloc_qr(u, v, umin, umax, B, u_guess, W_init, Wv, Wu, up, gamma_sq, imax, n_u, n_v);
+#else
   // allocate variables, use defaults where parameters are set to 0
   if(!gamma_sq) gamma_sq = 100000;
   if(!imax) imax = 100;
@@ -307,6 +317,7 @@ int wls_alloc(float* u, float* v, float* umin, float* umax, float** B,
     }
   }
   return iter;
+#endif
 }
 
 #if WLS_VERBOSE
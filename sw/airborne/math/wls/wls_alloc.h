@@ -68,5 +68,15 @@ extern int wls_alloc(float* u, float* v,
               float* u_guess, float* W_init, float* Wv, float* Wu,
               float* ud, float gamma, int imax, int n_u, int n_v);
 
+/**
+ * Same as wls_alloc, but the QR factorization of the free columns is updated
+ * with Givens rotations when the active set changes instead of being
+ * recomputed at each iteration.
+ */
+extern int wls_alloc_qr(float* u, float* v,
+              float* umin, float* umax, float** B,
+              float* u_guess, float* W_init, float* Wv, float* Wu,
+              float* ud, float gamma, int imax, int n_u, int n_v);
+
 
 #endif
\ No newline at end of file
@@ -236,11 +236,11 @@ void ahrs_fc_update_accel(struct FloatVect3 *accel, float dt)
      * <0.66G = 0, 1G = 1.0, >1.33G = 0
      */
 
-    const float g_meas_norm = float_vect3_norm(&filtered_gravity_measurement) / 9.81;
-    ahrs_fc.weight = 1.0 - ahrs_fc.gravity_heuristic_factor * fabs(1.0 - g_meas_norm) / 10.0;
-    Bound(ahrs_fc.weight, 0.15, 1.0);
+    const float g_meas_norm = float_vect3_norm(&filtered_gravity_measurement) / 9.81f;
+    ahrs_fc.weight = 1.f - ahrs_fc.gravity_heuristic_factor * fabsf(1.f - g_meas_norm) / 10.f;
+    Bound(ahrs_fc.weight, 0.15f, 1.f);
   } else {
-    ahrs_fc.weight = 1.0;
+    ahrs_fc.weight = 1.f;
   }
 
   /* Complementary filter proportional gain.
@@ -248,7 +248,7 @@ void ahrs_fc_update_accel(struct FloatVect3 *accel, float dt)
    * with ahrs_fc.accel_cnt beeing the number of propagations since last update
    */
   const float gravity_rate_update_gain = -2 * ahrs_fc.accel_zeta * ahrs_fc.accel_omega *
-                                         ahrs_fc.weight * ahrs_fc.accel_cnt / 9.81;
+                                         ahrs_fc.weight * ahrs_fc.accel_cnt / 9.81f;
   RATES_ADD_SCALED_VECT(ahrs_fc.rate_correction, residual, gravity_rate_update_gain);
 
   // reset accel propagation counter
@@ -259,7 +259,7 @@ void ahrs_fc_update_accel(struct FloatVect3 *accel, float dt)
    * Ki = (omega*weight)^2 * dt
    */
   const float gravity_bias_update_gain = ahrs_fc.accel_omega * ahrs_fc.accel_omega *
-                                         ahrs_fc.weight * ahrs_fc.weight * dt / 9.81;
+                                         ahrs_fc.weight * ahrs_fc.weight * dt / 9.81f;
   RATES_ADD_SCALED_VECT(ahrs_fc.gyro_bias, residual, gravity_bias_update_gain);
 
   /* FIXME: saturate bias */
@@ -370,7 +370,7 @@ void ahrs_fc_update_mag_2d_dumb(struct FloatVect3 *mag)
   const float ctheta = cosf(ltp_to_body_euler.theta);
   const float stheta = sinf(ltp_to_body_euler.theta);
   const float mn = ctheta * mag->x + sphi * stheta * mag->y + cphi * stheta * mag->z;
-  const float me =     0. * mag->x + cphi          * mag->y - sphi          * mag->z;
+  const float me =    0.f * mag->x + cphi          * mag->y - sphi          * mag->z;
 
   const float res_norm = -RMAT_ELMT(ahrs_fc.ltp_to_body_rmat, 0, 0) * me +
                          RMAT_ELMT(ahrs_fc.ltp_to_body_rmat, 1, 0) * mn;
@@ -378,9 +378,9 @@ void ahrs_fc_update_mag_2d_dumb(struct FloatVect3 *mag)
           RMAT_ELMT(ahrs_fc.ltp_to_body_rmat, 2, 1),
           RMAT_ELMT(ahrs_fc.ltp_to_body_rmat, 2, 2)
   };
-  const float mag_rate_update_gain = 2.5;
+  const float mag_rate_update_gain = 2.5f;
   RATES_ADD_SCALED_VECT(ahrs_fc.rate_correction, r2, (mag_rate_update_gain * res_norm));
-  const float mag_bias_update_gain = -mag_rate_update_gain * 1e-4;
+  const float mag_bias_update_gain = -mag_rate_update_gain * 1e-4f;
   RATES_ADD_SCALED_VECT(ahrs_fc.gyro_bias, r2, (mag_bias_update_gain * res_norm));
 
 }
@@ -448,10 +448,10 @@ void ahrs_fc_update_heading(float heading)
    * the gps course information you get once you have a gps fix.
    * Otherwise the bias will be falsely "corrected".
    */
-  if (fabs(residual_ltp.z) < sinf(RadOfDeg(5.))) {
-    heading_bias_update_gain = -heading_rate_update_gain * 1e-4;
+  if (fabsf(residual_ltp.z) < sinf(RadOfDeg(5.f))) {
+    heading_bias_update_gain = -heading_rate_update_gain * 1e-4f;
   } else {
-    heading_bias_update_gain = 0.0;
+    heading_bias_update_gain = 0.f;
   }
   RATES_ADD_SCALED_VECT(ahrs_fc.gyro_bias, residual_imu, heading_bias_update_gain);
 }
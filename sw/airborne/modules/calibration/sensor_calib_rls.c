@@ -0,0 +1,741 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file "modules/calibration/sensor_calib_rls.c"
+ * Online calibration of the IMU sensors with recursive least squares.
+ *
+ * The ABI callbacks and the periodic function run in the main thread, so
+ * the sample queue has a single producer and a single consumer (the solver).
+ * The reference calibration used to normalize the samples is passed to the
+ * solver and its results are passed back with sequence locks. The main
+ * thread never waits for the solver: an output being written is simply
+ * read at the next period.
+ */
+
+#include "modules/calibration/sensor_calib_rls.h"
+#include "modules/imu/imu.h"
+#include "modules/core/abi.h"
+#include "autopilot.h"
+#include "math/pprz_rls_float.h"
+#include "utils/spsc_queue.h"
+#include "utils/seqlock.h"
+#include "generated/airframe.h"
+#include <math.h>
+#include <string.h>
+
+#if USE_CHIBIOS_RTOS
+#include <ch.h>
+#define SENSOR_CALIB_RLS_THREAD 1
+#elif defined(__linux__) && !defined(SITL)
+#include <pthread.h>
+#include <unistd.h>
+#include <stdio.h>
+#include "rt_priority.h"
+#define SENSOR_CALIB_RLS_THREAD 1
+#else
+#define SENSOR_CALIB_RLS_THREAD 0
+#endif
+
+/** ABI senders of the calibrated sensors, the first one received by default */
+#ifndef SENSOR_CALIB_RLS_GYRO_ID
+#define SENSOR_CALIB_RLS_GYRO_ID ABI_BROADCAST
+#endif
+#ifndef SENSOR_CALIB_RLS_ACCEL_ID
+#define SENSOR_CALIB_RLS_ACCEL_ID ABI_BROADCAST
+#endif
+#ifndef SENSOR_CALIB_RLS_MAG_ID
+#define SENSOR_CALIB_RLS_MAG_ID ABI_BROADCAST
+#endif
+
+/** Number of queued samples, must be a power of two */
+#ifndef SENSOR_CALIB_RLS_QUEUE_SIZE
+#define SENSOR_CALIB_RLS_QUEUE_SIZE 64
+#endif
+
+/** Gyro and accel samples are averaged over this period (s) before being queued */
+#ifndef SENSOR_CALIB_RLS_SAMPLE_PERIOD
+#define SENSOR_CALIB_RLS_SAMPLE_PERIOD 0.01f
+#endif
+
+/** Sleep time of the solver thread between two batches (ms) */
+#ifndef SENSOR_CALIB_RLS_THREAD_PERIOD
+#define SENSOR_CALIB_RLS_THREAD_PERIOD 20
+#endif
+
+/** Linux nice level of the solver thread */
+#ifndef SENSOR_CALIB_RLS_NICE
+#define SENSOR_CALIB_RLS_NICE 10
+#endif
+
+/** Maximum number of samples processed by each periodic call without a solver thread */
+#ifndef SENSOR_CALIB_RLS_BATCH
+#define SENSOR_CALIB_RLS_BATCH 8
+#endif
+
+/** Forgetting factors of the estimations */
+#ifndef SENSOR_CALIB_RLS_MAG_LAMBDA
+#define SENSOR_CALIB_RLS_MAG_LAMBDA 0.999f
+#endif
+#ifndef SENSOR_CALIB_RLS_ACCEL_LAMBDA
+#define SENSOR_CALIB_RLS_ACCEL_LAMBDA 1.f
+#endif
+#ifndef SENSOR_CALIB_RLS_GYRO_LAMBDA
+#define SENSOR_CALIB_RLS_GYRO_LAMBDA 0.999f
+#endif
+
+/** Minimum distance between two samples of the ellipsoid fits (normalized units) */
+#ifndef SENSOR_CALIB_RLS_MIN_DIFF
+#define SENSOR_CALIB_RLS_MIN_DIFF 0.05f
+#endif
+
+/** Minimum span of the samples on each axis for a valid ellipsoid fit (normalized units) */
+#ifndef SENSOR_CALIB_RLS_MIN_SPAN
+#define SENSOR_CALIB_RLS_MIN_SPAN 1.f
+#endif
+
+/** Maximum RMS residual of a valid ellipsoid fit (relative squared norm) */
+#ifndef SENSOR_CALIB_RLS_MAX_RESIDUAL
+#define SENSOR_CALIB_RLS_MAX_RESIDUAL 0.05f
+#endif
+
+/** Number of gyro samples of the rest detection window */
+#ifndef SENSOR_CALIB_RLS_REST_NB
+#define SENSOR_CALIB_RLS_REST_NB 50
+#endif
+
+/** Maximum standard deviations at rest */
+#ifndef SENSOR_CALIB_RLS_REST_GYRO_STD
+#define SENSOR_CALIB_RLS_REST_GYRO_STD 0.02f
+#endif
+#ifndef SENSOR_CALIB_RLS_REST_ACCEL_STD
+#define SENSOR_CALIB_RLS_REST_ACCEL_STD 0.2f
+#endif
+
+/** Maximum difference between the mean accel norm and gravity at rest (m/s2) */
+#ifndef SENSOR_CALIB_RLS_REST_ACCEL_NORM
+#define SENSOR_CALIB_RLS_REST_ACCEL_NORM 0.5f
+#endif
+
+/** Minimum number of updates of a valid estimation */
+#ifndef SENSOR_CALIB_RLS_MAG_MIN_NB
+#define SENSOR_CALIB_RLS_MAG_MIN_NB 300
+#endif
+#ifndef SENSOR_CALIB_RLS_ACCEL_MIN_NB
+#define SENSOR_CALIB_RLS_ACCEL_MIN_NB 12
+#endif
+#ifndef SENSOR_CALIB_RLS_GYRO_MIN_NB
+#define SENSOR_CALIB_RLS_GYRO_MIN_NB 10
+#endif
+
+/** Fractional bits of the denominator of the scales written to the IMU */
+#ifndef SENSOR_CALIB_RLS_SCALE_FRAC
+#define SENSOR_CALIB_RLS_SCALE_FRAC 12
+#endif
+
+struct SensorCalibRls sensor_calib_rls;
+
+enum sensor_calib_rls_type {
+  SENSOR_CALIB_RLS_GYRO,
+  SENSOR_CALIB_RLS_ACCEL,
+  SENSOR_CALIB_RLS_MAG
+};
+
+/** Queued raw sample */
+struct sensor_calib_rls_sample {
+  uint8_t type;           ///< sensor type
+  float temp;             ///< sensor temperature, NAN if unknown
+  struct FloatVect3 v;    ///< raw measurement
+};
+
+/** Reference calibration of one sensor: physical = (raw - neutral) * scale */
+struct sensor_calib_rls_sensor_ref {
+  bool ok;
+  struct FloatVect3 neutral;
+  struct FloatVect3 scale;
+};
+
+/** Reference calibrations, written by the main thread */
+struct sensor_calib_rls_ref {
+  uint32_t gen;           ///< incremented at each reset
+  bool flying;            ///< in flight or motors on, no rest window
+  struct sensor_calib_rls_sensor_ref gyro, accel, mag;
+};
+
+/** Solver results in the units of the airframe IMU section, written by the solver */
+struct sensor_calib_rls_output {
+  uint32_t gen;           ///< reference generation of the results
+  bool mag_valid, accel_valid, gyro_valid;
+  struct FloatVect3 mag_neutral, mag_sens;
+  struct FloatVect3 accel_neutral, accel_sens;
+  struct FloatRates gyro_neutral, gyro_temp_coef;
+  float gyro_temp_ref;
+  uint32_t nb_mag, nb_accel, nb_gyro;
+};
+
+/** Ellipsoid fit with its coverage and residual */
+struct sensor_calib_rls_ellipsoid {
+  struct RlsFloat rls;
+  struct FloatVect3 last;   ///< last sample used
+  struct FloatVect3 min, max;
+  float residual;           ///< low pass filtered squared a posteriori error
+};
+
+/** Rest detection window */
+struct sensor_calib_rls_window {
+  struct FloatVect3 gyro_sum, gyro_sum2, gyro_raw;
+  struct FloatVect3 accel_sum, accel_sum2;    ///< in m/s2
+  float temp;
+  uint16_t nb_gyro, nb_accel, nb_temp;
+};
+
+/** Solver state, only accessed by the solver */
+static struct {
+  uint32_t gen;
+  struct sensor_calib_rls_ref ref;
+  struct sensor_calib_rls_ellipsoid mag, accel;
+  struct RlsFloat gyro[3];
+  bool gyro_temp_init;
+  float gyro_temp_ref;
+  struct sensor_calib_rls_window win;
+} solver;
+
+static struct sensor_calib_rls_sample sample_buf[SENSOR_CALIB_RLS_QUEUE_SIZE];
+static struct spsc_queue queue;
+
+static struct sensor_calib_rls_ref ref;
+static struct seqlock ref_lock;
+static struct sensor_calib_rls_output output;
+static struct seqlock output_lock;
+static uint32_t output_seq;     ///< last output sequence read by the main thread
+
+/** Sample accumulation in the ABI callbacks */
+struct sensor_calib_rls_acc {
+  uint8_t id;             ///< ABI sender
+  uint32_t stamp;         ///< stamp of the last queued sample
+  struct FloatVect3 sum;
+  uint16_t nb;
+};
+
+static struct sensor_calib_rls_acc gyro_acc, accel_acc;
+static uint8_t mag_id;
+
+static abi_event gyro_ev, accel_ev, mag_ev;
+
+/** Reset the estimations, the first temperature becomes the reference of the gyro fit */
+static void sensor_calib_rls_solver_reset(void)
+{
+  rls_float_init(&solver.mag.rls, 6, SENSOR_CALIB_RLS_MAG_LAMBDA, 100.f);
+  rls_float_init(&solver.accel.rls, 6, SENSOR_CALIB_RLS_ACCEL_LAMBDA, 100.f);
+  struct sensor_calib_rls_ellipsoid *e[2] = { &solver.mag, &solver.accel };
+  for (uint8_t i = 0; i < 2; i++) {
+    FLOAT_VECT3_ZERO(e[i]->last);
+    VECT3_ASSIGN(e[i]->min, 1e6f, 1e6f, 1e6f);
+    VECT3_ASSIGN(e[i]->max, -1e6f, -1e6f, -1e6f);
+    e[i]->residual = 0.f;
+  }
+  for (uint8_t i = 0; i < 3; i++) {
+    rls_float_init(&solver.gyro[i], 2, SENSOR_CALIB_RLS_GYRO_LAMBDA, 1e4f);
+  }
+  solver.gyro_temp_init = false;
+  solver.gyro_temp_ref = 0.f;
+  memset(&solver.win, 0, sizeof(solver.win));
+}
+
+/** Normalized sample of a sensor */
+static void sensor_calib_rls_normalize(struct FloatVect3 *v, const struct FloatVect3 *raw,
+                                       const struct sensor_calib_rls_sensor_ref *r, float norm)
+{
+  v->x = (raw->x - r->neutral.x) * r->scale.x / norm;
+  v->y = (raw->y - r->neutral.y) * r->scale.y / norm;
+  v->z = (raw->z - r->neutral.z) * r->scale.z / norm;
+}
+
+/** Update an ellipsoid fit if the sample is far enough from the previous one */
+static void sensor_calib_rls_ellipsoid_update(struct sensor_calib_rls_ellipsoid *e, const struct FloatVect3 *v)
+{
+  struct FloatVect3 diff;
+  VECT3_DIFF(diff, *v, e->last);
+  if (float_vect3_norm(&diff) < SENSOR_CALIB_RLS_MIN_DIFF) {
+    return;
+  }
+  e->last = *v;
+  e->min.x = Min(e->min.x, v->x);
+  e->min.y = Min(e->min.y, v->y);
+  e->min.z = Min(e->min.z, v->z);
+  e->max.x = Max(e->max.x, v->x);
+  e->max.y = Max(e->max.y, v->y);
+  e->max.z = Max(e->max.z, v->z);
+  rls_float_ellipsoid_update(&e->rls, v);
+  const float phi[6] = { v->x * v->x, v->y * v->y, v->z * v->z, v->x, v->y, v->z };
+  const float err = 1.f - rls_float_predict(&e->rls, phi);
+  e->residual += 0.1f * (err * err - e->residual);
+}
+
+/** Convert an ellipsoid fit to a neutral and sensitivity in the airframe units
+ * @param norm normalization of the samples (physical units)
+ * @param frac fractional bits of the scaled sensor values
+ * @return true if the fit is valid
+ */
+static bool sensor_calib_rls_ellipsoid_result(const struct sensor_calib_rls_ellipsoid *e,
+    const struct sensor_calib_rls_sensor_ref *r, float norm, uint8_t frac, uint32_t min_nb,
+    struct FloatVect3 *neutral, struct FloatVect3 *sens)
+{
+  struct FloatVect3 c, radii;
+  if (!rls_float_ellipsoid_get(&e->rls, &c, &radii)) {
+    return false;
+  }
+  // raw = neutral + v * norm / scale and physical = v * norm / radii
+  neutral->x = r->neutral.x + c.x * norm / r->scale.x;
+  neutral->y = r->neutral.y + c.y * norm / r->scale.y;
+  neutral->z = r->neutral.z + c.z * norm / r->scale.z;
+  const float one = (float)(1 << frac);
+  sens->x = fabsf(r->scale.x) / radii.x * one;
+  sens->y = fabsf(r->scale.y) / radii.y * one;
+  sens->z = fabsf(r->scale.z) / radii.z * one;
+
+  return e->rls.nb_update >= min_nb &&
+         e->max.x - e->min.x > SENSOR_CALIB_RLS_MIN_SPAN &&
+         e->max.y - e->min.y > SENSOR_CALIB_RLS_MIN_SPAN &&
+         e->max.z - e->min.z > SENSOR_CALIB_RLS_MIN_SPAN &&
+         sqrtf(e->residual) < SENSOR_CALIB_RLS_MAX_RESIDUAL &&
+         radii.x > 0.5f && radii.x < 2.f &&
+         radii.y > 0.5f && radii.y < 2.f &&
+         radii.z > 0.5f && radii.z < 2.f;
+}
+
+/** Maximum variance over the axes of a window */
+static float sensor_calib_rls_var(const struct FloatVect3 *sum, const struct FloatVect3 *sum2, uint16_t nb)
+{
+  const float n = (float)nb;
+  float vx = sum2->x / n - (sum->x / n) * (sum->x / n);
+  float vy = sum2->y / n - (sum->y / n) * (sum->y / n);
+  float vz = sum2->z / n - (sum->z / n) * (sum->z / n);
+  float vmax = Max(vx, vy);
+  return Max(vmax, vz);
+}
+
+/** Update the gyro and accel estimations with a full rest window
+ * The vehicle is at rest on the ground when it is not flying, with a low
+ * variance of the gyro and accel samples and a mean accel close to gravity
+ * (a steady turn or climb has low variances too).
+ */
+static void sensor_calib_rls_window_end(void)
+{
+  struct sensor_calib_rls_window *w = &solver.win;
+  const bool has_accel = w->nb_accel > SENSOR_CALIB_RLS_REST_NB / 2;
+  bool rest = !solver.ref.flying && has_accel &&
+              sensor_calib_rls_var(&w->gyro_sum, &w->gyro_sum2, w->nb_gyro) <
+              SENSOR_CALIB_RLS_REST_GYRO_STD * SENSOR_CALIB_RLS_REST_GYRO_STD;
+  if (rest) {
+    struct FloatVect3 mean;
+    VECT3_SDIV(mean, w->accel_sum, (float)w->nb_accel);
+    rest = sensor_calib_rls_var(&w->accel_sum, &w->accel_sum2, w->nb_accel) <
+           SENSOR_CALIB_RLS_REST_ACCEL_STD * SENSOR_CALIB_RLS_REST_ACCEL_STD &&
+           fabsf(float_vect3_norm(&mean) - 9.81f) < SENSOR_CALIB_RLS_REST_ACCEL_NORM;
+  }
+
+  if (rest) {
+    // gyro neutral is linear with the temperature
+    float dt = 0.f;
+    if (w->nb_temp > 0) {
+      float temp = w->temp / (float)w->nb_temp;
+      if (!solver.gyro_temp_init) {
+        solver.gyro_temp_ref = temp;
+        solver.gyro_temp_init = true;
+      }
+      dt = temp - solver.gyro_temp_ref;
+    }
+    const float phi[2] = { 1.f, dt };
+    rls_float_update(&solver.gyro[0], phi, w->gyro_raw.x / (float)w->nb_gyro);
+    rls_float_update(&solver.gyro[1], phi, w->gyro_raw.y / (float)w->nb_gyro);
+    rls_float_update(&solver.gyro[2], phi, w->gyro_raw.z / (float)w->nb_gyro);
+
+    // mean gravity vector
+    if (solver.ref.accel.ok) {
+      struct FloatVect3 v;
+      VECT3_SDIV(v, w->accel_sum, 9.81f * (float)w->nb_accel);
+      sensor_calib_rls_ellipsoid_update(&solver.accel, &v);
+    }
+  }
+  memset(w, 0, sizeof(*w));
+}
+
+/** Process one queued sample */
+static void sensor_calib_rls_process(const struct sensor_calib_rls_sample *s)
+{
+  struct sensor_calib_rls_window *w = &solver.win;
+  struct FloatVect3 v;
+
+  switch (s->type) {
+    case SENSOR_CALIB_RLS_MAG:
+      if (solver.ref.mag.ok) {
+        sensor_calib_rls_normalize(&v, &s->v, &solver.ref.mag, 1.f);
+        sensor_calib_rls_ellipsoid_update(&solver.mag, &v);
+      }
+      break;
+    case SENSOR_CALIB_RLS_ACCEL:
+      if (solver.ref.accel.ok) {
+        sensor_calib_rls_normalize(&v, &s->v, &solver.ref.accel, 1.f);
+        VECT3_ADD(w->accel_sum, v);
+        VECT3_ADD(w->accel_sum2, ((struct FloatVect3){ v.x * v.x, v.y * v.y, v.z * v.z }));
+        w->nb_accel++;
+      }
+      break;
+    case SENSOR_CALIB_RLS_GYRO:
+      if (solver.ref.gyro.ok) {
+        sensor_calib_rls_normalize(&v, &s->v, &solver.ref.gyro, 1.f);
+        VECT3_ADD(w->gyro_sum, v);
+        VECT3_ADD(w->gyro_sum2, ((struct FloatVect3){ v.x * v.x, v.y * v.y, v.z * v.z }));
+        VECT3_ADD(w->gyro_raw, s->v);
+        if (isfinite(s->temp)) {
+          w->temp += s->temp;
+          w->nb_temp++;
+        }
+        w->nb_gyro++;
+        if (w->nb_gyro >= SENSOR_CALIB_RLS_REST_NB) {
+          sensor_calib_rls_window_end();
+        }
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+/** Publish the current results */
+static void sensor_calib_rls_publish(void)
+{
+  struct sensor_calib_rls_output out;
+  out.gen = solver.gen;
+  out.mag_valid = solver.ref.mag.ok &&
+                  sensor_calib_rls_ellipsoid_result(&solver.mag, &solver.ref.mag, 1.f, INT32_MAG_FRAC,
+                      SENSOR_CALIB_RLS_MAG_MIN_NB, &out.mag_neutral, &out.mag_sens);
+  out.accel_valid = solver.ref.accel.ok &&
+                    sensor_calib_rls_ellipsoid_result(&solver.accel, &solver.ref.accel, 9.81f, INT32_ACCEL_FRAC,
+                        SENSOR_CALIB_RLS_ACCEL_MIN_NB, &out.accel_neutral, &out.accel_sens);
+  out.gyro_valid = solver.ref.gyro.ok && solver.gyro[0].nb_update >= SENSOR_CALIB_RLS_GYRO_MIN_NB;
+  RATES_ASSIGN(out.gyro_neutral, solver.gyro[0].theta[0], solver.gyro[1].theta[0], solver.gyro[2].theta[0]);
+  RATES_ASSIGN(out.gyro_temp_coef, solver.gyro[0].theta[1], solver.gyro[1].theta[1], solver.gyro[2].theta[1]);
+  out.gyro_temp_ref = solver.gyro_temp_ref;
+  out.nb_mag = solver.mag.rls.nb_update;
+  out.nb_accel = solver.accel.rls.nb_update;
+  out.nb_gyro = solver.gyro[0].nb_update;
+
+  seqlock_write_begin(&output_lock);
+  output = out;
+  seqlock_write_end(&output_lock);
+}
+
+/** Run the solver on at most nb queued samples
+ * @return number of processed samples
+ */
+static uint32_t sensor_calib_rls_solve(uint32_t nb)
+{
+  // the reference is written by the main thread, which is never preempted by the solver
+  uint32_t seq;
+  do {
+    seq = seqlock_read_begin(&ref_lock);
+    solver.ref = ref;
+  } while (seqlock_read_retry(&ref_lock, seq));
+
+  if (solver.ref.gen != solver.gen) {
+    solver.gen = solver.ref.gen;
+    sensor_calib_rls_solver_reset();
+  }
+
+  uint32_t i = 0;
+  struct sensor_calib_rls_sample *s;
+  while (i < nb && (s = (struct sensor_calib_rls_sample *)spsc_queue_front(&queue)) != NULL) {
+    sensor_calib_rls_process(s);
+    spsc_queue_release(&queue);
+    i++;
+  }
+  if (i > 0) {
+    sensor_calib_rls_publish();
+  }
+  return i;
+}
+
+#if USE_CHIBIOS_RTOS
+static THD_WORKING_AREA(wa_thd_sensor_calib_rls, 1024);
+
+/** Solver thread, only runs when the higher priority threads are idle */
+static __attribute__((noreturn)) void thd_sensor_calib_rls(void *arg)
+{
+  (void) arg;
+  chRegSetThreadName("sensor calib");
+
+  while (true) {
+    sensor_calib_rls_solve(SENSOR_CALIB_RLS_QUEUE_SIZE);
+    chThdSleepMilliseconds(SENSOR_CALIB_RLS_THREAD_PERIOD);
+  }
+}
+#elif SENSOR_CALIB_RLS_THREAD
+/** Solver thread, with a low priority nice level */
+static void *thd_sensor_calib_rls(void *arg __attribute__((unused)))
+{
+  rt_thread_setup("sensor_calib", RT_THREAD_NICE, SENSOR_CALIB_RLS_NICE);
+
+  while (true) {
+    sensor_calib_rls_solve(SENSOR_CALIB_RLS_QUEUE_SIZE);
+    usleep(SENSOR_CALIB_RLS_THREAD_PERIOD * 1000);
+  }
+  return NULL;
+}
+#endif
+
+/** Queue the gyro and accel samples averaged over SENSOR_CALIB_RLS_SAMPLE_PERIOD */
+static void sensor_calib_rls_accumulate(uint8_t type, uint32_t stamp, const struct Int32Vect3 *data,
+                                        uint8_t nb, float temp)
+{
+  struct sensor_calib_rls_acc *acc = type == SENSOR_CALIB_RLS_GYRO ? &gyro_acc : &accel_acc;
+  for (uint8_t i = 0; i < nb; i++) {
+    acc->sum.x += (float)data[i].x;
+    acc->sum.y += (float)data[i].y;
+    acc->sum.z += (float)data[i].z;
+  }
+  acc->nb += nb;
+
+  if (acc->nb > 0 && (float)(stamp - acc->stamp) >= SENSOR_CALIB_RLS_SAMPLE_PERIOD * 1e6f) {
+    struct sensor_calib_rls_sample *s = (struct sensor_calib_rls_sample *)spsc_queue_reserve(&queue);
+    if (s != NULL) {
+      s->type = type;
+      s->temp = temp;
+      VECT3_SDIV(s->v, acc->sum, (float)acc->nb);
+      spsc_queue_commit(&queue);
+    }
+    FLOAT_VECT3_ZERO(acc->sum);
+    acc->nb = 0;
+    acc->stamp = stamp;
+  }
+}
+
+static void gyro_raw_cb(uint8_t sender_id, uint32_t stamp, struct Int32Rates *data, uint8_t samples,
+                        float rate __attribute__((unused)), float temp)
+{
+  if (gyro_acc.id == ABI_BROADCAST) {
+    gyro_acc.id = sender_id;
+  }
+  if (sender_id != gyro_acc.id || samples == 0) {
+    return;
+  }
+  sensor_calib_rls.temperature = temp;
+  // Int32Rates and Int32Vect3 have the same layout
+  sensor_calib_rls_accumulate(SENSOR_CALIB_RLS_GYRO, stamp, (struct Int32Vect3 *)data, samples, temp);
+}
+
+static void accel_raw_cb(uint8_t sender_id, uint32_t stamp, struct Int32Vect3 *data, uint8_t samples,
+                         float rate __attribute__((unused)), float temp)
+{
+  if (accel_acc.id == ABI_BROADCAST) {
+    accel_acc.id = sender_id;
+  }
+  if (sender_id != accel_acc.id || samples == 0) {
+    return;
+  }
+  sensor_calib_rls_accumulate(SENSOR_CALIB_RLS_ACCEL, stamp, data, samples, temp);
+}
+
+static void mag_raw_cb(uint8_t sender_id, uint32_t stamp __attribute__((unused)), struct Int32Vect3 *data)
+{
+  if (mag_id == ABI_BROADCAST) {
+    mag_id = sender_id;
+  }
+  if (sender_id != mag_id) {
+    return;
+  }
+  struct sensor_calib_rls_sample *s = (struct sensor_calib_rls_sample *)spsc_queue_reserve(&queue);
+  if (s != NULL) {
+    s->type = SENSOR_CALIB_RLS_MAG;
+    s->temp = NAN;
+    VECT3_COPY(s->v, *data);
+    spsc_queue_commit(&queue);
+  }
+}
+
+void sensor_calib_rls_init(void)
+{
+  memset(&sensor_calib_rls, 0, sizeof(sensor_calib_rls));
+  sensor_calib_rls.temperature = NAN;
+
+  memset(&ref, 0, sizeof(ref));
+  memset(&output, 0, sizeof(output));
+  seqlock_init(&ref_lock);
+  seqlock_init(&output_lock);
+  output_seq = 0;
+  solver.gen = 0;
+  sensor_calib_rls_solver_reset();
+
+  spsc_queue_init(&queue, sample_buf, SENSOR_CALIB_RLS_QUEUE_SIZE, sizeof(struct sensor_calib_rls_sample));
+  memset(&gyro_acc, 0, sizeof(gyro_acc));
+  memset(&accel_acc, 0, sizeof(accel_acc));
+  gyro_acc.id = SENSOR_CALIB_RLS_GYRO_ID;
+  accel_acc.id = SENSOR_CALIB_RLS_ACCEL_ID;
+  mag_id = SENSOR_CALIB_RLS_MAG_ID;
+
+  AbiBindMsgIMU_GYRO_RAW(ABI_BROADCAST, &gyro_ev, gyro_raw_cb);
+  AbiBindMsgIMU_ACCEL_RAW(ABI_BROADCAST, &accel_ev, accel_raw_cb);
+  AbiBindMsgIMU_MAG_RAW(ABI_BROADCAST, &mag_ev, mag_raw_cb);
+
+#if USE_CHIBIOS_RTOS
+  chThdCreateStatic(wa_thd_sensor_calib_rls, sizeof(wa_thd_sensor_calib_rls),
+                    LOWPRIO, thd_sensor_calib_rls, NULL);
+#elif SENSOR_CALIB_RLS_THREAD
+  pthread_t thread;
+  if (pthread_create(&thread, NULL, thd_sensor_calib_rls, NULL) != 0) {
+    fprintf(stderr, "[sensor_calib_rls] Could not create solver thread\n");
+    return;
+  }
+  pthread_setname_np(thread, "sensor_calib");
+#endif
+}
+
+/** Get the reference calibration of a sensor from the IMU */
+static void sensor_calib_rls_set_ref(struct sensor_calib_rls_sensor_ref *r, const int32_t *neutral,
+                                     const int32_t *num, const int32_t *den, uint8_t frac)
+{
+  const float one = (float)(1 << frac);
+  r->neutral.x = (float)neutral[0];
+  r->neutral.y = (float)neutral[1];
+  r->neutral.z = (float)neutral[2];
+  r->scale.x = (float)num[0] / (float)den[0] / one;
+  r->scale.y = (float)num[1] / (float)den[1] / one;
+  r->scale.z = (float)num[2] / (float)den[2] / one;
+  r->ok = true;
+}
+
+/** Take the reference calibrations of the sensors that have been received */
+static void sensor_calib_rls_update_ref(bool reset, bool flying)
+{
+  struct sensor_calib_rls_ref r = ref;
+  bool changed = reset || flying != r.flying;
+  r.flying = flying;
+  if (reset) {
+    r.gen++;
+    r.gyro.ok = false;
+    r.accel.ok = false;
+    r.mag.ok = false;
+  }
+
+  struct imu_gyro_t *gyro;
+  if (!r.gyro.ok && gyro_acc.id != ABI_BROADCAST && (gyro = imu_get_gyro(gyro_acc.id, false)) != NULL) {
+    sensor_calib_rls_set_ref(&r.gyro, (const int32_t *)&gyro->neutral, (const int32_t *)&gyro->scale[0],
+                             (const int32_t *)&gyro->scale[1], INT32_RATE_FRAC);
+    changed = true;
+  }
+  struct imu_accel_t *accel;
+  if (!r.accel.ok && accel_acc.id != ABI_BROADCAST && (accel = imu_get_accel(accel_acc.id, false)) != NULL) {
+    sensor_calib_rls_set_ref(&r.accel, (const int32_t *)&accel->neutral, (const int32_t *)&accel->scale[0],
+                             (const int32_t *)&accel->scale[1], INT32_ACCEL_FRAC);
+    changed = true;
+  }
+  struct imu_mag_t *mag;
+  if (!r.mag.ok && mag_id != ABI_BROADCAST && (mag = imu_get_mag(mag_id, false)) != NULL) {
+    sensor_calib_rls_set_ref(&r.mag, (const int32_t *)&mag->neutral, (const int32_t *)&mag->scale[0],
+                             (const int32_t *)&mag->scale[1], INT32_MAG_FRAC);
+    changed = true;
+  }
+
+  if (changed) {
+    seqlock_write_begin(&ref_lock);
+    ref = r;
+    seqlock_write_end(&ref_lock);
+  }
+}
+
+/** Convert a calibration to the IMU format, keeping the sign of the reference scale */
+static void sensor_calib_rls_to_imu(struct Int32Vect3 *neutral, struct Int32Vect3 scale[2],
+                                    const struct FloatVect3 *n, const struct FloatVect3 *sens,
+                                    const struct FloatVect3 *ref_scale)
+{
+  const float den = (float)(1 << SENSOR_CALIB_RLS_SCALE_FRAC);
+  VECT3_ASSIGN(*neutral, lroundf(n->x), lroundf(n->y), lroundf(n->z));
+  VECT3_ASSIGN(scale[0],
+               lroundf(copysignf(sens->x * den, ref_scale->x)),
+               lroundf(copysignf(sens->y * den, ref_scale->y)),
+               lroundf(copysignf(sens->z * den, ref_scale->z)));
+  VECT3_ASSIGN(scale[1], 1 << SENSOR_CALIB_RLS_SCALE_FRAC, 1 << SENSOR_CALIB_RLS_SCALE_FRAC,
+               1 << SENSOR_CALIB_RLS_SCALE_FRAC);
+}
+
+void sensor_calib_rls_periodic(void)
+{
+  // never calibrate nor change the calibration in flight
+  const bool flying = autopilot_in_flight() || autopilot_get_motors_on();
+  sensor_calib_rls_update_ref(sensor_calib_rls.reset, flying);
+  sensor_calib_rls.reset = false;
+  sensor_calib_rls.overruns = queue.overruns;
+
+#if !SENSOR_CALIB_RLS_THREAD
+  sensor_calib_rls_solve(SENSOR_CALIB_RLS_BATCH);
+#endif
+
+  // single read attempt, the solver may have a lower priority
+  struct sensor_calib_rls_output out;
+  uint32_t seq = seqlock_read_begin(&output_lock);
+  out = output;
+  if (seqlock_read_retry(&output_lock, seq) || seq == output_seq || out.gen != ref.gen) {
+    return;
+  }
+  output_seq = seq;
+
+  sensor_calib_rls.nb_mag = out.nb_mag;
+  sensor_calib_rls.nb_accel = out.nb_accel;
+  sensor_calib_rls.nb_gyro = out.nb_gyro;
+  sensor_calib_rls.mag_valid = out.mag_valid;
+  if (out.mag_valid) {
+    sensor_calib_rls.mag_neutral = out.mag_neutral;
+    sensor_calib_rls.mag_sens = out.mag_sens;
+    if (sensor_calib_rls.apply_mag && !flying) {
+      struct Int32Vect3 neutral, scale[2];
+      sensor_calib_rls_to_imu(&neutral, scale, &out.mag_neutral, &out.mag_sens, &ref.mag.scale);
+      imu_set_calibration_mag(mag_id, &neutral, scale);
+    }
+  }
+  sensor_calib_rls.accel_valid = out.accel_valid;
+  if (out.accel_valid) {
+    sensor_calib_rls.accel_neutral = out.accel_neutral;
+    sensor_calib_rls.accel_sens = out.accel_sens;
+    if (sensor_calib_rls.apply_accel && !flying) {
+      struct Int32Vect3 neutral, scale[2];
+      sensor_calib_rls_to_imu(&neutral, scale, &out.accel_neutral, &out.accel_sens, &ref.accel.scale);
+      imu_set_calibration_accel(accel_acc.id, &neutral, scale);
+    }
+  }
+  sensor_calib_rls.gyro_valid = out.gyro_valid;
+  if (out.gyro_valid) {
+    // neutral at the current temperature
+    float dt = isfinite(sensor_calib_rls.temperature) ? sensor_calib_rls.temperature - out.gyro_temp_ref : 0.f;
+    sensor_calib_rls.gyro_neutral.p = out.gyro_neutral.p + out.gyro_temp_coef.p * dt;
+    sensor_calib_rls.gyro_neutral.q = out.gyro_neutral.q + out.gyro_temp_coef.q * dt;
+    sensor_calib_rls.gyro_neutral.r = out.gyro_neutral.r + out.gyro_temp_coef.r * dt;
+    sensor_calib_rls.gyro_temp_coef = out.gyro_temp_coef;
+    sensor_calib_rls.gyro_temp_ref = out.gyro_temp_ref;
+    if (sensor_calib_rls.apply_gyro && !flying) {
+      struct Int32Rates neutral = {
+        lroundf(sensor_calib_rls.gyro_neutral.p),
+        lroundf(sensor_calib_rls.gyro_neutral.q),
+        lroundf(sensor_calib_rls.gyro_neutral.r)
+      };
+      imu_set_calibration_gyro(gyro_acc.id, &neutral, NULL);
+    }
+  }
+}
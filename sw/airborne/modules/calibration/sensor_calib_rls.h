@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file "modules/calibration/sensor_calib_rls.h"
+ * Online calibration of the IMU sensors with recursive least squares.
+ *
+ * Raw samples are queued by the ABI callbacks and processed by a low
+ * priority thread (ChibiOS and Linux) or in the periodic task otherwise:
+ *  - mag hard iron and axis scale from an ellipsoid fit
+ *  - accel neutral and axis scale from an ellipsoid fit of the samples at rest
+ *  - gyro neutral as a linear function of the temperature, at rest
+ *
+ * The results are published as settings, with the names of the airframe
+ * IMU parameters so that they can be saved, and can be applied to the IMU.
+ */
+
+#ifndef SENSOR_CALIB_RLS_H
+#define SENSOR_CALIB_RLS_H
+
+#include "std.h"
+#include "math/pprz_algebra_float.h"
+
+struct SensorCalibRls {
+  /* settings */
+  bool reset;                       ///< restart all the estimations
+  bool apply_mag;                   ///< write the mag calibration to the IMU when valid, on the ground
+  bool apply_accel;                 ///< write the accel calibration to the IMU when valid, on the ground
+  bool apply_gyro;                  ///< write the gyro neutral at the current temperature to the IMU when valid, on the ground
+
+  /* published results, in the units of the airframe IMU section */
+  bool mag_valid;                   ///< mag fit converged
+  struct FloatVect3 mag_neutral;    ///< mag neutral in raw units
+  struct FloatVect3 mag_sens;       ///< mag sensitivity (scaled units per raw unit)
+  bool accel_valid;                 ///< accel fit converged
+  struct FloatVect3 accel_neutral;  ///< accel neutral in raw units
+  struct FloatVect3 accel_sens;     ///< accel sensitivity (scaled units per raw unit)
+  bool gyro_valid;                  ///< gyro fit converged
+  struct FloatRates gyro_neutral;   ///< gyro neutral at the current temperature in raw units
+  struct FloatRates gyro_temp_coef; ///< gyro neutral drift in raw units per degree
+  float gyro_temp_ref;              ///< reference temperature of the gyro fit
+  float temperature;                ///< last gyro temperature
+
+  /* statistics */
+  uint32_t nb_mag;                  ///< number of mag updates
+  uint32_t nb_accel;                ///< number of accel updates (at rest)
+  uint32_t nb_gyro;                 ///< number of gyro updates (at rest)
+  uint32_t overruns;                ///< samples dropped because the queue was full
+};
+
+extern struct SensorCalibRls sensor_calib_rls;
+
+extern void sensor_calib_rls_init(void);
+extern void sensor_calib_rls_periodic(void);
+
+#endif /* SENSOR_CALIB_RLS_H */
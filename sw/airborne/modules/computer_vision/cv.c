@@ -148,7 +148,7 @@ void *cv_async_thread(void *args)
   struct cv_async *async = listener->async;
   async->thread_running = true;
 
-  set_nice_level(async->thread_priority);
+  rt_thread_setup("cv", RT_THREAD_NICE, async->thread_priority);
 
   // Request new image from video thread
   pthread_mutex_lock(&async->img_mutex);
@@ -98,6 +98,8 @@ struct color_object_t {
 };
 struct color_object_t global_filters[2];  // Array to hold filter results
 
+static void send_detection(uint8_t filter, struct color_object_t *obj);
+
 // Functions
 // Floor calibration function
 void calibrate_floor_color(struct image_t *img);
@@ -280,6 +282,19 @@ static struct image_t *object_detector(struct image_t *img, uint8_t filter)
   global_filters[filter-1].updated = true;
   pthread_mutex_unlock(&mutex);
 
+#if ABI_DEFERRED
+  // send directly from the video thread, messages are delivered in the autopilot thread
+  struct color_object_t result = {
+    .x_c = x_c,
+    .y_c = y_c,
+    .color_count = count,
+    .color_ground_count = floor_count_central,
+    .color_plant_count = plant_count,
+    .updated = true
+  };
+  send_detection(filter, &result);
+#endif
+
   return img;
 }
 
@@ -505,6 +520,26 @@ uint32_t find_plant_count(struct image_t *img,
   return cnt;
 }
 
+/**
+ * Sends the ABI messages of a filter result.
+ * The first filter sends a single detection, the second one sends multiple ABI messages
+ * for different types of detections: ground, central ground, and plant
+ */
+static void send_detection(uint8_t filter, struct color_object_t *obj)
+{
+  if (filter == 1) {
+    AbiSendMsgVISUAL_DETECTION(COLOR_OBJECT_DETECTION1_ID, obj->x_c, obj->y_c,
+        0, 0, obj->color_count, 0);
+  } else {
+    AbiSendMsgVISUAL_DETECTION(COLOR_OBJECT_DETECTION2_ID, obj->x_c, obj->y_c,
+        0, 0, obj->color_count, 1);
+    AbiSendMsgVISUAL_DETECTION(COLOR_OBJECT_DETECTION3_ID, obj->x_c, obj->y_c,
+        0, 0, obj->color_ground_count, 2);
+    AbiSendMsgVISUAL_DETECTION(COLOR_OBJECT_DETECTION4_ID, obj->x_c, obj->y_c,
+        0, 0, obj->color_plant_count, 2);
+  }
+}
+
 /**
  * Periodically checks the updated status of the detected color objects and sends
  * ABI messages for each detection. This function ensures that other modules in the
@@ -512,28 +547,21 @@ uint32_t find_plant_count(struct image_t *img,
  */
 void color_object_detector_periodic(void)
 {
+#if !ABI_DEFERRED
   static struct color_object_t local_filters[2];
   pthread_mutex_lock(&mutex);
   memcpy(local_filters, global_filters, 2*sizeof(struct color_object_t));
   pthread_mutex_unlock(&mutex);
 
-  // Check if the first filter's results are updated and send ABI message
+  // Check if the filters results are updated and send ABI messages
   if(local_filters[0].updated){
-    AbiSendMsgVISUAL_DETECTION(COLOR_OBJECT_DETECTION1_ID, local_filters[0].x_c, local_filters[0].y_c,
-        0, 0, local_filters[0].color_count, 0);
+    send_detection(1, &local_filters[0]);
     local_filters[0].updated = false;
   }
-
-  // Check if the second filter's results are updated and send multiple ABI messages
-  // for different types of detections: ground, central ground, and plant
   if(local_filters[1].updated){
-    AbiSendMsgVISUAL_DETECTION(COLOR_OBJECT_DETECTION2_ID, local_filters[1].x_c, local_filters[1].y_c,
-        0, 0, local_filters[1].color_count, 1);
-    AbiSendMsgVISUAL_DETECTION(COLOR_OBJECT_DETECTION3_ID, local_filters[1].x_c, local_filters[1].y_c,
-        0, 0, local_filters[1].color_ground_count, 2);
-    AbiSendMsgVISUAL_DETECTION(COLOR_OBJECT_DETECTION4_ID, local_filters[1].x_c, local_filters[1].y_c,
-        0, 0, local_filters[1].color_plant_count, 2);
+    send_detection(2, &local_filters[1]);
     local_filters[1].updated = false;
   }
+#endif
 }
 
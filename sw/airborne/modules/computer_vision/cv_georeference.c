@@ -75,8 +75,15 @@ void georeference_project(struct camera_frame_t *tar, int wp)
   int32_rmat_transp_vmult(&target_b, &body_to_cam_rmat, &geo.target_i);
 
   // Body <-> LTP
-  struct Int32RMat *ltp_to_body_rmat = stateGetNedToBodyRMat_i();
-  int32_rmat_transp_vmult(&geo.target_l, ltp_to_body_rmat, &target_b);
+  // called from the vision thread, use the published state
+  struct StateSnapshot snapshot;
+  stateGetSnapshot(&snapshot);
+  if (!snapshot.attitude_valid || !snapshot.local_pos_valid) {
+    return;
+  }
+  struct Int32RMat ltp_to_body_rmat;
+  RMAT_BFP_OF_REAL(ltp_to_body_rmat, snapshot.ned_to_body_rmat);
+  int32_rmat_transp_vmult(&geo.target_l, &ltp_to_body_rmat, &target_b);
 
   // target_l is now a scale-less [pix<<POS_FRAC] vector in LTP from the drone to the target
   // Divide by z-component to normalize the projection vector
@@ -88,8 +95,9 @@ void georeference_project(struct camera_frame_t *tar, int wp)
   }
 
   // Multiply with height above ground
-  struct NedCoor_i *pos = stateGetPositionNed_i();
-  int32_t zb = pos->z;
+  struct NedCoor_i pos;
+  POSITIONS_BFP_OF_REAL(pos, snapshot.ned_pos);
+  int32_t zb = pos.z;
   geo.target_l.x *= zb;
   geo.target_l.y *= zb;
 
@@ -99,8 +107,8 @@ void georeference_project(struct camera_frame_t *tar, int wp)
   geo.target_l.z = zb;
 
   // NED
-  geo.x_t.x = pos->x - geo.target_l.x;
-  geo.x_t.y = pos->y - geo.target_l.y;
+  geo.x_t.x = pos.x - geo.target_l.x;
+  geo.x_t.y = pos.y - geo.target_l.y;
   geo.x_t.z = 0;
 
   // ENU
@@ -188,6 +196,8 @@ void georeference_init(void)
   INT32_VECT3_ZERO(geo.filter.x);
   geo.filter.P = 0;
   focus_length = 400;
+
+  stateSnapshotRegister();
 }
 
 
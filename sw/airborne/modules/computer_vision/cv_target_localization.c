@@ -138,15 +138,20 @@ static void detection_cb(uint8_t sender_id UNUSED,
   target_loc.px = pixel_x;
   target_loc.py = pixel_y;
 
+  // Detections may come from the vision thread, use the published state
+  struct StateSnapshot snapshot;
+  stateGetSnapshot(&snapshot);
+  if (!snapshot.attitude_valid || !snapshot.local_pos_valid) {
+    return;
+  }
   // Prepare rotation matrices
-  struct FloatRMat *ltp_to_body_rmat = stateGetNedToBodyRMat_f();
   struct FloatRMat ltp_to_cam_rmat;
-  float_rmat_comp(&ltp_to_cam_rmat, ltp_to_body_rmat, &target_loc.body_to_cam);
+  float_rmat_comp(&ltp_to_cam_rmat, &snapshot.ned_to_body_rmat, &target_loc.body_to_cam);
   // Prepare cam world position
   // C_w = P_w + R_w2b * C_b
   struct FloatVect3 cam_pos_ltp;
-  float_rmat_vmult(&cam_pos_ltp, ltp_to_body_rmat, &target_loc.cam_pos);
-  VECT3_ADD(cam_pos_ltp, *stateGetPositionNed_f());
+  float_rmat_vmult(&cam_pos_ltp, &snapshot.ned_to_body_rmat, &target_loc.cam_pos);
+  VECT3_ADD(cam_pos_ltp, snapshot.ned_pos);
 
   // Compute target position here (pixels in "mm" to meters)
   struct FloatVect3 target_img = {
@@ -213,6 +218,7 @@ void target_localization_init(void)
 
   // Bind to ABI message
   AbiBindMsgVISUAL_DETECTION(TARGET_LOC_ID, &detection_ev, detection_cb);
+  stateSnapshotRegister();
 }
 
 void target_localization_report(void)
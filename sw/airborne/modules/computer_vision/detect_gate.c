@@ -16,6 +16,7 @@
 #include "math/pprz_simple_matrix.h"
 #include "modules/core/abi.h"
 #include "modules/core/abi_sender_ids.h"
+#include "state.h"
 
 #include "modules/computer_vision/snake_gate_detection.h"
 
@@ -354,6 +355,8 @@ void detect_gate_init(void)
   detect_gate_y = 0;
   detect_gate_z = 0;
 
+  // the PnP solver reads the attitude from the state snapshot
+  stateSnapshotRegister();
   cv_add_to_device(&DETECT_GATE_CAMERA, detect_gate_func, DETECT_GATE_FPS, 0);
 
   register_periodic_telemetry(DefaultPeriodic, PPRZ_MSG_ID_VISION_POSITION_ESTIMATE, send_detect_gate_visual_position);
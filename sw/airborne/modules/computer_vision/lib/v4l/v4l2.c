@@ -38,6 +38,7 @@
 #include <pthread.h>
 
 #include "v4l2.h"
+#include "rt_priority.h"
 #include "virt2phys.h"
 
 #include <sys/time.h>
@@ -61,6 +62,8 @@ static void *v4l2_capture_thread(void *data)
   struct timeval tv;
   fd_set fds;
 
+  rt_thread_setup("v4l2", RT_THREAD_NICE, 0);
+
   while (TRUE) {
     FD_ZERO(&fds);
     FD_SET(dev->fd, &fds);
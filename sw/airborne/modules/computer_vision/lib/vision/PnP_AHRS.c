@@ -75,9 +75,15 @@ struct FloatVect3 get_world_position_from_image_points(int *x_corners, int *y_co
   float_rmat_of_eulers_321(&R_C_B, &cam_body);
 
   // Use the AHRS roll and pitch from the filter to get the attitude in a rotation matrix R_E_B:
+  // (called from the vision thread, use the published state, see stateSnapshotRegister)
+  struct StateSnapshot snapshot;
+  stateGetSnapshot(&snapshot);
+  if (!snapshot.attitude_valid) {
+    return pos_drone_E_vec;
+  }
   struct FloatEulers attitude;
-  attitude.phi =    stateGetNedToBodyEulers_f()->phi;//positive ccw
-  attitude.theta = stateGetNedToBodyEulers_f()->theta;//negative downward
+  attitude.phi =    snapshot.ned_to_body_eulers.phi;//positive ccw
+  attitude.theta = snapshot.ned_to_body_eulers.theta;//negative downward
   // local_psi typically assumed 0.0f (meaning you are straight in front of the object):
   // If you want to use the estimate of psi, stateGetNedToBodyEulers_f()->psi, then you still need to take the psi of the gate into account.
   float local_psi = 0.0f; // stateGetNedToBodyEulers_f()->psi; // 0.0f;
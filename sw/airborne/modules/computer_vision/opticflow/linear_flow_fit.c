@@ -110,204 +110,52 @@ void fit_linear_flow_field(struct flow_t *vectors, int count, float error_thresh
                            float *parameters_u, float *parameters_v, float *fit_error, float *min_error_u, float *min_error_v, int *n_inliers_u,
                            int *n_inliers_v)
 {
-
-  // We will solve systems of the form A x = b,
+  // We solve systems of the form A x = b,
   // where A = [nx3] matrix with entries [x, y, 1] for each optic flow location
   // and b = [nx1] vector with either the horizontal (bu) or vertical (bv) flow.
   // x in the system are the parameters for the horizontal (pu) or vertical (pv) flow field.
+  int sam;
 
-  // local vars for iterating, random numbers:
-  int sam, p, i_rand, si, add_si;
-
-  // ensure that n_samples is high enough to ensure a result for a single fit:
-  n_samples = (n_samples < MIN_SAMPLES_FIT) ? MIN_SAMPLES_FIT : n_samples;
-  // n_samples should not be higher than count:
-  n_samples = (n_samples < count) ? n_samples : count;
-
-  // initialize matrices and vectors for the full point set problem:
-  // this is used for determining inliers
-  float _AA[count][3];
-  MAKE_MATRIX_PTR(AA, _AA, count);
-  float _bu_all[count][1];
-  MAKE_MATRIX_PTR(bu_all, _bu_all, count);
-  float _bv_all[count][1];
-  MAKE_MATRIX_PTR(bv_all, _bv_all, count);
-  for (sam = 0; sam < count; sam++) {
-    AA[sam][0] = (float) vectors[sam].pos.x;
-    AA[sam][1] = (float) vectors[sam].pos.y;
-    AA[sam][2] = 1.0f;
-    bu_all[sam][0] = (float) vectors[sam].flow_x;
-    bv_all[sam][0] = (float) vectors[sam].flow_y;
-  }
-
-  // later used to determine the error of a set of parameters on the whole set:
-  float _bb[count][1];
-  MAKE_MATRIX_PTR(bb, _bb, count);
-  float _C[count][1];
-  MAKE_MATRIX_PTR(C, _C, count);
-
-  // ***************
-  // perform RANSAC:
-  // ***************
-
-  // set up variables for small linear system solved repeatedly inside RANSAC:
-  float _A[n_samples][3];
-  MAKE_MATRIX_PTR(A, _A, n_samples);
-  float _bu[n_samples][1];
-  MAKE_MATRIX_PTR(bu, _bu, n_samples);
-  float _bv[n_samples][1];
-  MAKE_MATRIX_PTR(bv, _bv, n_samples);
-  float w[n_samples], _v[3][3];
-  MAKE_MATRIX_PTR(v, _v, 3);
-  float _pu[3][1];
-  MAKE_MATRIX_PTR(pu, _pu, 3);
-  float _pv[3][1];
-  MAKE_MATRIX_PTR(pv, _pv, 3);
-
-  // iterate and store parameters, errors, inliers per fit:
-  float PU[n_iterations * 3];
-  float PV[n_iterations * 3];
-  float errors_pu[n_iterations];
-  errors_pu[0] = 0.0;
-  float errors_pv[n_iterations];
-  errors_pv[0] = 0.0;
-  int n_inliers_pu[n_iterations];
-  int n_inliers_pv[n_iterations];
-  int it, ii;
-  for (it = 0; it < n_iterations; it++) {
-    // select a random sample of n_sample points:
-    int sample_indices[n_samples];
-    i_rand = 0;
-
-    // sampling without replacement:
-    while (i_rand < n_samples) {
-      si = rand() % count;
-      add_si = 1;
-      for (ii = 0; ii < i_rand; ii++) {
-        if (sample_indices[ii] == si) { add_si = 0; }
-      }
-      if (add_si) {
-        sample_indices[i_rand] = si;
-        i_rand ++;
-      }
-    }
-
-    // Setup the system:
-    for (sam = 0; sam < n_samples; sam++) {
-      A[sam][0] = (float) vectors[sample_indices[sam]].pos.x;
-      A[sam][1] = (float) vectors[sample_indices[sam]].pos.y;
-      A[sam][2] = 1.0f;
-      bu[sam][0] = (float) vectors[sample_indices[sam]].flow_x;
-      bv[sam][0] = (float) vectors[sample_indices[sam]].flow_y;
-      //printf("%d,%d,%d,%d,%d\n",A[sam][0],A[sam][1],A[sam][2],bu[sam][0],bv[sam][0]);
-    }
-
-    // Solve the small system:
-
-    // for horizontal flow:
-    // decompose A in u, w, v with singular value decomposition A = u * w * vT.
-    // u replaces A as output:
-    pprz_svd_float(A, w, v, n_samples, 3);
-    pprz_svd_solve_float(pu, A, w, v, bu, n_samples, 3, 1);
-    PU[it * 3] = pu[0][0];
-    PU[it * 3 + 1] = pu[1][0];
-    PU[it * 3 + 2] = pu[2][0];
-
-    // for vertical flow:
-    pprz_svd_solve_float(pv, A, w, v, bv, n_samples, 3, 1);
-    PV[it * 3] = pv[0][0];
-    PV[it * 3 + 1] = pv[1][0];
-    PV[it * 3 + 2] = pv[2][0];
-
-    // count inliers and determine their error on all points:
-    errors_pu[it] = 0;
-    errors_pv[it] = 0;
-    n_inliers_pu[it] = 0;
-    n_inliers_pv[it] = 0;
-
-    // for horizontal flow:
-    // bb = AA * pu:
-    MAT_MUL(count, 3, 1, bb, AA, pu);
-    // subtract bu_all: C = 0 in case of perfect fit:
-    MAT_SUB(count, 1, C, bb, bu_all);
-
-    for (p = 0; p < count; p++) {
-      C[p][0] = fabsf(C[p][0]);
-      if (C[p][0] < error_threshold) {
-        errors_pu[it] += C[p][0];
-        n_inliers_pu[it]++;
-      } else {
-        errors_pu[it] += error_threshold;
-      }
-    }
-
-    // for vertical flow:
-    // bb = AA * pv:
-    MAT_MUL(count, 3, 1, bb, AA, pv);
-    // subtract bv_all: C = 0 in case of perfect fit:
-    MAT_SUB(count, 1, C, bb, bv_all);
-
-    for (p = 0; p < count; p++) {
-      C[p][0] = fabsf(C[p][0]);
-      if (C[p][0] < error_threshold) {
-        errors_pv[it] += C[p][0];
-        n_inliers_pv[it]++;
-      } else {
-        errors_pv[it] += error_threshold;
-      }
+  // no vectors, return an empty fit instead of leaving the outputs unset
+  if (count <= 0) {
+    for (int i = 0; i < 3; i++) {
+      parameters_u[i] = 0.f;
+      parameters_v[i] = 0.f;
     }
+    *fit_error = 0.f;
+    *min_error_u = 0.f;
+    *min_error_v = 0.f;
+    *n_inliers_u = 0;
+    *n_inliers_v = 0;
+    return;
   }
 
-  // After all iterations:
-  // select the parameters with lowest error:
-  // for horizontal flow:
-  int param;
-  int min_ind = 0;
-  *min_error_u = (float)errors_pu[0];
-  for (it = 1; it < n_iterations; it++) {
-    if (errors_pu[it] < *min_error_u) {
-      *min_error_u = (float)errors_pu[it];
-      min_ind = it;
-    }
-  }
-  for (param = 0; param < 3; param++) {
-    parameters_u[param] = PU[min_ind * 3 + param];
-  }
-  *n_inliers_u = n_inliers_pu[min_ind];
-
-  // for vertical flow:
-  min_ind = 0;
-  *min_error_v = (float)errors_pv[0];
-  for (it = 0; it < n_iterations; it++) {
-    if (errors_pv[it] < *min_error_v) {
-      *min_error_v = (float)errors_pv[it];
-      min_ind = it;
-    }
-  }
-  for (param = 0; param < 3; param++) {
-    parameters_v[param] = PV[min_ind * 3 + param];
+  float samples[count][2];
+  float bu_all[count];
+  float bv_all[count];
+  for (sam = 0; sam < count; sam++) {
+    samples[sam][0] = (float) vectors[sam].pos.x;
+    samples[sam][1] = (float) vectors[sam].pos.y;
+    bu_all[sam] = (float) vectors[sam].flow_x;
+    bv_all[sam] = (float) vectors[sam].flow_y;
   }
-  *n_inliers_v = n_inliers_pv[min_ind];
+
+  // the number of iterations is adapted to the inlier ratio, n_iterations is the upper bound:
+  float err;
+  n_samples = (n_samples < MIN_SAMPLES_FIT) ? MIN_SAMPLES_FIT : n_samples;
+  RANSAC_linear_model_adaptive(n_samples, n_iterations, RANSAC_CONFIDENCE, error_threshold, bu_all, 2, samples,
+                               count, true, parameters_u, &err, n_inliers_u);
+  RANSAC_linear_model_adaptive(n_samples, n_iterations, RANSAC_CONFIDENCE, error_threshold, bv_all, 2, samples,
+                               count, true, parameters_v, &err, n_inliers_v);
 
   // error has to be determined on the entire set without threshold:
-  // bb = AA * pu:
-  MAT_MUL(count, 3, 1, bb, AA, pu);
-  // subtract bu_all: C = 0 in case of perfect fit:
-  MAT_SUB(count, 1, C, bb, bu_all);
   *min_error_u = 0;
-  for (p = 0; p < count; p++) {
-    *min_error_u += fabsf(C[p][0]);
-  }
-  // bb = AA * pv:
-  MAT_MUL(count, 3, 1, bb, AA, pv);
-  // subtract bv_all: C = 0 in case of perfect fit:
-  MAT_SUB(count, 1, C, bb, bv_all);
   *min_error_v = 0;
-  for (p = 0; p < count; p++) {
-    *min_error_v += fabsf(C[p][0]);
+  for (sam = 0; sam < count; sam++) {
+    *min_error_u += fabsf(parameters_u[0] * samples[sam][0] + parameters_u[1] * samples[sam][1] + parameters_u[2] - bu_all[sam]);
+    *min_error_v += fabsf(parameters_v[0] * samples[sam][0] + parameters_v[1] * samples[sam][1] + parameters_v[2] - bv_all[sam]);
   }
   *fit_error = (*min_error_u + *min_error_v) / (2 * count);
-
 }
 /**
  * Extract information from the parameters that were fit to the optical flow field.
@@ -185,12 +185,15 @@ static void update_tag_position(void)
   // compute target position in body frame (rotate and translate)
   float_rmat_transp_vmult(&target_pos_body, &tag_track_private.body_to_cam, &tag_track_private.meas);
   VECT3_ADD(target_pos_body, tag_track_private.cam_pos);
-  // rotate to ltp frame
-  struct FloatRMat *ltp_to_body_rmat = stateGetNedToBodyRMat_f();
-  float_rmat_transp_vmult(&target_pos_ned, ltp_to_body_rmat, &target_pos_body);
+  // rotate to ltp frame, measurements may come from another thread
+  struct StateSnapshot snapshot;
+  stateGetSnapshot(&snapshot);
+  if (!snapshot.attitude_valid || !snapshot.local_pos_valid) {
+    return;
+  }
+  float_rmat_transp_vmult(&target_pos_ned, &snapshot.ned_to_body_rmat, &target_pos_body);
   // compute absolute position of tag in earth frame
-  struct NedCoor_f * pos_ned = stateGetPositionNed_f();
-  VECT3_ADD(target_pos_ned, *pos_ned);
+  VECT3_ADD(target_pos_ned, snapshot.ned_pos);
 
   if (tag_tracking.status == TAG_TRACKING_DISABLE) {
     // don't run kalman, just update pos, set speed to zero
@@ -295,6 +298,7 @@ void tag_tracking_init()
 
   // Bind to ABI message
   AbiBindMsgJEVOIS_MSG(TAG_TRACKING_ID, &tag_track_ev, tag_track_cb);
+  stateSnapshotRegister();
 
   tag_tracking.status = TAG_TRACKING_SEARCHING;
   tag_tracking.motion_type = TAG_TRACKING_FIXED_POS;
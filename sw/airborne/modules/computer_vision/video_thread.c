@@ -116,9 +116,8 @@ static void *video_thread_function(void *data)
   }
 #endif
 
-  // Be nice to the more important stuff
-  set_nice_level(VIDEO_THREAD_NICE_LEVEL);
-  fprintf(stdout, "[%s] Set nice level to %i.\n", print_tag, VIDEO_THREAD_NICE_LEVEL);
+  // Be nice to the more important stuff (unless overridden by the rt_threads module)
+  rt_thread_setup("camera", RT_THREAD_NICE, VIDEO_THREAD_NICE_LEVEL);
 
   // Initialize timing
   uint32_t time_begin = get_sys_time_usec();
@@ -0,0 +1,291 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file modules/core/abi_deferred.c
+ *
+ * Deferred delivery of ABI messages sent from other threads.
+ *
+ * Queued messages are stored in a bounded multi-producer single-consumer
+ * ring buffer where each slot has its own sequence number, producers only
+ * compete on the write index with a compare-and-swap.
+ * Messages with the overwrite policy are stored in mailboxes indexed by
+ * message and sender IDs, producers and consumer never wait for each other:
+ * a message that finds its mailbox busy is dropped and counted.
+ */
+
+#include "modules/core/abi_deferred.h"
+#include "modules/core/abi.h"
+#include <string.h>
+
+#if USE_CHIBIOS_RTOS
+#include <ch.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#endif
+
+#include "modules/datalink/downlink.h"
+
+/** Size of the message queue, must be a power of 2 */
+#ifndef ABI_DEFERRED_QUEUE_SIZE
+#define ABI_DEFERRED_QUEUE_SIZE 32
+#endif
+
+#if (ABI_DEFERRED_QUEUE_SIZE & (ABI_DEFERRED_QUEUE_SIZE - 1)) != 0
+#error "ABI_DEFERRED_QUEUE_SIZE must be a power of 2"
+#endif
+
+/** Number of mailboxes for messages with overwrite policy (one per message and sender pair) */
+#ifndef ABI_DEFERRED_MAILBOX_NB
+#define ABI_DEFERRED_MAILBOX_NB 8
+#endif
+
+/** Maximum number of queued messages delivered per event loop */
+#ifndef ABI_DEFERRED_MAX_PER_EVENT
+#define ABI_DEFERRED_MAX_PER_EVENT ABI_DEFERRED_QUEUE_SIZE
+#endif
+
+struct abi_deferred_slot {
+  uint32_t seq;                   ///< slot sequence number
+  uint8_t msg_id;
+  uint8_t sender_id;
+  union abi_deferred_args args;
+};
+
+struct abi_deferred_mailbox {
+  uint8_t used;                   ///< mailbox assigned to a message/sender pair
+  uint8_t lock;                   ///< taken while a producer or the consumer copies the data
+  uint8_t pending;                ///< new message not yet delivered
+  uint8_t msg_id;
+  uint8_t sender_id;
+  union abi_deferred_args args;
+};
+
+struct abi_deferred_queue {
+  struct abi_deferred_slot slots[ABI_DEFERRED_QUEUE_SIZE];
+  uint32_t write_pos;             ///< shared between producers
+  uint32_t read_pos;              ///< only used by the consumer
+  struct abi_deferred_mailbox mailboxes[ABI_DEFERRED_MAILBOX_NB];
+};
+
+static struct abi_deferred_queue abi_deferred_queue;
+struct AbiDeferredStats abi_deferred_stats;
+
+static bool abi_deferred_initialized = false;
+#if USE_CHIBIOS_RTOS
+static thread_t *abi_main_thread;
+#elif defined(__linux__)
+static pthread_t abi_main_thread;
+#endif
+
+bool abi_deferred_is_main_thread(void)
+{
+  if (!abi_deferred_initialized) {
+    return true;
+  }
+#if USE_CHIBIOS_RTOS
+  return (chThdGetSelfX() == abi_main_thread);
+#elif defined(__linux__)
+  return pthread_equal(pthread_self(), abi_main_thread);
+#else
+  return true;
+#endif
+}
+
+static inline void abi_deferred_stat_inc(uint32_t *counter)
+{
+  __atomic_fetch_add(counter, 1, __ATOMIC_RELAXED);
+}
+
+/** Push a message to the queue, drop it if the queue is full */
+static bool abi_deferred_queue_push(uint8_t msg_id, uint8_t sender_id, const void *args, size_t len)
+{
+  struct abi_deferred_slot *slot;
+  uint32_t pos = __atomic_load_n(&abi_deferred_queue.write_pos, __ATOMIC_RELAXED);
+  while (true) {
+    slot = &abi_deferred_queue.slots[pos & (ABI_DEFERRED_QUEUE_SIZE - 1)];
+    uint32_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+    int32_t diff = (int32_t)(seq - pos);
+    if (diff == 0) {
+      // slot is free, try to reserve it
+      if (__atomic_compare_exchange_n(&abi_deferred_queue.write_pos, &pos, pos + 1, true,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // queue is full
+      abi_deferred_stat_inc(&abi_deferred_stats.dropped);
+      return false;
+    } else {
+      pos = __atomic_load_n(&abi_deferred_queue.write_pos, __ATOMIC_RELAXED);
+    }
+  }
+  slot->msg_id = msg_id;
+  slot->sender_id = sender_id;
+  memcpy(&slot->args, args, len);
+  __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+  abi_deferred_stat_inc(&abi_deferred_stats.queued);
+  return true;
+}
+
+/** Pop a message from the queue (consumer only) */
+static bool abi_deferred_queue_pop(struct abi_deferred_slot *msg)
+{
+  uint32_t pos = abi_deferred_queue.read_pos;
+  struct abi_deferred_slot *slot = &abi_deferred_queue.slots[pos & (ABI_DEFERRED_QUEUE_SIZE - 1)];
+  uint32_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+  if ((int32_t)(seq - (pos + 1)) < 0) {
+    return false;
+  }
+  msg->msg_id = slot->msg_id;
+  msg->sender_id = slot->sender_id;
+  msg->args = slot->args;
+  // release the slot for the next round
+  __atomic_store_n(&slot->seq, pos + ABI_DEFERRED_QUEUE_SIZE, __ATOMIC_RELEASE);
+  abi_deferred_queue.read_pos = pos + 1;
+  return true;
+}
+
+static inline bool abi_deferred_mailbox_trylock(struct abi_deferred_mailbox *mb)
+{
+  return !__atomic_test_and_set(&mb->lock, __ATOMIC_ACQUIRE);
+}
+
+static inline void abi_deferred_mailbox_unlock(struct abi_deferred_mailbox *mb)
+{
+  __atomic_clear(&mb->lock, __ATOMIC_RELEASE);
+}
+
+/** Find or assign the mailbox of a message/sender pair
+ * @return NULL if no mailbox is left or another producer is assigning one
+ */
+static struct abi_deferred_mailbox *abi_deferred_mailbox_get(uint8_t msg_id, uint8_t sender_id)
+{
+  for (int i = 0; i < ABI_DEFERRED_MAILBOX_NB; i++) {
+    struct abi_deferred_mailbox *mb = &abi_deferred_queue.mailboxes[i];
+    if (!__atomic_load_n(&mb->used, __ATOMIC_ACQUIRE)) {
+      // claim a new mailbox, the key is set before it is marked as used
+      if (!abi_deferred_mailbox_trylock(mb)) {
+        return NULL;
+      }
+      if (!mb->used) {
+        mb->msg_id = msg_id;
+        mb->sender_id = sender_id;
+        __atomic_store_n(&mb->used, 1, __ATOMIC_RELEASE);
+        abi_deferred_mailbox_unlock(mb);
+        return mb;
+      }
+      abi_deferred_mailbox_unlock(mb);
+    }
+    if (mb->msg_id == msg_id && mb->sender_id == sender_id) {
+      return mb;
+    }
+  }
+  return NULL;
+}
+
+bool abi_deferred_push(uint8_t msg_id, uint8_t sender_id, uint8_t policy, const void *args, size_t len)
+{
+  if (policy == ABI_DEFERRED_OVERWRITE) {
+    struct abi_deferred_mailbox *mb = abi_deferred_mailbox_get(msg_id, sender_id);
+    if (mb != NULL) {
+      // never wait for the consumer copy or another producer
+      if (!abi_deferred_mailbox_trylock(mb)) {
+        abi_deferred_stat_inc(&abi_deferred_stats.dropped);
+        return false;
+      }
+      memcpy(&mb->args, args, len);
+      if (mb->pending) {
+        abi_deferred_stat_inc(&abi_deferred_stats.overwritten);
+      } else {
+        abi_deferred_stat_inc(&abi_deferred_stats.queued);
+      }
+      mb->pending = 1;
+      abi_deferred_mailbox_unlock(mb);
+      return true;
+    }
+    // no mailbox available, fallback to the queue
+  }
+  return abi_deferred_queue_push(msg_id, sender_id, args, len);
+}
+
+void abi_deferred_init(void)
+{
+  memset(&abi_deferred_queue, 0, sizeof(abi_deferred_queue));
+  for (uint32_t i = 0; i < ABI_DEFERRED_QUEUE_SIZE; i++) {
+    abi_deferred_queue.slots[i].seq = i;
+  }
+  memset(&abi_deferred_stats, 0, sizeof(abi_deferred_stats));
+
+  // init is called from the autopilot thread
+#if USE_CHIBIOS_RTOS
+  abi_main_thread = chThdGetSelfX();
+#elif defined(__linux__)
+  abi_main_thread = pthread_self();
+#endif
+  __atomic_store_n(&abi_deferred_initialized, true, __ATOMIC_RELEASE);
+}
+
+/**
+ * Deliver pending messages from the autopilot thread
+ */
+void abi_deferred_event(void)
+{
+  struct abi_deferred_slot msg;
+
+  uint16_t depth = (uint16_t)(__atomic_load_n(&abi_deferred_queue.write_pos, __ATOMIC_RELAXED) - abi_deferred_queue.read_pos);
+  abi_deferred_stats.depth = depth;
+  if (depth > abi_deferred_stats.depth_max) {
+    abi_deferred_stats.depth_max = depth;
+  }
+
+  for (int i = 0; i < ABI_DEFERRED_MAX_PER_EVENT && abi_deferred_queue_pop(&msg); i++) {
+    abi_deferred_dispatch_msg(msg.msg_id, msg.sender_id, &msg.args);
+    abi_deferred_stats.dispatched++;
+  }
+
+  for (int i = 0; i < ABI_DEFERRED_MAILBOX_NB; i++) {
+    struct abi_deferred_mailbox *mb = &abi_deferred_queue.mailboxes[i];
+    if (!__atomic_load_n(&mb->used, __ATOMIC_ACQUIRE) || !mb->pending) {
+      continue;
+    }
+    // don't wait for a producer, try again at next event
+    if (abi_deferred_mailbox_trylock(mb)) {
+      msg.msg_id = mb->msg_id;
+      msg.sender_id = mb->sender_id;
+      msg.args = mb->args;
+      mb->pending = 0;
+      abi_deferred_mailbox_unlock(mb);
+      abi_deferred_dispatch_msg(msg.msg_id, msg.sender_id, &msg.args);
+      abi_deferred_stats.dispatched++;
+    }
+  }
+}
+
+/**
+ * Report statistics with an ABI_DEFERRED message
+ */
+void abi_deferred_report(void)
+{
+  DOWNLINK_SEND_ABI_DEFERRED(DefaultChannel, DefaultDevice, &abi_deferred_stats.queued, &abi_deferred_stats.dispatched,
+                             &abi_deferred_stats.dropped, &abi_deferred_stats.overwritten,
+                             &abi_deferred_stats.depth, &abi_deferred_stats.depth_max);
+}
+
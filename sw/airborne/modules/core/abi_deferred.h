@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file modules/core/abi_deferred.h
+ *
+ * Deferred delivery of ABI messages sent from other threads.
+ *
+ * Messages with a 'deferred' policy in conf/abi.xml that are sent from a
+ * thread other than the autopilot one are copied into a lock-free queue
+ * and delivered to their subscribers from the autopilot event loop.
+ * - ABI_DEFERRED_DROP: every message is queued, new messages are dropped when the queue is full
+ * - ABI_DEFERRED_OVERWRITE: only the latest message of each sender is kept
+ */
+
+#ifndef ABI_DEFERRED_H
+#define ABI_DEFERRED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "std.h"
+#include <stddef.h>
+
+/** Enable deferred delivery, set by the abi_deferred module */
+#ifndef ABI_DEFERRED
+#define ABI_DEFERRED FALSE
+#endif
+
+/** Deferred delivery policies */
+#define ABI_DEFERRED_DROP       0
+#define ABI_DEFERRED_OVERWRITE  1
+
+/** Deferred delivery statistics */
+struct AbiDeferredStats {
+  uint32_t queued;        ///< number of messages queued
+  uint32_t dispatched;    ///< number of messages delivered to the subscribers
+  uint32_t dropped;       ///< number of messages dropped because the queue was full or the mailbox busy
+  uint32_t overwritten;   ///< number of messages replaced by a newer one before delivery
+  uint16_t depth;         ///< current number of pending messages in the queue
+  uint16_t depth_max;     ///< highest queue depth since startup
+};
+
+extern struct AbiDeferredStats abi_deferred_stats;
+
+/**
+ * Test if the caller runs in the autopilot thread.
+ * Always true before the module is initialized.
+ */
+extern bool abi_deferred_is_main_thread(void);
+
+/**
+ * Copy the arguments of a message to be delivered from the autopilot thread.
+ * Never blocks the caller.
+ * @param msg_id ABI message ID
+ * @param sender_id ABI sender ID
+ * @param policy ABI_DEFERRED_DROP or ABI_DEFERRED_OVERWRITE
+ * @param args message arguments structure
+ * @param len size of args
+ * @return false if the message was dropped
+ */
+extern bool abi_deferred_push(uint8_t msg_id, uint8_t sender_id, uint8_t policy, const void *args, size_t len);
+
+extern void abi_deferred_init(void);
+extern void abi_deferred_event(void);
+extern void abi_deferred_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ABI_DEFERRED_H */
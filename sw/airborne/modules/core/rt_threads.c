@@ -0,0 +1,363 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file modules/core/rt_threads.c
+ *
+ * Scheduling policy, priority and CPU affinity of the Linux threads.
+ */
+
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+#include "modules/core/rt_threads.h"
+#include "rt_priority.h"
+#include "generated/airframe.h"
+#include "modules/datalink/downlink.h"
+
+#if !USE_RT_THREADS
+#error "rt_threads: USE_RT_THREADS should be defined by the module"
+#endif
+
+/** Lock the current and future memory pages of the process */
+#ifndef RT_THREADS_MLOCKALL
+#define RT_THREADS_MLOCKALL TRUE
+#endif
+
+/** Change the scheduling of the main thread.
+ * By default only when it is configured in the airframe file, otherwise the
+ * main thread is only registered and keeps the scheduling it was started with
+ * (e.g. from chrt or the launch script).
+ */
+#ifndef RT_THREADS_MAIN_SETUP
+#if defined(RT_THREADS_MAIN_POLICY) || defined(RT_THREADS_MAIN_PRIO) || defined(RT_THREADS_MAIN_CPUS)
+#define RT_THREADS_MAIN_SETUP TRUE
+#else
+#define RT_THREADS_MAIN_SETUP FALSE
+#endif
+#endif
+
+/*
+ * Per thread configuration, from the airframe file:
+ * RT_THREADS_<NAME>_POLICY, RT_THREADS_<NAME>_PRIO and RT_THREADS_<NAME>_CPUS
+ */
+#ifndef RT_THREADS_MAIN_POLICY
+#define RT_THREADS_MAIN_POLICY RT_THREADS_KEEP
+#endif
+#ifndef RT_THREADS_MAIN_PRIO
+#define RT_THREADS_MAIN_PRIO RT_THREADS_KEEP
+#endif
+#ifndef RT_THREADS_MAIN_CPUS
+#define RT_THREADS_MAIN_CPUS 0
+#endif
+
+#ifndef RT_THREADS_SYS_TIME_POLICY
+#define RT_THREADS_SYS_TIME_POLICY RT_THREADS_KEEP
+#endif
+#ifndef RT_THREADS_SYS_TIME_PRIO
+#define RT_THREADS_SYS_TIME_PRIO RT_THREADS_KEEP
+#endif
+#ifndef RT_THREADS_SYS_TIME_CPUS
+#define RT_THREADS_SYS_TIME_CPUS 0
+#endif
+
+#ifndef RT_THREADS_UART_POLICY
+#define RT_THREADS_UART_POLICY RT_THREADS_KEEP
+#endif
+#ifndef RT_THREADS_UART_PRIO
+#define RT_THREADS_UART_PRIO RT_THREADS_KEEP
+#endif
+#ifndef RT_THREADS_UART_CPUS
+#define RT_THREADS_UART_CPUS 0
+#endif
+
+#ifndef RT_THREADS_UDP_POLICY
+#define RT_THREADS_UDP_POLICY RT_THREADS_KEEP
+#endif
+#ifndef RT_THREADS_UDP_PRIO
+#define RT_THREADS_UDP_PRIO RT_THREADS_KEEP
+#endif
+#ifndef RT_THREADS_UDP_CPUS
+#define RT_THREADS_UDP_CPUS 0
+#endif
+
+#ifndef RT_THREADS_I2C_POLICY
+#define RT_THREADS_I2C_POLICY RT_THREADS_KEEP
+#endif
+#ifndef RT_THREADS_I2C_PRIO
+#define RT_THREADS_I2C_PRIO RT_THREADS_KEEP
+#endif
+#ifndef RT_THREADS_I2C_CPUS
+#define RT_THREADS_I2C_CPUS 0
+#endif
+
+#ifndef RT_THREADS_PIPE_POLICY
+#define RT_THREADS_PIPE_POLICY RT_THREADS_KEEP
+#endif
+#ifndef RT_THREADS_PIPE_PRIO
+#define RT_THREADS_PIPE_PRIO RT_THREADS_KEEP
+#endif
+#ifndef RT_THREADS_PIPE_CPUS
+#define RT_THREADS_PIPE_CPUS 0
+#endif
+
+#ifndef RT_THREADS_CAMERA_POLICY
+#define RT_THREADS_CAMERA_POLICY RT_THREADS_KEEP
+#endif
+#ifndef RT_THREADS_CAMERA_PRIO
+#define RT_THREADS_CAMERA_PRIO RT_THREADS_KEEP
+#endif
+#ifndef RT_THREADS_CAMERA_CPUS
+#define RT_THREADS_CAMERA_CPUS 0
+#endif
+
+#ifndef RT_THREADS_V4L2_POLICY
+#define RT_THREADS_V4L2_POLICY RT_THREADS_KEEP
+#endif
+#ifndef RT_THREADS_V4L2_PRIO
+#define RT_THREADS_V4L2_PRIO RT_THREADS_KEEP
+#endif
+#ifndef RT_THREADS_V4L2_CPUS
+#define RT_THREADS_V4L2_CPUS 0
+#endif
+
+#ifndef RT_THREADS_CV_POLICY
+#define RT_THREADS_CV_POLICY RT_THREADS_KEEP
+#endif
+#ifndef RT_THREADS_CV_PRIO
+#define RT_THREADS_CV_PRIO RT_THREADS_KEEP
+#endif
+#ifndef RT_THREADS_CV_CPUS
+#define RT_THREADS_CV_CPUS 0
+#endif
+
+#ifndef RT_THREADS_EKF2_POLICY
+#define RT_THREADS_EKF2_POLICY RT_THREADS_KEEP
+#endif
+#ifndef RT_THREADS_EKF2_PRIO
+#define RT_THREADS_EKF2_PRIO RT_THREADS_KEEP
+#endif
+#ifndef RT_THREADS_EKF2_CPUS
+#define RT_THREADS_EKF2_CPUS 0
+#endif
+
+#define RT_THREADS_CONFIG(_name, _NAME) { _name, RT_THREADS_##_NAME##_POLICY, RT_THREADS_##_NAME##_PRIO, RT_THREADS_##_NAME##_CPUS }
+
+static const struct rt_thread_config rt_threads_config[] = {
+  RT_THREADS_CONFIG("main", MAIN),
+  RT_THREADS_CONFIG("sys_time", SYS_TIME),
+  RT_THREADS_CONFIG("uart", UART),
+  RT_THREADS_CONFIG("udp", UDP),
+  RT_THREADS_CONFIG("i2c", I2C),
+  RT_THREADS_CONFIG("pipe", PIPE),
+  RT_THREADS_CONFIG("camera", CAMERA),
+  RT_THREADS_CONFIG("v4l2", V4L2),
+  RT_THREADS_CONFIG("cv", CV),
+  RT_THREADS_CONFIG("ekf2", EKF2),
+};
+
+#define RT_THREADS_CONFIG_NB (sizeof(rt_threads_config) / sizeof(struct rt_thread_config))
+
+/** Registered thread, with the result of the configuration */
+struct rt_thread_info {
+  const char *name;
+  pthread_t thread;
+  pid_t tid;
+  int error;          ///< 0 if the requested scheduling was applied
+};
+
+static struct rt_thread_info rt_threads[RT_THREADS_MAX];
+static uint8_t rt_threads_nb = 0;
+static uint8_t rt_threads_printed = 0;
+static uint8_t rt_threads_report_idx = 0;
+static int rt_threads_mlock_error = 0;
+static pthread_mutex_t rt_threads_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static const struct rt_thread_config *rt_threads_find(const char *name)
+{
+  for (uint8_t i = 0; i < RT_THREADS_CONFIG_NB; i++) {
+    if (strcmp(rt_threads_config[i].name, name) == 0) {
+      return &rt_threads_config[i];
+    }
+  }
+  return NULL;
+}
+
+static int rt_threads_set_affinity(uint32_t cpus)
+{
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu = 0; cpu < 32; cpu++) {
+    if (cpus & (1UL << cpu)) {
+      CPU_SET(cpu, &set);
+    }
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+/** Add a thread to the report, error is 0 if its scheduling was applied */
+static void rt_threads_register(const char *name, int error)
+{
+  pthread_mutex_lock(&rt_threads_mutex);
+  if (rt_threads_nb < RT_THREADS_MAX) {
+    struct rt_thread_info *info = &rt_threads[rt_threads_nb++];
+    info->name = name;
+    info->thread = pthread_self();
+    info->tid = syscall(SYS_gettid);
+    info->error = error;
+  }
+  pthread_mutex_unlock(&rt_threads_mutex);
+}
+
+void rt_thread_setup(const char *name, int policy, int prio)
+{
+  int error = 0;
+  uint32_t cpus = 0;
+
+  const struct rt_thread_config *conf = rt_threads_find(name);
+  if (conf != NULL) {
+    if (conf->policy != RT_THREADS_KEEP) {
+      policy = conf->policy;
+    }
+    if (conf->prio != RT_THREADS_KEEP) {
+      prio = conf->prio;
+    }
+    cpus = conf->cpus;
+  }
+
+  if (policy == RT_THREAD_NICE) {
+    // a realtime thread can not go back to SCHED_OTHER with set_nice_level only
+    struct sched_param param = { .sched_priority = 0 };
+    pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+    if (set_nice_level(prio) != 0) {
+      error = -1;
+    }
+  } else if (set_rt_sched(policy == RT_THREAD_RR ? SCHED_RR : SCHED_FIFO, prio) != 0) {
+    error = -1;
+  }
+  if (cpus != 0 && rt_threads_set_affinity(cpus) != 0) {
+    fprintf(stderr, "[rt_threads] Could not set CPU affinity 0x%x of thread %s\n", cpus, name);
+    error = -1;
+  }
+
+  rt_threads_register(name, error);
+}
+
+/** Read back the actual scheduling of a registered thread */
+static void rt_threads_get(struct rt_thread_info *info, int *policy, int *prio, int *nice, uint32_t *cpus)
+{
+  struct sched_param param;
+  if (pthread_getschedparam(info->thread, policy, &param) != 0) {
+    *policy = -1;
+    param.sched_priority = 0;
+  }
+  *prio = param.sched_priority;
+  *nice = getpriority(PRIO_PROCESS, info->tid);
+
+  cpu_set_t set;
+  *cpus = 0;
+  if (pthread_getaffinity_np(info->thread, sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < 32; cpu++) {
+      if (CPU_ISSET(cpu, &set)) {
+        *cpus |= 1UL << cpu;
+      }
+    }
+  }
+}
+
+static const char *rt_threads_policy_name(int policy)
+{
+  switch (policy) {
+    case SCHED_OTHER: return "OTHER";
+    case SCHED_FIFO: return "FIFO";
+    case SCHED_RR: return "RR";
+    default: return "?";
+  }
+}
+
+void rt_threads_print(void)
+{
+  pthread_mutex_lock(&rt_threads_mutex);
+  printf("[rt_threads] mlockall: %s\n", RT_THREADS_MLOCKALL ? (rt_threads_mlock_error ? "failed" : "ok") : "off");
+  printf("[rt_threads] %-10s %6s %6s %5s %5s %10s %s\n", "thread", "tid", "policy", "prio", "nice", "cpus", "status");
+  for (uint8_t i = 0; i < rt_threads_nb; i++) {
+    int policy, prio, nice;
+    uint32_t cpus;
+    rt_threads_get(&rt_threads[i], &policy, &prio, &nice, &cpus);
+    printf("[rt_threads] %-10s %6d %6s %5d %5d 0x%08x %s\n", rt_threads[i].name, (int)rt_threads[i].tid,
+           rt_threads_policy_name(policy), prio, nice, cpus, rt_threads[i].error ? "failed" : "ok");
+  }
+  rt_threads_printed = rt_threads_nb;
+  pthread_mutex_unlock(&rt_threads_mutex);
+}
+
+void rt_threads_init(void)
+{
+#if RT_THREADS_MLOCKALL
+  if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+    perror("[rt_threads] mlockall failed");
+    rt_threads_mlock_error = -1;
+  }
+#endif
+  // the main thread runs the control loop
+#if RT_THREADS_MAIN_SETUP
+  rt_thread_setup("main", RT_THREAD_NICE, 0);
+#else
+  rt_threads_register("main", 0);
+#endif
+}
+
+/**
+ * Print the table when new threads registered, and send the actual
+ * scheduling of one thread per call with a RT_THREAD message
+ */
+void rt_threads_report(void)
+{
+  if (rt_threads_printed != rt_threads_nb) {
+    rt_threads_print();
+  }
+  if (rt_threads_nb == 0) {
+    return;
+  }
+  if (rt_threads_report_idx >= rt_threads_nb) {
+    rt_threads_report_idx = 0;
+  }
+
+  int policy, prio, nice;
+  uint32_t cpus;
+  struct rt_thread_info *info = &rt_threads[rt_threads_report_idx];
+  rt_threads_get(info, &policy, &prio, &nice, &cpus);
+  int32_t tid = info->tid;
+  uint8_t policy_u8 = policy;
+  int16_t prio_i16 = prio;
+  int8_t nice_i8 = nice;
+  uint8_t status = info->error != 0;
+  DOWNLINK_SEND_RT_THREAD(DefaultChannel, DefaultDevice, &rt_threads_report_idx, &tid, &policy_u8, &prio_i16,
+                          &nice_i8, &cpus, &status, strlen(info->name), (char *)info->name);
+  rt_threads_report_idx++;
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file modules/core/rt_threads.h
+ *
+ * Scheduling policy, priority and CPU affinity of the Linux threads.
+ *
+ * Each thread calls rt_thread_setup() (see arch/linux/rt_priority.h) when it
+ * starts, with its name and default scheduling. The defaults can be overridden
+ * per thread from the airframe file, and threads can be pinned to a set of CPUs.
+ * The memory of the process is locked to avoid page faults in the control loop.
+ */
+
+#ifndef RT_THREADS_H
+#define RT_THREADS_H
+
+#include "std.h"
+
+/** Maximum number of registered threads */
+#ifndef RT_THREADS_MAX
+#define RT_THREADS_MAX 16
+#endif
+
+/** Keep the default policy or priority given by the thread */
+#define RT_THREADS_KEEP (-100)
+
+/** Scheduling configuration of a named thread */
+struct rt_thread_config {
+  const char *name;   ///< thread name
+  int policy;         ///< RT_THREAD_NICE, RT_THREAD_FIFO, RT_THREAD_RR or RT_THREADS_KEEP
+  int prio;           ///< priority or nice level, RT_THREADS_KEEP for the thread default
+  uint32_t cpus;      ///< CPU affinity bitmask, 0 to run on any CPU
+};
+
+extern void rt_threads_init(void);
+extern void rt_threads_report(void);
+extern void rt_threads_print(void);
+
+#endif /* RT_THREADS_H */
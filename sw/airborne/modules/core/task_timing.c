@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file modules/core/task_timing.c
+ *
+ * Execution time of the task groups and of the module periodic functions.
+ */
+
+#include "modules/core/task_timing.h"
+#include "generated/airframe.h"
+#include "generated/modules.h"
+#include "modules/datalink/downlink.h"
+#include <string.h>
+
+#ifdef __linux__
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+
+#if !USE_TASK_TIMING
+#error "task_timing module requires USE_TASK_TIMING"
+#endif
+
+/** Deadlines of the task groups in usec.
+ * By default, sensors and GNC groups have half a period each (GNC is
+ * called with an offset of half a period), other groups their own period.
+ */
+#ifndef TASK_TIMING_DEADLINE_SENSORS
+#define TASK_TIMING_DEADLINE_SENSORS (1000000 / (2 * PERIODIC_FREQUENCY))
+#endif
+#ifndef TASK_TIMING_DEADLINE_RADIO_CONTROL
+#define TASK_TIMING_DEADLINE_RADIO_CONTROL (1000000 / 60)
+#endif
+#ifndef TASK_TIMING_DEADLINE_GNC
+#define TASK_TIMING_DEADLINE_GNC (1000000 / (2 * PERIODIC_FREQUENCY))
+#endif
+#ifndef TASK_TIMING_DEADLINE_CORE
+#define TASK_TIMING_DEADLINE_CORE (1000000 / PERIODIC_FREQUENCY)
+#endif
+#ifndef TASK_TIMING_DEADLINE_DATALINK
+#define TASK_TIMING_DEADLINE_DATALINK (1000000 / TELEMETRY_FREQUENCY)
+#endif
+
+/** Dump the statistics on exit (Linux and NPS only) */
+#ifndef TASK_TIMING_DUMP_ON_EXIT
+#define TASK_TIMING_DUMP_ON_EXIT TRUE
+#endif
+
+struct task_timing_stat task_timing_groups[TASK_TIMING_GROUP_NB];
+struct task_timing_stat task_timing_modules[MODULES_TIMING_NB + 1];
+
+static const char *task_timing_group_names[TASK_TIMING_GROUP_NB] = {
+  "sensors", "radio_control", "gnc", "core", "datalink"
+};
+
+/** Deadlines of the task groups in usec */
+static const uint32_t task_timing_deadlines[TASK_TIMING_GROUP_NB] = {
+  TASK_TIMING_DEADLINE_SENSORS,
+  TASK_TIMING_DEADLINE_RADIO_CONTROL,
+  TASK_TIMING_DEADLINE_GNC,
+  TASK_TIMING_DEADLINE_CORE,
+  TASK_TIMING_DEADLINE_DATALINK
+};
+
+uint8_t task_timing_reset_flag = 0;
+
+/** index of the next stat to report, groups first */
+static uint16_t task_timing_report_idx = 0;
+
+/** Reset a statistic, the deadline is given in usec */
+static void task_timing_stat_reset(struct task_timing_stat *stat, uint32_t deadline)
+{
+  memset(stat, 0, sizeof(struct task_timing_stat));
+  stat->min = UINT32_MAX;
+  stat->deadline = (uint32_t)(((uint64_t)deadline * TASK_TIMING_FREQUENCY) / 1000000);
+}
+
+void task_timing_update(struct task_timing_stat *stat, uint32_t duration)
+{
+  stat->count++;
+  stat->sum += duration;
+  if (duration < stat->min) {
+    stat->min = duration;
+  }
+  if (duration > stat->max) {
+    stat->max = duration;
+  }
+  if (stat->deadline > 0 && duration > stat->deadline) {
+    stat->overruns++;
+  }
+  // log2 histogram
+  uint8_t bin = 0;
+  while ((duration >>= 1) > 0 && bin < TASK_TIMING_HIST_NB - 1) {
+    bin++;
+  }
+  stat->hist[bin]++;
+}
+
+void task_timing_reset(void)
+{
+  for (int i = 0; i < TASK_TIMING_GROUP_NB; i++) {
+    task_timing_stat_reset(&task_timing_groups[i], task_timing_deadlines[i]);
+  }
+  for (int i = 0; i < MODULES_TIMING_NB; i++) {
+    task_timing_stat_reset(&task_timing_modules[i], 0);
+  }
+}
+
+void task_timing_Reset(uint8_t reset)
+{
+  if (reset) {
+    task_timing_reset();
+  }
+  task_timing_reset_flag = 0;
+}
+
+#ifdef __linux__
+static void task_timing_print_stat(FILE *f, const char *name, struct task_timing_stat *stat)
+{
+  if (stat->count == 0) {
+    fprintf(f, "%-40s %10u\n", name, 0);
+    return;
+  }
+  fprintf(f, "%-40s %10u %8u %8u %8u %9u |", name, stat->count, stat->min,
+          (uint32_t)(stat->sum / stat->count), stat->max, stat->overruns);
+  for (int i = 0; i < TASK_TIMING_HIST_NB; i++) {
+    fprintf(f, " %u", stat->hist[i]);
+  }
+  fprintf(f, "\n");
+}
+
+/** Print all the statistics as a table */
+static void task_timing_dump(void)
+{
+  FILE *f = stderr;
+  fprintf(f, "\n%-40s %10s %8s %8s %8s %9s | %s\n", "task timing [" TASK_TIMING_UNIT "]", "count", "min", "avg",
+          "max", "overruns", "log2 histogram");
+  for (int i = 0; i < TASK_TIMING_GROUP_NB; i++) {
+    task_timing_print_stat(f, task_timing_group_names[i], &task_timing_groups[i]);
+  }
+  for (int i = 0; i < MODULES_TIMING_NB; i++) {
+    task_timing_print_stat(f, modules_timing_names[i], &task_timing_modules[i]);
+  }
+}
+#endif
+
+void task_timing_init(void)
+{
+#if TASK_TIMING_USE_DWT
+  dwt_enable_cycle_counter();
+#endif
+  task_timing_reset();
+  task_timing_report_idx = 0;
+#if defined(__linux__) && TASK_TIMING_DUMP_ON_EXIT
+  atexit(task_timing_dump);
+#endif
+}
+
+/**
+ * Report one statistic per call with a TASK_TIMING message,
+ * round robin over the groups and the modules.
+ * The times and the histogram are sent in ticks of the time source.
+ */
+void task_timing_report(void)
+{
+  struct task_timing_stat *stat;
+  uint8_t type, idx;
+  uint8_t unit = TASK_TIMING_UNIT_ID;
+  if (task_timing_report_idx < TASK_TIMING_GROUP_NB) {
+    stat = &task_timing_groups[task_timing_report_idx];
+    type = 0;
+    idx = task_timing_report_idx;
+  } else {
+    stat = &task_timing_modules[task_timing_report_idx - TASK_TIMING_GROUP_NB];
+    type = 1;
+    idx = task_timing_report_idx - TASK_TIMING_GROUP_NB;
+  }
+  uint32_t min = stat->count > 0 ? stat->min : 0;
+  uint32_t avg = stat->count > 0 ? (uint32_t)(stat->sum / stat->count) : 0;
+  DOWNLINK_SEND_TASK_TIMING(DefaultChannel, DefaultDevice, &type, &idx, &unit, &stat->count, &min, &avg,
+                            &stat->max, &stat->overruns, TASK_TIMING_HIST_NB, stat->hist);
+
+  task_timing_report_idx++;
+  if (task_timing_report_idx >= TASK_TIMING_GROUP_NB + MODULES_TIMING_NB) {
+    task_timing_report_idx = 0;
+  }
+}
+
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file modules/core/task_timing.h
+ *
+ * Execution time of the task groups and of the module periodic functions.
+ *
+ * The probes are generated around each periodic call in generated/modules.h
+ * and around each task group in main_ap.c. They are empty unless the
+ * task_timing module is loaded (USE_TASK_TIMING).
+ *
+ * The durations are read from the cycle counter on the MCU (DWT, or the
+ * ChibiOS realtime counter which is the DWT on STM32) and from the
+ * monotonic clock in nanoseconds on Linux, get_sys_time_usec() is too
+ * coarse for most module functions and takes a mutex on ChibiOS.
+ */
+
+#ifndef TASK_TIMING_H
+#define TASK_TIMING_H
+
+#include "std.h"
+
+/** Number of histogram bins, bin k counts durations in [2^k, 2^(k+1)[ ticks */
+#ifndef TASK_TIMING_HIST_NB
+#define TASK_TIMING_HIST_NB 16
+#endif
+
+/** Task groups of the main periodic loop */
+enum task_timing_group {
+  TASK_TIMING_SENSORS,
+  TASK_TIMING_RADIO_CONTROL,
+  TASK_TIMING_GNC,
+  TASK_TIMING_CORE,
+  TASK_TIMING_DATALINK,
+  TASK_TIMING_GROUP_NB
+};
+
+/** Timing statistics of a function or task group, times in ticks of task_timing_now() */
+struct task_timing_stat {
+  uint32_t start;     ///< start time of the current call
+  uint32_t count;     ///< number of calls
+  uint32_t min;       ///< min duration
+  uint32_t max;       ///< max duration
+  uint64_t sum;       ///< sum of durations, for average
+  uint32_t overruns;  ///< number of calls longer than the deadline (groups only)
+  uint32_t deadline;  ///< deadline in ticks, 0 to disable (groups only)
+  uint32_t hist[TASK_TIMING_HIST_NB]; ///< log2 histogram of durations
+};
+
+#if USE_TASK_TIMING
+
+/*
+ * Time source of the probes, TASK_TIMING_FREQUENCY ticks per second.
+ * TASK_TIMING_UNIT_ID is the unit field of the TASK_TIMING message.
+ */
+#if defined(__linux__)
+#include <time.h>
+
+static inline uint32_t task_timing_now(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (uint32_t)(t.tv_sec * 1000000000ULL + t.tv_nsec);
+}
+#define TASK_TIMING_FREQUENCY 1000000000UL
+#define TASK_TIMING_UNIT "ns"
+#define TASK_TIMING_UNIT_ID 2
+#elif USE_CHIBIOS_RTOS
+#include <ch.h>
+#include <hal.h>
+#define task_timing_now() ((uint32_t)chSysGetRealtimeCounterX())
+#define TASK_TIMING_FREQUENCY STM32_SYSCLK
+#define TASK_TIMING_UNIT "cycles"
+#define TASK_TIMING_UNIT_ID 0
+#elif defined(STM32F1) || defined(STM32F4) || defined(STM32F7)
+#include <libopencm3/cm3/dwt.h>
+#include <libopencm3/stm32/rcc.h>
+#define task_timing_now() dwt_read_cycle_counter()
+#define TASK_TIMING_FREQUENCY rcc_ahb_frequency
+#define TASK_TIMING_UNIT "cycles"
+#define TASK_TIMING_UNIT_ID 0
+#define TASK_TIMING_USE_DWT 1
+#else
+#include "mcu_periph/sys_time.h"
+#define task_timing_now() get_sys_time_usec()
+#define TASK_TIMING_FREQUENCY 1000000UL
+#define TASK_TIMING_UNIT "us"
+#define TASK_TIMING_UNIT_ID 1
+#endif
+
+extern struct task_timing_stat task_timing_groups[TASK_TIMING_GROUP_NB];
+extern struct task_timing_stat task_timing_modules[];
+extern const char *modules_timing_names[];
+
+extern void task_timing_update(struct task_timing_stat *stat, uint32_t duration);
+
+static inline void task_timing_start(struct task_timing_stat *stat)
+{
+  stat->start = task_timing_now();
+}
+
+static inline void task_timing_stop(struct task_timing_stat *stat)
+{
+  task_timing_update(stat, task_timing_now() - stat->start);
+}
+
+#define TASK_TIMING_GROUP_START(_g) task_timing_start(&task_timing_groups[_g])
+#define TASK_TIMING_GROUP_STOP(_g) task_timing_stop(&task_timing_groups[_g])
+#define MODULES_TIMING_START(_i) task_timing_start(&task_timing_modules[_i])
+#define MODULES_TIMING_STOP(_i) task_timing_stop(&task_timing_modules[_i])
+
+#else
+
+#define TASK_TIMING_GROUP_START(_g) {}
+#define TASK_TIMING_GROUP_STOP(_g) {}
+#define MODULES_TIMING_START(_i) {}
+#define MODULES_TIMING_STOP(_i) {}
+
+#endif
+
+extern void task_timing_init(void);
+extern void task_timing_report(void);
+extern void task_timing_reset(void);
+
+/** Settings handlers */
+extern uint8_t task_timing_reset_flag;
+extern void task_timing_Reset(uint8_t reset);
+
+#endif /* TASK_TIMING_H */
@@ -29,6 +29,7 @@
 #include "modules/geo_mag/geo_mag.h"
 #include "math/pprz_geodetic_wmm2020.h"
 #include "math/pprz_algebra_double.h"
+#include "math/pprz_geodetic_int.h"
 #include "modules/gps/gps.h"
 #include "modules/core/abi.h"
 
@@ -40,12 +41,35 @@
 #define GEO_MAG_SENDER_ID 1
 #endif
 
+/** Size of the cached cells in degrees, the field is interpolated within a cell */
+#ifndef GEO_MAG_CACHE_CELL
+#define GEO_MAG_CACHE_CELL 1.f
+#endif
+
+/** Altitude change in meters triggering a new evaluation of the cell */
+#ifndef GEO_MAG_CACHE_ALT
+#define GEO_MAG_CACHE_ALT 1000.f
+#endif
+
+/** Update the field every period along the flight, not only once on ground */
+#ifndef GEO_MAG_CONTINUOUS
+#define GEO_MAG_CONTINUOUS FALSE
+#endif
+
 struct GeoMag geo_mag;
 
+#if GEO_MAG_CONTINUOUS
+static struct Wmm2020Cache geo_mag_cache;
+static bool geo_mag_cache_init;
+#endif
+
 void geo_mag_init(void)
 {
   geo_mag.calc_once = false;
   geo_mag.ready = false;
+#if GEO_MAG_CONTINUOUS
+  geo_mag_cache_init = false;
+#endif
 }
 
 void geo_mag_periodic(void)
@@ -54,35 +78,40 @@ void geo_mag_periodic(void)
   if (!geo_mag.ready && GpsFixValid() && autopilot_throttle_killed()) {
     geo_mag.calc_once = true;
   }
+#if GEO_MAG_CONTINUOUS
+  if (geo_mag.ready && GpsFixValid()) {
+    geo_mag.calc_once = true;
+  }
+#endif
 }
 
 void geo_mag_event(void)
 {
   if (geo_mag.calc_once) {
-    double gha[MAXCOEFF]; // Geomag global variables
-    int32_t nmax;
-
     /* Current date in decimal year, for example 2015.68 */
-    double sdate = GPS_EPOCH_BEGIN +
-                   (double)gps.week / WEEKS_IN_YEAR +
-                   (double)gps.tow / 1000 / SECS_IN_YEAR;
-
-    /* LLA Position in decimal degrees and altitude in km */
-    double latitude = (double)gps.lla_pos.lat / 1e7;
-    double longitude = (double)gps.lla_pos.lon / 1e7;
-    double alt = (double)gps.lla_pos.alt / 1e6;
-
-    // Calculates additional coeffs
-    nmax = extrapsh(sdate, GEO_EPOCH, NMAX_1, NMAX_2, gha);
-    // Calculates absolute magnet fields
-    mag_calc(1, latitude, longitude, alt, nmax, gha,
-             &geo_mag.vect.x, &geo_mag.vect.y, &geo_mag.vect.z,
-             IEXT, EXT_COEFF1, EXT_COEFF2, EXT_COEFF3);
+    float sdate = GPS_EPOCH_BEGIN +
+                  (double)gps.week / WEEKS_IN_YEAR +
+                  (double)gps.tow / 1000 / SECS_IN_YEAR;
+    struct LlaCoor_f lla;
+    LLA_FLOAT_OF_BFP(lla, gps.lla_pos);
+    struct FloatVect3 h;
+#if GEO_MAG_CONTINUOUS
+    if (!geo_mag_cache_init) {
+      // Calculates the coeffs at this date
+      wmm2020_cache_init(&geo_mag_cache, sdate, RadOfDeg(GEO_MAG_CACHE_CELL), GEO_MAG_CACHE_ALT);
+      geo_mag_cache_init = true;
+    }
+    // Calculates absolute magnet fields, only evaluating the model when entering a new cell
+    wmm2020_cache_get(&geo_mag_cache, &h, &lla);
+#else
+    // Single calculation, evaluate the model at the position only
+    float gh[WMM2020_NB_COEFF];
+    wmm2020_extrapsh_f(gh, sdate);
+    wmm2020_mag_calc_f(&h, gh, &lla);
+#endif
+    VECT3_COPY(geo_mag.vect, h);
 
     // send as normalized float vector via ABI
-    struct FloatVect3 h = { .x = geo_mag.vect.x,
-                            .y = geo_mag.vect.y,
-                            .z = geo_mag.vect.z };
     float_vect3_normalize(&h);
     AbiSendMsgGEO_MAG(GEO_MAG_SENDER_ID, &h);
 
@@ -33,12 +33,54 @@
 #include "state.h"
 #include "modules/core/abi.h"
 #include "modules/energy/electrical.h"
+#include "modules/datalink/downlink.h"
+#include "utils/spsc_queue.h"
 
 /** By default disable IMU integration calculations */
 #ifndef IMU_INTEGRATION
 #define IMU_INTEGRATION false
 #endif
 
+/** Maximum number of samples of a burst processed at once, older samples of a longer burst are dropped.
+ * The invensense drivers send up to 22 samples per burst.
+ */
+#ifndef IMU_MAX_BURST
+#define IMU_MAX_BURST 32
+#endif
+
+/** Maximum number of gyro samples per burst kept for the sculling correction of the accel */
+#ifndef IMU_INTEGRATION_MAX_BURST
+#define IMU_INTEGRATION_MAX_BURST IMU_MAX_BURST
+#endif
+
+/** By default raw samples are processed directly in the driver context */
+#ifndef IMU_RAW_QUEUE
+#define IMU_RAW_QUEUE false
+#endif
+
+/** Size of the raw samples queue in samples, must be a power of 2 */
+#ifndef IMU_RAW_QUEUE_SIZE
+#define IMU_RAW_QUEUE_SIZE 128
+#endif
+
+#if (IMU_RAW_QUEUE_SIZE & (IMU_RAW_QUEUE_SIZE - 1)) != 0
+#error "IMU_RAW_QUEUE_SIZE must be a power of 2"
+#endif
+
+/** Maximum number of consecutive samples of a sensor processed as one burst */
+#ifndef IMU_RAW_QUEUE_MAX_BATCH
+#define IMU_RAW_QUEUE_MAX_BATCH IMU_MAX_BURST
+#endif
+
+#if IMU_RAW_QUEUE_MAX_BATCH > IMU_MAX_BURST
+#error "IMU_RAW_QUEUE_MAX_BATCH must not be larger than IMU_MAX_BURST"
+#endif
+
+/** Process the queue from the IMU event, disable when the estimation calls imu_process_queue itself */
+#ifndef IMU_RAW_QUEUE_EVENT
+#define IMU_RAW_QUEUE_EVENT true
+#endif
+
 /** By default gyro signs are positive for single IMU with old format or defaults */
 #if defined(IMU_GYRO_CALIB) && (defined(IMU_GYRO_P_SIGN) || defined(IMU_GYRO_Q_SIGN) || defined(IMU_GYRO_R_SIGN))
 #warning "The IMU_GYRO_?_SIGN's aren't compatible with the IMU_GYRO_CALIB define in the airframe"
@@ -335,11 +377,33 @@ static void send_mag_current(struct transport_tx *trans, struct link_device *dev
 #endif /* PERIODIC_TELEMETRY */
 
 struct Imu imu = {0};
+struct imu_queue_stats_t imu_queue_stats = {0};
+
+#if IMU_RAW_QUEUE
+/** Raw sample type in the queue */
+#define IMU_RAW_GYRO  0
+#define IMU_RAW_ACCEL 1
+
+/** Timestamped raw sample in the queue */
+struct imu_raw_sample_t {
+  uint32_t stamp;       ///< Timestamp of the sample (us)
+  float rate;           ///< Sample rate of the sensor (Hz)
+  float temp;           ///< Temperature (degrees celcius)
+  int32_t data[3];      ///< Raw gyro or accel sample
+  uint8_t sender_id;    ///< ABI sender id of the sensor
+  uint8_t type;         ///< IMU_RAW_GYRO or IMU_RAW_ACCEL
+};
+
+static struct imu_raw_sample_t imu_raw_buf[IMU_RAW_QUEUE_SIZE];
+static struct spsc_queue imu_raw_queue;
+#endif
+
 static abi_event imu_gyro_raw_ev, imu_accel_raw_ev, imu_mag_raw_ev;
 static void imu_gyro_raw_cb(uint8_t sender_id, uint32_t stamp, struct Int32Rates *data, uint8_t samples, float rate, float temp);
 static void imu_accel_raw_cb(uint8_t sender_id, uint32_t stamp, struct Int32Vect3 *data, uint8_t samples, float rate, float temp);
 static void imu_mag_raw_cb(uint8_t sender_id, uint32_t stamp, struct Int32Vect3 *data);
 static void imu_set_body_to_imu_eulers(struct FloatEulers *body_to_imu_eulers);
+static void imu_update_scale_q(int32_t scale_q[3], const int32_t *num, const int32_t *den);
 
 void imu_init(void)
 {
@@ -379,6 +443,7 @@ void imu_init(void)
       RATES_ASSIGN(imu.gyros[i].scale[0], IMU_GYRO_P_SIGN, IMU_GYRO_Q_SIGN, IMU_GYRO_R_SIGN);
       RATES_ASSIGN(imu.gyros[i].scale[1], 1, 1, 1);
     }
+    imu_update_scale_q(imu.gyros[i].scale_q, (const int32_t *)&imu.gyros[i].scale[0], (const int32_t *)&imu.gyros[i].scale[1]);
     if(!imu.gyros[i].calibrated.rotation) {
       int32_rmat_identity(&imu.gyros[i].body_to_sensor);
     }
@@ -412,6 +477,7 @@ void imu_init(void)
       VECT3_ASSIGN(imu.accels[i].scale[0], IMU_ACCEL_X_SIGN, IMU_ACCEL_Y_SIGN, IMU_ACCEL_Z_SIGN);
       VECT3_ASSIGN(imu.accels[i].scale[1], 1, 1, 1);
     }
+    imu_update_scale_q(imu.accels[i].scale_q, (const int32_t *)&imu.accels[i].scale[0], (const int32_t *)&imu.accels[i].scale[1]);
     if(!imu.accels[i].calibrated.rotation) {
       int32_rmat_identity(&imu.accels[i].body_to_sensor);
     }
@@ -455,6 +521,10 @@ void imu_init(void)
     RMAT_COPY(imu.mags[i].body_to_sensor, body_to_sensor);
   }
 
+#if IMU_RAW_QUEUE
+  spsc_queue_init(&imu_raw_queue, imu_raw_buf, IMU_RAW_QUEUE_SIZE, sizeof(struct imu_raw_sample_t));
+#endif
+
   // Bind to raw measurements
   AbiBindMsgIMU_GYRO_RAW(ABI_BROADCAST, &imu_gyro_raw_ev, imu_gyro_raw_cb);
   AbiBindMsgIMU_ACCEL_RAW(ABI_BROADCAST, &imu_accel_raw_ev, imu_accel_raw_cb);
@@ -507,6 +577,7 @@ void imu_set_defaults_gyro(uint8_t abi_id, const struct Int32RMat *imu_to_sensor
   if(scale != NULL && !gyro->calibrated.scale) {
     RATES_ASSIGN(gyro->scale[0], IMU_GYRO_P_SIGN*scale[0].p, IMU_GYRO_Q_SIGN*scale[0].q, IMU_GYRO_R_SIGN*scale[0].r);
     RATES_COPY(gyro->scale[1], scale[1]);
+    imu_update_scale_q(gyro->scale_q, (const int32_t *)&gyro->scale[0], (const int32_t *)&gyro->scale[1]);
   }
 }
 
@@ -537,6 +608,7 @@ void imu_set_defaults_accel(uint8_t abi_id, const struct Int32RMat *imu_to_senso
   if(scale != NULL && !accel->calibrated.scale) {
     VECT3_ASSIGN(accel->scale[0], IMU_ACCEL_X_SIGN*scale[0].x, IMU_ACCEL_Y_SIGN*scale[0].y, IMU_ACCEL_Z_SIGN*scale[0].z);
     VECT3_COPY(accel->scale[1], scale[1]);
+    imu_update_scale_q(accel->scale_q, (const int32_t *)&accel->scale[0], (const int32_t *)&accel->scale[1]);
   }
 }
 
@@ -570,82 +642,226 @@ void imu_set_defaults_mag(uint8_t abi_id, const struct Int32RMat *imu_to_sensor,
   }
 }
 
-static void imu_gyro_raw_cb(uint8_t sender_id, uint32_t stamp, struct Int32Rates *data, uint8_t samples, float rate, float temp)
+/**
+ * @brief Update the calibration of a gyro sensor, e.g. from an online calibration
+ * Unlike the defaults, this overrides the calibration of the airframe file
+ * @param abi_id The ABI sender id of the sensor
+ * @param neutral Neutral values or NULL to keep them
+ * @param scale Scale values with their sign or NULL to keep them, 0 index is multiply and 1 index is divide
+ */
+void imu_set_calibration_gyro(uint8_t abi_id, const struct Int32Rates *neutral, const struct Int32Rates *scale)
+{
+  struct imu_gyro_t *gyro = imu_get_gyro(abi_id, false);
+  if(gyro == NULL)
+    return;
+
+  if(neutral != NULL) {
+    RATES_COPY(gyro->neutral, *neutral);
+    gyro->calibrated.neutral = true;
+  }
+  if(scale != NULL) {
+    RATES_COPY(gyro->scale[0], scale[0]);
+    RATES_COPY(gyro->scale[1], scale[1]);
+    imu_update_scale_q(gyro->scale_q, (const int32_t *)&gyro->scale[0], (const int32_t *)&gyro->scale[1]);
+    gyro->calibrated.scale = true;
+  }
+}
+
+/**
+ * @brief Update the calibration of an accel sensor, e.g. from an online calibration
+ * Unlike the defaults, this overrides the calibration of the airframe file
+ * @param abi_id The ABI sender id of the sensor
+ * @param neutral Neutral values or NULL to keep them
+ * @param scale Scale values with their sign or NULL to keep them, 0 index is multiply and 1 index is divide
+ */
+void imu_set_calibration_accel(uint8_t abi_id, const struct Int32Vect3 *neutral, const struct Int32Vect3 *scale)
+{
+  struct imu_accel_t *accel = imu_get_accel(abi_id, false);
+  if(accel == NULL)
+    return;
+
+  if(neutral != NULL) {
+    VECT3_COPY(accel->neutral, *neutral);
+    accel->calibrated.neutral = true;
+  }
+  if(scale != NULL) {
+    VECT3_COPY(accel->scale[0], scale[0]);
+    VECT3_COPY(accel->scale[1], scale[1]);
+    imu_update_scale_q(accel->scale_q, (const int32_t *)&accel->scale[0], (const int32_t *)&accel->scale[1]);
+    accel->calibrated.scale = true;
+  }
+}
+
+/**
+ * @brief Update the calibration of a mag sensor, e.g. from an online calibration
+ * Unlike the defaults, this overrides the calibration of the airframe file
+ * @param abi_id The ABI sender id of the sensor
+ * @param neutral Neutral values or NULL to keep them
+ * @param scale Scale values with their sign or NULL to keep them, 0 index is multiply and 1 index is divide
+ */
+void imu_set_calibration_mag(uint8_t abi_id, const struct Int32Vect3 *neutral, const struct Int32Vect3 *scale)
+{
+  struct imu_mag_t *mag = imu_get_mag(abi_id, false);
+  if(mag == NULL)
+    return;
+
+  if(neutral != NULL) {
+    VECT3_COPY(mag->neutral, *neutral);
+    mag->calibrated.neutral = true;
+  }
+  if(scale != NULL) {
+    VECT3_COPY(mag->scale[0], scale[0]);
+    VECT3_COPY(mag->scale[1], scale[1]);
+    mag->calibrated.scale = true;
+  }
+}
+
+/**
+ * @brief Precompute the fixed point scale factors of a sensor
+ * This avoids two divisions per axis and per sample when scaling a burst
+ * @param scale_q Resulting scale[0] / scale[1] with IMU_SCALE_FRAC bits
+ * @param num Scale numerator (3 axis)
+ * @param den Scale denominator (3 axis)
+ */
+static void imu_update_scale_q(int32_t scale_q[3], const int32_t *num, const int32_t *den)
+{
+  for(uint8_t j = 0; j < 3; j++) {
+    scale_q[j] = imu_scale_q(num[j], den[j]);
+  }
+}
+
+/**
+ * @brief Filter and scale a burst of raw samples
+ * The burst is processed axis by axis so that the filter state, neutral and
+ * scale factor of an axis stay in registers for all the samples.
+ * The filter banks of filter_bank.h are not used: they update many channels
+ * for one sample, while here there are only 3 channels and the recursion is
+ * over the samples of the burst, which can't be vectorized.
+ * @param samples Number of samples in the burst, at most IMU_MAX_BURST
+ * @param[out] scaled Scaled samples in sensor frame, per axis
+ * @param[in] raw Raw samples, 3 consecutive int32 per sample (Int32Rates or Int32Vect3)
+ * @param[out] unscaled Last (filtered) raw sample
+ * @param neutral Neutral of each axis
+ * @param scale_q Fixed point scale factor of each axis
+ * @param filter Lowpass filter of each axis or NULL when not filtering
+ */
+static void imu_scale_burst(uint8_t samples, int32_t scaled[3][IMU_MAX_BURST], const int32_t *raw, int32_t *unscaled,
+                            const int32_t *neutral, const int32_t *scale_q, Butterworth2LowPass *filter)
+{
+  for(uint8_t j = 0; j < 3; j++) {
+    const int32_t neutral_j = neutral[j];
+    const int64_t scale_j = scale_q[j];
+    int32_t x = 0;
+    if(filter != NULL) {
+      Butterworth2LowPass f = filter[j];
+      for(uint8_t i = 0; i < samples; i++) {
+        x = update_butterworth_2_low_pass(&f, raw[3 * i + j]);
+        scaled[j][i] = imu_scale_apply(x - neutral_j, scale_j);
+      }
+      filter[j] = f;
+    } else {
+      for(uint8_t i = 0; i < samples; i++) {
+        x = raw[3 * i + j];
+        scaled[j][i] = imu_scale_apply(x - neutral_j, scale_j);
+      }
+    }
+    unscaled[j] = x;
+  }
+}
+
+#if IMU_INTEGRATION
+/** Delta angles of the last gyro burst, used for the sculling correction of the accel */
+struct imu_gyro_burst_t {
+  uint32_t stamp;                                         ///< Timestamp of the burst
+  uint8_t samples;                                        ///< Number of delta angles stored
+  struct FloatVect3 rate;                                 ///< Mean rate over the burst in body frame (rad/s)
+  struct FloatVect3 delta[IMU_INTEGRATION_MAX_BURST];     ///< Delta angle of each sample in body frame (rad)
+  struct FloatVect3 last_delta;                           ///< Last delta angle, kept for the coning correction
+};
+
+/** Previous increments of the accel integration, used for the sculling correction */
+struct imu_accel_burst_t {
+  struct FloatVect3 last_dalpha;  ///< Last delta angle (rad)
+  struct FloatVect3 last_dv;      ///< Last delta velocity (m/s)
+};
+
+static struct imu_gyro_burst_t imu_gyro_bursts[IMU_MAX_SENSORS];
+static struct imu_accel_burst_t imu_accel_bursts[IMU_MAX_SENSORS];
+#endif
+
+static void imu_gyro_process(uint8_t sender_id, uint32_t stamp, struct Int32Rates *data, uint8_t samples, float rate, float temp)
 {
   // Find the correct gyro
   struct imu_gyro_t *gyro = imu_get_gyro(sender_id, true);
   if(gyro == NULL || samples < 1)
     return;
 
-  // Filter the gyro
-  struct Int32Rates data_filtered[samples];
-  if(gyro->calibrated.filter) {
-    for(uint8_t i = 0; i < samples; i++) {
-      data_filtered[i].p = update_butterworth_2_low_pass(&gyro->filter[0], data[i].p);
-      data_filtered[i].q = update_butterworth_2_low_pass(&gyro->filter[1], data[i].q);
-      data_filtered[i].r = update_butterworth_2_low_pass(&gyro->filter[2], data[i].r);
-    }
-    data = data_filtered;
+  // Keep the newest samples of a too long burst
+  if(samples > IMU_MAX_BURST) {
+    data += samples - IMU_MAX_BURST;
+    samples = IMU_MAX_BURST;
   }
 
-  // Copy last sample as unscaled
-  RATES_COPY(gyro->unscaled, data[samples-1]);
+  // Filter and scale the whole burst (Int32Rates are 3 consecutive int32)
+  int32_t burst[3][IMU_MAX_BURST];
+  imu_scale_burst(samples, burst, (const int32_t *)data, (int32_t *)&gyro->unscaled,
+                  (const int32_t *)&gyro->neutral, gyro->scale_q, gyro->calibrated.filter ? gyro->filter : NULL);
 
-  // Scale the gyro
+  // Rotate the last sample
   struct Int32Rates scaled, scaled_rot;
-  scaled.p = (gyro->unscaled.p - gyro->neutral.p) * gyro->scale[0].p / gyro->scale[1].p;
-  scaled.q = (gyro->unscaled.q - gyro->neutral.q) * gyro->scale[0].q / gyro->scale[1].q;
-  scaled.r = (gyro->unscaled.r - gyro->neutral.r) * gyro->scale[0].r / gyro->scale[1].r;
-
-  // Rotate the sensor
+  RATES_ASSIGN(scaled, burst[0][samples-1], burst[1][samples-1], burst[2][samples-1]);
   int32_rmat_transp_ratemult(&scaled_rot, &gyro->body_to_sensor, &scaled);
 
 #if IMU_INTEGRATION
+  struct imu_gyro_burst_t *gb = &imu_gyro_bursts[gyro - imu.gyros];
   // Only integrate if we have gotten a previous measurement and didn't overflow the timer
   if(!isnan(rate) && gyro->last_stamp > 0 && stamp > gyro->last_stamp) {
-    struct FloatRates integrated;
+    struct FloatRMat body_to_sensor;
+    RMAT_FLOAT_OF_BFP(body_to_sensor, gyro->body_to_sensor);
+    const float dt = 1.f / rate;
 
-    // Trapezoidal integration (TODO: coning correction)
-    integrated.p = RATE_FLOAT_OF_BFP(gyro->scaled.p + scaled_rot.p) * 0.5f;
-    integrated.q = RATE_FLOAT_OF_BFP(gyro->scaled.q + scaled_rot.q) * 0.5f;
-    integrated.r = RATE_FLOAT_OF_BFP(gyro->scaled.r + scaled_rot.r) * 0.5f;
-
-    // Only perform multiple integrations in sensor frame if needed
-    if(samples > 1) {
-      struct FloatRates integrated_sensor;
-      struct FloatRMat body_to_sensor;
-      // Rotate back to sensor frame
-      RMAT_FLOAT_OF_BFP(body_to_sensor, gyro->body_to_sensor);
-      float_rmat_ratemult(&integrated_sensor, &body_to_sensor, &integrated);
-
-      // Add all the other samples
-      for(uint8_t i = 0; i < samples-1; i++) {
-        struct FloatRates f_sample;
-        f_sample.p = RATE_FLOAT_OF_BFP((data[i].p - gyro->neutral.p) * gyro->scale[0].p / gyro->scale[1].p);
-        f_sample.q = RATE_FLOAT_OF_BFP((data[i].q - gyro->neutral.q) * gyro->scale[0].q / gyro->scale[1].q);
-        f_sample.r = RATE_FLOAT_OF_BFP((data[i].r - gyro->neutral.r) * gyro->scale[0].r / gyro->scale[1].r);
+    // Delta angle of each sample in body frame with coning correction
+    struct FloatVect3 alpha = {0.f, 0.f, 0.f}, beta = {0.f, 0.f, 0.f};
+    for(uint8_t i = 0; i < samples; i++) {
+      struct FloatVect3 f_sample, dalpha;
+      f_sample.x = RATE_FLOAT_OF_BFP(burst[0][i]);
+      f_sample.y = RATE_FLOAT_OF_BFP(burst[1][i]);
+      f_sample.z = RATE_FLOAT_OF_BFP(burst[2][i]);
 
 #if IMU_LOG_HIGHSPEED
-        pprz_msg_send_IMU_GYRO(&pprzlog_tp.trans_tx, &(IMU_LOG_HIGHSPEED_DEVICE).device, AC_ID, &sender_id, &f_sample.p, &f_sample.q, &f_sample.r);
+      if(i < samples-1) {
+        pprz_msg_send_IMU_GYRO(&pprzlog_tp.trans_tx, &(IMU_LOG_HIGHSPEED_DEVICE).device, AC_ID, &sender_id, &f_sample.x, &f_sample.y, &f_sample.z);
+      }
 #endif
 
-        integrated_sensor.p += f_sample.p;
-        integrated_sensor.q += f_sample.q;
-        integrated_sensor.r += f_sample.r;
+      float_rmat_transp_vmult(&dalpha, &body_to_sensor, &f_sample);
+      if(i == samples - 1) {
+        // previous convention: the last sample is averaged with the last one of the previous burst
+        struct FloatVect3 last = {RATE_FLOAT_OF_BFP(gyro->scaled.p), RATE_FLOAT_OF_BFP(gyro->scaled.q), RATE_FLOAT_OF_BFP(gyro->scaled.r)};
+        VECT3_ADD(dalpha, last);
+        VECT3_SMUL(dalpha, dalpha, 0.5f * dt);
+      } else {
+        VECT3_SMUL(dalpha, dalpha, dt);
       }
-
-      // Rotate to body frame
-      float_rmat_transp_ratemult(&integrated, &body_to_sensor, &integrated_sensor);
+      if(i < IMU_INTEGRATION_MAX_BURST) {
+        gb->delta[i] = dalpha;
+      }
+      imu_coning_update(&alpha, &beta, &gb->last_delta, &dalpha);
     }
 
-    // Divide by the time of the collected samples
-    integrated.p = integrated.p * (1.f / rate);
-    integrated.q = integrated.q * (1.f / rate);
-    integrated.r = integrated.r * (1.f / rate);
+    // Keep the burst for the sculling correction of the accel
+    gb->stamp = stamp;
+    gb->samples = Min(samples, IMU_INTEGRATION_MAX_BURST);
+    VECT3_SMUL(gb->rate, alpha, rate / samples);
 
     // Send the integrated values
-    uint16_t dt = (1e6 / rate) * samples;
-    AbiSendMsgIMU_GYRO_INT(sender_id, stamp, &integrated, dt);
+    struct FloatRates integrated;
+    RATES_ASSIGN(integrated, alpha.x + beta.x, alpha.y + beta.y, alpha.z + beta.z);
+    uint16_t dt_us = (1e6 / rate) * samples;
+    AbiSendMsgIMU_GYRO_INT(sender_id, stamp, &integrated, dt_us);
+  } else {
+    // Restart the integration
+    memset(gb, 0, sizeof(struct imu_gyro_burst_t));
   }
 #else
   (void)rate; // Surpress compile warning not used
@@ -664,82 +880,87 @@ static void imu_gyro_raw_cb(uint8_t sender_id, uint32_t stamp, struct Int32Rates
   gyro->last_stamp = stamp;
 }
 
-static void imu_accel_raw_cb(uint8_t sender_id, uint32_t stamp, struct Int32Vect3 *data, uint8_t samples, float rate, float temp)
+static void imu_accel_process(uint8_t sender_id, uint32_t stamp, struct Int32Vect3 *data, uint8_t samples, float rate, float temp)
 {
   // Find the correct accel
   struct imu_accel_t *accel = imu_get_accel(sender_id, true);
   if(accel == NULL || samples < 1)
     return;
 
-  // Filter the accel
-  struct Int32Vect3 data_filtered[samples];
-  if(accel->calibrated.filter) {
-    for(uint8_t i = 0; i < samples; i++) {
-      data_filtered[i].x = update_butterworth_2_low_pass(&accel->filter[0], data[i].x);
-      data_filtered[i].y = update_butterworth_2_low_pass(&accel->filter[1], data[i].y);
-      data_filtered[i].z = update_butterworth_2_low_pass(&accel->filter[2], data[i].z);
-    }
-    data = data_filtered;
+  // Keep the newest samples of a too long burst
+  if(samples > IMU_MAX_BURST) {
+    data += samples - IMU_MAX_BURST;
+    samples = IMU_MAX_BURST;
   }
 
-  // Copy last sample as unscaled
-  VECT3_COPY(accel->unscaled, data[samples-1]);
+  // Filter and scale the whole burst
+  int32_t burst[3][IMU_MAX_BURST];
+  imu_scale_burst(samples, burst, (const int32_t *)data, (int32_t *)&accel->unscaled,
+                  (const int32_t *)&accel->neutral, accel->scale_q, accel->calibrated.filter ? accel->filter : NULL);
 
-  // Scale the accel
+  // Rotate the last sample
   struct Int32Vect3 scaled, scaled_rot;
-  scaled.x = (accel->unscaled.x - accel->neutral.x) * accel->scale[0].x / accel->scale[1].x;
-  scaled.y = (accel->unscaled.y - accel->neutral.y) * accel->scale[0].y / accel->scale[1].y;
-  scaled.z = (accel->unscaled.z - accel->neutral.z) * accel->scale[0].z / accel->scale[1].z;
-
-  // Rotate the sensor
+  VECT3_ASSIGN(scaled, burst[0][samples-1], burst[1][samples-1], burst[2][samples-1]);
   int32_rmat_transp_vmult(&scaled_rot, &accel->body_to_sensor, &scaled);
 
 #if IMU_INTEGRATION
+  struct imu_accel_burst_t *ab = &imu_accel_bursts[accel - imu.accels];
   // Only integrate if we have gotten a previous measurement and didn't overflow the timer
   if(!isnan(rate) && accel->last_stamp > 0 && stamp > accel->last_stamp) {
-    struct FloatVect3 integrated;
-
-    // Trapezoidal integration
-    integrated.x = ACCEL_FLOAT_OF_BFP(accel->scaled.x + scaled_rot.x) * 0.5f;
-    integrated.y = ACCEL_FLOAT_OF_BFP(accel->scaled.y + scaled_rot.y) * 0.5f;
-    integrated.z = ACCEL_FLOAT_OF_BFP(accel->scaled.z + scaled_rot.z) * 0.5f;
-
-    // Only perform multiple integrations in sensor frame if needed
-    if(samples > 1) {
-      struct FloatVect3 integrated_sensor;
-      struct FloatRMat body_to_sensor;
-      // Rotate back to sensor frame
-      RMAT_FLOAT_OF_BFP(body_to_sensor, accel->body_to_sensor);
-      float_rmat_vmult(&integrated_sensor, &body_to_sensor, &integrated);
-
-      // Add all the other samples
-      for(uint8_t i = 0; i < samples-1; i++) {
-        struct FloatVect3 f_sample;
-        f_sample.x = ACCEL_FLOAT_OF_BFP((data[i].x - accel->neutral.x) * accel->scale[0].x / accel->scale[1].x);
-        f_sample.y = ACCEL_FLOAT_OF_BFP((data[i].y - accel->neutral.y) * accel->scale[0].y / accel->scale[1].y);
-        f_sample.z = ACCEL_FLOAT_OF_BFP((data[i].z - accel->neutral.z) * accel->scale[0].z / accel->scale[1].z);
+    struct FloatRMat body_to_sensor;
+    RMAT_FLOAT_OF_BFP(body_to_sensor, accel->body_to_sensor);
+    const float dt = 1.f / rate;
+
+    // Delta angles of the gyro from the same sensor, published just before in the same burst
+    // if available, otherwise the mean rate of its last burst is used
+    struct imu_gyro_t *gyro = imu_get_gyro(sender_id, false);
+    struct imu_gyro_burst_t *gb = (gyro != NULL) ? &imu_gyro_bursts[gyro - imu.gyros] : NULL;
+    const bool same_burst = (gb != NULL && gb->stamp == stamp && gb->samples == samples);
+    struct FloatVect3 dalpha_mean = {0.f, 0.f, 0.f};
+    if(gb != NULL) {
+      VECT3_SMUL(dalpha_mean, gb->rate, dt);
+    }
+
+    // Delta velocity of each sample in body frame with sculling correction
+    struct FloatVect3 alpha = {0.f, 0.f, 0.f}, v = {0.f, 0.f, 0.f}, scul = {0.f, 0.f, 0.f};
+    for(uint8_t i = 0; i < samples; i++) {
+      struct FloatVect3 f_sample, dv;
+      f_sample.x = ACCEL_FLOAT_OF_BFP(burst[0][i]);
+      f_sample.y = ACCEL_FLOAT_OF_BFP(burst[1][i]);
+      f_sample.z = ACCEL_FLOAT_OF_BFP(burst[2][i]);
 
 #if IMU_LOG_HIGHSPEED
+      if(i < samples-1) {
         pprz_msg_send_IMU_ACCEL(&pprzlog_tp.trans_tx, &(IMU_LOG_HIGHSPEED_DEVICE).device, AC_ID, &sender_id, &f_sample.x, &f_sample.y, &f_sample.z);
+      }
 #endif
 
-        integrated_sensor.x += f_sample.x;
-        integrated_sensor.y += f_sample.y;
-        integrated_sensor.z += f_sample.z;
+      float_rmat_transp_vmult(&dv, &body_to_sensor, &f_sample);
+      if(i == samples - 1) {
+        // previous convention: the last sample is averaged with the last one of the previous burst
+        struct FloatVect3 last;
+        ACCELS_FLOAT_OF_BFP(last, accel->scaled);
+        VECT3_ADD(dv, last);
+        VECT3_SMUL(dv, dv, 0.5f * dt);
+      } else {
+        VECT3_SMUL(dv, dv, dt);
       }
-
-      // Rotate to body frame
-      float_rmat_transp_vmult(&integrated, &body_to_sensor, &integrated_sensor);
+      imu_sculling_update(&alpha, &v, &scul, &ab->last_dalpha, &ab->last_dv,
+                          same_burst ? &gb->delta[i] : &dalpha_mean, &dv);
     }
 
-    // Divide by the time of the collected samples
-    integrated.x = integrated.x * (1.f / rate);
-    integrated.y = integrated.y * (1.f / rate);
-    integrated.z = integrated.z * (1.f / rate);
+    // Rotation compensation 1/2 alpha x v and sculling correction
+    struct FloatVect3 integrated, rot;
+    VECT3_CROSS_PRODUCT(rot, alpha, v);
+    VECT3_SUM_SCALED(integrated, v, rot, 0.5f);
+    VECT3_ADD(integrated, scul);
 
     // Send the integrated values
-    uint16_t dt = (1e6 / rate) * samples;
-    AbiSendMsgIMU_ACCEL_INT(sender_id, stamp, &integrated, dt);
+    uint16_t dt_us = (1e6 / rate) * samples;
+    AbiSendMsgIMU_ACCEL_INT(sender_id, stamp, &integrated, dt_us);
+  } else {
+    // Restart the integration
+    memset(ab, 0, sizeof(struct imu_accel_burst_t));
   }
 #else
   (void)rate; // Surpress compile warning not used
@@ -758,6 +979,129 @@ static void imu_accel_raw_cb(uint8_t sender_id, uint32_t stamp, struct Int32Vect
   accel->last_stamp = stamp;
 }
 
+#if IMU_RAW_QUEUE
+/**
+ * @brief Copy a burst of raw samples in the queue
+ * Each sample gets its own timestamp, the last one being the burst timestamp.
+ * Samples are dropped when the queue is full.
+ * @param type IMU_RAW_GYRO or IMU_RAW_ACCEL
+ * @param data Raw samples, 3 consecutive int32 per sample (Int32Rates or Int32Vect3)
+ */
+static void imu_queue_raw(uint8_t type, uint8_t sender_id, uint32_t stamp, const int32_t *data, uint8_t samples, float rate, float temp)
+{
+  const float period_us = isnan(rate) ? 0.f : 1e6f / rate;
+  for(uint8_t i = 0; i < samples; i++) {
+    struct imu_raw_sample_t *s = spsc_queue_reserve(&imu_raw_queue);
+    if(s == NULL) {
+      continue;
+    }
+    s->stamp = stamp - (uint32_t)((samples - 1 - i) * period_us);
+    s->rate = rate;
+    s->temp = temp;
+    s->data[0] = data[3 * i];
+    s->data[1] = data[3 * i + 1];
+    s->data[2] = data[3 * i + 2];
+    s->sender_id = sender_id;
+    s->type = type;
+    spsc_queue_commit(&imu_raw_queue);
+    imu_queue_stats.queued++;
+  }
+}
+#endif
+
+static void imu_gyro_raw_cb(uint8_t sender_id, uint32_t stamp, struct Int32Rates *data, uint8_t samples, float rate, float temp)
+{
+#if IMU_RAW_QUEUE
+  imu_queue_raw(IMU_RAW_GYRO, sender_id, stamp, (const int32_t *)data, samples, rate, temp);
+#else
+  imu_gyro_process(sender_id, stamp, data, samples, rate, temp);
+#endif
+}
+
+static void imu_accel_raw_cb(uint8_t sender_id, uint32_t stamp, struct Int32Vect3 *data, uint8_t samples, float rate, float temp)
+{
+#if IMU_RAW_QUEUE
+  imu_queue_raw(IMU_RAW_ACCEL, sender_id, stamp, (const int32_t *)data, samples, rate, temp);
+#else
+  imu_accel_process(sender_id, stamp, data, samples, rate, temp);
+#endif
+}
+
+/**
+ * @brief Process the raw samples waiting in the queue
+ * Consecutive samples of the same sensor are processed as one burst. Only
+ * the samples present when called are processed so that a fast producer
+ * can't keep the caller busy. This can be called from the estimation when
+ * IMU_RAW_QUEUE_EVENT is disabled, but always from the same thread.
+ */
+void imu_process_queue(void)
+{
+#if IMU_RAW_QUEUE
+  union {
+    struct Int32Rates gyro[IMU_RAW_QUEUE_MAX_BATCH];
+    struct Int32Vect3 accel[IMU_RAW_QUEUE_MAX_BATCH];
+  } batch;
+
+  uint32_t depth = spsc_queue_count(&imu_raw_queue);
+  imu_queue_stats.depth = depth;
+  if(depth > imu_queue_stats.depth_max) {
+    imu_queue_stats.depth_max = depth;
+  }
+  imu_queue_stats.dropped = imu_raw_queue.overruns;
+
+  while(depth > 0) {
+    struct imu_raw_sample_t *s = spsc_queue_front(&imu_raw_queue);
+    const uint8_t type = s->type;
+    const uint8_t sender_id = s->sender_id;
+    uint32_t stamp = 0;
+    float rate = 0.f, temp = 0.f;
+
+    // Collect the consecutive samples of this sensor
+    uint8_t nb = 0;
+    while(depth > 0 && nb < IMU_RAW_QUEUE_MAX_BATCH) {
+      s = spsc_queue_front(&imu_raw_queue);
+      if(s->type != type || s->sender_id != sender_id) {
+        break;
+      }
+      if(type == IMU_RAW_GYRO) {
+        RATES_ASSIGN(batch.gyro[nb], s->data[0], s->data[1], s->data[2]);
+      } else {
+        VECT3_ASSIGN(batch.accel[nb], s->data[0], s->data[1], s->data[2]);
+      }
+      stamp = s->stamp;
+      rate = s->rate;
+      temp = s->temp;
+      spsc_queue_release(&imu_raw_queue);
+      depth--;
+      nb++;
+    }
+
+    if(type == IMU_RAW_GYRO) {
+      imu_gyro_process(sender_id, stamp, batch.gyro, nb, rate, temp);
+    } else {
+      imu_accel_process(sender_id, stamp, batch.accel, nb, rate, temp);
+    }
+    imu_queue_stats.processed += nb;
+  }
+#endif
+}
+
+void imu_event(void)
+{
+#if IMU_RAW_QUEUE && IMU_RAW_QUEUE_EVENT
+  imu_process_queue();
+#endif
+}
+
+/**
+ * Report the raw samples queue statistics with an IMU_QUEUE message
+ */
+void imu_queue_report(void)
+{
+  DOWNLINK_SEND_IMU_QUEUE(DefaultChannel, DefaultDevice, &imu_queue_stats.queued, &imu_queue_stats.processed,
+                          &imu_queue_stats.dropped, &imu_queue_stats.depth, &imu_queue_stats.depth_max);
+}
+
 static void imu_mag_raw_cb(uint8_t sender_id, uint32_t stamp, struct Int32Vect3 *data)
 {
   // Find the correct mag
@@ -32,6 +32,7 @@
 #include "math/pprz_algebra_float.h"
 #include "math/pprz_orientation_conversion.h"
 #include "filters/low_pass_filter.h"
+#include "modules/imu/imu_burst.h"
 #include "generated/airframe.h"
 
 #ifndef IMU_MAX_SENSORS
@@ -55,6 +56,7 @@ struct imu_gyro_t {
   float temperature;                  ///< Temperature in degrees celcius
   struct Int32Rates neutral;          ///< Neutral values, compensation on unscaled->scaled
   struct Int32Rates scale[2];         ///< Scaling, first is numerator and second denominator
+  int32_t scale_q[3];                 ///< Precomputed scale[0] / scale[1] with IMU_SCALE_FRAC bits
   struct Int32RMat body_to_sensor;    ///< Rotation from body to sensor frame (body to imu combined with imu to sensor)
   float filter_freq;                  ///< Filter frequency
   float filter_sample_freq;           ///< Lowpass filter sample frequency (Hz)
@@ -70,6 +72,7 @@ struct imu_accel_t {
   float temperature;                  ///< Temperature in degrees celcius
   struct Int32Vect3 neutral;          ///< Neutral values, compensation on unscaled->scaled
   struct Int32Vect3 scale[2];         ///< Scaling, first is numerator and second denominator
+  int32_t scale_q[3];                 ///< Precomputed scale[0] / scale[1] with IMU_SCALE_FRAC bits
   struct Int32RMat body_to_sensor;    ///< Rotation from body to sensor frame (body to imu combined with imu to sensor)
   float filter_freq;                  ///< Lowpass filter frequency (Hz)
   float filter_sample_freq;           ///< Lowpass filter sample frequency (Hz)
@@ -108,12 +111,29 @@ struct Imu {
 /** global IMU state */
 extern struct Imu imu;
 
+/** Statistics of the raw samples queue (when IMU_RAW_QUEUE is enabled) */
+struct imu_queue_stats_t {
+  uint32_t queued;      ///< Number of raw samples queued by the drivers
+  uint32_t processed;   ///< Number of raw samples processed
+  uint32_t dropped;     ///< Number of raw samples dropped because the queue was full
+  uint16_t depth;       ///< Number of samples waiting in the queue at the last processing
+  uint16_t depth_max;   ///< Highest queue depth since startup
+};
+
+extern struct imu_queue_stats_t imu_queue_stats;
+
 /** External functions */
 extern void imu_init(void);
+extern void imu_event(void);
+extern void imu_process_queue(void);
+extern void imu_queue_report(void);
 
 extern void imu_set_defaults_gyro(uint8_t abi_id, const struct Int32RMat *imu_to_sensor, const struct Int32Rates *neutral, const struct Int32Rates *scale);
 extern void imu_set_defaults_accel(uint8_t abi_id, const struct Int32RMat *imu_to_sensor, const struct Int32Vect3 *neutral, const struct Int32Vect3 *scale);
 extern void imu_set_defaults_mag(uint8_t abi_id, const struct Int32RMat *imu_to_sensor, const struct Int32Vect3 *neutral, const struct Int32Vect3 *scale);
+extern void imu_set_calibration_gyro(uint8_t abi_id, const struct Int32Rates *neutral, const struct Int32Rates *scale);
+extern void imu_set_calibration_accel(uint8_t abi_id, const struct Int32Vect3 *neutral, const struct Int32Vect3 *scale);
+extern void imu_set_calibration_mag(uint8_t abi_id, const struct Int32Vect3 *neutral, const struct Int32Vect3 *scale);
 
 extern struct imu_gyro_t *imu_get_gyro(uint8_t sender_id, bool create);
 extern struct imu_accel_t *imu_get_accel(uint8_t sender_id, bool create);
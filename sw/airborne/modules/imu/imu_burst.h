@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file modules/imu/imu_burst.h
+ * Helpers of the IMU burst processing: fixed point scaling of the raw
+ * samples and coning/sculling compensated integration of the increments.
+ */
+
+#ifndef IMU_BURST_H
+#define IMU_BURST_H
+
+#include "std.h"
+#include "math/pprz_algebra_float.h"
+
+/** Fractional bits of the precomputed scale factors (scale[0] / scale[1]) */
+#define IMU_SCALE_FRAC 16
+
+/**
+ * @brief Fixed point scale factor num / den with IMU_SCALE_FRAC bits, rounded to nearest
+ */
+static inline int32_t imu_scale_q(int32_t num, int32_t den)
+{
+  const int64_t n = (int64_t)num << IMU_SCALE_FRAC;
+  const int64_t half = (den > 0 ? den : -den) / 2;
+  return (int32_t)((n >= 0 ? n + half : n - half) / den);
+}
+
+/**
+ * @brief Scale a sample with a fixed point factor, rounded to nearest
+ * Rounding is symmetric so that a zero mean signal keeps a zero mean.
+ * @param x Sample minus neutral
+ * @param scale_q Scale factor with IMU_SCALE_FRAC bits
+ */
+static inline int32_t imu_scale_apply(int32_t x, int64_t scale_q)
+{
+  const int64_t p = x * scale_q;
+  const int64_t half = 1 << (IMU_SCALE_FRAC - 1);
+  return (int32_t)(p >= 0 ? (p + half) >> IMU_SCALE_FRAC : -((half - p) >> IMU_SCALE_FRAC));
+}
+
+/**
+ * @brief Add a delta angle to a coning compensated integration
+ * beta += 1/2 (alpha + dalpha_prev / 6) x dalpha
+ * alpha += dalpha
+ * @param alpha Integrated delta angle
+ * @param beta Coning correction
+ * @param dalpha_prev Previous delta angle, updated to dalpha
+ * @param dalpha New delta angle
+ */
+static inline void imu_coning_update(struct FloatVect3 *alpha, struct FloatVect3 *beta,
+                                     struct FloatVect3 *dalpha_prev, const struct FloatVect3 *dalpha)
+{
+  struct FloatVect3 a, c;
+  VECT3_SUM_SCALED(a, *alpha, *dalpha_prev, 1.f / 6.f);
+  VECT3_CROSS_PRODUCT(c, a, *dalpha);
+  VECT3_ADD_SCALED(*beta, c, 0.5f);
+  VECT3_ADD(*alpha, *dalpha);
+  *dalpha_prev = *dalpha;
+}
+
+/**
+ * @brief Add a delta velocity to a sculling compensated integration
+ * scul += 1/2 ((alpha + dalpha_prev / 6) x dv + (v + dv_prev / 6) x dalpha)
+ * alpha += dalpha, v += dv
+ * The velocity change over the integration is then v + 1/2 alpha x v + scul.
+ * @param alpha Integrated delta angle
+ * @param v Integrated delta velocity
+ * @param scul Sculling correction
+ * @param dalpha_prev Previous delta angle, updated to dalpha
+ * @param dv_prev Previous delta velocity, updated to dv
+ * @param dalpha New delta angle
+ * @param dv New delta velocity
+ */
+static inline void imu_sculling_update(struct FloatVect3 *alpha, struct FloatVect3 *v, struct FloatVect3 *scul,
+                                       struct FloatVect3 *dalpha_prev, struct FloatVect3 *dv_prev,
+                                       const struct FloatVect3 *dalpha, const struct FloatVect3 *dv)
+{
+  struct FloatVect3 a, b, c;
+  VECT3_SUM_SCALED(a, *alpha, *dalpha_prev, 1.f / 6.f);
+  VECT3_CROSS_PRODUCT(c, a, *dv);
+  VECT3_ADD_SCALED(*scul, c, 0.5f);
+  VECT3_SUM_SCALED(b, *v, *dv_prev, 1.f / 6.f);
+  VECT3_CROSS_PRODUCT(c, b, *dalpha);
+  VECT3_ADD_SCALED(*scul, c, 0.5f);
+  VECT3_ADD(*alpha, *dalpha);
+  VECT3_ADD(*v, *dv);
+  *dalpha_prev = *dalpha;
+  *dv_prev = *dv;
+}
+
+#endif /* IMU_BURST_H */
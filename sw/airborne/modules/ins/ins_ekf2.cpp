@@ -273,6 +273,78 @@ PRINT_CONFIG_VAR(INS_EKF2_GPS_P_NOISE)
 #endif
 PRINT_CONFIG_VAR(INS_EKF2_BARO_NOISE)
 
+/** Number of EKF2 lanes.
+ * With more than one lane, each lane runs its own Ekf instance in a worker
+ * thread (Linux only), fed through a lock-free sample queue from the ABI
+ * callbacks. The healthiest lane is published to the state interface.
+ */
+#ifndef INS_EKF2_NB_LANES
+#define INS_EKF2_NB_LANES 1
+#endif
+PRINT_CONFIG_VAR(INS_EKF2_NB_LANES)
+
+#if INS_EKF2_NB_LANES > 1
+#ifndef __linux__
+#error "ins_ekf2: multiple lanes are only supported on Linux"
+#endif
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <errno.h>
+#include <stdio.h>
+#include <new>
+extern "C" {
+#include "rt_priority.h"
+}
+#include "utils/spsc_queue.h"
+#include "utils/seqlock.h"
+
+/* Gyro ABI sender id of each lane, e.g. {IMU_BOARD_ID, IMU_MPU9250_ID} */
+#ifndef INS_EKF2_LANES_GYRO_ID
+#error "ins_ekf2: INS_EKF2_LANES_GYRO_ID must list the gyro of each lane"
+#endif
+
+/* Accelerometer ABI sender id of each lane, same IMU as the gyro by default */
+#ifndef INS_EKF2_LANES_ACCEL_ID
+#define INS_EKF2_LANES_ACCEL_ID INS_EKF2_LANES_GYRO_ID
+#endif
+
+/* Magnetometer fusion type of each lane (see mag_fusion setting), AUTO by default */
+#ifndef INS_EKF2_LANES_MAG_TYPE
+#define INS_EKF2_LANES_MAG_TYPE {}
+#endif
+
+/* Number of samples queued per lane, must be a power of two */
+#ifndef INS_EKF2_LANES_QUEUE_SIZE
+#define INS_EKF2_LANES_QUEUE_SIZE 64
+#endif
+PRINT_CONFIG_VAR(INS_EKF2_LANES_QUEUE_SIZE)
+
+/* Default scheduling of the lane threads, can be overridden with rt_threads (EKF2) */
+#ifndef INS_EKF2_LANES_PRIO
+#define INS_EKF2_LANES_PRIO 25
+#endif
+PRINT_CONFIG_VAR(INS_EKF2_LANES_PRIO)
+
+/* A lane without output for this time (ms) is unhealthy */
+#ifndef INS_EKF2_LANES_TIMEOUT
+#define INS_EKF2_LANES_TIMEOUT 100
+#endif
+PRINT_CONFIG_VAR(INS_EKF2_LANES_TIMEOUT)
+
+/* Switch to a healthy lane when its test ratio is lower by this margin... */
+#ifndef INS_EKF2_LANES_SWITCH_MARGIN
+#define INS_EKF2_LANES_SWITCH_MARGIN 0.3f
+#endif
+PRINT_CONFIG_VAR(INS_EKF2_LANES_SWITCH_MARGIN)
+
+/* ...during this time (ms) */
+#ifndef INS_EKF2_LANES_SWITCH_TIME
+#define INS_EKF2_LANES_SWITCH_TIME 1000
+#endif
+PRINT_CONFIG_VAR(INS_EKF2_LANES_SWITCH_TIME)
+#endif /* INS_EKF2_NB_LANES > 1 */
+
 /* All registered ABI events */
 static abi_event baro_ev;
 static abi_event temperature_ev;
@@ -294,13 +366,163 @@ static void gps_cb(uint8_t sender_id, uint32_t stamp, struct GpsState *gps_s);
 static void optical_flow_cb(uint8_t sender_id, uint32_t stamp, int32_t flow_x, int32_t flow_y, int32_t flow_der_x,
                             int32_t flow_der_y, float quality, float size_divergence);
 
+/** Outputs of an Ekf instance, used for the state and the telemetry */
+struct ekf2_output {
+  Quatf quat;
+  Vector3f pos;
+  Vector3f vel;
+  Vector3f vel_deriv;
+  Vector3f gyro_bias;
+  Vector3f accel_bias;
+  Vector3f mag_bias;
+  Vector2f wind;
+  float tas;
+  Vector3f vibe;
+  float gps_drift[3];
+  bool gps_blocked;
+  filter_control_status_u control_status;
+  uint32_t fault_status;
+  uint16_t gps_check_status;
+  uint16_t soln_status;
+  uint16_t innov_test_status;
+  float mag_test, vel_test, pos_test, hgt_test, tas_test, hagl_test, beta_test;
+  float mag_decl;
+  bool terrain_valid;
+  bool dead_reckoning;
+  bool attitude_valid;
+  float delta_q_reset[4];
+  uint8_t quat_reset_counter;
+  bool origin_valid;
+  uint64_t origin_time;
+  double origin_lat;
+  double origin_lon;
+  float origin_alt;
+};
+
 /* Static local functions */
-static void ins_ekf2_publish_attitude(uint32_t stamp);
+static void ins_ekf2_setup(Ekf &e, parameters *params, int32_t mag_fusion_type);
+static void ins_ekf2_get_output(Ekf &e, struct ekf2_output *out);
+static void ins_ekf2_telemetry_output(struct ekf2_output *out);
+static void ins_ekf2_publish_ned(const struct ekf2_output *out);
+static void ins_ekf2_publish_origin(const struct ekf2_output *out);
+static void ins_ekf2_reset_heading(float psi);
 
 /* Static local variables */
+struct ekf2_t ekf2;                               ///< Local EKF2 status structure
+
+#if INS_EKF2_NB_LANES > 1
+
+/** Types of samples sent to the lanes */
+enum ekf2_sample_type {
+  EKF2_SAMPLE_IMU,
+  EKF2_SAMPLE_MAG,
+  EKF2_SAMPLE_BARO,
+  EKF2_SAMPLE_RANGE,
+  EKF2_SAMPLE_GPS,
+  EKF2_SAMPLE_FLOW,
+  EKF2_SAMPLE_EV,
+  EKF2_SAMPLE_ORIGIN,
+  EKF2_SAMPLE_PARAM
+};
+
+/** Barometer sample with the air density computed from the temperature */
+struct ekf2_baro {
+  baroSample sample;
+  float rho;
+};
+
+/** New global origin */
+struct ekf2_origin {
+  double lat;
+  double lon;
+  float alt;
+};
+
+/** Settings of a lane, changed from the ground */
+struct ekf2_param {
+  int32_t fusion_mode;
+  int32_t mag_fusion_type;
+};
+
+template <typename T, typename... Ts> struct ekf2_max_size {
+  static const size_t value = sizeof(T) > ekf2_max_size<Ts...>::value ? sizeof(T) : ekf2_max_size<Ts...>::value;
+};
+template <typename T> struct ekf2_max_size<T> {
+  static const size_t value = sizeof(T);
+};
+
+/** Queued sample, the data is copy constructed in place */
+struct ekf2_sample {
+  uint8_t type;
+  alignas(8) uint8_t data[ekf2_max_size<imuSample, magSample, struct ekf2_baro, rangeSample, gps_message,
+                                       flowSample, extVisionSample, struct ekf2_origin, struct ekf2_param>::value];
+};
+
+/** Output of a lane, written by its thread and read by the selector */
+struct ekf2_lane_output {
+  struct ekf2_output ekf;
+  struct FloatRates rates;        ///< unbiased body rates
+  struct FloatVect3 accel;        ///< unbiased body accelerations
+  uint32_t stamp;                 ///< time of the last update (us)
+  uint32_t update_us;             ///< duration of the last update (us)
+  uint32_t update_max_us;         ///< longest update (us)
+};
+
+/** One EKF2 lane */
+struct ekf2_lane {
+  Ekf ekf;
+  uint8_t gyro_id;
+  uint8_t accel_id;
+
+  /* IMU pairing, producer side */
+  struct FloatRates delta_gyro;
+  struct FloatVect3 delta_accel;
+  uint32_t gyro_dt;
+  uint32_t accel_dt;
+  bool gyro_valid;
+  bool accel_valid;
+
+  /* commands kept until queued, never dropped */
+  struct ekf2_origin origin;
+  struct ekf2_param param;        ///< with the mag fusion type of the lane
+  bool origin_pending;
+  bool param_pending;
+
+  /* samples from the main thread to the lane thread */
+  struct spsc_queue queue;
+  struct ekf2_sample samples[INS_EKF2_LANES_QUEUE_SIZE];
+  sem_t sem;
+  pthread_t thread;
+
+  /* published by the lane thread */
+  struct seqlock lock;
+  struct ekf2_lane_output out;
+
+  /* lane thread only */
+  imuSample last_imu;
+
+  /* selector, main thread only */
+  struct ekf2_lane_output snap;   ///< last consistent copy of out
+  bool healthy;
+  float score;                    ///< largest innovation test ratio
+  uint8_t quat_reset_counter;
+};
+
+static struct ekf2_lane ekf2_lanes[INS_EKF2_NB_LANES];
+static struct ekf2_output ekf2_lanes_telemetry;   ///< output of the selected lane
+static uint32_t ekf2_lanes_better_since;          ///< time since another lane is better (us)
+static bool ekf2_lanes_in_air;
+static bool ekf2_lanes_switched;                  ///< republish the origin of the new lane
+
+#else /* INS_EKF2_NB_LANES == 1 */
+
 static Ekf ekf;                                   ///< EKF class itself
 static parameters *ekf_params;                    ///< The EKF parameters
-struct ekf2_t ekf2;                               ///< Local EKF2 status structure
+
+/* Static local functions */
+static void ins_ekf2_publish_attitude(uint32_t stamp);
+
+#endif
 
 #if PERIODIC_TELEMETRY
 #include "modules/datalink/telemetry.h"
@@ -308,22 +530,21 @@ struct ekf2_t ekf2;                               ///< Local EKF2 status structu
 static void send_ins(struct transport_tx *trans, struct link_device *dev)
 {
   struct NedCoor_i pos, speed, accel;
+  struct ekf2_output out;
 
   // Get it from the EKF
-  const Vector3f pos_f{ekf.getPosition()};
-  const Vector3f speed_f{ekf.getVelocity()};
-  const Vector3f accel_f{ekf.getVelocityDerivative()};
+  ins_ekf2_telemetry_output(&out);
 
   // Convert to integer
-  pos.x = POS_BFP_OF_REAL(pos_f(0));
-  pos.y = POS_BFP_OF_REAL(pos_f(1));
-  pos.z = POS_BFP_OF_REAL(pos_f(2));
-  speed.x = SPEED_BFP_OF_REAL(speed_f(0));
-  speed.y = SPEED_BFP_OF_REAL(speed_f(1));
-  speed.z = SPEED_BFP_OF_REAL(speed_f(2));
-  accel.x = ACCEL_BFP_OF_REAL(accel_f(0));
-  accel.y = ACCEL_BFP_OF_REAL(accel_f(1));
-  accel.z = ACCEL_BFP_OF_REAL(accel_f(2));
+  pos.x = POS_BFP_OF_REAL(out.pos(0));
+  pos.y = POS_BFP_OF_REAL(out.pos(1));
+  pos.z = POS_BFP_OF_REAL(out.pos(2));
+  speed.x = SPEED_BFP_OF_REAL(out.vel(0));
+  speed.y = SPEED_BFP_OF_REAL(out.vel(1));
+  speed.z = SPEED_BFP_OF_REAL(out.vel(2));
+  accel.x = ACCEL_BFP_OF_REAL(out.vel_deriv(0));
+  accel.y = ACCEL_BFP_OF_REAL(out.vel_deriv(1));
+  accel.z = ACCEL_BFP_OF_REAL(out.vel_deriv(2));
 
   // Send the message
   pprz_msg_send_INS(trans, dev, AC_ID,
@@ -336,16 +557,15 @@ static void send_ins_z(struct transport_tx *trans, struct link_device *dev)
 {
   float baro_z = 0.0f;
   int32_t pos_z, speed_z, accel_z;
+  struct ekf2_output out;
 
   // Get it from the EKF
-  const Vector3f pos_f{ekf.getPosition()};
-  const Vector3f speed_f{ekf.getVelocity()};
-  const Vector3f accel_f{ekf.getVelocityDerivative()};
+  ins_ekf2_telemetry_output(&out);
 
   // Convert to integer
-  pos_z = POS_BFP_OF_REAL(pos_f(2));
-  speed_z = SPEED_BFP_OF_REAL(speed_f(2));
-  accel_z = ACCEL_BFP_OF_REAL(accel_f(2));
+  pos_z = POS_BFP_OF_REAL(out.pos(2));
+  speed_z = SPEED_BFP_OF_REAL(out.vel(2));
+  accel_z = ACCEL_BFP_OF_REAL(out.vel_deriv(2));
 
   // Send the message
   pprz_msg_send_INS_Z(trans, dev, AC_ID,
@@ -364,56 +584,40 @@ static void send_ins_ref(struct transport_tx *trans, struct link_device *dev)
 
 static void send_ins_ekf2(struct transport_tx *trans, struct link_device *dev)
 {
-  uint16_t gps_check_status, soln_status;
-  uint16_t filter_fault_status = ekf.fault_status().value; // FIXME: 32bit instead of 16bit
-  uint32_t control_mode = ekf.control_status().value;
-  ekf.get_gps_check_status(&gps_check_status);
-  ekf.get_ekf_soln_status(&soln_status);
-
-  uint16_t innov_test_status;
-  float mag, vel, pos, hgt, tas, hagl, flow, beta, mag_decl;
-  uint8_t terrain_valid, dead_reckoning;
-  ekf.get_innovation_test_status(innov_test_status, mag, vel, pos, hgt, tas, hagl, beta);
-  //ekf.get_flow_innov(&flow);
-  ekf.get_mag_decl_deg(&mag_decl);
-
-  if (ekf.isTerrainEstimateValid()) {
-    terrain_valid = 1;
-  } else {
-    terrain_valid = 0;
-  }
+  struct ekf2_output out;
+  ins_ekf2_telemetry_output(&out);
 
-  if (ekf.inertial_dead_reckoning()) {
-    dead_reckoning = 1;
-  } else {
-    dead_reckoning = 0;
-  }
+  uint16_t filter_fault_status = out.fault_status; // FIXME: 32bit instead of 16bit
+  uint32_t control_mode = out.control_status.value;
+  float flow = 0.f;
+  uint8_t terrain_valid = out.terrain_valid;
+  uint8_t dead_reckoning = out.dead_reckoning;
 
   pprz_msg_send_INS_EKF2(trans, dev, AC_ID,
-                         &control_mode, &filter_fault_status, &gps_check_status, &soln_status,
-                         &innov_test_status, &mag, &vel, &pos, &hgt, &tas, &hagl, &flow, &beta,
-                         &mag_decl, &terrain_valid, &dead_reckoning);
+                         &control_mode, &filter_fault_status, &out.gps_check_status, &out.soln_status,
+                         &out.innov_test_status, &out.mag_test, &out.vel_test, &out.pos_test, &out.hgt_test,
+                         &out.tas_test, &out.hagl_test, &flow, &out.beta_test,
+                         &out.mag_decl, &terrain_valid, &dead_reckoning);
 }
 
 static void send_ins_ekf2_ext(struct transport_tx *trans, struct link_device *dev)
 {
-  float gps_drift[3];
-  Vector3f vibe = ekf.getImuVibrationMetrics();
-  bool gps_blocked;
-  uint8_t gps_blocked_b;
-  ekf.get_gps_drift_metrics(gps_drift, &gps_blocked);
-  gps_blocked_b = gps_blocked;
+  struct ekf2_output out;
+  ins_ekf2_telemetry_output(&out);
+  uint8_t gps_blocked_b = out.gps_blocked;
 
   pprz_msg_send_INS_EKF2_EXT(trans, dev, AC_ID,
-                             &gps_drift[0], &gps_drift[1], &gps_drift[2], &gps_blocked_b,
-                             &vibe(0), &vibe(1), &vibe(2));
+                             &out.gps_drift[0], &out.gps_drift[1], &out.gps_drift[2], &gps_blocked_b,
+                             &out.vibe(0), &out.vibe(1), &out.vibe(2));
 }
 
 static void send_filter_status(struct transport_tx *trans, struct link_device *dev)
 {
   uint8_t ahrs_ekf2_id = AHRS_COMP_ID_EKF2;
-  filter_control_status_u control_mode = ekf.control_status();
-  uint32_t filter_fault_status = ekf.fault_status().value;
+  struct ekf2_output out;
+  ins_ekf2_telemetry_output(&out);
+  filter_control_status_u control_mode = out.control_status;
+  uint32_t filter_fault_status = out.fault_status;
   uint16_t filter_fault_status_16 = filter_fault_status; //FIXME
   uint8_t mde = 0;
 
@@ -436,34 +640,33 @@ static void send_filter_status(struct transport_tx *trans, struct link_device *d
 
 static void send_wind_info_ret(struct transport_tx *trans, struct link_device *dev)
 {
-  float tas;
-  Vector2f wind = ekf.getWindVelocity();
+  struct ekf2_output out;
+  ins_ekf2_telemetry_output(&out);
   uint8_t flags = 0x5;
   float f_zero = 0;
 
-  ekf.get_true_airspeed(&tas);
-
-  pprz_msg_send_WIND_INFO_RET(trans, dev, AC_ID, &flags, &wind(1), &wind(0), &f_zero, &tas);
+  pprz_msg_send_WIND_INFO_RET(trans, dev, AC_ID, &flags, &out.wind(1), &out.wind(0), &f_zero, &out.tas);
 }
 
 static void send_ahrs_bias(struct transport_tx *trans, struct link_device *dev)
 {
-  Vector3f accel_bias = ekf.getAccelBias();
-  Vector3f gyro_bias = ekf.getGyroBias();
-  Vector3f mag_bias = ekf.getMagBias();
+  struct ekf2_output out;
+  ins_ekf2_telemetry_output(&out);
 
-  pprz_msg_send_AHRS_BIAS(trans, dev, AC_ID, &accel_bias(0), &accel_bias(1), &accel_bias(2),
-                          &gyro_bias(0), &gyro_bias(1), &gyro_bias(2), &mag_bias(0), &mag_bias(1), &mag_bias(2));
+  pprz_msg_send_AHRS_BIAS(trans, dev, AC_ID, &out.accel_bias(0), &out.accel_bias(1), &out.accel_bias(2),
+                          &out.gyro_bias(0), &out.gyro_bias(1), &out.gyro_bias(2),
+                          &out.mag_bias(0), &out.mag_bias(1), &out.mag_bias(2));
 }
 
 static void send_ahrs_quat(struct transport_tx *trans, struct link_device *dev)
 {
   struct Int32Quat ltp_to_body_quat;
-  const Quatf att_q{ekf.calculate_quaternion()};
-  ltp_to_body_quat.qi = QUAT1_BFP_OF_REAL(att_q(0));
-  ltp_to_body_quat.qx = QUAT1_BFP_OF_REAL(att_q(1));
-  ltp_to_body_quat.qy = QUAT1_BFP_OF_REAL(att_q(2));
-  ltp_to_body_quat.qz = QUAT1_BFP_OF_REAL(att_q(3));
+  struct ekf2_output out;
+  ins_ekf2_telemetry_output(&out);
+  ltp_to_body_quat.qi = QUAT1_BFP_OF_REAL(out.quat(0));
+  ltp_to_body_quat.qx = QUAT1_BFP_OF_REAL(out.quat(1));
+  ltp_to_body_quat.qy = QUAT1_BFP_OF_REAL(out.quat(2));
+  ltp_to_body_quat.qz = QUAT1_BFP_OF_REAL(out.quat(3));
   struct Int32Quat *quat = stateGetNedToBodyQuat_i();
   float foo = 0.f;
   uint8_t ahrs_id = 1; // generic
@@ -480,55 +683,462 @@ static void send_ahrs_quat(struct transport_tx *trans, struct link_device *dev)
                               &ahrs_id);
 }
 
+#if INS_EKF2_NB_LANES > 1
+/** Lanes status: selected lane and the status of each lane */
+static void send_ins_ekf2_lanes(struct transport_tx *trans, struct link_device *dev)
+{
+  uint8_t healthy[INS_EKF2_NB_LANES];
+  float test_ratio[INS_EKF2_NB_LANES];
+  uint32_t update_us[INS_EKF2_NB_LANES], update_max_us[INS_EKF2_NB_LANES], overruns[INS_EKF2_NB_LANES];
+  for (uint8_t i = 0; i < INS_EKF2_NB_LANES; i++) {
+    struct ekf2_lane *lane = &ekf2_lanes[i];
+    healthy[i] = lane->healthy;
+    test_ratio[i] = lane->score;
+    update_us[i] = lane->snap.update_us;
+    update_max_us[i] = lane->snap.update_max_us;
+    overruns[i] = lane->queue.overruns;
+  }
+  pprz_msg_send_INS_EKF2_LANES(trans, dev, AC_ID, &ekf2.lane, INS_EKF2_NB_LANES, healthy, INS_EKF2_NB_LANES, test_ratio,
+                               INS_EKF2_NB_LANES, update_us, INS_EKF2_NB_LANES, update_max_us,
+                               INS_EKF2_NB_LANES, overruns);
+}
 #endif
 
-/* Initialize the EKF */
-void ins_ekf2_init(void)
+#endif
+
+/** Get all the outputs of an Ekf instance */
+static void ins_ekf2_get_output(Ekf &e, struct ekf2_output *out)
 {
-  /* Get the ekf parameters */
-  ekf_params = ekf.getParamHandle();
-  ekf_params->fusion_mode = INS_EKF2_FUSION_MODE;
-  ekf_params->vdist_sensor_type = INS_EKF2_VDIST_SENSOR_TYPE;
-  ekf_params->gps_check_mask = INS_EKF2_GPS_CHECK_MASK;
+  out->quat = e.calculate_quaternion();
+  out->pos = e.getPosition();
+  out->vel = e.getVelocity();
+  out->vel_deriv = e.getVelocityDerivative();
+  out->gyro_bias = e.getGyroBias();
+  out->accel_bias = e.getAccelBias();
+  out->mag_bias = e.getMagBias();
+  out->wind = e.getWindVelocity();
+  e.get_true_airspeed(&out->tas);
+  out->vibe = e.getImuVibrationMetrics();
+  e.get_gps_drift_metrics(out->gps_drift, &out->gps_blocked);
+  out->control_status = e.control_status();
+  out->fault_status = e.fault_status().value;
+  e.get_gps_check_status(&out->gps_check_status);
+  e.get_ekf_soln_status(&out->soln_status);
+  e.get_innovation_test_status(out->innov_test_status, out->mag_test, out->vel_test, out->pos_test,
+                               out->hgt_test, out->tas_test, out->hagl_test, out->beta_test);
+  e.get_mag_decl_deg(&out->mag_decl);
+  out->terrain_valid = e.isTerrainEstimateValid();
+  out->dead_reckoning = e.inertial_dead_reckoning();
+  out->attitude_valid = e.attitude_valid();
+  e.get_quat_reset(out->delta_q_reset, &out->quat_reset_counter);
+  out->origin_valid = e.getEkfGlobalOrigin(out->origin_time, out->origin_lat, out->origin_lon, out->origin_alt);
+}
+
+/** Outputs sent in telemetry, from the single EKF or the selected lane */
+static void ins_ekf2_telemetry_output(struct ekf2_output *out)
+{
+#if INS_EKF2_NB_LANES > 1
+  *out = ekf2_lanes_telemetry;
+#else
+  ins_ekf2_get_output(ekf, out);
+#endif
+}
+
+/** Apply the airframe configuration to an Ekf instance */
+static void ins_ekf2_setup(Ekf &e, parameters *params, int32_t mag_fusion_type)
+{
+  params->fusion_mode = INS_EKF2_FUSION_MODE;
+  params->vdist_sensor_type = INS_EKF2_VDIST_SENSOR_TYPE;
+  params->gps_check_mask = INS_EKF2_GPS_CHECK_MASK;
+  params->mag_fusion_type = mag_fusion_type;
 
   /* Set specific noise levels */
-  ekf_params->accel_bias_p_noise = 3.0e-3f;
-  ekf_params->gps_vel_noise = INS_EKF2_GPS_V_NOISE;
-  ekf_params->gps_pos_noise = INS_EKF2_GPS_P_NOISE;
-  ekf_params->baro_noise = INS_EKF2_BARO_NOISE;
+  params->accel_bias_p_noise = 3.0e-3f;
+  params->gps_vel_noise = INS_EKF2_GPS_V_NOISE;
+  params->gps_pos_noise = INS_EKF2_GPS_P_NOISE;
+  params->baro_noise = INS_EKF2_BARO_NOISE;
 
   /* Set optical flow parameters */
-  ekf_params->flow_qual_min = INS_EKF2_MIN_FLOW_QUALITY;
-  ekf_params->flow_delay_ms = INS_EKF2_FLOW_SENSOR_DELAY;
-  ekf_params->range_delay_ms = INS_EKF2_FLOW_SENSOR_DELAY;
-  ekf_params->flow_noise = INS_EKF2_FLOW_NOISE;
-  ekf_params->flow_noise_qual_min = INS_EKF2_FLOW_NOISE_QMIN;
-  ekf_params->flow_innov_gate = INS_EKF2_FLOW_INNOV_GATE;
+  params->flow_qual_min = INS_EKF2_MIN_FLOW_QUALITY;
+  params->flow_delay_ms = INS_EKF2_FLOW_SENSOR_DELAY;
+  params->range_delay_ms = INS_EKF2_FLOW_SENSOR_DELAY;
+  params->flow_noise = INS_EKF2_FLOW_NOISE;
+  params->flow_noise_qual_min = INS_EKF2_FLOW_NOISE_QMIN;
+  params->flow_innov_gate = INS_EKF2_FLOW_INNOV_GATE;
 
   /* Set the IMU position relative from the CoG in xyz (m) */
-  ekf_params->imu_pos_body = {
+  params->imu_pos_body = {
     INS_EKF2_IMU_POS_X,
     INS_EKF2_IMU_POS_Y,
     INS_EKF2_IMU_POS_Z
   };
 
   /* Set the GPS position relative from the CoG in xyz (m) */
-  ekf_params->gps_pos_body = {
+  params->gps_pos_body = {
     INS_EKF2_GPS_POS_X,
     INS_EKF2_GPS_POS_Y,
     INS_EKF2_GPS_POS_Z
   };
 
   /* Set flow sensor offset from CoG position in xyz (m) */
-  ekf_params->flow_pos_body = {
+  params->flow_pos_body = {
     INS_EKF2_FLOW_POS_X,
     INS_EKF2_FLOW_POS_Y,
     INS_EKF2_FLOW_POS_Z
   };
 
   /* Set range as default AGL measurement if possible */
-  ekf_params->range_aid = INS_EKF2_RANGE_MAIN_AGL;
+  params->range_aid = INS_EKF2_RANGE_MAIN_AGL;
+
+  /* Initialize the range sensor limits */
+  e.set_rangefinder_limits(INS_EKF2_SONAR_MIN_RANGE, INS_EKF2_SONAR_MAX_RANGE);
+
+  /* Initialize the flow sensor limits */
+  e.set_optical_flow_limits(INS_EKF2_MAX_FLOW_RATE, INS_EKF2_SONAR_MIN_RANGE, INS_EKF2_SONAR_MAX_RANGE);
+}
+
+#if INS_EKF2_NB_LANES > 1
+
+/** Queue a sample to a lane, from the main thread
+ * @return false if the queue is full, counted as overrun
+ */
+template <typename T>
+static bool ins_ekf2_lane_queue(struct ekf2_lane *lane, uint8_t type, const T &data)
+{
+  struct ekf2_sample *s = (struct ekf2_sample *)spsc_queue_reserve(&lane->queue);
+  if (s == NULL) {
+    return false;
+  }
+  s->type = type;
+  new (s->data) T(data);
+  spsc_queue_commit(&lane->queue);
+  return true;
+}
+
+/** Queue the pending origin and settings of a lane
+ * @return true when nothing is pending anymore
+ */
+static bool ins_ekf2_lane_flush(struct ekf2_lane *lane)
+{
+  if (lane->origin_pending) {
+    lane->origin_pending = !ins_ekf2_lane_queue(lane, EKF2_SAMPLE_ORIGIN, lane->origin);
+  }
+  if (lane->param_pending && !lane->origin_pending) {
+    lane->param_pending = !ins_ekf2_lane_queue(lane, EKF2_SAMPLE_PARAM, lane->param);
+  }
+  return !lane->origin_pending && !lane->param_pending;
+}
+
+/** Queue a sample to a lane after the pending commands, from the main thread
+ * Samples are dropped rather than queued before a pending command.
+ */
+template <typename T>
+static void ins_ekf2_lane_push(struct ekf2_lane *lane, uint8_t type, const T &data)
+{
+  if ((lane->origin_pending || lane->param_pending) && !ins_ekf2_lane_flush(lane)) {
+    lane->queue.overruns++;
+    return;
+  }
+  ins_ekf2_lane_queue(lane, type, data);
+}
+
+/** Queue a sample to all lanes */
+template <typename T>
+static void ins_ekf2_lanes_push(uint8_t type, const T &data)
+{
+  for (uint8_t i = 0; i < INS_EKF2_NB_LANES; i++) {
+    ins_ekf2_lane_push(&ekf2_lanes[i], type, data);
+  }
+}
+
+/** Queue the paired gyro and accel sample and wake up the lane thread */
+static void ins_ekf2_lane_push_imu(struct ekf2_lane *lane, uint32_t stamp)
+{
+  imuSample imu_sample = {};
+  imu_sample.time_us = stamp;
+  imu_sample.delta_ang_dt = lane->gyro_dt * 1.e-6f;
+  imu_sample.delta_ang = Vector3f{lane->delta_gyro.p, lane->delta_gyro.q, lane->delta_gyro.r};
+  imu_sample.delta_vel_dt = lane->accel_dt * 1.e-6f;
+  imu_sample.delta_vel = Vector3f{lane->delta_accel.x, lane->delta_accel.y, lane->delta_accel.z};
+  ins_ekf2_lane_push(lane, EKF2_SAMPLE_IMU, imu_sample);
+
+  lane->gyro_valid = false;
+  lane->accel_valid = false;
+  sem_post(&lane->sem);
+}
+
+/**
+ * Give a queued sample to the Ekf of a lane, from the lane thread
+ * @return true for IMU samples
+ */
+static bool ins_ekf2_lane_apply(struct ekf2_lane *lane, struct ekf2_sample *s)
+{
+  Ekf &e = lane->ekf;
+  switch (s->type) {
+    case EKF2_SAMPLE_IMU:
+      lane->last_imu = *(imuSample *)s->data;
+      e.setIMUData(lane->last_imu);
+      return true;
+    case EKF2_SAMPLE_MAG:
+      e.setMagData(*(magSample *)s->data);
+      break;
+    case EKF2_SAMPLE_BARO: {
+      struct ekf2_baro *baro = (struct ekf2_baro *)s->data;
+      e.set_air_density(baro->rho);
+      e.setBaroData(baro->sample);
+      break;
+    }
+    case EKF2_SAMPLE_RANGE:
+      e.setRangeData(*(rangeSample *)s->data);
+      break;
+    case EKF2_SAMPLE_GPS:
+      e.setGpsData(*(gps_message *)s->data);
+      break;
+    case EKF2_SAMPLE_FLOW:
+      e.setOpticalFlowData(*(flowSample *)s->data);
+      break;
+    case EKF2_SAMPLE_EV:
+      e.setExtVisionData(*(extVisionSample *)s->data);
+      break;
+    case EKF2_SAMPLE_ORIGIN: {
+      struct ekf2_origin *origin = (struct ekf2_origin *)s->data;
+      e.setEkfGlobalOrigin(origin->lat, origin->lon, origin->alt);
+      break;
+    }
+    case EKF2_SAMPLE_PARAM: {
+      struct ekf2_param *param = (struct ekf2_param *)s->data;
+      parameters *params = e.getParamHandle();
+      params->fusion_mode = param->fusion_mode;
+      params->mag_fusion_type = param->mag_fusion_type;
+      break;
+    }
+    default:
+      break;
+  }
+  return false;
+}
+
+/** Lane thread: run the Ekf on the queued samples and publish its output */
+static void *ins_ekf2_lane_thread(void *arg)
+{
+  struct ekf2_lane *lane = (struct ekf2_lane *)arg;
+  struct ekf2_lane_output out = {};
+
+  rt_thread_setup("ekf2", RT_THREAD_FIFO, INS_EKF2_LANES_PRIO);
+
+  while (true) {
+    if (sem_wait(&lane->sem) != 0 && errno == EINTR) {
+      continue;
+    }
+
+    /* Drain the queue in one batch */
+    bool got_imu = false;
+    struct ekf2_sample *s;
+    while ((s = (struct ekf2_sample *)spsc_queue_front(&lane->queue)) != NULL) {
+      got_imu |= ins_ekf2_lane_apply(lane, s);
+      spsc_queue_release(&lane->queue);
+    }
+    if (!got_imu) {
+      continue;
+    }
+
+    uint32_t start = get_sys_time_usec();
+    lane->ekf.set_in_air_status(__atomic_load_n(&ekf2_lanes_in_air, __ATOMIC_RELAXED));
+    lane->ekf.update();
+    ins_ekf2_get_output(lane->ekf, &out.ekf);
+
+    /* Unbiased rates and accelerations of the last IMU sample */
+    const imuSample &imu = lane->last_imu;
+    if (imu.delta_ang_dt > 0.f && imu.delta_vel_dt > 0.f) {
+      out.rates.p = imu.delta_ang(0) / imu.delta_ang_dt - out.ekf.gyro_bias(0);
+      out.rates.q = imu.delta_ang(1) / imu.delta_ang_dt - out.ekf.gyro_bias(1);
+      out.rates.r = imu.delta_ang(2) / imu.delta_ang_dt - out.ekf.gyro_bias(2);
+      out.accel.x = imu.delta_vel(0) / imu.delta_vel_dt - out.ekf.accel_bias(0);
+      out.accel.y = imu.delta_vel(1) / imu.delta_vel_dt - out.ekf.accel_bias(1);
+      out.accel.z = imu.delta_vel(2) / imu.delta_vel_dt - out.ekf.accel_bias(2);
+    }
+    out.stamp = get_sys_time_usec();
+    out.update_us = out.stamp - start;
+    if (out.update_us > out.update_max_us) {
+      out.update_max_us = out.update_us;
+    }
+
+    seqlock_write_begin(&lane->lock);
+    lane->out = out;
+    seqlock_write_end(&lane->lock);
+  }
+  return NULL;
+}
+
+static void ins_ekf2_lanes_init(void)
+{
+  static const uint8_t gyro_ids[INS_EKF2_NB_LANES] = INS_EKF2_LANES_GYRO_ID;
+  static const uint8_t accel_ids[INS_EKF2_NB_LANES] = INS_EKF2_LANES_ACCEL_ID;
+  static const int32_t mag_types[INS_EKF2_NB_LANES] = INS_EKF2_LANES_MAG_TYPE;
+
+  for (uint8_t i = 0; i < INS_EKF2_NB_LANES; i++) {
+    struct ekf2_lane *lane = &ekf2_lanes[i];
+    ins_ekf2_setup(lane->ekf, lane->ekf.getParamHandle(), mag_types[i]);
+    lane->gyro_id = gyro_ids[i];
+    lane->accel_id = accel_ids[i];
+    lane->gyro_valid = false;
+    lane->accel_valid = false;
+    lane->healthy = false;
+    lane->score = 0.f;
+    lane->quat_reset_counter = 0;
+    lane->param.fusion_mode = ekf2.fusion_mode;
+    lane->param.mag_fusion_type = mag_types[i];
+    lane->origin_pending = false;
+    lane->param_pending = false;
+    spsc_queue_init(&lane->queue, lane->samples, INS_EKF2_LANES_QUEUE_SIZE, sizeof(struct ekf2_sample));
+    seqlock_init(&lane->lock);
+    sem_init(&lane->sem, 0, 0);
+  }
+  ekf2.lane = 0;
+  ekf2_lanes_better_since = 0;
+  ekf2_lanes_in_air = false;
+  ekf2_lanes_switched = false;
+}
+
+static void ins_ekf2_lanes_start(void)
+{
+  for (uint8_t i = 0; i < INS_EKF2_NB_LANES; i++) {
+    if (pthread_create(&ekf2_lanes[i].thread, NULL, ins_ekf2_lane_thread, &ekf2_lanes[i]) != 0) {
+      fprintf(stderr, "[ins_ekf2] Could not create thread of lane %d\n", i);
+      continue;
+    }
+    char name[16];
+    snprintf(name, sizeof(name), "ekf2_%d", i);
+    pthread_setname_np(ekf2_lanes[i].thread, name);
+  }
+}
+
+/** Copy the lane outputs and update their health */
+static void ins_ekf2_lanes_check(uint32_t now)
+{
+  for (uint8_t i = 0; i < INS_EKF2_NB_LANES; i++) {
+    struct ekf2_lane *lane = &ekf2_lanes[i];
+    uint32_t seq;
+    do {
+      seq = seqlock_read_begin(&lane->lock);
+      lane->snap = lane->out;
+    } while (seqlock_read_retry(&lane->lock, seq));
+
+    const struct ekf2_output *out = &lane->snap.ekf;
+    lane->healthy = lane->snap.stamp > 0 &&
+                    (now - lane->snap.stamp) < INS_EKF2_LANES_TIMEOUT * 1000 &&
+                    out->attitude_valid && out->control_status.flags.tilt_align &&
+                    out->fault_status == 0;
+    lane->score = Max(Max(out->mag_test, out->vel_test), Max(out->pos_test, out->hgt_test));
+  }
+}
+
+/**
+ * Select the lane to publish.
+ * Switch immediately when the current lane is unhealthy, or when another
+ * lane has a lower test ratio by a margin for some time.
+ */
+static void ins_ekf2_lanes_select(uint32_t now)
+{
+  struct ekf2_lane *current = &ekf2_lanes[ekf2.lane];
+  uint8_t best = ekf2.lane;
+  for (uint8_t i = 0; i < INS_EKF2_NB_LANES; i++) {
+    struct ekf2_lane *lane = &ekf2_lanes[i];
+    if (lane->healthy && (!ekf2_lanes[best].healthy || lane->score < ekf2_lanes[best].score)) {
+      best = i;
+    }
+  }
+
+  bool do_switch = false;
+  if (best != ekf2.lane) {
+    if (!current->healthy) {
+      do_switch = true;
+    } else if (ekf2_lanes[best].score < current->score - INS_EKF2_LANES_SWITCH_MARGIN) {
+      if (ekf2_lanes_better_since == 0) {
+        ekf2_lanes_better_since = now;
+      } else if (now - ekf2_lanes_better_since > INS_EKF2_LANES_SWITCH_TIME * 1000) {
+        do_switch = true;
+      }
+    } else {
+      ekf2_lanes_better_since = 0;
+    }
+  } else {
+    ekf2_lanes_better_since = 0;
+  }
+
+  if (do_switch) {
+    /* Keep the heading setpoints consistent with the new lane */
+    if (current->snap.ekf.attitude_valid) {
+      float psi_old = matrix::Eulerf(current->snap.ekf.quat).psi();
+      float psi_new = matrix::Eulerf(ekf2_lanes[best].snap.ekf.quat).psi();
+      float dpsi = psi_new - psi_old;
+      FLOAT_ANGLE_NORMALIZE(dpsi);
+      ins_ekf2_reset_heading(dpsi);
+    }
+    ekf2_lanes[best].quat_reset_counter = ekf2_lanes[best].snap.ekf.quat_reset_counter;
+    ekf2.lane = best;
+    ekf2_lanes_better_since = 0;
+    ekf2_lanes_switched = true;
+  }
+}
+
+/** Publish the selected lane to the state, from the main thread */
+static void ins_ekf2_lanes_update(void)
+{
+  uint32_t now = get_sys_time_usec();
+  __atomic_store_n(&ekf2_lanes_in_air, autopilot_in_flight(), __ATOMIC_RELAXED);
+
+  /* Retry the commands that did not fit in the queues */
+  for (uint8_t i = 0; i < INS_EKF2_NB_LANES; i++) {
+    ins_ekf2_lane_flush(&ekf2_lanes[i]);
+  }
 
+  ins_ekf2_lanes_check(now);
+  ins_ekf2_lanes_select(now);
+
+  struct ekf2_lane *lane = &ekf2_lanes[ekf2.lane];
+  const struct ekf2_output *out = &lane->snap.ekf;
+  ekf2_lanes_telemetry = *out;
+  if (!out->attitude_valid) {
+    return;
+  }
+
+  struct FloatQuat ltp_to_body_quat;
+  ltp_to_body_quat.qi = out->quat(0);
+  ltp_to_body_quat.qx = out->quat(1);
+  ltp_to_body_quat.qy = out->quat(2);
+  ltp_to_body_quat.qz = out->quat(3);
+  stateSetNedToBodyQuat_f(&ltp_to_body_quat);
+
+#ifndef NO_RESET_UPDATE_SETPOINT_HEADING
+  if (lane->quat_reset_counter < out->quat_reset_counter) {
+    ins_ekf2_reset_heading(matrix::Eulerf(matrix::Quatf(out->delta_q_reset)).psi());
+    lane->quat_reset_counter = out->quat_reset_counter;
+  }
+#endif
+
+  stateSetBodyRates_f(&lane->snap.rates);
+  struct Int32Vect3 accel;
+  ACCELS_BFP_OF_REAL(accel, lane->snap.accel);
+  stateSetAccelBody_i(&accel);
+
+  // Only publish position after successful alignment
+  if (out->control_status.flags.tilt_align) {
+    ins_ekf2_publish_ned(out);
+    if (ekf2_lanes_switched && out->origin_valid) {
+      // the lanes set their origin independently, always take the one of the new lane
+      ekf2.ltp_stamp = 0;
+      ekf2_lanes_switched = false;
+    }
+    ins_ekf2_publish_origin(out);
+  }
+}
+
+#endif /* INS_EKF2_NB_LANES > 1 */
+
+/* Initialize the EKF */
+void ins_ekf2_init(void)
+{
   /* Initialize struct */
   ekf2.ltp_stamp = 0;
   ekf2.flow_stamp = 0;
@@ -538,16 +1148,29 @@ void ins_ekf2_init(void)
   ekf2.quat_reset_counter = 0;
   ekf2.temp = 20.0f; // Default temperature of 20 degrees celcius
   ekf2.qnh = 1013.25f; // Default atmosphere
+  ekf2.fusion_mode = INS_EKF2_FUSION_MODE;
+  ekf2.mag_fusion_type = 0;
+  ekf2.lane = 0;
 
-  /* Initialize the range sensor limits */
-  ekf.set_rangefinder_limits(INS_EKF2_SONAR_MIN_RANGE, INS_EKF2_SONAR_MAX_RANGE);
-
-  /* Initialize the flow sensor limits */
-  ekf.set_optical_flow_limits(INS_EKF2_MAX_FLOW_RATE, INS_EKF2_SONAR_MIN_RANGE, INS_EKF2_SONAR_MAX_RANGE);
+  /* Get the ekf parameters */
+#if INS_EKF2_NB_LANES > 1
+  ins_ekf2_lanes_init();
+#else
+  ekf_params = ekf.getParamHandle();
+  ins_ekf2_setup(ekf, ekf_params, 0);
+#endif
 
   /* Initialize the origin from flight plan */
 #if USE_INS_NAV_INIT
-  if(ekf.setEkfGlobalOrigin(NAV_LAT0*1e-7, NAV_LON0*1e-7, (NAV_ALT0)*1e-3)) // EKF2 works HMSL
+  bool origin_set = true;
+#if INS_EKF2_NB_LANES > 1
+  for (uint8_t i = 0; i < INS_EKF2_NB_LANES; i++) {
+    origin_set &= ekf2_lanes[i].ekf.setEkfGlobalOrigin(NAV_LAT0*1e-7, NAV_LON0*1e-7, (NAV_ALT0)*1e-3);
+  }
+#else
+  origin_set = ekf.setEkfGlobalOrigin(NAV_LAT0*1e-7, NAV_LON0*1e-7, (NAV_ALT0)*1e-3); // EKF2 works HMSL
+#endif
+  if(origin_set)
   {
     struct LlaCoor_i llh_nav0; /* Height above the ellipsoid */
     llh_nav0.lat = NAV_LAT0;
@@ -576,19 +1199,32 @@ void ins_ekf2_init(void)
   register_periodic_telemetry(DefaultPeriodic, PPRZ_MSG_ID_WIND_INFO_RET, send_wind_info_ret);
   register_periodic_telemetry(DefaultPeriodic, PPRZ_MSG_ID_AHRS_BIAS, send_ahrs_bias);
   register_periodic_telemetry(DefaultPeriodic, PPRZ_MSG_ID_AHRS_QUAT_INT, send_ahrs_quat);
+#if INS_EKF2_NB_LANES > 1
+  register_periodic_telemetry(DefaultPeriodic, PPRZ_MSG_ID_INS_EKF2_LANES, send_ins_ekf2_lanes);
+#endif
 #endif
 
   /*
    * Subscribe to scaled IMU measurements and attach callbacks
+   * With multiple lanes, the IMUs are selected per lane in the callbacks
    */
   AbiBindMsgBARO_ABS(INS_EKF2_BARO_ID, &baro_ev, baro_cb);
   AbiBindMsgTEMPERATURE(INS_EKF2_TEMPERATURE_ID, &temperature_ev, temperature_cb);
   AbiBindMsgAGL(INS_EKF2_AGL_ID, &agl_ev, agl_cb);
+#if INS_EKF2_NB_LANES > 1
+  AbiBindMsgIMU_GYRO_INT(ABI_BROADCAST, &gyro_int_ev, gyro_int_cb);
+  AbiBindMsgIMU_ACCEL_INT(ABI_BROADCAST, &accel_int_ev, accel_int_cb);
+#else
   AbiBindMsgIMU_GYRO_INT(INS_EKF2_GYRO_ID, &gyro_int_ev, gyro_int_cb);
   AbiBindMsgIMU_ACCEL_INT(INS_EKF2_ACCEL_ID, &accel_int_ev, accel_int_cb);
+#endif
   AbiBindMsgIMU_MAG(INS_EKF2_MAG_ID, &mag_ev, mag_cb);
   AbiBindMsgGPS(INS_EKF2_GPS_ID, &gps_ev, gps_cb);
   AbiBindMsgOPTICAL_FLOW(INS_EKF2_OF_ID, &optical_flow_ev, optical_flow_cb);
+
+#if INS_EKF2_NB_LANES > 1
+  ins_ekf2_lanes_start();
+#endif
 }
 
 void ins_reset_local_origin(void)
@@ -596,18 +1232,97 @@ void ins_reset_local_origin(void)
 #if USE_GPS
   if (GpsFixValid()) {
     struct LlaCoor_i lla_pos = lla_int_from_gps(&gps);
+#if INS_EKF2_NB_LANES > 1
+    // the new origin is published by the selected lane once applied
+    struct ekf2_origin origin = { lla_pos.lat*1e-7, lla_pos.lon*1e-7, gps.hmsl*1e-3f };
+    for (uint8_t i = 0; i < INS_EKF2_NB_LANES; i++) {
+      ekf2_lanes[i].origin = origin;
+      ekf2_lanes[i].origin_pending = true;
+      ins_ekf2_lane_flush(&ekf2_lanes[i]);
+    }
+#else
     if (ekf.setEkfGlobalOrigin(lla_pos.lat*1e-7, lla_pos.lon*1e-7, gps.hmsl*1e-3)) {
       ltp_def_from_lla_i(&ekf2.ltp_def, &lla_pos);
       ekf2.ltp_def.hmsl = gps.hmsl;
       stateSetLocalOrigin_i(&ekf2.ltp_def);
     }
+#endif
   }
 #endif
 }
 
+/** Publish position, speed and acceleration in the local NED frame */
+static void ins_ekf2_publish_ned(const struct ekf2_output *out)
+{
+  /* Get the position */
+  struct NedCoor_f pos;
+  pos.x = out->pos(0);
+  pos.y = out->pos(1);
+  pos.z = out->pos(2);
+
+  // Publish to the state
+  stateSetPositionNed_f(&pos);
+
+  /* Get the velocity in NED frame */
+  struct NedCoor_f speed;
+  speed.x = out->vel(0);
+  speed.y = out->vel(1);
+  speed.z = out->vel(2);
+
+  // Publish to state
+  stateSetSpeedNed_f(&speed);
+
+  /* Get the accelerations in NED frame */
+  struct NedCoor_f accel;
+  accel.x = out->vel_deriv(0);
+  accel.y = out->vel_deriv(1);
+  accel.z = out->vel_deriv(2);
+
+  // Publish to state
+  stateSetAccelNed_f(&accel);
+}
+
+/** Update the local origin when the state estimator has updated it */
+static void ins_ekf2_publish_origin(const struct ekf2_output *out)
+{
+  // Position of local NED origin in GPS / WGS84 frame
+  if (out->origin_valid && (out->origin_time > ekf2.ltp_stamp)) {
+    struct LlaCoor_i lla_ref;
+    lla_ref.lat = out->origin_lat * 1e7; // WGS-84 lat
+    lla_ref.lon = out->origin_lon * 1e7; // WGS-84 lon
+    lla_ref.alt = out->origin_alt * 1e3 + wgs84_ellipsoid_to_geoid_i(lla_ref.lat, lla_ref.lon); // in millimeters above WGS84 reference ellipsoid (ref_alt is in HMSL)
+    ltp_def_from_lla_i(&ekf2.ltp_def, &lla_ref);
+    ekf2.ltp_def.hmsl = out->origin_alt * 1e3;
+    stateSetLocalOrigin_i(&ekf2.ltp_def);
+
+    /* update local ENU coordinates of global waypoints */
+    waypoints_localize_all();
+
+    ekf2.ltp_stamp = out->origin_time;
+  }
+}
+
+/** Shift the heading setpoints after a jump of the estimated heading */
+static void ins_ekf2_reset_heading(float psi)
+{
+#if defined STABILIZATION_ATTITUDE_TYPE_INT
+  stab_att_sp_euler.psi += ANGLE_BFP_OF_REAL(psi);
+#else
+  stab_att_sp_euler.psi += psi;
+#endif
+  guidance_h.sp.heading += psi;
+  guidance_h.rc_sp.psi += psi;
+  nav.heading += psi;
+  guidance_h_read_rc(autopilot_in_flight());
+  stabilization_attitude_enter();
+}
+
 /* Update the INS state */
 void ins_ekf2_update(void)
 {
+#if INS_EKF2_NB_LANES > 1
+  ins_ekf2_lanes_update();
+#else
   /* Set EKF settings */
   ekf.set_in_air_status(autopilot_in_flight());
 
@@ -619,60 +1334,18 @@ void ins_ekf2_update(void)
 
     // Only publish position after successful alignment
     if (control_status.flags.tilt_align) {
-      /* Get the position */
-      const Vector3f pos_f{ekf.getPosition()};
-      struct NedCoor_f pos;
-      pos.x = pos_f(0);
-      pos.y = pos_f(1);
-      pos.z = pos_f(2);
-
-      // Publish to the state
-      stateSetPositionNed_f(&pos);
-
-      /* Get the velocity in NED frame */
-      const Vector3f vel_f{ekf.getVelocity()};
-      struct NedCoor_f speed;
-      speed.x = vel_f(0);
-      speed.y = vel_f(1);
-      speed.z = vel_f(2);
-
-      // Publish to state
-      stateSetSpeedNed_f(&speed);
-
-      /* Get the accelerations in NED frame */
-      const Vector3f vel_deriv_f{ekf.getVelocityDerivative()};
-      struct NedCoor_f accel;
-      accel.x = vel_deriv_f(0);
-      accel.y = vel_deriv_f(1);
-      accel.z = vel_deriv_f(2);
-
-      // Publish to state
-      stateSetAccelNed_f(&accel);
+      struct ekf2_output out;
+      out.pos = ekf.getPosition();
+      out.vel = ekf.getVelocity();
+      out.vel_deriv = ekf.getVelocityDerivative();
+      ins_ekf2_publish_ned(&out);
 
       /* Get local origin */
-      // Position of local NED origin in GPS / WGS84 frame
-      double ekf_origin_lat, ekf_origin_lon;
-      float ref_alt;
-      struct LlaCoor_i lla_ref;
-      uint64_t origin_time;
-
-      // Only update the origin when the state estimator has updated the origin
-      bool ekf_origin_valid = ekf.getEkfGlobalOrigin(origin_time, ekf_origin_lat, ekf_origin_lon, ref_alt);
-      if (ekf_origin_valid && (origin_time > ekf2.ltp_stamp)) {
-        lla_ref.lat = ekf_origin_lat * 1e7; // WGS-84 lat
-        lla_ref.lon = ekf_origin_lon * 1e7; // WGS-84 lon
-        lla_ref.alt = ref_alt * 1e3 + wgs84_ellipsoid_to_geoid_i(lla_ref.lat, lla_ref.lon); // in millimeters above WGS84 reference ellipsoid (ref_alt is in HMSL)
-        ltp_def_from_lla_i(&ekf2.ltp_def, &lla_ref);
-        ekf2.ltp_def.hmsl = ref_alt * 1e3;
-        stateSetLocalOrigin_i(&ekf2.ltp_def);
-
-        /* update local ENU coordinates of global waypoints */
-        waypoints_localize_all();
-
-        ekf2.ltp_stamp = origin_time;
-      }
+      out.origin_valid = ekf.getEkfGlobalOrigin(out.origin_time, out.origin_lat, out.origin_lon, out.origin_alt);
+      ins_ekf2_publish_origin(&out);
     }
   }
+#endif
 
 #if defined SITL && USE_NPS
   if (nps_bypass_ins) {
@@ -685,16 +1358,36 @@ void ins_ekf2_update(void)
 
 void ins_ekf2_change_param(int32_t unk)
 {
-  ekf_params->mag_fusion_type = ekf2.mag_fusion_type = unk;
+  ekf2.mag_fusion_type = unk;
+#if INS_EKF2_NB_LANES > 1
+  // explicitly set from the ground, overrides INS_EKF2_LANES_MAG_TYPE
+  for (uint8_t i = 0; i < INS_EKF2_NB_LANES; i++) {
+    ekf2_lanes[i].param.mag_fusion_type = unk;
+    ekf2_lanes[i].param_pending = true;
+    ins_ekf2_lane_flush(&ekf2_lanes[i]);
+  }
+#else
+  ekf_params->mag_fusion_type = unk;
+#endif
 }
 
 void ins_ekf2_remove_gps(int32_t mode)
 {
   if (mode) {
-    ekf_params->fusion_mode = ekf2.fusion_mode = (MASK_USE_OF | MASK_USE_GPSYAW);
+    ekf2.fusion_mode = (MASK_USE_OF | MASK_USE_GPSYAW);
   } else {
-    ekf_params->fusion_mode = ekf2.fusion_mode = INS_EKF2_FUSION_MODE;
+    ekf2.fusion_mode = INS_EKF2_FUSION_MODE;
   }
+#if INS_EKF2_NB_LANES > 1
+  // each lane keeps its own mag fusion type
+  for (uint8_t i = 0; i < INS_EKF2_NB_LANES; i++) {
+    ekf2_lanes[i].param.fusion_mode = ekf2.fusion_mode;
+    ekf2_lanes[i].param_pending = true;
+    ins_ekf2_lane_flush(&ekf2_lanes[i]);
+  }
+#else
+  ekf_params->fusion_mode = ekf2.fusion_mode;
+#endif
 }
 
 void ins_ekf2_parse_EXTERNAL_POSE(uint8_t *buf) {
@@ -717,13 +1410,18 @@ void ins_ekf2_parse_EXTERNAL_POSE(uint8_t *buf) {
   sample.angVar = INS_EKF2_EVA_NOISE;
   sample.vel_frame = velocity_frame_t::LOCAL_FRAME_FRD;
 
+#if INS_EKF2_NB_LANES > 1
+  ins_ekf2_lanes_push(EKF2_SAMPLE_EV, sample);
+#else
   ekf.setExtVisionData(sample);
+#endif
 }
 
 void ins_ekf2_parse_EXTERNAL_POSE_SMALL(uint8_t __attribute__((unused)) *buf) {
 
 }
 
+#if INS_EKF2_NB_LANES == 1
 /** Publish the attitude and get the new state
  *  Directly called after a succeslfull gyro+accel reading
  */
@@ -757,17 +1455,7 @@ static void ins_ekf2_publish_attitude(uint32_t stamp)
 #ifndef NO_RESET_UPDATE_SETPOINT_HEADING
 
     if (ekf2.quat_reset_counter < quat_reset_counter) {
-      float psi = matrix::Eulerf(matrix::Quatf(delta_q_reset)).psi();
-#if defined STABILIZATION_ATTITUDE_TYPE_INT
-      stab_att_sp_euler.psi += ANGLE_BFP_OF_REAL(psi);
-#else
-      stab_att_sp_euler.psi += psi;
-#endif
-      guidance_h.sp.heading += psi;
-      guidance_h.rc_sp.psi += psi;
-      nav.heading += psi;
-      guidance_h_read_rc(autopilot_in_flight());
-      stabilization_attitude_enter();
+      ins_ekf2_reset_heading(matrix::Eulerf(matrix::Quatf(delta_q_reset)).psi());
       ekf2.quat_reset_counter = quat_reset_counter;
     }
 #endif
@@ -797,6 +1485,7 @@ static void ins_ekf2_publish_attitude(uint32_t stamp)
   ekf2.accel_valid = false;
   ekf2.got_imu_data = true;
 }
+#endif
 
 /* Update INS based on Baro information */
 static void baro_cb(uint8_t __attribute__((unused)) sender_id, uint32_t stamp, float pressure)
@@ -806,11 +1495,16 @@ static void baro_cb(uint8_t __attribute__((unused)) sender_id, uint32_t stamp, f
 
   // Calculate the air density
   float rho = pprz_isa_density_of_pressure(pressure, ekf2.temp);
-  ekf.set_air_density(rho);
 
   // Calculate the height above mean sea level based on pressure
   sample.hgt = pprz_isa_height_of_pressure_full(pressure, ekf2.qnh * 100.0f);
+#if INS_EKF2_NB_LANES > 1
+  struct ekf2_baro baro = { sample, rho };
+  ins_ekf2_lanes_push(EKF2_SAMPLE_BARO, baro);
+#else
+  ekf.set_air_density(rho);
   ekf.setBaroData(sample);
+#endif
 }
 
 /* Save the latest temperature measurement for air density calculations */
@@ -827,13 +1521,32 @@ static void agl_cb(uint8_t __attribute__((unused)) sender_id, uint32_t stamp, fl
   sample.rng = distance;
   sample.quality = -1;
 
+#if INS_EKF2_NB_LANES > 1
+  ins_ekf2_lanes_push(EKF2_SAMPLE_RANGE, sample);
+#else
   ekf.setRangeData(sample);
+#endif
 }
 
 /* Update INS based on Gyro information */
 static void gyro_int_cb(uint8_t __attribute__((unused)) sender_id,
                     uint32_t stamp, struct FloatRates *delta_gyro, uint16_t dt)
 {
+#if INS_EKF2_NB_LANES > 1
+  for (uint8_t i = 0; i < INS_EKF2_NB_LANES; i++) {
+    struct ekf2_lane *lane = &ekf2_lanes[i];
+    if (lane->gyro_id != ABI_BROADCAST && lane->gyro_id != sender_id) {
+      continue;
+    }
+    RATES_COPY(lane->delta_gyro, *delta_gyro);
+    lane->gyro_dt = dt;
+    lane->gyro_valid = true;
+    if (lane->accel_valid) {
+      ins_ekf2_lane_push_imu(lane, stamp);
+    }
+  }
+  ekf2.got_imu_data = true;
+#else
   // Copy and save the gyro data
   RATES_COPY(ekf2.delta_gyro, *delta_gyro);
   ekf2.gyro_dt = dt;
@@ -843,12 +1556,28 @@ static void gyro_int_cb(uint8_t __attribute__((unused)) sender_id,
   if (ekf2.gyro_valid && ekf2.accel_valid) {
     ins_ekf2_publish_attitude(stamp);
   }
+#endif
 }
 
 /* Update INS based on Accelerometer information */
 static void accel_int_cb(uint8_t sender_id __attribute__((unused)),
                      uint32_t stamp, struct FloatVect3 *delta_accel, uint16_t dt)
 {
+#if INS_EKF2_NB_LANES > 1
+  for (uint8_t i = 0; i < INS_EKF2_NB_LANES; i++) {
+    struct ekf2_lane *lane = &ekf2_lanes[i];
+    if (lane->accel_id != ABI_BROADCAST && lane->accel_id != sender_id) {
+      continue;
+    }
+    VECT3_COPY(lane->delta_accel, *delta_accel);
+    lane->accel_dt = dt;
+    lane->accel_valid = true;
+    if (lane->gyro_valid) {
+      ins_ekf2_lane_push_imu(lane, stamp);
+    }
+  }
+  ekf2.got_imu_data = true;
+#else
   // Copy and save the gyro data
   VECT3_COPY(ekf2.delta_accel, *delta_accel);
   ekf2.accel_dt = dt;
@@ -858,6 +1587,7 @@ static void accel_int_cb(uint8_t sender_id __attribute__((unused)),
   if (ekf2.gyro_valid && ekf2.accel_valid) {
     ins_ekf2_publish_attitude(stamp);
   }
+#endif
 }
 
 /* Update INS based on Magnetometer information */
@@ -880,7 +1610,11 @@ static void mag_cb(uint8_t __attribute__((unused)) sender_id,
   sample.mag(1) = mag_gauss.y;
   sample.mag(2) = mag_gauss.z;
 
+#if INS_EKF2_NB_LANES > 1
+  ins_ekf2_lanes_push(EKF2_SAMPLE_MAG, sample);
+#else
   ekf.setMagData(sample);
+#endif
   ekf2.got_imu_data = true;
 }
 
@@ -915,7 +1649,11 @@ static void gps_cb(uint8_t sender_id __attribute__((unused)),
   gps_msg.nsats = gps_s->num_sv;
   gps_msg.pdop = gps_s->pdop;
 
+#if INS_EKF2_NB_LANES > 1
+  ins_ekf2_lanes_push(EKF2_SAMPLE_GPS, gps_msg);
+#else
   ekf.setGpsData(gps_msg);
+#endif
 }
 
 /* Update INS based on Optical Flow information */
@@ -956,5 +1694,9 @@ static void optical_flow_cb(uint8_t sender_id __attribute__((unused)),
   sample.gyro_xyz = Vector3f{NAN, NAN, NAN};    // measured delta angle of the inertial frame about the body axes obtained from rate gyro measurements (rad), RH rotation is positive
 
   // Update the optical flow data based on the callback
+#if INS_EKF2_NB_LANES > 1
+  ins_ekf2_lanes_push(EKF2_SAMPLE_FLOW, sample);
+#else
   ekf.setOpticalFlowData(sample);
+#endif
 }
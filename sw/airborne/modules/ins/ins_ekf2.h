@@ -55,6 +55,7 @@ struct ekf2_t {
 
   int32_t mag_fusion_type;
   int32_t fusion_mode;
+  uint8_t lane;                   ///< Lane published to the state (INS_EKF2_NB_LANES > 1)
 };
 
 extern void ins_ekf2_init(void);
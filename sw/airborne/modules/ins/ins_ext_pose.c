@@ -30,6 +30,7 @@
 #include "ins_ext_pose.h"
 #include "state.h"
 #include "math/pprz_algebra_float.h"
+#include "math/pprz_matrix_decomp_fixed_float.h"
 #include "modules/imu/imu.h"
 #include "modules/ins/ins.h"
 #include "generated/flight_plan.h"
@@ -919,8 +920,10 @@ static inline void ekf_step(const float U[EKF_NUM_INPUTS], const float Z[EKF_NUM
   MAKE_MATRIX_PTR(Sk_inv_, Sk_inv, EKF_NUM_OUTPUTS);
   MAKE_MATRIX_PTR(K_, K, EKF_NUM_STATES);
 
-  // Sk_inv = inv(Sk)
-  float_mat_invert(Sk_inv_, Sk_, EKF_NUM_OUTPUTS);
+  // Sk_inv = inv(Sk), Sk is symmetric positive definite
+  if (!PPRZ_MATRIX_DECOMP_FIXED(pprz_cholesky_inv_float, EKF_NUM_OUTPUTS)(&Sk_inv[0][0], &Sk[0][0])) {
+    float_mat_invert(Sk_inv_, Sk_, EKF_NUM_OUTPUTS);
+  }
 
   // K = PHT*Sk_inv
   float_mat_mul(K_, PHT_, Sk_inv_, EKF_NUM_STATES, EKF_NUM_OUTPUTS, EKF_NUM_OUTPUTS);
@@ -1081,8 +1084,10 @@ static inline void ekf_measurement_step(const float Z[EKF_NUM_OUTPUTS])
   MAKE_MATRIX_PTR(Sk_inv_, Sk_inv, EKF_NUM_OUTPUTS);
   MAKE_MATRIX_PTR(K_, K, EKF_NUM_STATES);
 
-  // Sk_inv = inv(Sk)
-  float_mat_invert(Sk_inv_, Sk_, EKF_NUM_OUTPUTS);
+  // Sk_inv = inv(Sk), Sk is symmetric positive definite
+  if (!PPRZ_MATRIX_DECOMP_FIXED(pprz_cholesky_inv_float, EKF_NUM_OUTPUTS)(&Sk_inv[0][0], &Sk[0][0])) {
+    float_mat_invert(Sk_inv_, Sk_, EKF_NUM_OUTPUTS);
+  }
 
   // K = PHT*Sk_inv
   float_mat_mul(K_, PHT_, Sk_inv_, EKF_NUM_STATES, EKF_NUM_OUTPUTS, EKF_NUM_OUTPUTS);
@@ -44,6 +44,17 @@
 #include "math/pprz_rk_float.h"
 #include "math/pprz_isa.h"
 
+/** Use the generated straight-line model and correction (ins_float_invariant_gen.h)
+ * instead of the generic runge-kutta propagation
+ */
+#ifndef INS_INV_CODEGEN
+#define INS_INV_CODEGEN FALSE
+#endif
+
+#if INS_INV_CODEGEN
+#include "modules/ins/ins_float_invariant_gen.h"
+#endif
+
 #include "state.h"
 
 // for debugging
@@ -367,12 +378,16 @@ void ins_float_invariant_propagate(struct FloatRates* gyro, struct FloatVect3* a
   error_output(&ins_float_inv);
 
   // propagate model
+#if INS_INV_CODEGEN
+  ins_float_invariant_gen_propagate(&ins_float_inv.state, &ins_float_inv.cmd, &ins_float_inv.corr, dt);
+#else
   struct inv_state new_state;
   runge_kutta_4_float((float *)&new_state,
                       (float *)&ins_float_inv.state, INV_STATE_DIM,
                       (float *)&ins_float_inv.cmd, INV_COMMAND_DIM,
                       invariant_model, dt);
   ins_float_inv.state = new_state;
+#endif
 
   // normalize quaternion
   float_quat_normalize(&ins_float_inv.state.quat);
@@ -652,22 +667,10 @@ static inline void invariant_model(float *o, const float *x, const int n, const
 static inline void error_output(struct InsFloatInv *_ins)
 {
 
-  struct FloatVect3 YBt, I, Ev, Eb, Ex, Itemp, Ebtemp, Evtemp;
+  struct FloatVect3 Ev, Ex;
   float Eh;
-  float temp;
-
-  /* YBt = q * yB * q-1  */
-  struct FloatQuat q_b2n;
-  float_quat_invert(&q_b2n, &(_ins->state.quat));
-  float_quat_vmult(&YBt, &q_b2n, &(_ins->meas.mag));
-
-  float_quat_vmult(&I, &q_b2n, &(_ins->cmd.accel));
-  VECT3_SMUL(I, I, 1.f / (_ins->state.as));
 
   /*--------- E = ( ŷ - y ) ----------*/
-  /* Eb = ( B - YBt ) */
-  VECT3_DIFF(Eb, B, YBt);
-
   // pos and speed error only if GPS data are valid
   // or while waiting first GPS data to prevent diverging
   if ((gps.fix >= GPS_FIX_3D && _ins->is_aligned
@@ -688,6 +691,24 @@ static inline void error_output(struct InsFloatInv *_ins)
   /* Eh = < X,e3 > - hb - YH */
   Eh = _ins->state.pos.z - _ins->state.hb - _ins->meas.baro_alt;
 
+#if INS_INV_CODEGEN
+  ins_float_invariant_gen_correction(&_ins->corr, &_ins->state, &_ins->cmd, &_ins->meas.mag, &B,
+                                     &Ev, &Ex, Eh, &_ins->gains);
+#else
+  struct FloatVect3 YBt, I, Eb, Itemp, Ebtemp, Evtemp;
+  float temp;
+
+  /* YBt = q * yB * q-1  */
+  struct FloatQuat q_b2n;
+  float_quat_invert(&q_b2n, &(_ins->state.quat));
+  float_quat_vmult(&YBt, &q_b2n, &(_ins->meas.mag));
+
+  float_quat_vmult(&I, &q_b2n, &(_ins->cmd.accel));
+  VECT3_SMUL(I, I, 1.f / (_ins->state.as));
+
+  /* Eb = ( B - YBt ) */
+  VECT3_DIFF(Eb, B, YBt);
+
   /*--------------Gains--------------*/
 
   /**** LvEv + LbEb = -lvIa x Ev +  lb < B x Eb, Ia > Ia *****/
@@ -730,7 +751,7 @@ static inline void error_output(struct InsFloatInv *_ins)
 
   /****** ShEh ******/
   _ins->corr.SE = (_ins->gains.sh) * Eh;
-
+#endif
 }
 
 
@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file modules/ins/ins_float_invariant_gen.h
+ *
+ * Straight-line model, correction and RK4 propagation of the invariant filter.
+ *
+ * Generated by ins_float_invariant_gen.py, do not edit.
+ */
+
+#ifndef INS_FLOAT_INVARIANT_GEN_H
+#define INS_FLOAT_INVARIANT_GEN_H
+
+#include "modules/ins/ins_float_invariant.h"
+
+/** State derivative (invariant_model) */
+static inline void ins_float_invariant_gen_model(struct inv_state *sd, const struct inv_state *s,
+    const struct inv_command *c, const struct inv_correction_gains *corr)
+{
+  const float t0 = (0.5f)*c->rates.p - 0.5f*s->bias.p;
+  const float t1 = c->rates.q - s->bias.q;
+  const float t2 = (0.5f)*s->quat.qy;
+  const float t3 = c->rates.r - s->bias.r;
+  const float t4 = (0.5f)*s->quat.qz;
+  const float t5 = (s->quat.qi*s->quat.qi);
+  const float t6 = (s->quat.qx*s->quat.qx);
+  const float t7 = (s->quat.qy*s->quat.qy);
+  const float t8 = (s->quat.qz*s->quat.qz);
+  const float t9 = t5 + t6 + t7 + t8 - 1.f;
+  const float t10 = (0.5f)*s->quat.qi;
+  const float t11 = (0.5f)*s->quat.qx;
+  const float t12 = s->quat.qi*s->quat.qz;
+  const float t13 = s->quat.qx*s->quat.qy;
+  const float t14 = t12 + t13;
+  const float t15 = 2.f*corr->OE.y;
+  const float t16 = s->quat.qi*s->quat.qy;
+  const float t17 = s->quat.qx*s->quat.qz;
+  const float t18 = t16 - t17;
+  const float t19 = 2.f*corr->OE.z;
+  const float t20 = 2.f*t5 - 1.f;
+  const float t21 = t20 + 2.f*t6;
+  const float t22 = s->quat.qi*s->quat.qx;
+  const float t23 = s->quat.qy*s->quat.qz;
+  const float t24 = t22 + t23;
+  const float t25 = t12 - t13;
+  const float t26 = 2.f*corr->OE.x;
+  const float t27 = t20 + 2.f*t7;
+  const float t28 = t16 + t17;
+  const float t29 = t22 - t23;
+  const float t30 = t20 + 2.f*t8;
+  const float t31 = (1.f/s->as);
+  const float t32 = 2.f*c->accel.z;
+  const float t33 = 2.f*c->accel.y;
+  const float t34 = 2.f*c->accel.x;
+  sd->quat.qi = -corr->LE.x*s->quat.qx - corr->LE.y*s->quat.qy - corr->LE.z*s->quat.qz - s->quat.qi*t9 - s->quat.qx*t0 - t1*t2 - t3*t4;
+  sd->quat.qx = corr->LE.x*s->quat.qi + corr->LE.y*s->quat.qz - corr->LE.z*s->quat.qy + s->quat.qi*t0 - s->quat.qx*t9 - t1*t4 + t2*t3;
+  sd->quat.qy = -corr->LE.x*s->quat.qz + corr->LE.y*s->quat.qi + corr->LE.z*s->quat.qx - s->quat.qy*t9 + s->quat.qz*t0 + t1*t10 - t11*t3;
+  sd->quat.qz = corr->LE.x*s->quat.qy - corr->LE.y*s->quat.qx + corr->LE.z*s->quat.qi - s->quat.qy*t0 - s->quat.qz*t9 + t1*t11 + t10*t3;
+  sd->bias.p = corr->OE.x*t21 + t14*t15 - t18*t19;
+  sd->bias.q = corr->OE.y*t27 + t19*t24 - t25*t26;
+  sd->bias.r = corr->OE.z*t30 - t15*t29 + t26*t28;
+  sd->speed.x = corr->ME.x + t31*(c->accel.x*t21 - t25*t33 + t28*t32);
+  sd->speed.y = corr->ME.y + t31*(c->accel.y*t27 + t14*t34 - t29*t32);
+  sd->speed.z = corr->ME.z + t31*(c->accel.z*t30 - t18*t34 + t24*t33) + 9.81f;
+  sd->pos.x = corr->NE.x + s->speed.x;
+  sd->pos.y = corr->NE.y + s->speed.y;
+  sd->pos.z = corr->NE.z + s->speed.z;
+  sd->hb = corr->SE;
+  sd->as = corr->RE*s->as;
+  // keep as in a reasonable range, so 50% around the nominal value
+  if (((s->as < 0.5f) && (sd->as < 0.f)) || ((s->as > 1.5f) && (sd->as > 0.f))) {
+    sd->as = 0.f;
+  }
+}
+
+/** Correction terms from the output errors (error_output) */
+static inline void ins_float_invariant_gen_correction(struct inv_correction_gains *corr,
+    const struct inv_state *s, const struct inv_command *c, const struct FloatVect3 *mag,
+    const struct FloatVect3 *mag_h, const struct FloatVect3 *Ev, const struct FloatVect3 *Ex, float Eh,
+    const struct inv_gains *g)
+{
+  const float t0 = s->quat.qi*s->quat.qz;
+  const float t1 = s->quat.qx*s->quat.qy;
+  const float t2 = t0 + t1;
+  const float t3 = 2.f*c->accel.x;
+  const float t4 = s->quat.qi*s->quat.qx;
+  const float t5 = s->quat.qy*s->quat.qz;
+  const float t6 = t4 - t5;
+  const float t7 = 2.f*c->accel.z;
+  const float t8 = 2.f*(s->quat.qi*s->quat.qi) - 1.f;
+  const float t9 = 2.f*(s->quat.qy*s->quat.qy) + t8;
+  const float t10 = c->accel.y*t9 + t2*t3 - t6*t7;
+  const float t11 = t4 + t5;
+  const float t12 = 2.f*c->accel.y;
+  const float t13 = s->quat.qi*s->quat.qy;
+  const float t14 = s->quat.qx*s->quat.qz;
+  const float t15 = t13 - t14;
+  const float t16 = 2.f*(s->quat.qz*s->quat.qz) + t8;
+  const float t17 = c->accel.z*t16 + t11*t12 - t15*t3;
+  const float t18 = t13 + t14;
+  const float t19 = t0 - t1;
+  const float t20 = 2.f*(s->quat.qx*s->quat.qx) + t8;
+  const float t21 = c->accel.x*t20 - t12*t19 + t18*t7;
+  const float t22 = (1.f/s->as);
+  const float t23 = t21*t22;
+  const float t24 = 2.f*mag->y;
+  const float t25 = 2.f*mag->x;
+  const float t26 = mag->z*t16 - mag_h->z + t11*t24 - t15*t25;
+  const float t27 = 2.f*mag->z;
+  const float t28 = mag->x*t20 - mag_h->x + t18*t27 - t19*t24;
+  const float t29 = mag->y*t9 - mag_h->y + t2*t25 - t27*t6;
+  const float t30 = mag_h->x*t29 - mag_h->y*t28;
+  const float t31 = mag_h->y*t26 - mag_h->z*t29;
+  const float t32 = g->lb*(t10*(-mag_h->x*t26 + mag_h->z*t28) + t17*t30 + t21*t31);
+  const float t33 = (0.01f)*t22;
+  const float t34 = t22*t32;
+  const float t35 = g->ob*(-t10*(-mag_h->x*t26 + mag_h->z*t28) - t17*t30 - t21*t31);
+  const float t36 = (0.001f)*t22;
+  const float t37 = t22*t35;
+  corr->LE.x = t33*(Ev->y*g->lv*t17 - Ev->z*g->lv*t10 - t23*t32);
+  corr->LE.y = t33*(-Ev->x*g->lv*t17 + Ev->z*g->lv*t21 - t10*t34);
+  corr->LE.z = t33*(Ev->x*g->lv*t10 - Ev->y*g->lv*t21 - t17*t34);
+  corr->ME.x = -Ev->x*g->mv;
+  corr->ME.y = -Ev->y*g->mv;
+  corr->ME.z = -Eh*g->mh - Ev->z*g->mvz;
+  corr->NE.x = -Ex->x*g->nx;
+  corr->NE.y = -Ex->y*g->nx;
+  corr->NE.z = -Eh*g->nh - Ex->z*g->nxz;
+  corr->OE.x = t36*(-Ev->y*g->ov*t17 + Ev->z*g->ov*t10 - t23*t35);
+  corr->OE.y = t36*(Ev->x*g->ov*t17 - Ev->z*g->ov*t21 - t10*t37);
+  corr->OE.z = t36*(-Ev->x*g->ov*t10 + Ev->y*g->ov*t21 - t17*t37);
+  corr->RE = -0.0001f*Eh*g->rh + (0.01f)*g->rv*t22*(Ev->x*t21 + Ev->y*t10 + Ev->z*t17);
+  corr->SE = Eh*g->sh;
+}
+
+/** Fourth order Runge-Kutta propagation of the state (runge_kutta_4_float) */
+static inline void ins_float_invariant_gen_propagate(struct inv_state *s,
+    const struct inv_command *c, const struct inv_correction_gains *corr, float dt)
+{
+  struct inv_state k1, k2, k3, k4, tmp;
+  const float dt_2 = 0.5f * dt;
+  const float dt_6 = dt / 6.f;
+  ins_float_invariant_gen_model(&k1, s, c, corr);
+  tmp.quat.qi = s->quat.qi + dt_2 * k1.quat.qi;
+  tmp.quat.qx = s->quat.qx + dt_2 * k1.quat.qx;
+  tmp.quat.qy = s->quat.qy + dt_2 * k1.quat.qy;
+  tmp.quat.qz = s->quat.qz + dt_2 * k1.quat.qz;
+  tmp.bias.p = s->bias.p + dt_2 * k1.bias.p;
+  tmp.bias.q = s->bias.q + dt_2 * k1.bias.q;
+  tmp.bias.r = s->bias.r + dt_2 * k1.bias.r;
+  tmp.speed.x = s->speed.x + dt_2 * k1.speed.x;
+  tmp.speed.y = s->speed.y + dt_2 * k1.speed.y;
+  tmp.speed.z = s->speed.z + dt_2 * k1.speed.z;
+  tmp.pos.x = s->pos.x + dt_2 * k1.pos.x;
+  tmp.pos.y = s->pos.y + dt_2 * k1.pos.y;
+  tmp.pos.z = s->pos.z + dt_2 * k1.pos.z;
+  tmp.hb = s->hb + dt_2 * k1.hb;
+  tmp.as = s->as + dt_2 * k1.as;
+  ins_float_invariant_gen_model(&k2, &tmp, c, corr);
+  tmp.quat.qi = s->quat.qi + dt_2 * k2.quat.qi;
+  tmp.quat.qx = s->quat.qx + dt_2 * k2.quat.qx;
+  tmp.quat.qy = s->quat.qy + dt_2 * k2.quat.qy;
+  tmp.quat.qz = s->quat.qz + dt_2 * k2.quat.qz;
+  tmp.bias.p = s->bias.p + dt_2 * k2.bias.p;
+  tmp.bias.q = s->bias.q + dt_2 * k2.bias.q;
+  tmp.bias.r = s->bias.r + dt_2 * k2.bias.r;
+  tmp.speed.x = s->speed.x + dt_2 * k2.speed.x;
+  tmp.speed.y = s->speed.y + dt_2 * k2.speed.y;
+  tmp.speed.z = s->speed.z + dt_2 * k2.speed.z;
+  tmp.pos.x = s->pos.x + dt_2 * k2.pos.x;
+  tmp.pos.y = s->pos.y + dt_2 * k2.pos.y;
+  tmp.pos.z = s->pos.z + dt_2 * k2.pos.z;
+  tmp.hb = s->hb + dt_2 * k2.hb;
+  tmp.as = s->as + dt_2 * k2.as;
+  ins_float_invariant_gen_model(&k3, &tmp, c, corr);
+  tmp.quat.qi = s->quat.qi + dt * k3.quat.qi;
+  tmp.quat.qx = s->quat.qx + dt * k3.quat.qx;
+  tmp.quat.qy = s->quat.qy + dt * k3.quat.qy;
+  tmp.quat.qz = s->quat.qz + dt * k3.quat.qz;
+  tmp.bias.p = s->bias.p + dt * k3.bias.p;
+  tmp.bias.q = s->bias.q + dt * k3.bias.q;
+  tmp.bias.r = s->bias.r + dt * k3.bias.r;
+  tmp.speed.x = s->speed.x + dt * k3.speed.x;
+  tmp.speed.y = s->speed.y + dt * k3.speed.y;
+  tmp.speed.z = s->speed.z + dt * k3.speed.z;
+  tmp.pos.x = s->pos.x + dt * k3.pos.x;
+  tmp.pos.y = s->pos.y + dt * k3.pos.y;
+  tmp.pos.z = s->pos.z + dt * k3.pos.z;
+  tmp.hb = s->hb + dt * k3.hb;
+  tmp.as = s->as + dt * k3.as;
+  ins_float_invariant_gen_model(&k4, &tmp, c, corr);
+  s->quat.qi += dt_6 * (k1.quat.qi + 2.f * (k2.quat.qi + k3.quat.qi) + k4.quat.qi);
+  s->quat.qx += dt_6 * (k1.quat.qx + 2.f * (k2.quat.qx + k3.quat.qx) + k4.quat.qx);
+  s->quat.qy += dt_6 * (k1.quat.qy + 2.f * (k2.quat.qy + k3.quat.qy) + k4.quat.qy);
+  s->quat.qz += dt_6 * (k1.quat.qz + 2.f * (k2.quat.qz + k3.quat.qz) + k4.quat.qz);
+  s->bias.p += dt_6 * (k1.bias.p + 2.f * (k2.bias.p + k3.bias.p) + k4.bias.p);
+  s->bias.q += dt_6 * (k1.bias.q + 2.f * (k2.bias.q + k3.bias.q) + k4.bias.q);
+  s->bias.r += dt_6 * (k1.bias.r + 2.f * (k2.bias.r + k3.bias.r) + k4.bias.r);
+  s->speed.x += dt_6 * (k1.speed.x + 2.f * (k2.speed.x + k3.speed.x) + k4.speed.x);
+  s->speed.y += dt_6 * (k1.speed.y + 2.f * (k2.speed.y + k3.speed.y) + k4.speed.y);
+  s->speed.z += dt_6 * (k1.speed.z + 2.f * (k2.speed.z + k3.speed.z) + k4.speed.z);
+  s->pos.x += dt_6 * (k1.pos.x + 2.f * (k2.pos.x + k3.pos.x) + k4.pos.x);
+  s->pos.y += dt_6 * (k1.pos.y + 2.f * (k2.pos.y + k3.pos.y) + k4.pos.y);
+  s->pos.z += dt_6 * (k1.pos.z + 2.f * (k2.pos.z + k3.pos.z) + k4.pos.z);
+  s->hb += dt_6 * (k1.hb + 2.f * (k2.hb + k3.hb) + k4.hb);
+  s->as += dt_6 * (k1.as + 2.f * (k2.as + k3.as) + k4.as);
+}
+
+#endif /* INS_FLOAT_INVARIANT_GEN_H */
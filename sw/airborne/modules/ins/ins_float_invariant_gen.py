@@ -0,0 +1,285 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2026 Paparazzi Team
+#
+# This file is part of paparazzi.
+#
+# paparazzi is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2, or (at your option)
+# any later version.
+#
+# paparazzi is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with paparazzi; see the file COPYING.  If not, see
+# <http://www.gnu.org/licenses/>.
+
+"""
+Generate straight-line C code for the invariant filter (ins_float_invariant).
+
+The model and the correction terms are described symbolically (following
+invariant_model and error_output in ins_float_invariant.c), common
+subexpressions are eliminated and the result is written as inline functions
+in ins_float_invariant_gen.h, used when INS_INV_CODEGEN is TRUE.
+
+Run again after changing the model:
+    make -C sw/airborne/modules/ins gen
+and check that the committed header is up to date with:
+    make -C sw/airborne/modules/ins check_gen
+tests/math/test_ins_float_invariant_gen compares the generated functions
+with the hand-written ones.
+
+Requires sympy.
+"""
+
+import argparse
+import os
+import sympy as sp
+from sympy.printing.c import C99CodePrinter
+
+GRAVITY = sp.Float(9.81)
+
+# state fields in the order of struct inv_state
+STATE = ['quat.qi', 'quat.qx', 'quat.qy', 'quat.qz',
+         'bias.p', 'bias.q', 'bias.r',
+         'speed.x', 'speed.y', 'speed.z',
+         'pos.x', 'pos.y', 'pos.z',
+         'hb', 'as']
+
+
+class FloatPrinter(C99CodePrinter):
+    """ Print single precision constants and expand small integer powers """
+
+    def _print_Float(self, expr):
+        return '{:.9g}f'.format(float(expr))
+
+    def _print_Rational(self, expr):
+        return '{:.9g}f'.format(float(expr.p) / float(expr.q))
+
+    def _print_Integer(self, expr):
+        return '{}.f'.format(int(expr))
+
+    def _print_Pow(self, expr):
+        b, e = expr.as_base_exp()
+        if e.is_Integer and 0 < e <= 3:
+            return '(' + '*'.join([self.parenthesize(b, 100)] * int(e)) + ')'
+        if e == -1:
+            return '(1.f/{})'.format(self.parenthesize(b, 100))
+        return super()._print_Pow(expr)
+
+
+def vec(prefix, names=('x', 'y', 'z')):
+    return sp.Matrix([sp.Symbol('{}.{}'.format(prefix, n)) for n in names])
+
+
+def quat_vmult(q, v):
+    """ float_quat_vmult: same expression as the C kernel (also for non unit q) """
+    qi, qx, qy, qz = q
+    h = qi * qi - sp.Rational(1, 2)
+    m = sp.Matrix([[h + qx * qx, qx * qy + qi * qz, qx * qz - qi * qy],
+                   [qx * qy - qi * qz, h + qy * qy, qy * qz + qi * qx],
+                   [qx * qz + qi * qy, qy * qz - qi * qx, h + qz * qz]])
+    return 2 * m * v
+
+
+def quat_invert(q):
+    return [q[0], -q[1], -q[2], -q[3]]
+
+
+def model(s, c, corr):
+    """ invariant_model: state derivative """
+    q = [s['quat.qi'], s['quat.qx'], s['quat.qy'], s['quat.qz']]
+    bias = sp.Matrix([s['bias.p'], s['bias.q'], s['bias.r']])
+    speed = sp.Matrix([s['speed.x'], s['speed.y'], s['speed.z']])
+    r = c['rates'] - bias
+    # dot_q = 0.5 * q * (rates - bias) + LE * q + (1 - ||q||^2) * q
+    qd = [-sp.Rational(1, 2) * (r[0] * q[1] + r[1] * q[2] + r[2] * q[3]),
+          -sp.Rational(1, 2) * (-r[0] * q[0] - r[2] * q[2] + r[1] * q[3]),
+          -sp.Rational(1, 2) * (-r[1] * q[0] + r[2] * q[1] - r[0] * q[3]),
+          -sp.Rational(1, 2) * (-r[2] * q[0] - r[1] * q[1] + r[0] * q[2])]
+    # float_quat_vmul_right(q, LE)
+    LE = corr['LE']
+    qv = sp.Matrix(q[1:])
+    v = LE.cross(qv) + q[0] * LE
+    qr = [-LE.dot(qv), v[0], v[1], v[2]]
+    n2 = 1 - sum(x * x for x in q)
+    qd = [qd[i] + qr[i] + n2 * q[i] for i in range(4)]
+    # dot_V = A + (1/as) * (q * am * q-1) + ME
+    vd = quat_vmult(quat_invert(q), c['accel']) / s['as'] + sp.Matrix([0, 0, GRAVITY]) + corr['ME']
+    # dot_X = V + NE
+    xd = speed + corr['NE']
+    # bias_dot = q-1 * (OE) * q
+    bd = quat_vmult(q, corr['OE'])
+    # as_dot = as * RE (range limited in C), hb_dot = SE
+    asd = s['as'] * corr['RE']
+    hbd = corr['SE']
+    return list(qd) + list(bd) + list(vd) + list(xd) + [hbd, asd]
+
+
+def correction(s, c, mag, B, Ev, Ex, Eh, g):
+    """ error_output: correction terms from the errors """
+    q = [s['quat.qi'], s['quat.qx'], s['quat.qy'], s['quat.qz']]
+    q_b2n = quat_invert(q)
+    YBt = quat_vmult(q_b2n, mag)
+    I = quat_vmult(q_b2n, c['accel']) / s['as']
+    Eb = B - YBt
+    BxEb_I = B.cross(Eb).dot(I)
+    LE = (-g['lv'] / 100 * I).cross(Ev) + (g['lb'] / 100 * BxEb_I) * I
+    ME = sp.Matrix([-g['mv'] * Ev[0], -g['mv'] * Ev[1], -g['mvz'] * Ev[2] - g['mh'] * Eh])
+    NE = sp.Matrix([-g['nx'] * Ex[0], -g['nx'] * Ex[1], -g['nxz'] * Ex[2] - g['nh'] * Eh])
+    OE = (g['ov'] / 1000 * I).cross(Ev) + (-g['ob'] / 1000 * BxEb_I) * I
+    RE = g['rv'] / 100 * Ev.dot(I) - g['rh'] / 10000 * Eh
+    SE = g['sh'] * Eh
+    out = {}
+    for name, v in (('LE', LE), ('ME', ME), ('NE', NE), ('OE', OE)):
+        for i, n in enumerate('xyz'):
+            out['{}.{}'.format(name, n)] = v[i]
+    out['RE'] = RE
+    out['SE'] = SE
+    return out
+
+
+def c_name(sym, ptr):
+    """ map a symbol 'a.b' to the C access 'ptr->a.b' """
+    return '{}->{}'.format(ptr, sym)
+
+
+def emit(assignments, inputs, printer, indent='  '):
+    """ CSE and print a list of (lhs, expr), inputs maps symbols to C expressions """
+    lhs = [a[0] for a in assignments]
+    exprs = [a[1] for a in assignments]
+    sub, red = sp.cse(exprs, symbols=sp.numbered_symbols('t'), optimizations='basic')
+    lines = []
+    repl = {k: sp.Symbol(v) for k, v in inputs.items()}
+    for t, e in sub:
+        lines.append('{}const float {} = {};'.format(indent, t, printer.doprint(e.xreplace(repl))))
+    for l, e in zip(lhs, red):
+        lines.append('{}{} = {};'.format(indent, l, printer.doprint(e.xreplace(repl))))
+    return lines
+
+
+def generate():
+    printer = FloatPrinter()
+    s = {n: sp.Symbol('s.' + n) for n in STATE}
+    c = {'rates': vec('c.rates', ('p', 'q', 'r')), 'accel': vec('c.accel')}
+    corr = {'LE': vec('corr.LE'), 'ME': vec('corr.ME'), 'NE': vec('corr.NE'), 'OE': vec('corr.OE'),
+            'RE': sp.Symbol('corr.RE'), 'SE': sp.Symbol('corr.SE')}
+    inputs = {}
+    for n, v in s.items():
+        inputs[v] = 's->' + n
+    for v in list(c['rates']) + list(c['accel']):
+        inputs[v] = 'c->' + v.name[2:]
+    for k in ('LE', 'ME', 'NE', 'OE'):
+        for v in corr[k]:
+            inputs[v] = 'corr->' + v.name[5:]
+    inputs[corr['RE']] = 'corr->RE'
+    inputs[corr['SE']] = 'corr->SE'
+
+    out = []
+    out.append('''/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file modules/ins/ins_float_invariant_gen.h
+ *
+ * Straight-line model, correction and RK4 propagation of the invariant filter.
+ *
+ * Generated by ins_float_invariant_gen.py, do not edit.
+ */
+
+#ifndef INS_FLOAT_INVARIANT_GEN_H
+#define INS_FLOAT_INVARIANT_GEN_H
+
+#include "modules/ins/ins_float_invariant.h"
+''')
+
+    # model
+    sd = model(s, c, corr)
+    out.append('/** State derivative (invariant_model) */')
+    out.append('static inline void ins_float_invariant_gen_model(struct inv_state *sd, const struct inv_state *s,')
+    out.append('    const struct inv_command *c, const struct inv_correction_gains *corr)')
+    out.append('{')
+    out += emit([('sd->' + n, e) for n, e in zip(STATE, sd)], inputs, printer)
+    out.append('  // keep as in a reasonable range, so 50% around the nominal value')
+    out.append('  if (((s->as < 0.5f) && (sd->as < 0.f)) || ((s->as > 1.5f) && (sd->as > 0.f))) {')
+    out.append('    sd->as = 0.f;')
+    out.append('  }')
+    out.append('}\n')
+
+    # correction
+    mag = vec('mag')
+    B = vec('mag_h')
+    Ev = vec('Ev')
+    Ex = vec('Ex')
+    Eh = sp.Symbol('Eh')
+    g = {n: sp.Symbol('g.' + n) for n in ('lv', 'lb', 'mv', 'mvz', 'mh', 'nx', 'nxz', 'nh', 'ov', 'ob', 'rv', 'rh', 'sh')}
+    cinputs = {}
+    for n in ('quat.qi', 'quat.qx', 'quat.qy', 'quat.qz', 'as'):
+        cinputs[s[n]] = 's->' + n
+    for v in c['accel']:
+        cinputs[v] = 'c->' + v.name[2:]
+    for p, v3 in (('mag', mag), ('mag_h', B), ('Ev', Ev), ('Ex', Ex)):
+        for v in v3:
+            cinputs[v] = '{}->{}'.format(p, v.name[len(p) + 1:])
+    cinputs[Eh] = 'Eh'
+    for n, v in g.items():
+        cinputs[v] = 'g->' + n
+    co = correction(s, c, mag, B, Ev, Ex, Eh, g)
+    out.append('/** Correction terms from the output errors (error_output) */')
+    out.append('static inline void ins_float_invariant_gen_correction(struct inv_correction_gains *corr,')
+    out.append('    const struct inv_state *s, const struct inv_command *c, const struct FloatVect3 *mag,')
+    out.append('    const struct FloatVect3 *mag_h, const struct FloatVect3 *Ev, const struct FloatVect3 *Ex, float Eh,')
+    out.append('    const struct inv_gains *g)')
+    out.append('{')
+    out += emit([('corr->' + n, e) for n, e in co.items()], cinputs, printer)
+    out.append('}\n')
+
+    # RK4
+    out.append('/** Fourth order Runge-Kutta propagation of the state (runge_kutta_4_float) */')
+    out.append('static inline void ins_float_invariant_gen_propagate(struct inv_state *s,')
+    out.append('    const struct inv_command *c, const struct inv_correction_gains *corr, float dt)')
+    out.append('{')
+    out.append('  struct inv_state k1, k2, k3, k4, tmp;')
+    out.append('  const float dt_2 = 0.5f * dt;')
+    out.append('  const float dt_6 = dt / 6.f;')
+    out.append('  ins_float_invariant_gen_model(&k1, s, c, corr);')
+    for k, kn, f in (('k1', 'k2', 'dt_2'), ('k2', 'k3', 'dt_2'), ('k3', 'k4', 'dt')):
+        for n in STATE:
+            out.append('  tmp.{0} = s->{0} + {1} * {2}.{0};'.format(n, f, k))
+        out.append('  ins_float_invariant_gen_model(&{}, &tmp, c, corr);'.format(kn))
+    for n in STATE:
+        out.append('  s->{0} += dt_6 * (k1.{0} + 2.f * (k2.{0} + k3.{0}) + k4.{0});'.format(n))
+    out.append('}\n')
+
+    out.append('#endif /* INS_FLOAT_INVARIANT_GEN_H */')
+    return '\n'.join(out) + '\n'
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('-o', '--output', help='output file',
+                        default=os.path.join(os.path.dirname(os.path.abspath(__file__)), 'ins_float_invariant_gen.h'))
+    args = parser.parse_args()
+    with open(args.output, 'w') as f:
+        f.write(generate())
@@ -39,6 +39,7 @@
 #include "mcu_periph/sys_time.h"
 #include "autopilot.h"
 #include "math/pprz_algebra_float.h"
+#include "math/pprz_matrix_decomp_fixed_float.h"
 #include "generated/airframe.h"
 #include "generated/flight_plan.h"
 #include "mcu_periph/sys_time.h"
@@ -1137,7 +1138,10 @@ void ins_flow_update(void)
     MAKE_MATRIX_PTR(K, _K, N_STATES_OF_KF);
     float _INVS[N_MEAS_OF_KF][N_MEAS_OF_KF];
     MAKE_MATRIX_PTR(INVS, _INVS, N_MEAS_OF_KF);
-    float_mat_invert(INVS, S, N_MEAS_OF_KF);
+    // S is symmetric positive definite
+    if (!PPRZ_MATRIX_DECOMP_FIXED(pprz_cholesky_inv_float, N_MEAS_OF_KF)(&_INVS[0][0], &_S[0][0])) {
+      float_mat_invert(INVS, S, N_MEAS_OF_KF);
+    }
     if (DEBUG_INS_FLOW) {
       // This should be the identity matrix:
       float _SINVS[N_MEAS_OF_KF][N_MEAS_OF_KF];
@@ -96,6 +96,50 @@
 #define INS_MAX_PROPAGATION_STEPS 200
 #endif
 
+/** Fuse the vertical filter measurements at the time they were taken,
+ * using a history of the past filter states
+ */
+#ifndef INS_INT_DELAYED_FUSION
+#define INS_INT_DELAYED_FUSION FALSE
+#endif
+
+#if INS_INT_DELAYED_FUSION
+#include "utils/state_history.h"
+
+/** number of stored propagation steps (power of two),
+ * bounds the compensated delay and the replay cost
+ */
+#ifndef INS_INT_HISTORY_SIZE
+#define INS_INT_HISTORY_SIZE 64
+#endif
+
+/** max number of measurements stored with one propagation step */
+#ifndef INS_INT_HISTORY_MEAS
+#define INS_INT_HISTORY_MEAS 3
+#endif
+#endif
+
+/** sensor delays in seconds, only used with INS_INT_DELAYED_FUSION */
+#ifndef INS_INT_BARO_DELAY
+#define INS_INT_BARO_DELAY 0.f
+#endif
+
+#ifndef INS_INT_GPS_DELAY
+#define INS_INT_GPS_DELAY 0.f
+#endif
+
+#ifndef INS_INT_AGL_DELAY
+#define INS_INT_AGL_DELAY 0.f
+#endif
+
+#ifndef INS_INT_VEL_DELAY
+#define INS_INT_VEL_DELAY 0.f
+#endif
+
+#ifndef INS_INT_POS_DELAY
+#define INS_INT_POS_DELAY 0.f
+#endif
+
 #ifndef USE_INS_NAV_INIT
 #define USE_INS_NAV_INIT TRUE
 PRINT_CONFIG_MSG("USE_INS_NAV_INIT defaulting to TRUE")
@@ -199,6 +243,139 @@ static void ins_update_from_vff(void);
 static void ins_update_from_hff(void);
 #endif
 
+/** vertical filter measurements */
+enum ins_int_vff_meas_type {
+  INS_VFF_BARO,
+  INS_VFF_Z,
+  INS_VFF_VZ,
+  INS_VFF_AGL
+};
+
+struct ins_int_vff_meas {
+  uint8_t type;
+  float value;
+  float conf;
+};
+
+static void ins_int_vff_apply(const struct ins_int_vff_meas *m)
+{
+  switch (m->type) {
+    case INS_VFF_BARO:
+#if USE_VFF_EXTENDED
+      vff_update_baro(m->value);
+#else
+      vff_update(m->value);
+#endif
+      break;
+    case INS_VFF_Z:
+      vff_update_z_conf(m->value, m->conf);
+      break;
+    case INS_VFF_VZ:
+      vff_update_vz_conf(m->value, m->conf);
+      break;
+#if USE_VFF_EXTENDED
+    case INS_VFF_AGL:
+      vff_update_agl(m->value, m->conf);
+      break;
+#endif
+    default:
+      break;
+  }
+}
+
+#if INS_INT_DELAYED_FUSION
+/** vertical filter after a propagation step and the measurements fused in it */
+struct ins_int_vff_snapshot {
+#if USE_VFF_EXTENDED
+  struct VffExtended vff;
+#else
+  struct Vff vff;
+#endif
+  float accel;    ///< vertical accel used for the propagation
+  float dt;       ///< propagation time step
+  uint8_t nb_meas;
+  struct ins_int_vff_meas meas[INS_INT_HISTORY_MEAS];
+};
+
+static struct ins_int_vff_snapshot ins_int_snapshots[INS_INT_HISTORY_SIZE];
+static uint32_t ins_int_snapshot_stamps[INS_INT_HISTORY_SIZE];
+static struct state_history ins_int_history;
+
+/** redo a propagation step and its measurements from the previous snapshot */
+static void ins_int_vff_replay_step(void *elt, const void *prev, void *user __attribute__((unused)))
+{
+  struct ins_int_vff_snapshot *s = (struct ins_int_vff_snapshot *)elt;
+  vff = ((const struct ins_int_vff_snapshot *)prev)->vff;
+  vff_propagate(s->accel, s->dt);
+  for (uint8_t i = 0; i < s->nb_meas; i++) {
+    ins_int_vff_apply(&s->meas[i]);
+  }
+  s->vff = vff;
+}
+#endif
+
+/** timestamp of the last propagation step */
+static uint32_t ins_int_stamp;
+
+/**
+ * Fuse a vertical filter measurement.
+ * With INS_INT_DELAYED_FUSION, it is fused in the stored state valid at
+ * stamp - delay and the following steps are propagated again, otherwise
+ * it is fused in the current state.
+ */
+static void ins_int_vff_fuse(uint32_t stamp, float delay, uint8_t type, float value, float conf)
+{
+  struct ins_int_vff_meas m = { type, value, conf };
+#if INS_INT_DELAYED_FUSION
+  uint32_t nb = state_history_count(&ins_int_history);
+  if (nb > 0) {
+    int32_t idx = state_history_find(&ins_int_history, stamp - (uint32_t)(delay * 1e6f));
+    if (idx < 0) {
+      // older than the history, use the oldest state
+      idx = 0;
+    }
+    struct ins_int_vff_snapshot *s = state_history_get(&ins_int_history, idx);
+    if (s->nb_meas < INS_INT_HISTORY_MEAS) {
+      s->meas[s->nb_meas++] = m;
+      vff = s->vff;
+      ins_int_vff_apply(&m);
+      s->vff = vff;
+      state_history_replay(&ins_int_history, idx, ins_int_vff_replay_step, NULL);
+      vff = ((struct ins_int_vff_snapshot *)state_history_get(&ins_int_history, nb - 1))->vff;
+      return;
+    }
+    // no room left in this step, fuse in the current state
+    ins_int_vff_apply(&m);
+    ((struct ins_int_vff_snapshot *)state_history_get(&ins_int_history, nb - 1))->vff = vff;
+    return;
+  }
+#else
+  (void) stamp;
+  (void) delay;
+#endif
+  ins_int_vff_apply(&m);
+}
+
+/** store the vertical filter after a propagation step */
+static void ins_int_vff_store(float accel __attribute__((unused)), float dt __attribute__((unused)))
+{
+#if INS_INT_DELAYED_FUSION
+  struct ins_int_vff_snapshot *s = state_history_push(&ins_int_history, ins_int_stamp);
+  s->vff = vff;
+  s->accel = accel;
+  s->dt = dt;
+  s->nb_meas = 0;
+#endif
+}
+
+/** drop the stored states after a filter reset */
+static void ins_int_vff_reset_history(void)
+{
+#if INS_INT_DELAYED_FUSION
+  state_history_reset(&ins_int_history);
+#endif
+}
+
 
 void ins_int_init(void)
 {
@@ -222,6 +399,10 @@ void ins_int_init(void)
 
   /* init vertical and horizontal filters */
   vff_init_zero();
+#if INS_INT_DELAYED_FUSION
+  state_history_init(&ins_int_history, ins_int_snapshots, ins_int_snapshot_stamps,
+                     INS_INT_HISTORY_SIZE, sizeof(struct ins_int_vff_snapshot));
+#endif
 #if USE_HFF
   hff_init(0., 0., 0., 0.);
 #endif
@@ -311,8 +492,10 @@ void ins_int_propagate(struct Int32Vect3 *accel, float dt)
    */
   if (ins_int.propagation_cnt < INS_MAX_PROPAGATION_STEPS) {
     vff_propagate(z_accel_meas_float, dt);
+    ins_int_vff_store(z_accel_meas_float, dt);
     ins_update_from_vff();
   } else {
+    ins_int_vff_reset_history();
     // feed accel from the sensors
     // subtract -9.81m/s2 (acceleration measured due to gravity,
     // but vehicle not accelerating in ltp)
@@ -337,7 +520,7 @@ void ins_int_propagate(struct Int32Vect3 *accel, float dt)
   }
 }
 
-static void baro_cb(uint8_t __attribute__((unused)) sender_id, __attribute__((unused)) uint32_t stamp, float pressure)
+static void baro_cb(uint8_t __attribute__((unused)) sender_id, uint32_t stamp, float pressure)
 {
   if (pressure < 1.f)
   {
@@ -376,6 +559,7 @@ static void baro_cb(uint8_t __attribute__((unused)) sender_id, __attribute__((un
       ins_int.vf_reset = false;
       ins_int.qfe = pressure;
       vff_realign(height_correction);
+      ins_int_vff_reset_history();
       ins_update_from_vff();
     }
 
@@ -384,11 +568,7 @@ static void baro_cb(uint8_t __attribute__((unused)) sender_id, __attribute__((un
     // The VFF will update in the NED frame
     ins_int.baro_z = -(baro_up - height_correction);
 
-#if USE_VFF_EXTENDED
-    vff_update_baro(ins_int.baro_z);
-#else
-    vff_update(ins_int.baro_z);
-#endif
+    ins_int_vff_fuse(stamp, INS_INT_BARO_DELAY, INS_VFF_BARO, ins_int.baro_z, 0.f);
 
     /* reset the counter to indicate we just had a measurement update */
     ins_int.propagation_cnt = 0;
@@ -396,7 +576,14 @@ static void baro_cb(uint8_t __attribute__((unused)) sender_id, __attribute__((un
 }
 
 #if USE_GPS
+static void ins_int_update_gps_stamped(struct GpsState *gps_s, uint32_t stamp);
+
 void ins_int_update_gps(struct GpsState *gps_s)
+{
+  ins_int_update_gps_stamped(gps_s, ins_int_stamp);
+}
+
+static void ins_int_update_gps_stamped(struct GpsState *gps_s, uint32_t stamp)
 {
   if (gps_s->fix < GPS_FIX_3D) {
     return;
@@ -433,10 +620,10 @@ void ins_int_update_gps(struct GpsState *gps_s)
   ned_of_ecef_vect_i(&gps_speed_cm_s_ned, &ins_int.ltp_def, &ecef_vel_i);
 
 #if INS_USE_GPS_ALT
-  vff_update_z_conf(((float)gps_pos_cm_ned.z) / 100.0, INS_VFF_R_GPS);
+  ins_int_vff_fuse(stamp, INS_INT_GPS_DELAY, INS_VFF_Z, ((float)gps_pos_cm_ned.z) / 100.0, INS_VFF_R_GPS);
 #endif
 #if INS_USE_GPS_ALT_SPEED
-  vff_update_vz_conf(((float)gps_speed_cm_s_ned.z) / 100.0, INS_VFF_VZ_R_GPS);
+  ins_int_vff_fuse(stamp, INS_INT_GPS_DELAY, INS_VFF_VZ, ((float)gps_speed_cm_s_ned.z) / 100.0, INS_VFF_VZ_R_GPS);
   ins_int.propagation_cnt = 0;
 #endif
 
@@ -474,6 +661,8 @@ void ins_int_update_gps(struct GpsState *gps_s)
 }
 #else
 void ins_int_update_gps(struct GpsState *gps_s __attribute__((unused))) {}
+static void ins_int_update_gps_stamped(struct GpsState *gps_s __attribute__((unused)),
+                                       uint32_t stamp __attribute__((unused))) {}
 #endif /* USE_GPS */
 
 /** agl_cb
@@ -481,7 +670,7 @@ void ins_int_update_gps(struct GpsState *gps_s __attribute__((unused))) {}
  * This is only used with the extended version of the vertical float filter
  */
 #if USE_VFF_EXTENDED
-static void agl_cb(uint8_t __attribute__((unused)) sender_id, __attribute__((unused)) uint32_t stamp, float distance) {
+static void agl_cb(uint8_t __attribute__((unused)) sender_id, uint32_t stamp, float distance) {
   if (distance <= 0 || !(ins_int.baro_initialized)) {
     return;
   }
@@ -503,10 +692,10 @@ static void agl_cb(uint8_t __attribute__((unused)) sender_id, __attribute__((unu
 #endif
 
 #if USE_SONAR
-  vff_update_agl(-distance, VFF_R_SONAR_0 + VFF_R_SONAR_OF_M * fabsf(distance));
+  ins_int_vff_fuse(stamp, INS_INT_AGL_DELAY, INS_VFF_AGL, -distance, VFF_R_SONAR_0 + VFF_R_SONAR_OF_M * fabsf(distance));
 #else
   // TODO: this assumes that you will either have sonar or other agl sensor never both
-  vff_update_agl(-distance, VFF_R_AGL);
+  ins_int_vff_fuse(stamp, INS_INT_AGL_DELAY, INS_VFF_AGL, -distance, VFF_R_AGL);
 #endif
     /* reset the counter to indicate we just had a measurement update */
     ins_int.propagation_cnt = 0;
@@ -560,23 +749,24 @@ static void accel_cb(uint8_t sender_id __attribute__((unused)),
 
   if (last_stamp > 0) {
     float dt = (float)(stamp - last_stamp) * 1e-6;
+    ins_int_stamp = stamp;
     ins_int_propagate(accel, dt);
   }
   last_stamp = stamp;
 }
 
 static void gps_cb(uint8_t sender_id __attribute__((unused)),
-                   uint32_t stamp __attribute__((unused)),
+                   uint32_t stamp,
                    struct GpsState *gps_s)
 {
-  ins_int_update_gps(gps_s);
+  ins_int_update_gps_stamped(gps_s, stamp);
 }
 
 /* body relative velocity estimate
  *
  */
 static void vel_est_cb(uint8_t sender_id __attribute__((unused)),
-                       uint32_t stamp __attribute__((unused)),
+                       uint32_t stamp,
                        float x, float y, float z,
                        float noise_x, float noise_y, float noise_z)
 {
@@ -627,7 +817,7 @@ static void vel_est_cb(uint8_t sender_id __attribute__((unused)),
 #endif
 
   // abi message contains an update to the vertical velocity estimate
-  vff_update_vz_conf(vel_ned.z, noise_z);
+  ins_int_vff_fuse(stamp, INS_INT_VEL_DELAY, INS_VFF_VZ, vel_ned.z, noise_z);
 
   ins_ned_to_state();
 
@@ -638,7 +828,7 @@ static void vel_est_cb(uint8_t sender_id __attribute__((unused)),
 /* NED position estimate relative to ltp origin
  */
 static void pos_est_cb(uint8_t sender_id __attribute__((unused)),
-                       uint32_t stamp __attribute__((unused)),
+                       uint32_t stamp,
                        float x, float y, float z,
                        float noise_x, float noise_y, float noise_z)
 {
@@ -660,7 +850,7 @@ static void pos_est_cb(uint8_t sender_id __attribute__((unused)),
   }
 #endif
 
-  vff_update_z_conf(z, noise_z);
+  ins_int_vff_fuse(stamp, INS_INT_POS_DELAY, INS_VFF_Z, z, noise_z);
 
   ins_ned_to_state();
 
@@ -3,30 +3,15 @@
 #include <stdio.h>
 #include "std.h"
 #include <math.h>
+#include <string.h>
 
-#include "mcu_periph/sys_time.h" // FOR DEBUG
+#include "mcu_periph/sys_time.h"
 
 #include <matrix/math.hpp>
-
-// Covariance matrix elements and size
-enum ekfAwCovVar {
-  EKF_AW_u_index, EKF_AW_v_index, EKF_AW_w_index,
-  EKF_AW_mu_x_index, EKF_AW_mu_y_index, EKF_AW_mu_z_index,
-  EKF_AW_k_x_index, EKF_AW_k_y_index, EKF_AW_k_z_index,
-  EKF_AW_COV_SIZE
-};
+#include "modules/meteo/ekf_aw_cov.h"
 
 typedef matrix::SquareMatrix<float, EKF_AW_COV_SIZE> EKF_Aw_Cov;
 
-// Process noise elements and size
-enum ekfAwQVar {
-  EKF_AW_Q_accel_x_index, EKF_AW_Q_accel_y_index, EKF_AW_Q_accel_z_index,
-  EKF_AW_Q_gyro_x_index,  EKF_AW_Q_gyro_y_index,  EKF_AW_Q_gyro_z_index,
-  EKF_AW_Q_mu_x_index,    EKF_AW_Q_mu_y_index,    EKF_AW_Q_mu_z_index,
-  EKF_AW_Q_k_x_index,     EKF_AW_Q_k_y_index,     EKF_AW_Q_k_z_index,
-  EKF_AW_Q_SIZE
-};
-
 typedef matrix::SquareMatrix<float, EKF_AW_Q_SIZE> EKF_Aw_Q;
 
 // Measurement noise elements and size
@@ -81,11 +66,12 @@ struct ekfAwPrivate {
   struct ekfAwMeasurements innovations;
   struct ekfAwForces forces;
 
-  EKF_Aw_Cov P;
+  EKF_Aw_Kf kf;     ///< error state filter holding the state covariance
   EKF_Aw_Q Q;
   EKF_Aw_R R;
 
   struct ekfHealth health;
+  struct ekfAwTiming timing;
 };
 
 // Parameters Process Noise
@@ -351,9 +337,10 @@ struct ekfAwPrivate {
 #define EKF_AW_SKEW_POLY_2 0.0f
 #endif
 
-// FOR DEBUG
-#ifndef EKF_AW_DEBUG
-#define EKF_AW_DEBUG false
+// Measurement update one scalar measurement at a time (no matrix inversion)
+// instead of the batch update
+#ifndef EKF_AW_SEQUENTIAL_UPDATE
+#define EKF_AW_SEQUENTIAL_UPDATE true
 #endif
 
 /*
@@ -371,6 +358,10 @@ S calculation G*P*G^T+R     | 28
 Kalman gain calc P*G^T*S^-1 | 48
 State update                | 7
 Cov Update P=(I-K*G)*P      | 36
+
+The last four lines are the batch update, replaced by default with
+sequential scalar updates (EKF_AW_SEQUENTIAL_UPDATE).
+Actual timing is available with ekf_aw_get_timing().
 */
 
 // Parameters
@@ -435,16 +426,17 @@ static void init_ekf_aw_state(void)
   eawp.forces.pusher.setZero();
 
   // Init State Covariance
-  eawp.P.setZero();
-  eawp.P(EKF_AW_u_index, EKF_AW_u_index) = EKF_AW_P0_V_BODY;
-  eawp.P(EKF_AW_v_index, EKF_AW_v_index) = EKF_AW_P0_V_BODY;
-  eawp.P(EKF_AW_w_index, EKF_AW_w_index) = EKF_AW_P0_V_BODY;
-  eawp.P(EKF_AW_mu_x_index, EKF_AW_mu_x_index) = EKF_AW_P0_MU;
-  eawp.P(EKF_AW_mu_y_index, EKF_AW_mu_y_index) = EKF_AW_P0_MU;
-  eawp.P(EKF_AW_mu_z_index, EKF_AW_mu_z_index) = EKF_AW_P0_MU;
-  eawp.P(EKF_AW_k_x_index, EKF_AW_k_x_index) = EKF_AW_P0_OFFSET;
-  eawp.P(EKF_AW_k_y_index, EKF_AW_k_y_index) = EKF_AW_P0_OFFSET;
-  eawp.P(EKF_AW_k_z_index, EKF_AW_k_z_index) = EKF_AW_P0_OFFSET;
+  float P0_diag[EKF_AW_COV_SIZE];
+  P0_diag[EKF_AW_u_index] = EKF_AW_P0_V_BODY;
+  P0_diag[EKF_AW_v_index] = EKF_AW_P0_V_BODY;
+  P0_diag[EKF_AW_w_index] = EKF_AW_P0_V_BODY;
+  P0_diag[EKF_AW_mu_x_index] = EKF_AW_P0_MU;
+  P0_diag[EKF_AW_mu_y_index] = EKF_AW_P0_MU;
+  P0_diag[EKF_AW_mu_z_index] = EKF_AW_P0_MU;
+  P0_diag[EKF_AW_k_x_index] = EKF_AW_P0_OFFSET;
+  P0_diag[EKF_AW_k_y_index] = EKF_AW_P0_OFFSET;
+  P0_diag[EKF_AW_k_z_index] = EKF_AW_P0_OFFSET;
+  eawp.kf.init(NULL, P0_diag);
 
   // Init Process and Measurements Noise Matrix
   ekf_aw_update_params();
@@ -544,6 +536,9 @@ void ekf_aw_init(void)
   // Init crashes number
   eawp.health.crashes_n = 0;
 
+  // Init timing counters
+  memset(&eawp.timing, 0, sizeof(eawp.timing));
+
   // Init quick convergence
   ekf_aw_params.quick_convergence = false;
 
@@ -598,10 +593,7 @@ void ekf_aw_propagate(struct FloatVect3 *acc, struct FloatRates *gyro, struct Fl
   z = [V_x V_y V_z a_x a_y a_z];
   */
 
-  // FOR DEBUG
-  uint32_t tic = get_sys_time_usec(); uint32_t duration_1; uint32_t duration_2; uint32_t duration_3; uint32_t duration_4;
-  uint32_t duration_5; uint32_t duration_6; uint32_t duration_7; uint32_t duration_8; uint32_t duration_9;
-  uint32_t duration_10; uint32_t duration_11;
+  uint32_t tic = get_sys_time_usec();
 
   // Exit filter if the filter crashed for more than 5s
   if (eawp.health.crashes_n > floor(5.0f / dt)) {
@@ -650,19 +642,10 @@ void ekf_aw_propagate(struct FloatVect3 *acc, struct FloatRates *gyro, struct Fl
   float sign_u = u < 0.0f ? -1.0f : u > 0.0f ? 1.0f : 0.0f;
   float sign_v = v < 0.0f ? -1.0f : v > 0.0f ? 1.0f : 0.0f;
 
-  float p = eawp.inputs.rates(0);
-  float q = eawp.inputs.rates(1);
-  float r = eawp.inputs.rates(2);
-
   float phi = eawp.inputs.euler(0);
   float theta = eawp.inputs.euler(1);
   float psi = eawp.inputs.euler(2);
 
-  // FOR DEBUG
-  if (EKF_AW_DEBUG) {
-    duration_1 = get_sys_time_usec() - tic;
-  }
-
   float cos_phi = cosf(phi);
   float sin_phi = sinf(phi);
   float cos_theta = cosf(theta);
@@ -673,10 +656,6 @@ void ekf_aw_propagate(struct FloatVect3 *acc, struct FloatRates *gyro, struct Fl
   float cos_skew = cosf(eawp.inputs.skew);
   float sin_skew = sinf(eawp.inputs.skew);
 
-  // FOR DEBUG
-#if EKF_AW_DEBUG
-  duration_2 = get_sys_time_usec() - tic;
-#endif
 
   // DCM from Euler Angles
   matrix::Matrix3f dcm;
@@ -718,10 +697,6 @@ void ekf_aw_propagate(struct FloatVect3 *acc, struct FloatRates *gyro, struct Fl
   // Verify vehicle mass is not 0
   ekf_aw_params.vehicle_mass = fabsf(ekf_aw_params.vehicle_mass) < 1E-1 ? 1E-1 : ekf_aw_params.vehicle_mass;
 
-  // FOR DEBUG
-#if EKF_AW_DEBUG
-  duration_3 = get_sys_time_usec() - tic;
-#endif
 
   /////////////////////////////////
   //    Special Conditions       //
@@ -838,38 +813,12 @@ void ekf_aw_propagate(struct FloatVect3 *acc, struct FloatRates *gyro, struct Fl
   //    Propagate Covariance     //
   /////////////////////////////////
 
-  // FOR DEBUG
-#if EKF_AW_DEBUG
-  duration_4 = get_sys_time_usec() - tic;
-#endif
-
-  // This is an optimized version using code generation from Matlab, as L and F are sparse matrix
-  // Goes from approx 4000 operation to 120 operations
-  eawp.P.setZero();
-  eawp.P(0, 0) = eawp.Q(0, 0) + q * (q * eawp.P(2, 2) - r * eawp.P(1, 2)) - r * (q * eawp.P(2, 1) - r * eawp.P(1,
-                 1)) + v * v * eawp.Q(5, 5) + w * w * eawp.Q(4, 4);
-  eawp.P(0, 1) = r * (q * eawp.P(2, 0) - r * eawp.P(1, 0)) - p * (q * eawp.P(2, 2) - r * eawp.P(1, 2)) - u * v * eawp.Q(5,
-                 5);
-  eawp.P(0, 2) = p * (q * eawp.P(2, 1) - r * eawp.P(1, 1)) - q * (q * eawp.P(2, 0) - r * eawp.P(1, 0)) - u * w * eawp.Q(4,
-                 4);
-  eawp.P(1, 0) = r * (p * eawp.P(2, 1) - r * eawp.P(0, 1)) - q * (p * eawp.P(2, 2) - r * eawp.P(0, 2)) - u * v * eawp.Q(5,
-                 5);
-  eawp.P(1, 1) = eawp.Q(1, 1) + p * (p * eawp.P(2, 2) - r * eawp.P(0, 2)) - r * (p * eawp.P(2, 0) - r * eawp.P(0,
-                 0)) + u * u * eawp.Q(5, 5) + w * w * eawp.Q(3, 3);
-  eawp.P(1, 2) = q * (p * eawp.P(2, 0) - r * eawp.P(0, 0)) - p * (p * eawp.P(2, 1) - r * eawp.P(0, 1)) - v * w * eawp.Q(3,
-                 3);
-  eawp.P(2, 0) = q * (p * eawp.P(1, 2) - q * eawp.P(0, 2)) - r * (p * eawp.P(1, 1) - q * eawp.P(0, 1)) - u * w * eawp.Q(4,
-                 4);
-  eawp.P(2, 1) = r * (p * eawp.P(1, 0) - q * eawp.P(0, 0)) - p * (p * eawp.P(1, 2) - q * eawp.P(0, 2)) - v * w * eawp.Q(3,
-                 3);
-  eawp.P(2, 2) = eawp.Q(2, 2) + p * (p * eawp.P(1, 1) - q * eawp.P(0, 1)) - q * (p * eawp.P(1, 0) - q * eawp.P(0,
-                 0)) + u * u * eawp.Q(4, 4) + v * v * eawp.Q(3, 3);
-  eawp.P(3, 3) = eawp.Q(6, 6);
-  eawp.P(4, 4) = eawp.Q(7, 7);
-  eawp.P(5, 5) = eawp.Q(8, 8);
-  eawp.P(6, 6) = eawp.Q(9, 9);
-  eawp.P(7, 7) = eawp.Q(10, 10);
-  eawp.P(8, 8) = eawp.Q(11, 11);
+  // Generated sparse version of P = L Q L^T, see ekf_aw_propagate_cov()
+  float Q_diag[EKF_AW_Q_SIZE];
+  for (int i = 0; i < EKF_AW_Q_SIZE; i++) {
+    Q_diag[i] = eawp.Q(i, i);
+  }
+  ekf_aw_propagate_cov(eawp.kf.P, Q_diag, u, v, w);
 
   // Other way of calculating covariance, but involves more operations:
   /*
@@ -922,10 +871,9 @@ void ekf_aw_propagate(struct FloatVect3 *acc, struct FloatRates *gyro, struct Fl
   eawp.P = F * eawp.P * F.transpose() + L * eawp.Q * L.transpose();
   */
 
-  // FOR DEBUG
-#if EKF_AW_DEBUG
-  duration_5 = get_sys_time_usec() - tic;
-#endif
+  uint32_t tic_update = get_sys_time_usec();
+  eawp.timing.propagate_us = tic_update - tic;
+
   ///////////////////////////////////////////
   //  Measurement estimation from state    //
   ///////////////////////////////////////////
@@ -1008,10 +956,6 @@ void ekf_aw_propagate(struct FloatVect3 *acc, struct FloatRates *gyro, struct Fl
   //std::cout << "Innov accel_filt:\n" << eawp.innovations.accel_filt << std::endl;
   //std::cout << "Euler:\n" << eawp.inputs.euler << std::endl;
 
-  // FOR DEBUG
-#if EKF_AW_DEBUG
-  duration_6 = get_sys_time_usec() - tic;
-#endif
 
   /////////////////////////////////
   //         State Update        //
@@ -1157,26 +1101,64 @@ void ekf_aw_propagate(struct FloatVect3 *acc, struct FloatRates *gyro, struct Fl
   // V_pitot related lines
   G(6, 0) = 1;
 
-  // FOR DEBUG
-#if EKF_AW_DEBUG
-  duration_7 = get_sys_time_usec() - tic;
-#endif
+#if EKF_AW_SEQUENTIAL_UPDATE
+  // Sequential update with FixedKalmanFilter, valid as R is diagonal: the
+  // measurements are fused one at a time, their innovation corrected by the
+  // state change of the previous ones. Pitot is only fused when used and the
+  // offset is not corrected when it is not estimated. The error state is
+  // injected in the state, a failed update restores the covariance.
+  float innov[EKF_AW_R_SIZE];
+  innov[EKF_AW_R_V_gnd_x_index] = eawp.innovations.V_gnd(0);
+  innov[EKF_AW_R_V_gnd_y_index] = eawp.innovations.V_gnd(1);
+  innov[EKF_AW_R_V_gnd_z_index] = eawp.innovations.V_gnd(2);
+  innov[EKF_AW_R_a_x_filt_index] = eawp.innovations.accel_filt(0);
+  innov[EKF_AW_R_a_y_filt_index] = eawp.innovations.accel_filt(1);
+  innov[EKF_AW_R_a_z_filt_index] = eawp.innovations.accel_filt(2);
+  innov[EKF_AW_R_V_pitot_index] = eawp.innovations.V_pitot;
+
+  uint8_t nb_meas = ekf_aw_params.use_pitot ? EKF_AW_R_SIZE : EKF_AW_R_V_pitot_index;
+  float H[EKF_AW_R_SIZE][EKF_AW_COV_SIZE], R_diag[EKF_AW_R_SIZE];
+  for (int i = 0; i < nb_meas; i++) {
+    for (int j = 0; j < EKF_AW_COV_SIZE; j++) {
+      H[i][j] = G(i, j);
+    }
+    R_diag[i] = eawp.R(i, i);
+  }
+  eawp.kf.nb_est = ekf_aw_params.propagate_offset ? EKF_AW_COV_SIZE : EKF_AW_k_x_index;
+  const KfSymMatrix<EKF_AW_COV_SIZE> P_prev = eawp.kf.P;
+  anyNan = eawp.kf.update(H, innov, R_diag, nb_meas) < nb_meas;
+  float dx[EKF_AW_COV_SIZE];
+  eawp.kf.reset_error(dx);
+  for (int i = 0; i < EKF_AW_COV_SIZE; i++) {
+    anyNan = anyNan || !std::isfinite(dx[i]);
+  }
 
+  if (anyNan) {
+    eawp.health.healthy = false;
+    eawp.health.crashes_n += 1;
+    eawp.kf.P = P_prev;
+  } else {
+    eawp.health.healthy = true;
+    for (int i = 0; i < 3; i++) {
+      eawp.state.V_body(i) += dx[EKF_AW_u_index + i];
+      eawp.state.wind(i) += dx[EKF_AW_mu_x_index + i];
+      eawp.state.offset(i) += dx[EKF_AW_k_x_index + i];
+    }
+  }
+#else
   // Innovation S Matrix Calculation
-  matrix::SquareMatrix<float, EKF_AW_R_SIZE> S = G * eawp.P * G.transpose() + eawp.R; // M = identity
+  EKF_Aw_Cov P_full;
+  for (int i = 0; i < EKF_AW_COV_SIZE; i++) {
+    for (int j = 0; j < EKF_AW_COV_SIZE; j++) {
+      P_full(i, j) = eawp.kf.P(i, j);
+    }
+  }
+  matrix::SquareMatrix<float, EKF_AW_R_SIZE> S = G * P_full * G.transpose() + eawp.R; // M = identity
 
-  // FOR DEBUG
-#if EKF_AW_DEBUG
-  duration_8 = get_sys_time_usec() - tic;
-#endif
 
   // Kalman Gain Calculation
-  matrix::Matrix<float, EKF_AW_COV_SIZE, EKF_AW_R_SIZE> K = eawp.P * G.transpose() * S.I();
+  matrix::Matrix<float, EKF_AW_COV_SIZE, EKF_AW_R_SIZE> K = P_full * G.transpose() * S.I();
 
-  // FOR DEBUG
-#if EKF_AW_DEBUG
-  duration_9 = get_sys_time_usec() - tic;
-#endif
 
   // Check if Kalman Gain contains any nan. Only update state if it is not NAN
   anyNan = false;
@@ -1221,37 +1203,26 @@ void ekf_aw_propagate(struct FloatVect3 *acc, struct FloatRates *gyro, struct Fl
         K_slice_1 = K.slice<3, 1>(6, 6); eawp.state.offset  += K_slice_1 * eawp.innovations.V_pitot;
       }
     }
-    // FOR DEBUG
-#if EKF_AW_DEBUG
-    duration_10 = get_sys_time_usec() - tic;
-#endif
 
     // Covariance update
     matrix::SquareMatrix<float, EKF_AW_COV_SIZE> eye;
     eye.setIdentity();
-    eawp.P = (eye - K * G) * eawp.P;
+    const EKF_Aw_Cov P_upd = (eye - K * G) * P_full;
+    for (int i = 0; i < EKF_AW_COV_SIZE; i++) {
+      for (int j = i; j < EKF_AW_COV_SIZE; j++) {
+        eawp.kf.P(i, j) = 0.5f * (P_upd(i, j) + P_upd(j, i));
+      }
+    }
   }
-
-  // FOR DEBUG
-#if EKF_AW_DEBUG
-  duration_11 = get_sys_time_usec() - tic;
-
-  eawp.forces.fuselage(0) = duration_1 * 1.0f;
-  eawp.forces.fuselage(1) = duration_2 * 1.0f;
-  eawp.forces.fuselage(2) = duration_3 * 1.0f;
-
-  eawp.forces.wing(0) = duration_4 * 1.0f;
-  eawp.forces.wing(1) = duration_5 * 1.0f;
-  eawp.forces.wing(2) = duration_6 * 1.0f;
-
-  eawp.forces.elevator(0) = duration_7 * 1.0f;
-  eawp.forces.elevator(1) = duration_8 * 1.0f;
-  eawp.forces.elevator(2) = duration_9 * 1.0f;
-
-  eawp.forces.hover(0) = duration_10 * 1.0f;
-  eawp.forces.hover(1) = duration_11 * 1.0f;
 #endif
 
+  uint32_t toc = get_sys_time_usec();
+  eawp.timing.update_us = toc - tic_update;
+  if (toc - tic > eawp.timing.max_us) {
+    eawp.timing.max_us = toc - tic;
+  }
+  eawp.timing.nb_steps++;
+
   //std::cout << "subs:\n" << EKF_Aw_Cov::Identity() - K * G  << std::endl;
   //std::cout << "Cov matrix:\n" << eawp.P << std::endl;
   //std::cout << "S inverse:\n" << S.inverse() << std::endl;
@@ -1292,6 +1263,11 @@ struct NedCoor_f ekf_aw_get_offset(void) // TO DO: use right type instead of NED
   return w;
 }
 
+struct ekfAwTiming ekf_aw_get_timing(void)
+{
+  return eawp.timing;
+}
+
 struct ekfHealth ekf_aw_get_health(void)
 {
   const struct ekfHealth w = {
@@ -1346,10 +1322,10 @@ void ekf_aw_get_state_cov(float state_cov[9])
   float diagonal[EKF_AW_COV_SIZE];
   for (int8_t i = 0; i < EKF_AW_COV_SIZE; i++) {
     // Protect log10 against 0 and negative values
-    if (eawp.P(i, i) <= 0.0f) {
-      diagonal[i] = eawp.P(i, i);
+    if (eawp.kf.P(i, i) <= 0.0f) {
+      diagonal[i] = eawp.kf.P(i, i);
     } else {
-      diagonal[i] = log10(eawp.P(i, i));
+      diagonal[i] = log10(eawp.kf.P(i, i));
     }
   }
 
@@ -56,6 +56,13 @@ struct ekfHealth {
   uint16_t crashes_n;
 };
 
+struct ekfAwTiming {
+  uint32_t propagate_us;  ///< input preparation and propagation time of the last step (us)
+  uint32_t update_us;     ///< measurement update time of the last step (us)
+  uint32_t max_us;        ///< longest step since init (us)
+  uint32_t nb_steps;      ///< number of steps since init
+};
+
 extern struct ekfAwParameters ekf_aw_params;
 
 // Init functions
@@ -88,6 +95,7 @@ extern void ekf_aw_set_speed_body(struct NedCoor_f *s);
 extern void ekf_aw_set_wind(struct NedCoor_f *s);
 extern void ekf_aw_set_offset(struct NedCoor_f *s);
 extern struct ekfHealth ekf_aw_get_health(void);
+extern struct ekfAwTiming ekf_aw_get_timing(void);
 
 // Settings handlers
 extern void ekf_aw_update_params(void);
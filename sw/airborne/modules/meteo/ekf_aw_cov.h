@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file modules/meteo/ekf_aw_cov.h
+ *
+ * State and process noise layout and covariance propagation of the EKF_AW
+ * filter. The covariance is stored and updated by FixedKalmanFilter,
+ * this only depends on filters/fixed_kalman_filter.h so it can be tested
+ * on the host without the matrix library.
+ */
+
+#ifndef EKF_AW_COV_H
+#define EKF_AW_COV_H
+
+#include "filters/fixed_kalman_filter.h"
+
+// Covariance matrix elements and size
+enum ekfAwCovVar {
+  EKF_AW_u_index, EKF_AW_v_index, EKF_AW_w_index,
+  EKF_AW_mu_x_index, EKF_AW_mu_y_index, EKF_AW_mu_z_index,
+  EKF_AW_k_x_index, EKF_AW_k_y_index, EKF_AW_k_z_index,
+  EKF_AW_COV_SIZE
+};
+
+// Process noise elements and size
+enum ekfAwQVar {
+  EKF_AW_Q_accel_x_index, EKF_AW_Q_accel_y_index, EKF_AW_Q_accel_z_index,
+  EKF_AW_Q_gyro_x_index,  EKF_AW_Q_gyro_y_index,  EKF_AW_Q_gyro_z_index,
+  EKF_AW_Q_mu_x_index,    EKF_AW_Q_mu_y_index,    EKF_AW_Q_mu_z_index,
+  EKF_AW_Q_k_x_index,     EKF_AW_Q_k_y_index,     EKF_AW_Q_k_z_index,
+  EKF_AW_Q_SIZE
+};
+
+typedef FixedKalmanFilter<EKF_AW_COV_SIZE> EKF_Aw_Kf;
+
+/**
+ * Covariance propagation P = L Q L^T
+ *
+ * Optimized version using code generation from Matlab, as L is sparse
+ * (approx 4000 operations down to 120). The generated code reads the
+ * covariance it is overwriting, which is zero, so the F P F^T term is
+ * dropped and the previous covariance is not propagated.
+ * Only the upper triangle is computed.
+ * @param P state covariance, overwritten
+ * @param Q_diag process noise variances
+ * @param u, v, w body speed
+ */
+static inline void ekf_aw_propagate_cov(KfSymMatrix<EKF_AW_COV_SIZE> &P, const float Q_diag[EKF_AW_Q_SIZE],
+                                        float u, float v, float w)
+{
+  P.setZero();
+  P(0, 0) = Q_diag[0] + v * v * Q_diag[5] + w * w * Q_diag[4];
+  P(0, 1) = -u * v * Q_diag[5];
+  P(0, 2) = -u * w * Q_diag[4];
+  P(1, 1) = Q_diag[1] + u * u * Q_diag[5] + w * w * Q_diag[3];
+  P(1, 2) = -v * w * Q_diag[3];
+  P(2, 2) = Q_diag[2] + u * u * Q_diag[4] + v * v * Q_diag[3];
+  P(3, 3) = Q_diag[6];
+  P(4, 4) = Q_diag[7];
+  P(5, 5) = Q_diag[8];
+  P(6, 6) = Q_diag[9];
+  P(7, 7) = Q_diag[10];
+  P(8, 8) = Q_diag[11];
+}
+
+#endif /* EKF_AW_COV_H */
@@ -27,9 +27,6 @@
 #ifndef EKF_AW_QUICK_CONVERGENCE_TIME
 #define EKF_AW_QUICK_CONVERGENCE_TIME 10.0f
 #endif
-#ifndef EKF_AW_DEBUG
-#define EKF_AW_DEBUG false
-#endif
 
 #if EKF_AW_WRAPPER_ROT_WING
 #include "modules/rot_wing_drone/wing_rotation_controller_servo.h"
@@ -88,6 +85,14 @@ static void send_airspeed_wind_ekf_debug(struct transport_tx *trans, struct link
   rw_state[3] = ekf_aw.RPM_hover[0];
 
   debug_vect(trans, dev, "rw_state", rw_state, 4);
+
+  float timing[4];
+  timing[0] = ekf_aw.timing.propagate_us;
+  timing[1] = ekf_aw.timing.update_us;
+  timing[2] = ekf_aw.timing.max_us;
+  timing[3] = ekf_aw.timing.nb_steps;
+
+  debug_vect(trans, dev, "timing", timing, 4);
 }
 #endif
 
@@ -312,6 +317,7 @@ void ekf_aw_wrapper_periodic(void)
   ekf_aw.wind = ekf_aw_get_wind_ned();
   ekf_aw.offset = ekf_aw_get_offset();
   ekf_aw.health = ekf_aw_get_health();
+  ekf_aw.timing = ekf_aw_get_timing();
   ekf_aw.innov_V_gnd = ekf_aw_get_innov_V_gnd();
   ekf_aw.innov_acc_filt = ekf_aw_get_innov_accel_filt();
   ekf_aw.innov_V_pitot = ekf_aw_get_innov_V_pitot();
@@ -463,6 +469,6 @@ To send random values in the filter:
 - Set define EKF_AW_WRAPPER_RANDOM_INPUTS in ekf_aw_wrapper.c to true
 
 To check filter timing:
-- time required to run different parts of filter sent on telementry  AIRSPEED_WIND_ESTIMATOR_EKF_FORCES, on different fields, if EKF_AW_DEBUG set to TRUE
+- propagation and update time of the last step, longest step and number of steps (us) sent as "timing" DEBUG_VECT
 
 */
@@ -58,6 +58,7 @@ struct ekfAw {
   struct NedCoor_f wind_guess;
   struct NedCoor_f offset_guess;
   struct ekfHealth health;
+  struct ekfAwTiming timing;
   uint64_t internal_clock;
   uint64_t time_last_on_gnd;
   uint64_t time_last_in_air;
@@ -20,96 +20,168 @@
 /**
  * @file "modules/pose_history/pose_history.c"
  * @author Roland Meertens
- * Ask this module for the pose the drone had closest to a given timestamp
+ * Ask this module for the pose the drone had at a given timestamp
+ *
+ * The samples are stored in a time ordered ring buffer written by the
+ * autopilot thread only. Readers (e.g. video threads) don't take any lock,
+ * the ring is protected by a sequence lock and the two samples around the
+ * requested time are found with a binary search.
  */
 
 #include "modules/pose_history/pose_history.h"
-#include <sys/time.h>
 #include "mcu_periph/sys_time.h"
+#include "utils/seqlock.h"
 #include "state.h"
-#ifdef __linux__
-#include <pthread.h>
-#endif
+#include <string.h>
 
 #ifndef POSE_HISTORY_SIZE
 #define POSE_HISTORY_SIZE 1024
 #endif
 
-struct rotation_history_ring_buffer_t {
-  uint32_t ring_index;
-  uint32_t ring_size;
+#if POSE_HISTORY_SIZE < 2
+#error "POSE_HISTORY_SIZE should be at least 2"
+#endif
+
+/** Also record NED position and speed */
+#ifndef POSE_HISTORY_POSITION
+#define POSE_HISTORY_POSITION FALSE
+#endif
+
+struct pose_history_ring_buffer_t {
+  struct seqlock lock;    ///< protects the index, count and data
+  uint32_t ring_index;    ///< index of the next sample to write
+  uint32_t ring_count;    ///< number of valid samples
   struct pose_t ring_data[POSE_HISTORY_SIZE];
 };
 
-struct rotation_history_ring_buffer_t location_history;
+static struct pose_history_ring_buffer_t pose_history;
 
-#ifdef __linux__
-pthread_mutex_t pose_mutex;
-#endif
+/** Logical index (0 is the oldest sample) to ring index */
+static inline uint32_t pose_history_index(uint32_t oldest, uint32_t i)
+{
+  return (oldest + i) % POSE_HISTORY_SIZE;
+}
 
 /**
- * Given a pprz timestamp in used (obtained with get_sys_time_usec) we return the pose in FloatEulers closest to that time.
+ * Find the samples around the requested time.
+ * Timestamps are compared as offsets from the oldest sample, so the
+ * search is not affected by the wrapping of the usec timer.
+ * @return false if the history is empty
  */
-struct pose_t get_rotation_at_timestamp(uint32_t timestamp)
+static bool pose_history_find(uint32_t timestamp, struct pose_t *before, struct pose_t *after)
 {
-#ifdef __linux__
-  pthread_mutex_lock(&pose_mutex);
-#endif
-  uint32_t index_history = 0;
-  uint32_t closestTimeDiff = timestamp - location_history.ring_data[0].timestamp;
-  uint32_t closestIndex = 0;
-
-  // Seach for the timestamp closes to the timestamp argument of this function.
-  for (index_history = 0; index_history < location_history.ring_size; index_history++) {
-    uint32_t diff = timestamp - location_history.ring_data[index_history].timestamp;
-    if (diff < closestTimeDiff) {
-      closestIndex = index_history;
-      closestTimeDiff = diff;
+  bool found;
+  uint32_t seq;
+  do {
+    seq = seqlock_read_begin(&pose_history.lock);
+    const uint32_t count = pose_history.ring_count;
+    found = (count > 0);
+    if (!found) {
+      continue;
     }
+    const uint32_t oldest = (pose_history.ring_index + POSE_HISTORY_SIZE - count) % POSE_HISTORY_SIZE;
+    const uint32_t t0 = pose_history.ring_data[oldest].timestamp;
+    const uint32_t newest = pose_history_index(oldest, count - 1);
+    uint32_t lo = 0, hi = count - 1;
+
+    if ((int32_t)(timestamp - t0) <= 0) {
+      hi = 0;
+    } else if ((timestamp - t0) >= (pose_history.ring_data[newest].timestamp - t0)) {
+      lo = count - 1;
+    } else {
+      // find the last sample before the timestamp, invariant: t[lo] <= timestamp < t[hi]
+      const uint32_t offset = timestamp - t0;
+      while (hi - lo > 1) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (pose_history.ring_data[pose_history_index(oldest, mid)].timestamp - t0 <= offset) {
+          lo = mid;
+        } else {
+          hi = mid;
+        }
+      }
+    }
+    *before = pose_history.ring_data[pose_history_index(oldest, lo)];
+    *after = pose_history.ring_data[pose_history_index(oldest, hi)];
+  } while (seqlock_read_retry(&pose_history.lock, seq));
+  return found;
+}
+
+bool get_pose_at_timestamp(uint32_t timestamp, struct pose_t *pose)
+{
+  struct pose_t before, after;
+  if (!pose_history_find(timestamp, &before, &after)) {
+    return false;
   }
 
-  // Save the pose closest to the given timestamp and return this
-  struct pose_t closest_pose;
-  closest_pose.eulers = location_history.ring_data[closestIndex].eulers;
-  closest_pose.rates = location_history.ring_data[closestIndex].rates;
+  const uint32_t dt = after.timestamp - before.timestamp;
+  if (dt == 0) {
+    *pose = before;
+    return true;
+  }
+  const float alpha = (float)(timestamp - before.timestamp) / (float)dt;
+
+  pose->timestamp = timestamp;
+  float_quat_slerp(&pose->quat, &before.quat, &after.quat, alpha);
+  float_eulers_of_quat(&pose->eulers, &pose->quat);
+  pose->rates.p = before.rates.p + alpha * (after.rates.p - before.rates.p);
+  pose->rates.q = before.rates.q + alpha * (after.rates.q - before.rates.q);
+  pose->rates.r = before.rates.r + alpha * (after.rates.r - before.rates.r);
+  VECT3_DIFF(pose->pos, after.pos, before.pos);
+  VECT3_SMUL(pose->pos, pose->pos, alpha);
+  VECT3_ADD(pose->pos, before.pos);
+  VECT3_DIFF(pose->speed, after.speed, before.speed);
+  VECT3_SMUL(pose->speed, pose->speed, alpha);
+  VECT3_ADD(pose->speed, before.speed);
+  return true;
+}
 
-#ifdef __linux__
-  pthread_mutex_unlock(&pose_mutex);
-#endif
-  return closest_pose;
+/**
+ * Given a pprz timestamp in usec (obtained with get_sys_time_usec) we return the pose at that time.
+ */
+struct pose_t get_rotation_at_timestamp(uint32_t timestamp)
+{
+  struct pose_t pose;
+  if (!get_pose_at_timestamp(timestamp, &pose)) {
+    memset(&pose, 0, sizeof(pose));
+    float_quat_identity(&pose.quat);
+  }
+  return pose;
 }
 
 /**
  * Initialises the pose history
  */
-void pose_init()
+void pose_init(void)
 {
-  location_history.ring_index = 0;
-  location_history.ring_size = POSE_HISTORY_SIZE;
+  memset(&pose_history, 0, sizeof(pose_history));
+  seqlock_init(&pose_history.lock);
 }
 
 
 /**
- * Records the pose history 512 times per second. Time gets saved in pprz usec, obtained with get_sys_time_usec();
+ * Records the pose history. Time gets saved in pprz usec, obtained with get_sys_time_usec();
  */
-void pose_periodic()
+void pose_periodic(void)
 {
-  uint32_t now_ts = get_sys_time_usec();
-#ifdef __linux__
-  pthread_mutex_lock(&pose_mutex);
+  struct pose_t sample;
+  sample.timestamp = get_sys_time_usec();
+  sample.quat = *stateGetNedToBodyQuat_f();
+  sample.eulers = *stateGetNedToBodyEulers_f();
+  sample.rates = *stateGetBodyRates_f();
+#if POSE_HISTORY_POSITION
+  sample.pos = *stateGetPositionNed_f();
+  sample.speed = *stateGetSpeedNed_f();
+#else
+  FLOAT_VECT3_ZERO(sample.pos);
+  FLOAT_VECT3_ZERO(sample.speed);
 #endif
-  struct pose_t *current_time_and_rotation = &location_history.ring_data[location_history.ring_index];
-  current_time_and_rotation->eulers = *stateGetNedToBodyEulers_f();
-  current_time_and_rotation->rates = *stateGetBodyRates_f();
-
-  current_time_and_rotation->timestamp = now_ts;
-
-  // increase index location history
-  location_history.ring_index = (location_history.ring_index + 1) % location_history.ring_size;
 
-#ifdef __linux__
-  pthread_mutex_unlock(&pose_mutex);
-#endif
+  seqlock_write_begin(&pose_history.lock);
+  pose_history.ring_data[pose_history.ring_index] = sample;
+  pose_history.ring_index = (pose_history.ring_index + 1) % POSE_HISTORY_SIZE;
+  if (pose_history.ring_count < POSE_HISTORY_SIZE) {
+    pose_history.ring_count++;
+  }
+  seqlock_write_end(&pose_history.lock);
 }
 
-
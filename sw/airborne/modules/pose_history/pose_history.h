@@ -20,22 +20,43 @@
 /**
  * @file "modules/pose_history/pose_history.h"
  * @author Roland Meertens
- * Ask this module for the pose the drone had closest to a given timestamp
+ * Ask this module for the pose the drone had at a given timestamp.
+ * Samples are interpolated between the two recorded neighbours.
+ * The history can safely be read from other threads (e.g. video threads).
  */
 
 #ifndef POSE_HISTORY_H
 #define POSE_HISTORY_H
 
+#include "std.h"
 #include "math/pprz_algebra_float.h"
+#include "math/pprz_geodetic_float.h"
 
 struct pose_t {
-  uint32_t timestamp;
-  struct FloatEulers eulers;
-  struct FloatRates rates;
+  uint32_t timestamp;           ///< pprz timestamp in usec (get_sys_time_usec)
+  struct FloatEulers eulers;    ///< NED to body eulers
+  struct FloatRates rates;      ///< body rates
+  struct FloatQuat quat;        ///< NED to body quaternion
+  struct NedCoor_f pos;         ///< NED position, only recorded if POSE_HISTORY_POSITION
+  struct NedCoor_f speed;       ///< NED speed, only recorded if POSE_HISTORY_POSITION
 };
 
 extern void pose_init(void);
 extern void pose_periodic(void);
+
+/**
+ * Get the pose interpolated at a given timestamp.
+ * Timestamps outside of the recorded history are clamped to the oldest or newest sample.
+ * @param timestamp pprz timestamp in usec
+ * @param pose output pose
+ * @return false if the history is still empty
+ */
+extern bool get_pose_at_timestamp(uint32_t timestamp, struct pose_t *pose);
+
+/**
+ * Get the pose interpolated at a given timestamp.
+ * Returns a zero pose if the history is still empty.
+ */
 extern struct pose_t get_rotation_at_timestamp(uint32_t timestamp);
 #endif
 
@@ -32,9 +32,16 @@
  */
 
 #include "state.h"
+#include "utils/seqlock.h"
 
 struct State state;
 
+/** Last published state, written by the autopilot thread only */
+static struct StateSnapshot state_snapshot;
+static struct seqlock state_snapshot_lock;
+/** Number of registered snapshot consumers, not reset by stateInit */
+static uint8_t state_snapshot_consumers;
+
 #if PREFLIGHT_CHECKS && !defined(AUTOPILOT_DISABLE_AHRS_KILL)
 /* Preflight checks */
 #include "modules/checks/preflight_checks.h"
@@ -69,6 +76,11 @@ void stateInit(void)
   /* setting to zero forces recomputation of zone using lla when utm uninitialised*/
   state.utm_origin_f.zone = 0;
 
+  memset(&state_snapshot, 0, sizeof(state_snapshot));
+  float_quat_identity(&state_snapshot.ned_to_body_quat);
+  float_rmat_identity(&state_snapshot.ned_to_body_rmat);
+  seqlock_init(&state_snapshot_lock);
+
   /* Register preflight checks */
 #if PREFLIGHT_CHECKS && !defined(AUTOPILOT_DISABLE_AHRS_KILL)
   preflight_check_register(&state_pfc, state_preflight);
@@ -76,6 +88,53 @@ void stateInit(void)
 }
 
 
+void stateSnapshotRegister(void)
+{
+  state_snapshot_consumers++;
+}
+
+void stateSnapshotPublish(uint32_t timestamp)
+{
+  // nobody reads it, save the conversions and the copy
+  if (state_snapshot_consumers == 0) {
+    return;
+  }
+
+  // do all the lazy conversions before entering the write section
+  struct StateSnapshot snapshot = state_snapshot;
+  snapshot.timestamp = timestamp;
+  snapshot.attitude_valid = stateIsAttitudeValid() && stateIsRateValid();
+  if (snapshot.attitude_valid) {
+    snapshot.ned_to_body_quat = *stateGetNedToBodyQuat_f();
+    snapshot.ned_to_body_rmat = *stateGetNedToBodyRMat_f();
+    snapshot.ned_to_body_eulers = *stateGetNedToBodyEulers_f();
+    snapshot.body_rates = *stateGetBodyRates_f();
+  }
+  snapshot.local_pos_valid = stateIsLocalCoordinateValid();
+  if (snapshot.local_pos_valid) {
+    snapshot.ned_pos = *stateGetPositionNed_f();
+    snapshot.ned_speed = *stateGetSpeedNed_f();
+  }
+  snapshot.global_pos_valid = stateIsGlobalCoordinateValid();
+  if (snapshot.global_pos_valid) {
+    snapshot.lla_pos = *stateGetPositionLla_f();
+  }
+
+  seqlock_write_begin(&state_snapshot_lock);
+  state_snapshot = snapshot;
+  seqlock_write_end(&state_snapshot_lock);
+}
+
+void stateGetSnapshot(struct StateSnapshot *snapshot)
+{
+  uint32_t seq;
+  do {
+    seq = seqlock_read_begin(&state_snapshot_lock);
+    *snapshot = state_snapshot;
+  } while (seqlock_read_retry(&state_snapshot_lock, seq));
+}
+
+
 /*******************************************************************************
  *                                                                             *
  * transformation functions for the POSITION representations                   *
@@ -597,7 +656,7 @@ void stateCalcPositionLla_f(void)
 
   int errno = 0;
   if (bit_is_set(state.pos_status, POS_LLA_I)) {
-    LLA_FLOAT_OF_BFP(state.lla_pos_f, state.lla_pos_f);
+    LLA_FLOAT_OF_BFP(state.lla_pos_f, state.lla_pos_i);
   } else if (bit_is_set(state.pos_status, POS_ECEF_F)) {
     lla_of_ecef_f(&state.lla_pos_f, &state.ecef_pos_f);
   } else if (bit_is_set(state.pos_status, POS_ECEF_I)) {
@@ -608,30 +667,21 @@ void stateCalcPositionLla_f(void)
   } else if (bit_is_set(state.pos_status, POS_UTM_F)) {
     lla_of_utm_f(&state.lla_pos_f, &state.utm_pos_f);
   } else if (state.ned_initialized_f) {
+    /* local to lla directly from the origin terms, without going through ECEF */
     if (bit_is_set(state.pos_status, POS_NED_F)) {
-      /* transform ned_f -> ecef_f -> lla_f, set status bits */
-      ecef_of_ned_point_f(&state.ecef_pos_f, &state.ned_origin_f, &state.ned_pos_f);
-      SetBit(state.pos_status, POS_ECEF_F);
-      lla_of_ecef_f(&state.lla_pos_f, &state.ecef_pos_f);
+      lla_of_ned_point_f(&state.lla_pos_f, &state.ned_origin_f, &state.ned_pos_f);
     } else if (bit_is_set(state.pos_status, POS_NED_I)) {
-      /* transform ned_i -> ned_f -> ecef_f -> lla_f, set status bits */
+      /* transform ned_i -> ned_f -> lla_f, set status bits */
       NED_FLOAT_OF_BFP(state.ned_pos_f, state.ned_pos_i);
       SetBit(state.pos_status, POS_NED_F);
-      ecef_of_ned_point_f(&state.ecef_pos_f, &state.ned_origin_f, &state.ned_pos_f);
-      SetBit(state.pos_status, POS_ECEF_F);
-      lla_of_ecef_f(&state.lla_pos_f, &state.ecef_pos_f);
+      lla_of_ned_point_f(&state.lla_pos_f, &state.ned_origin_f, &state.ned_pos_f);
     } else if (bit_is_set(state.pos_status, POS_ENU_F)) {
-      /* transform enu_f -> ecef_f -> lla_f, set status bits */
-      ecef_of_enu_point_f(&state.ecef_pos_f, &state.ned_origin_f, &state.enu_pos_f);
-      SetBit(state.pos_status, POS_ECEF_F);
-      lla_of_ecef_f(&state.lla_pos_f, &state.ecef_pos_f);
+      lla_of_enu_point_f(&state.lla_pos_f, &state.ned_origin_f, &state.enu_pos_f);
     } else if (bit_is_set(state.pos_status, POS_ENU_I)) {
-      /* transform enu_i -> enu_f -> ecef_f -> lla_f, set status bits */
+      /* transform enu_i -> enu_f -> lla_f, set status bits */
       ENU_FLOAT_OF_BFP(state.enu_pos_f, state.enu_pos_i);
       SetBit(state.pos_status, POS_ENU_F);
-      ecef_of_enu_point_f(&state.ecef_pos_f, &state.ned_origin_f, &state.enu_pos_f);
-      SetBit(state.pos_status, POS_ECEF_F);
-      lla_of_ecef_f(&state.lla_pos_f, &state.ecef_pos_f);
+      lla_of_enu_point_f(&state.lla_pos_f, &state.ned_origin_f, &state.enu_pos_f);
     } else { /* could not get this representation,  set errno */
       errno = 1;
     }
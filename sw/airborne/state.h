@@ -450,6 +450,65 @@ extern struct State state;
 
 extern void stateInit(void);
 
+/**
+ * @defgroup state_snapshot State snapshot for other threads
+ *
+ * The stateGet functions are lazily converting and updating the global
+ * state structure, they should only be called from the autopilot thread.
+ * Other threads (vision, logging) should use an immutable copy of the main
+ * states published once per GNC cycle by the autopilot thread.
+ * Reading the snapshot never blocks the autopilot.
+ * The snapshot is only published when at least one consumer registered
+ * with stateSnapshotRegister().
+ *
+ * It is published right after the estimation of each GNC cycle, so a copy
+ * can be up to one GNC cycle (1/PERIODIC_FREQUENCY) old, see its timestamp.
+ * The fields of a group are only meaningful when its valid flag is set,
+ * otherwise they still hold the last valid values (or zeros), consumers
+ * must check the flags before using them.
+ * @{
+ */
+
+/**
+ * Immutable copy of the main states.
+ */
+struct StateSnapshot {
+  uint32_t timestamp;                     ///< publication time in usec
+  bool attitude_valid;                    ///< attitude and rates are valid
+  bool local_pos_valid;                   ///< NED position and speed are valid
+  bool global_pos_valid;                  ///< LLA position is valid
+  struct FloatQuat ned_to_body_quat;      ///< NED to body quaternion
+  struct FloatRMat ned_to_body_rmat;      ///< NED to body rotation matrix
+  struct FloatEulers ned_to_body_eulers;  ///< NED to body eulers
+  struct FloatRates body_rates;           ///< body rates in rad/s
+  struct NedCoor_f ned_pos;               ///< position in local NED frame
+  struct NedCoor_f ned_speed;             ///< speed in local NED frame
+  struct LlaCoor_f lla_pos;               ///< position in LLA
+};
+
+/**
+ * Register a consumer of the state snapshot.
+ * Should be called from the init function of the consumer module.
+ */
+extern void stateSnapshotRegister(void);
+
+/**
+ * Publish a snapshot of the current state, if a consumer is registered.
+ * Should only be called from the autopilot thread, normally once per GNC cycle.
+ * @param timestamp current time in usec
+ */
+extern void stateSnapshotPublish(uint32_t timestamp);
+
+/**
+ * Get a consistent copy of the last published state.
+ * Can be called from any thread. The copy can be up to one GNC cycle old
+ * and each group must be checked with its valid flag.
+ * @param snapshot output state snapshot
+ */
+extern void stateGetSnapshot(struct StateSnapshot *snapshot);
+
+/** @}*/
+
 /** @addtogroup state_position
  *  @{ */
 
@@ -0,0 +1,642 @@
+/*
+ * Copyright (C) 2026 The Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test/abi_replay/abi_replay.c
+ *
+ * Host side ABI replay engine.
+ *
+ * Reads a recorded sensor log, rebuilds the ABI messages with their original
+ * timestamps and sends them as fast as possible to the estimator selected at
+ * build time (see Makefile). The simulated system time follows the log
+ * stamps, so estimators computing dt from stamps or get_sys_time_usec()
+ * behave as on board.
+ *
+ * Every bound callback is timed individually. At the end a table with
+ * min/median/p99/max/mean execution time per callback is printed, along
+ * with the replay speed relative to real time. Optionally an output trace
+ * of the state interface is written after each gyro message.
+ *
+ * Log format, one message per line, SI units, '#' starts a comment:
+ *
+ *     stamp_us IMU_GYRO      sender p q r                  [rad/s]
+ *     stamp_us IMU_ACCEL     sender ax ay az               [m/s2]
+ *     stamp_us IMU_MAG       sender mx my mz               [normalized]
+ *     stamp_us IMU_LOWPASSED sender p q r ax ay az mx my mz
+ *     stamp_us BARO_ABS      sender pressure               [Pa]
+ *     stamp_us GPS           sender fix lat lon alt hmsl vn ve vd pacc sacc num_sv
+ *                            [deg, deg, m, m, m/s, m/s, m/s, m, m/s]
+ *
+ * Paparazzi logs (.data) can be converted to this format with log2replay.py.
+ *
+ * Messages are converted to their fixed point ABI representation while the
+ * log is loaded, only the callbacks themselves are timed. The callbacks are
+ * reported by name, from the symbol table of the binary.
+ *
+ * If the log does not contain IMU_LOWPASSED messages, one is synthesized
+ * from the average of the first gyro, accel and mag samples so that the
+ * estimators can align without running the full ahrs_aligner/imu stack.
+ */
+
+#define ABI_C 1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <elf.h>
+#include <link.h>
+
+#include "std.h"
+#include "state.h"
+#include "mcu_periph/sys_time.h"
+#include "modules/core/abi.h"
+#include "math/pprz_algebra_int.h"
+#include "math/pprz_geodetic_int.h"
+
+#ifdef REPLAY_INIT_H
+#include REPLAY_INIT_H
+#endif
+
+#ifndef REPLAY_INIT
+#error "REPLAY_INIT must be set to the estimator init function"
+#endif
+
+/** Default number of samples averaged for the synthesized alignment */
+#ifndef REPLAY_ALIGN_SAMPLES
+#define REPLAY_ALIGN_SAMPLES 512
+#endif
+
+/** Maximum number of distinct callbacks that are timed */
+#define REPLAY_MAX_CB 32
+
+struct sys_time sys_time;
+
+enum replay_msg {
+  REPLAY_IMU_GYRO,
+  REPLAY_IMU_ACCEL,
+  REPLAY_IMU_MAG,
+  REPLAY_IMU_LOWPASSED,
+  REPLAY_BARO_ABS,
+  REPLAY_GPS,
+  REPLAY_NB_MSG
+};
+
+static const char *replay_msg_names[REPLAY_NB_MSG] = {
+  "IMU_GYRO", "IMU_ACCEL", "IMU_MAG", "IMU_LOWPASSED", "BARO_ABS", "GPS"
+};
+
+static const uint8_t replay_abi_ids[REPLAY_NB_MSG] = {
+  ABI_IMU_GYRO_ID, ABI_IMU_ACCEL_ID, ABI_IMU_MAG_ID, ABI_IMU_LOWPASSED_ID,
+  ABI_BARO_ABS_ID, ABI_GPS_ID
+};
+
+/** One decoded log entry, stored in ABI representation */
+struct replay_event {
+  uint32_t stamp;
+  uint8_t msg;
+  uint8_t sender;
+  union {
+    struct Int32Rates gyro;
+    struct Int32Vect3 vect;
+    struct {
+      struct Int32Rates gyro;
+      struct Int32Vect3 accel;
+      struct Int32Vect3 mag;
+    } lp;
+    float pressure;
+    uint32_t gps_idx;
+  } d;
+};
+
+/** Timing samples of one callback (abi_event) */
+struct replay_cb_stats {
+  abi_event *ev;
+  uint8_t msg;
+  uint32_t nb;
+  uint32_t len;
+  uint32_t *ns;
+  uint64_t total;
+};
+
+static struct replay_event *events;
+static uint32_t nb_events;
+static struct GpsState *gps_states;
+static uint32_t nb_gps_states;
+
+static struct replay_cb_stats cb_stats[REPLAY_MAX_CB];
+static uint8_t nb_cb_stats;
+
+/** Function symbols of the replay binary, to report the callbacks by name */
+static ElfW(Sym) *replay_syms;
+static uint32_t nb_replay_syms;
+static char *replay_strtab;
+static uintptr_t replay_load_bias;
+
+int main(int argc, char **argv);
+
+static inline uint64_t replay_now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void *replay_grow(void *ptr, uint32_t *len, size_t elt)
+{
+  *len = *len ? *len * 2 : 1024;
+  ptr = realloc(ptr, *len * elt);
+  if (ptr == NULL) {
+    fprintf(stderr, "abi_replay: out of memory\n");
+    exit(EXIT_FAILURE);
+  }
+  return ptr;
+}
+
+static struct replay_cb_stats *replay_get_stats(abi_event *ev, uint8_t msg)
+{
+  for (int i = 0; i < nb_cb_stats; i++) {
+    if (cb_stats[i].ev == ev) {
+      return &cb_stats[i];
+    }
+  }
+  if (nb_cb_stats >= REPLAY_MAX_CB) {
+    return NULL;
+  }
+  struct replay_cb_stats *s = &cb_stats[nb_cb_stats++];
+  memset(s, 0, sizeof(*s));
+  s->ev = ev;
+  s->msg = msg;
+  return s;
+}
+
+static inline void replay_add_sample(struct replay_cb_stats *s, uint64_t ns)
+{
+  if (s == NULL) {
+    return;
+  }
+  if (s->nb >= s->len) {
+    s->ns = replay_grow(s->ns, &s->len, sizeof(uint32_t));
+  }
+  s->ns[s->nb++] = ns > UINT32_MAX ? UINT32_MAX : (uint32_t)ns;
+  s->total += ns;
+}
+
+/**
+ * Load the function symbols from the symbol table of the running binary.
+ * The callbacks are mostly static functions, which are not exported and
+ * can't be resolved with dladdr().
+ * @return false if the binary has no symbol table (stripped)
+ */
+static bool replay_load_symbols(void)
+{
+  FILE *f = fopen("/proc/self/exe", "rb");
+  if (f == NULL) {
+    return false;
+  }
+  ElfW(Ehdr) eh;
+  ElfW(Shdr) *sh = NULL;
+  bool found = false;
+  if (fread(&eh, sizeof(eh), 1, f) == 1 && memcmp(eh.e_ident, ELFMAG, SELFMAG) == 0 &&
+      eh.e_shentsize == sizeof(ElfW(Shdr)) && (sh = malloc(eh.e_shnum * sizeof(ElfW(Shdr)))) != NULL &&
+      fseek(f, eh.e_shoff, SEEK_SET) == 0 && fread(sh, sizeof(ElfW(Shdr)), eh.e_shnum, f) == eh.e_shnum) {
+    for (int i = 0; i < eh.e_shnum && !found; i++) {
+      if (sh[i].sh_type != SHT_SYMTAB || sh[i].sh_link >= eh.e_shnum) {
+        continue;
+      }
+      ElfW(Shdr) *str = &sh[sh[i].sh_link];
+      replay_syms = malloc(sh[i].sh_size);
+      replay_strtab = malloc(str->sh_size);
+      if (replay_syms != NULL && replay_strtab != NULL &&
+          fseek(f, sh[i].sh_offset, SEEK_SET) == 0 && fread(replay_syms, sh[i].sh_size, 1, f) == 1 &&
+          fseek(f, str->sh_offset, SEEK_SET) == 0 && fread(replay_strtab, str->sh_size, 1, f) == 1) {
+        nb_replay_syms = sh[i].sh_size / sizeof(ElfW(Sym));
+        found = true;
+      }
+    }
+  }
+  free(sh);
+  fclose(f);
+
+  /* load bias of a position independent binary, from the address of main */
+  for (uint32_t i = 0; found && i < nb_replay_syms; i++) {
+    if (ELF32_ST_TYPE(replay_syms[i].st_info) == STT_FUNC && strcmp(replay_strtab + replay_syms[i].st_name, "main") == 0) {
+      replay_load_bias = (uintptr_t)main - replay_syms[i].st_value;
+      return true;
+    }
+  }
+  nb_replay_syms = 0;
+  return false;
+}
+
+/** Name of the function at address addr, or its address if unknown */
+static void replay_func_name(char *name, size_t len, void *addr)
+{
+  uintptr_t a = (uintptr_t)addr - replay_load_bias;
+  for (uint32_t i = 0; i < nb_replay_syms; i++) {
+    ElfW(Sym) *sym = &replay_syms[i];
+    if (ELF32_ST_TYPE(sym->st_info) == STT_FUNC && a >= sym->st_value && a < sym->st_value + Max(sym->st_size, 1)) {
+      snprintf(name, len, "%s", replay_strtab + sym->st_name);
+      return;
+    }
+  }
+  snprintf(name, len, "%p", addr);
+}
+
+/** Set the simulated system time from a log stamp */
+static void replay_set_time(uint32_t stamp)
+{
+  sys_time.nb_sec = stamp / 1000000;
+  sys_time.nb_sec_rem = cpu_ticks_of_usec(stamp % 1000000);
+  sys_time.nb_tick = sys_time_ticks_of_usec(stamp);
+}
+
+/**
+ * Send one event to every matching callback, timing each call.
+ * This mirrors the generated AbiSendMsg functions.
+ */
+static void replay_dispatch(struct replay_event *e)
+{
+  abi_event *ev;
+  ABI_FOREACH(abi_queues[replay_abi_ids[e->msg]], ev) {
+    if (ev->id != ABI_BROADCAST && ev->id != e->sender) {
+      continue;
+    }
+    struct replay_cb_stats *s = replay_get_stats(ev, e->msg);
+    if (e->msg == REPLAY_GPS) {
+      /* callbacks may keep a pointer to the global gps struct */
+      gps = gps_states[e->d.gps_idx];
+    }
+    uint64_t t0 = replay_now_ns();
+    switch (e->msg) {
+      case REPLAY_IMU_GYRO:
+        ((abi_callbackIMU_GYRO)ev->cb)(e->sender, e->stamp, &e->d.gyro);
+        break;
+      case REPLAY_IMU_ACCEL:
+        ((abi_callbackIMU_ACCEL)ev->cb)(e->sender, e->stamp, &e->d.vect);
+        break;
+      case REPLAY_IMU_MAG:
+        ((abi_callbackIMU_MAG)ev->cb)(e->sender, e->stamp, &e->d.vect);
+        break;
+      case REPLAY_IMU_LOWPASSED:
+        ((abi_callbackIMU_LOWPASSED)ev->cb)(e->sender, e->stamp, &e->d.lp.gyro,
+                                            &e->d.lp.accel, &e->d.lp.mag);
+        break;
+      case REPLAY_BARO_ABS:
+        ((abi_callbackBARO_ABS)ev->cb)(e->sender, e->stamp, e->d.pressure);
+        break;
+      case REPLAY_GPS:
+        ((abi_callbackGPS)ev->cb)(e->sender, e->stamp, &gps);
+        break;
+      default:
+        break;
+    }
+    replay_add_sample(s, replay_now_ns() - t0);
+  }
+}
+
+static int replay_msg_of_name(const char *name)
+{
+  for (int i = 0; i < REPLAY_NB_MSG; i++) {
+    if (strcmp(name, replay_msg_names[i]) == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static void replay_parse_gps(struct GpsState *g, uint32_t stamp, const double *v)
+{
+  memset(g, 0, sizeof(*g));
+  g->fix = (uint8_t)v[0];
+  g->lla_pos.lat = (int32_t)(v[1] * 1e7);
+  g->lla_pos.lon = (int32_t)(v[2] * 1e7);
+  g->lla_pos.alt = (int32_t)(v[3] * 1000.);
+  g->hmsl = (int32_t)(v[4] * 1000.);
+  g->ned_vel.x = (int32_t)(v[5] * 100.);
+  g->ned_vel.y = (int32_t)(v[6] * 100.);
+  g->ned_vel.z = (int32_t)(v[7] * 100.);
+  g->pacc = (uint32_t)(v[8] * 100.);
+  g->hacc = g->pacc;
+  g->vacc = g->pacc;
+  g->sacc = (uint32_t)(v[9] * 100.);
+  g->num_sv = (uint8_t)v[10];
+
+  double gspeed = sqrt(v[5] * v[5] + v[6] * v[6]);
+  g->gspeed = (uint16_t)(gspeed * 100.);
+  g->speed_3d = (uint16_t)(sqrt(gspeed * gspeed + v[7] * v[7]) * 100.);
+  double course = atan2(v[6], v[5]);
+  if (course < 0.) {
+    course += 2. * M_PI;
+  }
+  g->course = (int32_t)(course * 1e7);
+  g->cacc = gspeed > 0.1 ? (uint32_t)(atan2(v[9], gspeed) * 1e7) : (uint32_t)(M_PI * 1e7);
+
+  /* ECEF position and speed are derived from LLA and NED for the estimators using them */
+  struct LtpDef_i ltp;
+  ecef_of_lla_i(&g->ecef_pos, &g->lla_pos);
+  ltp_def_from_ecef_i(&ltp, &g->ecef_pos);
+  ecef_of_ned_vect_i(&g->ecef_vel, &ltp, &g->ned_vel);
+
+  g->valid_fields = (1 << GPS_VALID_POS_ECEF_BIT) | (1 << GPS_VALID_POS_LLA_BIT) |
+                    (1 << GPS_VALID_VEL_ECEF_BIT) | (1 << GPS_VALID_VEL_NED_BIT) |
+                    (1 << GPS_VALID_HMSL_BIT) | (1 << GPS_VALID_COURSE_BIT);
+  g->tow = stamp / 1000;
+  if (g->fix >= GPS_FIX_3D) {
+    g->last_3dfix_time = stamp / 1000000;
+    g->last_3dfix_ticks = sys_time_ticks_of_usec(stamp);
+  }
+  g->last_msg_time = stamp / 1000000;
+  g->last_msg_ticks = sys_time_ticks_of_usec(stamp);
+}
+
+static struct replay_event *replay_new_event(uint32_t *len)
+{
+  if (nb_events >= *len) {
+    events = replay_grow(events, len, sizeof(struct replay_event));
+  }
+  struct replay_event *e = &events[nb_events++];
+  memset(e, 0, sizeof(*e));
+  return e;
+}
+
+/**
+ * Load the whole log in memory.
+ * @return number of lines that could not be parsed
+ */
+static int replay_load(FILE *f, int align_samples)
+{
+  static const int nb_fields[REPLAY_NB_MSG] = { 3, 3, 3, 9, 1, 11 };
+  uint32_t events_len = 0, gps_len = 0;
+  char line[512], name[32];
+  int errors = 0, has_lowpassed = 0;
+  int line_nb = 0;
+
+  /* running sums for the synthesized alignment */
+  struct FloatVect3 sum[3];
+  int nb_sum[3] = { 0, 0, 0 };
+  memset(sum, 0, sizeof(sum));
+  uint8_t imu_sender = ABI_BROADCAST;
+
+  while (fgets(line, sizeof(line), f) != NULL) {
+    line_nb++;
+    char *c = strchr(line, '#');
+    if (c != NULL) {
+      *c = '\0';
+    }
+    unsigned long stamp;
+    unsigned int sender;
+    int n;
+    if (sscanf(line, "%lu %31s %u%n", &stamp, name, &sender, &n) != 3) {
+      if (strspn(line, " \t\r\n") != strlen(line)) {
+        fprintf(stderr, "abi_replay: line %d: cannot parse header\n", line_nb);
+        errors++;
+      }
+      continue;
+    }
+    int msg = replay_msg_of_name(name);
+    if (msg < 0) {
+      /* unknown messages are silently skipped so that richer logs can be replayed */
+      continue;
+    }
+    double v[11];
+    char *p = line + n;
+    int i;
+    for (i = 0; i < nb_fields[msg]; i++) {
+      char *end;
+      v[i] = strtod(p, &end);
+      if (end == p) {
+        break;
+      }
+      p = end;
+    }
+    if (i != nb_fields[msg]) {
+      fprintf(stderr, "abi_replay: line %d: %s expects %d fields\n", line_nb, name, nb_fields[msg]);
+      errors++;
+      continue;
+    }
+
+    struct replay_event *e = replay_new_event(&events_len);
+    e->stamp = (uint32_t)stamp;
+    e->msg = (uint8_t)msg;
+    e->sender = (uint8_t)sender;
+    switch (msg) {
+      case REPLAY_IMU_GYRO:
+        e->d.gyro.p = RATE_BFP_OF_REAL(v[0]);
+        e->d.gyro.q = RATE_BFP_OF_REAL(v[1]);
+        e->d.gyro.r = RATE_BFP_OF_REAL(v[2]);
+        imu_sender = e->sender;
+        break;
+      case REPLAY_IMU_ACCEL:
+        e->d.vect.x = ACCEL_BFP_OF_REAL(v[0]);
+        e->d.vect.y = ACCEL_BFP_OF_REAL(v[1]);
+        e->d.vect.z = ACCEL_BFP_OF_REAL(v[2]);
+        break;
+      case REPLAY_IMU_MAG:
+        e->d.vect.x = MAG_BFP_OF_REAL(v[0]);
+        e->d.vect.y = MAG_BFP_OF_REAL(v[1]);
+        e->d.vect.z = MAG_BFP_OF_REAL(v[2]);
+        break;
+      case REPLAY_IMU_LOWPASSED:
+        e->d.lp.gyro.p = RATE_BFP_OF_REAL(v[0]);
+        e->d.lp.gyro.q = RATE_BFP_OF_REAL(v[1]);
+        e->d.lp.gyro.r = RATE_BFP_OF_REAL(v[2]);
+        e->d.lp.accel.x = ACCEL_BFP_OF_REAL(v[3]);
+        e->d.lp.accel.y = ACCEL_BFP_OF_REAL(v[4]);
+        e->d.lp.accel.z = ACCEL_BFP_OF_REAL(v[5]);
+        e->d.lp.mag.x = MAG_BFP_OF_REAL(v[6]);
+        e->d.lp.mag.y = MAG_BFP_OF_REAL(v[7]);
+        e->d.lp.mag.z = MAG_BFP_OF_REAL(v[8]);
+        has_lowpassed = 1;
+        break;
+      case REPLAY_BARO_ABS:
+        e->d.pressure = v[0];
+        break;
+      case REPLAY_GPS:
+        if (nb_gps_states >= gps_len) {
+          gps_states = replay_grow(gps_states, &gps_len, sizeof(struct GpsState));
+        }
+        replay_parse_gps(&gps_states[nb_gps_states], e->stamp, v);
+        e->d.gps_idx = nb_gps_states++;
+        break;
+      default:
+        break;
+    }
+
+    /* average the first samples for the synthesized alignment */
+    if (msg <= REPLAY_IMU_MAG && !has_lowpassed && align_samples > 0 &&
+        nb_sum[REPLAY_IMU_GYRO] < align_samples) {
+      sum[msg].x += v[0];
+      sum[msg].y += v[1];
+      sum[msg].z += v[2];
+      nb_sum[msg]++;
+      if (msg == REPLAY_IMU_GYRO && nb_sum[REPLAY_IMU_GYRO] == align_samples) {
+        struct replay_event *lp = replay_new_event(&events_len);
+        lp->stamp = (uint32_t)stamp;
+        lp->msg = REPLAY_IMU_LOWPASSED;
+        lp->sender = imu_sender;
+        for (i = 0; i < 3; i++) {
+          if (nb_sum[i] > 0) {
+            VECT3_SDIV(sum[i], sum[i], (float)nb_sum[i]);
+          }
+        }
+        struct FloatRates lp_gyro = { sum[0].x, sum[0].y, sum[0].z };
+        RATES_BFP_OF_REAL(lp->d.lp.gyro, lp_gyro);
+        ACCELS_BFP_OF_REAL(lp->d.lp.accel, sum[REPLAY_IMU_ACCEL]);
+        MAGS_BFP_OF_REAL(lp->d.lp.mag, sum[REPLAY_IMU_MAG]);
+        has_lowpassed = 1;
+      }
+    }
+  }
+  return errors;
+}
+
+static void replay_write_trace(FILE *f, uint32_t stamp)
+{
+  struct FloatEulers *e = stateGetNedToBodyEulers_f();
+  struct FloatRates *r = stateGetBodyRates_f();
+  fprintf(f, "%u %f %f %f %f %f %f", stamp, e->phi, e->theta, e->psi, r->p, r->q, r->r);
+  if (stateIsLocalCoordinateValid()) {
+    struct NedCoor_f *pos = stateGetPositionNed_f();
+    struct NedCoor_f *speed = stateGetSpeedNed_f();
+    fprintf(f, " %f %f %f %f %f %f\n", pos->x, pos->y, pos->z, speed->x, speed->y, speed->z);
+  } else {
+    fprintf(f, " nan nan nan nan nan nan\n");
+  }
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+  uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+  return (x > y) - (x < y);
+}
+
+static void replay_report(uint64_t wall_ns)
+{
+  uint64_t cb_ns = 0;
+  for (int i = 0; i < nb_cb_stats; i++) {
+    cb_ns += cb_stats[i].total;
+  }
+  float log_s = nb_events > 0 ? (events[nb_events - 1].stamp - events[0].stamp) * 1e-6f : 0.f;
+  float wall_s = wall_ns * 1e-9f;
+
+  printf("estimator: %s\n", REPLAY_ESTIMATOR_NAME);
+  printf("events: %u, log duration: %.3f s, replay: %.3f s (%.1fx real time), callbacks: %.3f s\n",
+         nb_events, log_s, wall_s, wall_s > 0.f ? log_s / wall_s : 0.f, cb_ns * 1e-9f);
+  printf("%-14s %-24s %8s %8s %8s %8s %8s %8s %6s\n", "message", "callback", "calls",
+         "min_ns", "med_ns", "p99_ns", "max_ns", "mean_ns", "%cb");
+  replay_load_symbols();
+  for (int i = 0; i < nb_cb_stats; i++) {
+    struct replay_cb_stats *s = &cb_stats[i];
+    char cb_name[64];
+    replay_func_name(cb_name, sizeof(cb_name), (void *)s->ev->cb);
+    if (s->nb == 0) {
+      continue;
+    }
+    qsort(s->ns, s->nb, sizeof(uint32_t), cmp_u32);
+    printf("%-14s %-24s %8u %8u %8u %8u %8u %8u %6.1f\n", replay_msg_names[s->msg], cb_name,
+           s->nb, s->ns[0], s->ns[s->nb / 2], s->ns[(uint32_t)(s->nb * 0.99f)], s->ns[s->nb - 1],
+           (uint32_t)(s->total / s->nb), cb_ns > 0 ? 100.f * s->total / cb_ns : 0.f);
+  }
+}
+
+static void usage(const char *name)
+{
+  fprintf(stderr, "usage: %s [-o trace] [-d decimation] [-a align_samples] log\n"
+          "  -o trace          write state output trace after each gyro message\n"
+          "  -d decimation     only trace every n-th gyro message (default 1)\n"
+          "  -a align_samples  samples averaged for the synthesized IMU_LOWPASSED,\n"
+          "                    0 to disable (default %d)\n", name, REPLAY_ALIGN_SAMPLES);
+}
+
+int main(int argc, char **argv)
+{
+  const char *trace_name = NULL;
+  int decimation = 1;
+  int align_samples = REPLAY_ALIGN_SAMPLES;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "o:d:a:h")) != -1) {
+    switch (opt) {
+      case 'o': trace_name = optarg; break;
+      case 'd': decimation = atoi(optarg) > 0 ? atoi(optarg) : 1; break;
+      case 'a': align_samples = atoi(optarg); break;
+      default: usage(argv[0]); return EXIT_FAILURE;
+    }
+  }
+  if (optind >= argc) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  FILE *log = fopen(argv[optind], "r");
+  if (log == NULL) {
+    perror(argv[optind]);
+    return EXIT_FAILURE;
+  }
+  /* one cpu tick per microsecond, so that log stamps map directly on sys_time */
+  sys_time.cpu_ticks_per_sec = 1000000;
+  sys_time.ticks_per_sec = SYS_TIME_FREQUENCY;
+  sys_time.resolution = 1.f / SYS_TIME_FREQUENCY;
+  sys_time.resolution_cpu_ticks = sys_time.cpu_ticks_per_sec / SYS_TIME_FREQUENCY;
+
+  int errors = replay_load(log, align_samples);
+  fclose(log);
+  if (nb_events == 0) {
+    fprintf(stderr, "abi_replay: no event in %s\n", argv[optind]);
+    return EXIT_FAILURE;
+  }
+
+  FILE *trace = NULL;
+  if (trace_name != NULL) {
+    trace = fopen(trace_name, "w");
+    if (trace == NULL) {
+      perror(trace_name);
+      return EXIT_FAILURE;
+    }
+    fprintf(trace, "# stamp_us phi theta psi p q r x y z vx vy vz\n");
+  }
+
+  replay_set_time(events[0].stamp);
+  stateInit();
+  REPLAY_INIT();
+
+  uint32_t nb_gyro = 0;
+  uint64_t start = replay_now_ns();
+  for (uint32_t i = 0; i < nb_events; i++) {
+    replay_set_time(events[i].stamp);
+    replay_dispatch(&events[i]);
+    if (trace != NULL && events[i].msg == REPLAY_IMU_GYRO && (nb_gyro++ % decimation) == 0) {
+      replay_write_trace(trace, events[i].stamp);
+    }
+  }
+  uint64_t wall_ns = replay_now_ns() - start;
+
+  if (trace != NULL) {
+    fclose(trace);
+  }
+  replay_report(wall_ns);
+  if (errors > 0) {
+    fprintf(stderr, "abi_replay: %d line(s) skipped\n", errors);
+  }
+  return EXIT_SUCCESS;
+}
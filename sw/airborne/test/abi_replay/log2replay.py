@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2026 The Paparazzi Team
+#
+# This file is part of paparazzi.
+#
+# paparazzi is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2, or (at your option)
+# any later version.
+#
+# paparazzi is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with paparazzi; see the file COPYING.  If not, see
+# <http://www.gnu.org/licenses/>.
+
+"""
+Convert a Paparazzi log (.data file from the ground segment or from sd2log)
+to the input format of abi_replay.
+
+Used messages:
+ - IMU_GYRO, IMU_ACCEL, IMU_MAG (float) or their _SCALED versions (fixed point)
+ - GPS_INT
+ - BARO_RAW (absolute pressure)
+
+The replay is only as good as the log: telemetry logs usually have the IMU
+messages at a few tens of Hz, the high speed IMU log or an SD log with
+the IMU messages at the propagation frequency should be used for
+meaningful estimator outputs.
+
+usage: log2replay.py [-a ac_id] [-o output] log.data
+"""
+
+import argparse
+import math
+import sys
+
+RATE_FRAC = 1 << 12
+ACCEL_FRAC = 1 << 10
+MAG_FRAC = 1 << 11
+
+# default ABI senders of the messages without a sender field
+BARO_BOARD_SENDER_ID = 1
+GPS_MULTI_ID = 12
+
+
+def imu_line(stamp, name, args, scale):
+    sender = int(args[0])
+    v = [float(a) / scale for a in args[1:4]]
+    return f"{stamp} {name} {sender} {v[0]:.6f} {v[1]:.6f} {v[2]:.6f}"
+
+
+def gps_line(stamp, sender, args):
+    """
+    GPS_INT: ecef_x ecef_y ecef_z lat lon alt hmsl ecef_xd ecef_yd ecef_zd pacc sacc tow pdop numsv fix comp_id
+    The ECEF speed is rotated to NED at the current position.
+    """
+    lat = int(args[3]) * 1e-7
+    lon = int(args[4]) * 1e-7
+    alt = int(args[5]) * 1e-3
+    hmsl = int(args[6]) * 1e-3
+    vx, vy, vz = [int(a) * 1e-2 for a in args[7:10]]
+    pacc = int(args[10]) * 1e-2
+    sacc = int(args[11]) * 1e-2
+    numsv = int(args[14])
+    fix = int(args[15])
+
+    slat, clat = math.sin(math.radians(lat)), math.cos(math.radians(lat))
+    slon, clon = math.sin(math.radians(lon)), math.cos(math.radians(lon))
+    vn = -slat * clon * vx - slat * slon * vy + clat * vz
+    ve = -slon * vx + clon * vy
+    vd = -clat * clon * vx - clat * slon * vy - slat * vz
+    return (f"{stamp} GPS {sender} {fix} {lat:.7f} {lon:.7f} {alt:.3f} {hmsl:.3f} "
+            f"{vn:.2f} {ve:.2f} {vd:.2f} {pacc:.2f} {sacc:.2f} {numsv}")
+
+
+def convert(log, out, ac_id, gps_id, baro_id):
+    nb = 0
+    for line in log:
+        args = line.split()
+        if len(args) < 3 or (ac_id is not None and args[1] != ac_id):
+            continue
+        try:
+            stamp = int(round(float(args[0]) * 1e6))
+        except ValueError:
+            continue
+        msg, fields = args[2], args[3:]
+        try:
+            if msg == "IMU_GYRO":
+                res = imu_line(stamp, "IMU_GYRO", fields, 1.)
+            elif msg == "IMU_GYRO_SCALED":
+                res = imu_line(stamp, "IMU_GYRO", fields, RATE_FRAC)
+            elif msg == "IMU_ACCEL":
+                res = imu_line(stamp, "IMU_ACCEL", fields, 1.)
+            elif msg == "IMU_ACCEL_SCALED":
+                res = imu_line(stamp, "IMU_ACCEL", fields, ACCEL_FRAC)
+            elif msg == "IMU_MAG":
+                res = imu_line(stamp, "IMU_MAG", fields, 1.)
+            elif msg == "IMU_MAG_SCALED":
+                res = imu_line(stamp, "IMU_MAG", fields, MAG_FRAC)
+            elif msg == "GPS_INT":
+                res = gps_line(stamp, gps_id, fields)
+            elif msg == "BARO_RAW":
+                res = f"{stamp} BARO_ABS {baro_id} {float(fields[0]):.2f}"
+            else:
+                continue
+        except (ValueError, IndexError):
+            print(f"log2replay: cannot parse '{line.strip()}'", file=sys.stderr)
+            continue
+        out.write(res + "\n")
+        nb += 1
+    return nb
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert a Paparazzi .data log to an abi_replay log")
+    parser.add_argument("log", help="Paparazzi log (.data)")
+    parser.add_argument("-a", "--ac_id", help="only convert the messages of this aircraft")
+    parser.add_argument("-o", "--output", help="output file (default stdout)")
+    parser.add_argument("--gps_id", type=int, default=GPS_MULTI_ID, help="ABI sender of the GPS messages")
+    parser.add_argument("--baro_id", type=int, default=BARO_BOARD_SENDER_ID, help="ABI sender of the baro messages")
+    args = parser.parse_args()
+
+    with open(args.log, 'r') as log:
+        out = open(args.output, 'w') if args.output else sys.stdout
+        out.write(f"# converted from {args.log}\n")
+        nb = convert(log, out, args.ac_id, args.gps_id, args.baro_id)
+        if args.output:
+            out.close()
+    print(f"log2replay: {nb} messages converted", file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test/bench_common.h
+ *
+ * Time measurement, statistics, report and control allocation problems
+ * shared by the benchmarks (test_bench and test_alloc_bench)
+ */
+
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include "std.h"
+#include <string.h>
+#include "math/wls/wls_alloc.h"
+
+/*
+ * Time measurement, nanoseconds on the host (BENCH_HOST), cycles from the
+ * DWT counter on STM32, microseconds otherwise.
+ * BENCH_TIME_UNIT_ID is the unit field of the BENCH_KERNEL message.
+ */
+#if BENCH_HOST
+#include <time.h>
+#include <stdlib.h>
+
+static inline uint32_t bench_time(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (uint32_t)(t.tv_sec * 1000000000ULL + t.tv_nsec);
+}
+#define BENCH_TIME_FREQUENCY 1e9f
+#define BENCH_TIME_UNIT "ns"
+#define BENCH_TIME_UNIT_ID 2
+#define dwt_enable_cycle_counter() {}
+#elif defined(STM32F1) || defined(STM32F4) || defined(STM32F7)
+#include <libopencm3/cm3/dwt.h>
+#include <libopencm3/stm32/rcc.h>
+#define bench_time() dwt_read_cycle_counter()
+#define BENCH_TIME_FREQUENCY ((float)rcc_ahb_frequency)
+#define BENCH_TIME_UNIT "cycles"
+#define BENCH_TIME_UNIT_ID 0
+#else
+#include "mcu_periph/sys_time.h"
+#define bench_time() get_sys_time_usec()
+#define BENCH_TIME_FREQUENCY 1e6f
+#define BENCH_TIME_UNIT "us"
+#define BENCH_TIME_UNIT_ID 1
+#define dwt_enable_cycle_counter() {}
+#endif
+
+/*
+ * Statistics of the times of a kernel
+ */
+
+/** Results of one kernel, fields of the BENCH_KERNEL message */
+struct bench_report {
+  uint32_t min;
+  uint32_t median;
+  uint32_t max;
+  float load;     ///< median time in percent of a period at PERIODIC_FREQUENCY
+};
+
+#if BENCH_HOST
+static int bench_cmp_time(const void *a, const void *b)
+{
+  uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+  return (x > y) - (x < y);
+}
+#endif
+
+/** Sort the times in place, insertion sort on the MCU (no allocation) */
+static inline void bench_sort_times(uint32_t *times, uint32_t nb)
+{
+#if BENCH_HOST
+  qsort(times, nb, sizeof(uint32_t), bench_cmp_time);
+#else
+  for (uint32_t i = 1; i < nb; i++) {
+    uint32_t t = times[i];
+    uint32_t j = i;
+    while (j > 0 && times[j - 1] > t) {
+      times[j] = times[j - 1];
+      j--;
+    }
+    times[j] = t;
+  }
+#endif
+}
+
+/** Sort the times and get min, median, max and load */
+static inline void bench_report_of_times(struct bench_report *r, uint32_t *times, uint32_t nb)
+{
+  if (nb == 0) {
+    r->min = r->median = r->max = 0;
+    r->load = 0.f;
+    return;
+  }
+  bench_sort_times(times, nb);
+  r->min = times[0];
+  r->median = times[nb / 2];
+  r->max = times[nb - 1];
+#ifdef PERIODIC_FREQUENCY
+  r->load = 100.f * r->median * PERIODIC_FREQUENCY / BENCH_TIME_FREQUENCY;
+#else
+  r->load = 0.f;
+#endif
+}
+
+#if !BENCH_HOST
+#include "modules/datalink/downlink.h"
+
+/** Send the results of one kernel in a BENCH_KERNEL message */
+static inline void bench_send_report(uint8_t idx, const char *name, struct bench_report *r)
+{
+  uint8_t unit = BENCH_TIME_UNIT_ID;
+  DOWNLINK_SEND_BENCH_KERNEL(DefaultChannel, DefaultDevice, &idx, &unit, &r->min, &r->median, &r->max,
+                             &r->load, strlen(name), (char *)name);
+}
+#endif
+
+/*
+ * Control allocation problems
+ */
+#ifndef ALLOC_BENCH_N_U
+#define ALLOC_BENCH_N_U WLS_N_U
+#endif
+
+#ifndef ALLOC_BENCH_N_V
+#define ALLOC_BENCH_N_V WLS_N_V
+#endif
+
+#if ALLOC_BENCH_N_U > WLS_N_U || ALLOC_BENCH_N_V > WLS_N_V
+#error "ALLOC_BENCH_N_U and ALLOC_BENCH_N_V must not be larger than WLS_N_U and WLS_N_V"
+#endif
+
+/** Allocation problem */
+struct alloc_problem {
+  float du_min[ALLOC_BENCH_N_U];
+  float du_max[ALLOC_BENCH_N_U];
+  float B[ALLOC_BENCH_N_V][ALLOC_BENCH_N_U];
+  float v[ALLOC_BENCH_N_V];
+  float Wv[ALLOC_BENCH_N_V];
+  float Wu[ALLOC_BENCH_N_U];
+  float up[ALLOC_BENCH_N_U];
+};
+
+/** Deterministic xorshift32 generator */
+static uint32_t bench_seed = 2463534242UL;
+
+static inline float bench_rand(float min, float max)
+{
+  bench_seed ^= bench_seed << 13;
+  bench_seed ^= bench_seed >> 17;
+  bench_seed ^= bench_seed << 5;
+  return min + (max - min) * (float)(bench_seed >> 8) / (float)(1UL << 24);
+}
+
+/**
+ * Random problem with an INDI like scaling: effectiveness of ~1e-3 per
+ * actuator unit, actuator increments of a few thousand units.
+ * One in four problems asks for more than the actuators can give.
+ */
+static inline void alloc_random_problem(struct alloc_problem *p)
+{
+  for (int j = 0; j < ALLOC_BENCH_N_U; j++) {
+    p->du_min[j] = bench_rand(-9600.f, 0.f);
+    p->du_max[j] = bench_rand(0.f, 9600.f);
+    p->Wu[j] = bench_rand(0.5f, 2.f);
+    p->up[j] = bench_rand(p->du_min[j], p->du_max[j]);
+  }
+  float scale = (bench_rand(0.f, 1.f) < 0.25f) ? 10.f : 1.f;
+  for (int i = 0; i < ALLOC_BENCH_N_V; i++) {
+    for (int j = 0; j < ALLOC_BENCH_N_U; j++) {
+      p->B[i][j] = bench_rand(-1.f, 1.f) / 1000.f;
+    }
+    p->v[i] = scale * bench_rand(-5.f, 5.f);
+    p->Wv[i] = bench_rand(1.f, 1000.f);
+  }
+}
+
+/** Row pointers of the effectiveness matrix, as expected by the allocators */
+static inline void alloc_problem_rows(struct alloc_problem *p, float **B)
+{
+  for (int i = 0; i < ALLOC_BENCH_N_V; i++) {
+    B[i] = p->B[i];
+  }
+}
+
+#endif /* BENCH_COMMON_H */
@@ -0,0 +1,299 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_alloc_bench.c
+ *
+ * Benchmark of the control allocation algorithms
+ *
+ * The same allocation problems (du_min, du_max, B, v, Wv, Wu, up) are solved by
+ * each allocator. The solve times are reduced to min, median and max by the
+ * same code as test_bench (bench_common.h).
+ *
+ * The random problems come from a fixed seed xorshift generator, so the set is
+ * the same on every run and on every platform. Part of the random objectives
+ * are scaled up to saturate the actuators, which is where the active set
+ * needs the most iterations.
+ *
+ * On the host (make bench_alloc), the times are in nanoseconds and recorded
+ * problems can be replayed from a text file, one problem per line:
+ *   du_min[n_u] du_max[n_u] B[n_v*n_u] (row major) v[n_v] Wv[n_v] Wu[n_u] up[n_u]
+ * Besides the times, the number of iterations, the max constraint violation
+ * and the mean weighted residual of the control objective |Wv*(B*u - v)| are
+ * printed.
+ *
+ * On STM32 (test_alloc_bench target of test_progs), the times are in cycles
+ * from the DWT counter and the results of each allocator are sent in
+ * BENCH_KERNEL messages, like the kernels of test_bench. The iterations and
+ * residuals do not depend on the platform, they are checked on the host.
+ */
+
+#include <math.h>
+#include "std.h"
+#include "math/wls/wls_alloc.h"
+#include "bench_common.h"
+
+#if BENCH_HOST
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+
+/** Number of random problems, and number of recorded problems timed on the MCU */
+#ifndef ALLOC_BENCH_NB
+#define ALLOC_BENCH_NB 1000
+#endif
+
+/** Max number of iterations given to the allocators */
+#ifndef ALLOC_BENCH_IMAX
+#define ALLOC_BENCH_IMAX 100
+#endif
+
+/** Gamma given to the allocators (0 for their default) */
+#ifndef ALLOC_BENCH_GAMMA
+#define ALLOC_BENCH_GAMMA 10000.f
+#endif
+
+#define N_U ALLOC_BENCH_N_U
+#define N_V ALLOC_BENCH_N_V
+
+typedef int (*alloc_fun)(float *u, float *v, float *umin, float *umax, float **B,
+                         float *u_guess, float *W_init, float *Wv, float *Wu, float *up,
+                         float gamma_sq, int imax, int n_u, int n_v);
+
+struct alloc_bench {
+  const char *name;
+  alloc_fun fun;
+};
+
+/** Allocators to compare */
+static const struct alloc_bench allocators[] = {
+  { "wls_alloc", wls_alloc },
+  { "wls_alloc_qr", wls_alloc_qr },
+};
+
+#define ALLOCATORS_NB (sizeof(allocators) / sizeof(struct alloc_bench))
+
+/** Results of one allocator */
+struct alloc_result {
+  uint32_t nb;
+  uint32_t iter_sum;
+  uint32_t iter_max;
+  uint32_t imax_reached;
+  uint32_t truncated;       ///< problems not solved because the times storage is full
+  uint32_t *times;
+  uint32_t len;             ///< size of the times storage
+  float violation_max;
+  float residual_sum;
+};
+
+static struct alloc_result results[ALLOCATORS_NB];
+
+/**
+ * Make room for one more time of an allocator.
+ * The storage grows with the number of problems on the host, it is
+ * limited to ALLOC_BENCH_NB problems on the MCU.
+ */
+#if BENCH_HOST
+static bool grow_times(struct alloc_result *r)
+{
+  uint32_t len = r->len ? 2 * r->len : ALLOC_BENCH_NB;
+  uint32_t *times = realloc(r->times, len * sizeof(uint32_t));
+  if (times == NULL) {
+    return false;
+  }
+  r->times = times;
+  r->len = len;
+  return true;
+}
+#else
+static uint32_t times_storage[ALLOCATORS_NB][ALLOC_BENCH_NB];
+
+static bool grow_times(struct alloc_result *r)
+{
+  if (r->times != NULL) {
+    return false;
+  }
+  r->times = times_storage[r - results];
+  r->len = ALLOC_BENCH_NB;
+  return true;
+}
+#endif
+
+/** Max distance of u outside of [du_min, du_max] */
+static float constraint_violation(struct alloc_problem *p, float *u)
+{
+  float violation = 0.f;
+  for (int j = 0; j < N_U; j++) {
+    violation = Max(violation, p->du_min[j] - u[j]);
+    violation = Max(violation, u[j] - p->du_max[j]);
+  }
+  return violation;
+}
+
+/** Weighted norm of the control objective error */
+static float objective_residual(struct alloc_problem *p, float *u)
+{
+  float res = 0.f;
+  for (int i = 0; i < N_V; i++) {
+    float e = -p->v[i];
+    for (int j = 0; j < N_U; j++) {
+      e += p->B[i][j] * u[j];
+    }
+    res += p->Wv[i] * p->Wv[i] * e * e;
+  }
+  return sqrtf(res);
+}
+
+/** Solve a problem with all the allocators */
+static void run_problem(struct alloc_problem *p)
+{
+  float *B[N_V];
+  alloc_problem_rows(p, B);
+
+  for (uint8_t k = 0; k < ALLOCATORS_NB; k++) {
+    struct alloc_result *r = &results[k];
+    if (r->nb >= r->len && !grow_times(r)) {
+      r->truncated++;
+      continue;
+    }
+    float u[N_U];
+    uint32_t start = bench_time();
+    int iter = allocators[k].fun(u, p->v, p->du_min, p->du_max, B, 0, 0, p->Wv, p->Wu, p->up,
+                                 ALLOC_BENCH_GAMMA, ALLOC_BENCH_IMAX, N_U, N_V);
+    r->times[r->nb++] = bench_time() - start;
+
+    r->iter_sum += iter;
+    if ((uint32_t)iter > r->iter_max) {
+      r->iter_max = iter;
+    }
+    if (iter > ALLOC_BENCH_IMAX) {
+      r->imax_reached++;
+    }
+    r->violation_max = Max(r->violation_max, constraint_violation(p, u));
+    r->residual_sum += objective_residual(p, u);
+  }
+}
+
+static void run_random_problems(void)
+{
+  struct alloc_problem p;
+  for (int n = 0; n < ALLOC_BENCH_NB; n++) {
+    alloc_random_problem(&p);
+    run_problem(&p);
+  }
+}
+
+#if BENCH_HOST
+
+/** Read a recorded problem, returns false at the end of the file */
+static bool read_problem(FILE *f, struct alloc_problem *p)
+{
+  float *fields[] = { p->du_min, p->du_max, &p->B[0][0], p->v, p->Wv, p->Wu, p->up };
+  int sizes[] = { N_U, N_U, N_V * N_U, N_V, N_V, N_U, N_U };
+  for (uint8_t k = 0; k < sizeof(sizes) / sizeof(int); k++) {
+    for (int i = 0; i < sizes[k]; i++) {
+      if (fscanf(f, " %f ,", &fields[k][i]) != 1) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static void print_results(void)
+{
+  printf("%d x %d problems, imax %d, times in %s\n", N_V, N_U, ALLOC_BENCH_IMAX, BENCH_TIME_UNIT);
+  printf("%-14s %6s %8s %8s %6s %10s %10s %10s %10s %10s\n", "allocator", "nb", "iter_avg", "iter_max",
+         "imax", "time_min", "time_med", "time_max", "violation", "residual");
+  for (uint8_t k = 0; k < ALLOCATORS_NB; k++) {
+    struct alloc_result *r = &results[k];
+    struct bench_report report;
+    bench_report_of_times(&report, r->times, r->nb);
+    printf("%-14s %6u %8.2f %8u %6u %10u %10u %10u %10.3g %10.3g\n", allocators[k].name, r->nb,
+           r->nb ? (float)r->iter_sum / r->nb : 0.f, r->iter_max, r->imax_reached, report.min, report.median,
+           report.max, r->violation_max, r->nb ? r->residual_sum / r->nb : 0.f);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 1) {
+    FILE *f = fopen(argv[1], "r");
+    if (f == NULL) {
+      fprintf(stderr, "Could not open %s\n", argv[1]);
+      return 1;
+    }
+    struct alloc_problem p;
+    while (read_problem(f, &p)) {
+      run_problem(&p);
+    }
+    fclose(f);
+    printf("Recorded problems from %s\n", argv[1]);
+    for (uint8_t k = 0; k < ALLOCATORS_NB; k++) {
+      if (results[k].truncated > 0) {
+        fprintf(stderr, "%s: %u problems skipped, out of memory for the times\n", allocators[k].name,
+                results[k].truncated);
+      }
+    }
+  } else {
+    run_random_problems();
+    printf("Random problems\n");
+  }
+  print_results();
+  return 0;
+}
+
+#else /* MCU test program */
+
+#include BOARD_CONFIG
+#include "mcu.h"
+#include "mcu_periph/sys_time.h"
+#include "modules/datalink/downlink.h"
+#include "led.h"
+
+static struct bench_report report[ALLOCATORS_NB];
+
+int main(void)
+{
+  mcu_init();
+  sys_time_register_timer((1. / PERIODIC_FREQUENCY), NULL);
+  downlink_init();
+  dwt_enable_cycle_counter();
+
+  run_random_problems();
+  for (uint8_t k = 0; k < ALLOCATORS_NB; k++) {
+    bench_report_of_times(&report[k], results[k].times, results[k].nb);
+  }
+
+  uint8_t idx = 0;
+  while (1) {
+    if (sys_time_check_and_ack_timer(0)) {
+      LED_PERIODIC();
+      RunOnceEvery(PERIODIC_FREQUENCY, {
+        bench_send_report(idx, allocators[idx].name, &report[idx]);
+        idx = (idx + 1) % ALLOCATORS_NB;
+      });
+    }
+    mcu_event();
+  }
+  return 0;
+}
+
+#endif
@@ -0,0 +1,439 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_bench.c
+ *
+ * On target benchmark of the periodic kernels
+ *
+ * Each registered kernel (AHRS propagation and updates, full AHRS cycles,
+ * vertical filter, invariant filter, filter banks, control allocation,
+ * pprzlink packing and parsing) is run
+ * BENCH_NB_SAMPLES times after a few warm up calls and every call is timed
+ * individually. The min, median and max times give the cost of a kernel on
+ * this board, flash wait states and caches included, which is what is needed
+ * to choose PERIODIC_FREQUENCY.
+ *
+ * The invariant filter kernels run the generated propagation and correction
+ * (INS_INV_CODEGEN) on a local state, without the GPS and state interface of
+ * the module.
+ *
+ * On STM32 the times are in cycles from the DWT counter, otherwise in
+ * microseconds. Once a second, the results of one kernel are sent in a
+ * BENCH_KERNEL message.
+ */
+
+#include BOARD_CONFIG
+#include "std.h"
+#include "mcu.h"
+#include "mcu_periph/sys_time.h"
+#include "modules/datalink/downlink.h"
+#include "pprzlink/pprz_transport.h"
+#include "led.h"
+#include <string.h>
+
+#include "math/pprz_algebra_float.h"
+#include "math/pprz_algebra_int.h"
+#include "modules/ahrs/ahrs_float_cmpl.h"
+#include "modules/ahrs/ahrs_int_cmpl_quat.h"
+#include "modules/ins/vf_float.h"
+#include "modules/ins/ins_float_invariant_gen.h"
+#include "filters/low_pass_filter.h"
+#include "filters/filter_bank.h"
+#include "math/wls/wls_alloc.h"
+#include "bench_common.h"
+
+/** Number of timed calls per kernel */
+#ifndef BENCH_NB_SAMPLES
+#define BENCH_NB_SAMPLES 256
+#endif
+
+/** Number of untimed calls before the measurements */
+#ifndef BENCH_NB_WARMUP
+#define BENCH_NB_WARMUP 8
+#endif
+
+/** Number of channels of the filter bank kernels */
+#ifndef BENCH_NB_CHANNELS
+#define BENCH_NB_CHANNELS 8
+#endif
+
+/** Number of allocation problems, solved in turn by the allocation kernels */
+#ifndef BENCH_NB_ALLOC_PROBLEMS
+#define BENCH_NB_ALLOC_PROBLEMS 16
+#endif
+
+#define BENCH_DT (1.f / PERIODIC_FREQUENCY)
+
+struct bench_kernel {
+  const char *name;
+  void (*run)(void);
+};
+
+/*
+ * Kernel inputs, changed a little at each call so that the work is not
+ * the same every time
+ */
+static uint32_t bench_count;
+static struct FloatRates gyro_f = { 0.01f, -0.02f, 0.03f };
+static struct FloatVect3 accel_f = { 0.1f, -0.2f, -9.81f };
+static struct FloatVect3 mag_f = { 0.4f, 0.05f, 0.8f };
+static struct Int32Rates gyro_i;
+static struct Int32Vect3 accel_i;
+static struct Int32Vect3 mag_i;
+static struct FloatQuat quat_a, quat_b, quat_c;
+
+static struct inv_state inv_state;
+static struct inv_command inv_cmd;
+static struct inv_correction_gains inv_corr;
+static struct inv_gains inv_gains;
+static struct FloatVect3 inv_mag_h = { 0.5f, 0.05f, 0.85f };
+static struct FloatVect3 inv_speed_err, inv_pos_err;
+
+static float filter_in[BENCH_NB_CHANNELS];
+static float filter_out[BENCH_NB_CHANNELS];
+static Butterworth2LowPass filters[BENCH_NB_CHANNELS];
+static BUTTERWORTH_2_LOW_PASS_BANK(filter_bank, BENCH_NB_CHANNELS);
+
+static struct alloc_problem alloc_problems[BENCH_NB_ALLOC_PROBLEMS];
+static float alloc_u[ALLOC_BENCH_N_U];
+
+/** Memory link device used by the pprzlink kernels */
+struct bench_link {
+  struct link_device device;
+  uint8_t buf[256];
+  uint16_t len;
+};
+
+static struct bench_link bench_link;
+static struct pprz_transport bench_tp;
+static uint8_t bench_msg[256];
+static uint16_t bench_msg_len;
+
+static bool bench_link_check_free_space(struct bench_link *p, long *fd __attribute__((unused)), uint16_t len)
+{
+  return (p->len + len <= sizeof(p->buf));
+}
+
+static void bench_link_put_byte(struct bench_link *p, long fd __attribute__((unused)), uint8_t data)
+{
+  p->buf[p->len++] = data;
+}
+
+static void bench_link_put_buffer(struct bench_link *p, long fd __attribute__((unused)), uint8_t *data, uint16_t len)
+{
+  memcpy(&p->buf[p->len], data, len);
+  p->len += len;
+}
+
+static void bench_link_send_message(struct bench_link *p __attribute__((unused)), long fd __attribute__((unused))) {}
+
+static int bench_link_char_available(struct bench_link *p __attribute__((unused)))
+{
+  return false;
+}
+
+static uint8_t bench_link_get_byte(struct bench_link *p __attribute__((unused)))
+{
+  return 0;
+}
+
+static void bench_link_set_baudrate(struct bench_link *p __attribute__((unused)), uint32_t baudrate __attribute__((unused))) {}
+
+static void bench_link_init(void)
+{
+  bench_link.len = 0;
+  bench_link.device.periph = (void *)&bench_link;
+  bench_link.device.check_free_space = (check_free_space_t)bench_link_check_free_space;
+  bench_link.device.put_byte = (put_byte_t)bench_link_put_byte;
+  bench_link.device.put_buffer = (put_buffer_t)bench_link_put_buffer;
+  bench_link.device.send_message = (send_message_t)bench_link_send_message;
+  bench_link.device.char_available = (char_available_t)bench_link_char_available;
+  bench_link.device.get_byte = (get_byte_t)bench_link_get_byte;
+  bench_link.device.set_baudrate = (set_baudrate_t)bench_link_set_baudrate;
+  pprz_transport_init(&bench_tp);
+}
+
+/*
+ * Kernels
+ */
+
+static void bench_float_quat_comp(void)
+{
+  quat_a.qx = 0.001f * (bench_count & 0xff);
+  float_quat_comp(&quat_c, &quat_a, &quat_b);
+}
+
+static void bench_ahrs_fc_propagate(void)
+{
+  gyro_f.p = 0.0001f * (bench_count & 0xff);
+  ahrs_fc_propagate(&gyro_f, BENCH_DT);
+}
+
+static void bench_ahrs_fc_update_accel(void)
+{
+  accel_f.x = 0.001f * (bench_count & 0xff);
+  ahrs_fc_update_accel(&accel_f, BENCH_DT);
+}
+
+static void bench_ahrs_icq_propagate(void)
+{
+  gyro_i.p = RATE_BFP_OF_REAL(0.0001f * (bench_count & 0xff));
+  ahrs_icq_propagate(&gyro_i, BENCH_DT);
+}
+
+static void bench_ahrs_icq_update_accel(void)
+{
+  accel_i.x = ACCEL_BFP_OF_REAL(0.001f * (bench_count & 0xff));
+  ahrs_icq_update_accel(&accel_i, BENCH_DT);
+}
+
+static void bench_ahrs_fc_update_mag(void)
+{
+  mag_f.y = 0.0001f * (bench_count & 0xff);
+  ahrs_fc_update_mag(&mag_f, BENCH_DT);
+}
+
+/** Full AHRS cycle: propagation, accel and mag updates */
+static void bench_ahrs_fc_cycle(void)
+{
+  bench_ahrs_fc_propagate();
+  bench_ahrs_fc_update_accel();
+  bench_ahrs_fc_update_mag();
+}
+
+static void bench_ahrs_icq_update_mag(void)
+{
+  mag_i.y = MAG_BFP_OF_REAL(0.0001f * (bench_count & 0xff));
+  ahrs_icq_update_mag(&mag_i, BENCH_DT);
+}
+
+/** Full AHRS cycle: propagation, accel and mag updates */
+static void bench_ahrs_icq_cycle(void)
+{
+  bench_ahrs_icq_propagate();
+  bench_ahrs_icq_update_accel();
+  bench_ahrs_icq_update_mag();
+}
+
+static void bench_vff_propagate(void)
+{
+  vff_propagate(0.001f * (bench_count & 0xff), BENCH_DT);
+}
+
+static void bench_vff_update(void)
+{
+  vff_update(-0.01f * (bench_count & 0xff));
+}
+
+/** Invariant filter propagation, same as ins_float_invariant_propagate */
+static void bench_ins_inv_propagate(void)
+{
+  inv_cmd.rates.p = 0.0001f * (bench_count & 0xff);
+  ins_float_invariant_gen_propagate(&inv_state, &inv_cmd, &inv_corr, BENCH_DT);
+  float_quat_normalize(&inv_state.quat);
+}
+
+/** Invariant filter correction terms, same as error_output */
+static void bench_ins_inv_correction(void)
+{
+  inv_speed_err.x = 0.001f * (bench_count & 0xff);
+  ins_float_invariant_gen_correction(&inv_corr, &inv_state, &inv_cmd, &mag_f, &inv_mag_h,
+                                     &inv_speed_err, &inv_pos_err, 0.1f, &inv_gains);
+}
+
+/** Full invariant filter cycle: correction and propagation */
+static void bench_ins_inv_cycle(void)
+{
+  bench_ins_inv_correction();
+  bench_ins_inv_propagate();
+}
+
+static void bench_butterworth_2(void)
+{
+  filter_in[0] = 0.01f * (bench_count & 0xff);
+  for (int i = 0; i < BENCH_NB_CHANNELS; i++) {
+    filter_out[i] = update_butterworth_2_low_pass(&filters[i], filter_in[i]);
+  }
+}
+
+static void bench_butterworth_2_bank(void)
+{
+  filter_in[0] = 0.01f * (bench_count & 0xff);
+  update_butterworth_2_low_pass_bank(&filter_bank, filter_in, filter_out);
+}
+
+static void bench_alloc(int (*alloc)(float *, float *, float *, float *, float **, float *, float *,
+                        float *, float *, float *, float, int, int, int))
+{
+  struct alloc_problem *p = &alloc_problems[bench_count % BENCH_NB_ALLOC_PROBLEMS];
+  float *B[ALLOC_BENCH_N_V];
+  alloc_problem_rows(p, B);
+  alloc(alloc_u, p->v, p->du_min, p->du_max, B, 0, 0, p->Wv, p->Wu, p->up, 0.f, 100,
+        ALLOC_BENCH_N_U, ALLOC_BENCH_N_V);
+}
+
+static void bench_wls_alloc(void)
+{
+  bench_alloc(wls_alloc);
+}
+
+static void bench_wls_alloc_qr(void)
+{
+  bench_alloc(wls_alloc_qr);
+}
+
+static void bench_pprzlink_pack(void)
+{
+  float phi = 0.001f * (bench_count & 0xff);
+  float psi = 0.2f;
+  float theta = -0.1f;
+  bench_link.len = 0;
+  pprz_msg_send_ATTITUDE(&bench_tp.trans_tx, &bench_link.device, AC_ID, &phi, &psi, &theta);
+}
+
+static void bench_pprzlink_parse(void)
+{
+  for (uint16_t i = 0; i < bench_msg_len; i++) {
+    parse_pprz(&bench_tp, bench_msg[i]);
+  }
+  bench_tp.trans_rx.msg_received = false;
+}
+
+/** Registered kernels */
+static const struct bench_kernel kernels[] = {
+  { "float_quat_comp", bench_float_quat_comp },
+  { "ahrs_fc_propagate", bench_ahrs_fc_propagate },
+  { "ahrs_fc_update_accel", bench_ahrs_fc_update_accel },
+  { "ahrs_icq_propagate", bench_ahrs_icq_propagate },
+  { "ahrs_icq_update_accel", bench_ahrs_icq_update_accel },
+  { "ahrs_fc_update_mag", bench_ahrs_fc_update_mag },
+  { "ahrs_icq_update_mag", bench_ahrs_icq_update_mag },
+  { "ahrs_fc_cycle", bench_ahrs_fc_cycle },
+  { "ahrs_icq_cycle", bench_ahrs_icq_cycle },
+  { "vff_propagate", bench_vff_propagate },
+  { "vff_update", bench_vff_update },
+  { "ins_inv_propagate", bench_ins_inv_propagate },
+  { "ins_inv_correction", bench_ins_inv_correction },
+  { "ins_inv_cycle", bench_ins_inv_cycle },
+  { "butterworth_2", bench_butterworth_2 },
+  { "butterworth_2_bank", bench_butterworth_2_bank },
+  { "wls_alloc", bench_wls_alloc },
+  { "wls_alloc_qr", bench_wls_alloc_qr },
+  { "pprzlink_pack", bench_pprzlink_pack },
+  { "pprzlink_parse", bench_pprzlink_parse },
+};
+
+#define KERNELS_NB (sizeof(kernels) / sizeof(struct bench_kernel))
+
+static void bench_init(void)
+{
+  float_quat_identity(&quat_a);
+  struct FloatEulers e = { 0.1f, -0.2f, 0.3f };
+  float_quat_of_eulers(&quat_b, &e);
+
+  RATES_BFP_OF_REAL(gyro_i, gyro_f);
+  ACCELS_BFP_OF_REAL(accel_i, accel_f);
+  MAGS_BFP_OF_REAL(mag_i, mag_f);
+  ahrs_fc_init();
+  ahrs_fc_align(&gyro_f, &accel_f, &mag_f);
+  ahrs_icq_init();
+  ahrs_icq_align(&gyro_i, &accel_i, &mag_i);
+  vff_init_zero();
+
+  // invariant filter at rest, default gains of the module
+  float_quat_identity(&inv_state.quat);
+  inv_state.as = 1.f;
+  RATES_COPY(inv_cmd.rates, gyro_f);
+  VECT3_COPY(inv_cmd.accel, accel_f);
+  inv_gains.lv = 2.f;
+  inv_gains.lb = 6.f;
+  inv_gains.mv = 8.f;
+  inv_gains.mvz = 15.f;
+  inv_gains.mh = 0.2f;
+  inv_gains.nx = 0.8f;
+  inv_gains.nxz = 0.5f;
+  inv_gains.nh = 1.2f;
+  inv_gains.ov = 1.2f;
+  inv_gains.ob = 1.f;
+  inv_gains.rv = 4.f;
+  inv_gains.rh = 8.f;
+  inv_gains.sh = 0.01f;
+
+  for (int i = 0; i < BENCH_NB_CHANNELS; i++) {
+    init_butterworth_2_low_pass(&filters[i], 1.f / (2.f * M_PI * 20.f), BENCH_DT, 0.f);
+    filter_in[i] = 0.1f * i;
+  }
+  init_butterworth_2_low_pass_bank(&filter_bank, 1.f / (2.f * M_PI * 20.f), BENCH_DT, 0.f);
+
+  // same problems as the first ones of test_alloc_bench
+  for (int n = 0; n < BENCH_NB_ALLOC_PROBLEMS; n++) {
+    alloc_random_problem(&alloc_problems[n]);
+  }
+
+  // one message to parse
+  bench_link_init();
+  bench_pprzlink_pack();
+  memcpy(bench_msg, bench_link.buf, bench_link.len);
+  bench_msg_len = bench_link.len;
+}
+
+static uint32_t times[BENCH_NB_SAMPLES];
+static struct bench_report report[KERNELS_NB];
+
+/** Time one kernel and store min, median, max and load */
+static void bench_run(uint8_t k)
+{
+  for (int n = 0; n < BENCH_NB_WARMUP; n++, bench_count++) {
+    kernels[k].run();
+  }
+  for (int n = 0; n < BENCH_NB_SAMPLES; n++, bench_count++) {
+    uint32_t start = bench_time();
+    kernels[k].run();
+    times[n] = bench_time() - start;
+  }
+  bench_report_of_times(&report[k], times, BENCH_NB_SAMPLES);
+}
+
+int main(void)
+{
+  mcu_init();
+  sys_time_register_timer((1. / PERIODIC_FREQUENCY), NULL);
+  downlink_init();
+  dwt_enable_cycle_counter();
+
+  bench_init();
+  for (uint8_t k = 0; k < KERNELS_NB; k++) {
+    bench_run(k);
+  }
+
+  uint8_t idx = 0;
+  while (1) {
+    if (sys_time_check_and_ack_timer(0)) {
+      LED_PERIODIC();
+      RunOnceEvery(PERIODIC_FREQUENCY, {
+        bench_send_report(idx, kernels[idx].name, &report[idx]);
+        idx = (idx + 1) % KERNELS_NB;
+      });
+    }
+    mcu_event();
+  }
+  return 0;
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file utils/seqlock.h
+ *
+ * Single writer, multiple readers sequence lock.
+ *
+ * The writer never blocks: it makes the sequence counter odd while it
+ * updates the protected data and even again when it is done.
+ * Readers copy the data without taking any lock and retry if the counter
+ * was odd or changed during the copy:
+ *
+ * @code
+ * uint32_t seq;
+ * do {
+ *   seq = seqlock_read_begin(&lock);
+ *   copy = shared;
+ * } while (seqlock_read_retry(&lock, seq));
+ * @endcode
+ *
+ * Readers should only copy data inside the loop and do the actual work on
+ * the copy. On a single core RTOS, a reader must not have a higher priority
+ * than the writer, or it could spin while the writer is preempted.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+struct seqlock {
+  volatile uint32_t seq;  ///< sequence counter, odd while a write is in progress
+};
+
+/**
+ * @brief Initialize a sequence lock
+ * @param sl The sequence lock
+ */
+static inline void seqlock_init(struct seqlock *sl)
+{
+  sl->seq = 0;
+}
+
+/**
+ * @brief Start a write section, only one writer is allowed at a time
+ * @param sl The sequence lock
+ */
+static inline void seqlock_write_begin(struct seqlock *sl)
+{
+  __atomic_store_n(&sl->seq, sl->seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/**
+ * @brief End a write section and publish the data
+ * @param sl The sequence lock
+ */
+static inline void seqlock_write_end(struct seqlock *sl)
+{
+  __atomic_store_n(&sl->seq, sl->seq + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Start a read section
+ * @param sl The sequence lock
+ * @return sequence number to pass to @ref seqlock_read_retry
+ */
+static inline uint32_t seqlock_read_begin(const struct seqlock *sl)
+{
+  return __atomic_load_n(&sl->seq, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief End a read section
+ * @param sl The sequence lock
+ * @param start value returned by @ref seqlock_read_begin
+ * @return true if the data read may be inconsistent and must be read again
+ */
+static inline bool seqlock_read_retry(const struct seqlock *sl, uint32_t start)
+{
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  return (start & 1) || (__atomic_load_n(&sl->seq, __ATOMIC_RELAXED) != start);
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file utils/spsc_queue.h
+ * Lock-free single producer, single consumer queue of fixed size elements.
+ * The producer only writes the head index and the consumer only writes the
+ * tail index, so neither side ever blocks. When the queue is full, new
+ * elements are dropped and counted as overruns.
+ * The buffer is provided by the user and must hold a power of two number
+ * of elements:
+ * @code
+ * static struct sample samples[64];
+ * static struct spsc_queue queue;
+ * spsc_queue_init(&queue, samples, 64, sizeof(struct sample));
+ * @endcode
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+struct spsc_queue {
+  volatile uint32_t head;   ///< next element to write, only modified by the producer
+  volatile uint32_t tail;   ///< next element to read, only modified by the consumer
+  uint32_t mask;            ///< number of elements - 1
+  uint32_t elt_size;        ///< size of one element in bytes
+  uint8_t *buf;             ///< element storage
+  volatile uint32_t overruns; ///< number of elements dropped because the queue was full
+};
+
+/**
+ * @brief Initialize a queue
+ * @param q The queue
+ * @param buf storage for nb elements
+ * @param nb number of elements, must be a power of two
+ * @param elt_size size of one element in bytes
+ * @return false if nb is not a power of two
+ */
+static inline bool spsc_queue_init(struct spsc_queue *q, void *buf, uint32_t nb, uint32_t elt_size)
+{
+  if (nb == 0 || (nb & (nb - 1)) != 0) {
+    return false;
+  }
+  q->head = 0;
+  q->tail = 0;
+  q->mask = nb - 1;
+  q->elt_size = elt_size;
+  q->buf = (uint8_t *)buf;
+  q->overruns = 0;
+  return true;
+}
+
+/**
+ * @brief Get a pointer to the next free element, producer side.
+ * The element is only visible to the consumer after @ref spsc_queue_commit.
+ * @param q The queue
+ * @return pointer to the element or NULL if the queue is full
+ */
+static inline void *spsc_queue_reserve(struct spsc_queue *q)
+{
+  uint32_t head = q->head;
+  if (head - __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE) > q->mask) {
+    q->overruns++;
+    return NULL;
+  }
+  return q->buf + (head & q->mask) * q->elt_size;
+}
+
+/**
+ * @brief Publish the element obtained with @ref spsc_queue_reserve
+ * @param q The queue
+ */
+static inline void spsc_queue_commit(struct spsc_queue *q)
+{
+  __atomic_store_n(&q->head, q->head + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Copy an element in the queue, producer side
+ * @param q The queue
+ * @param elt element to copy
+ * @return false if the queue was full and the element dropped
+ */
+static inline bool spsc_queue_push(struct spsc_queue *q, const void *elt)
+{
+  void *dst = spsc_queue_reserve(q);
+  if (dst == NULL) {
+    return false;
+  }
+  memcpy(dst, elt, q->elt_size);
+  spsc_queue_commit(q);
+  return true;
+}
+
+/**
+ * @brief Get a pointer to the oldest element, consumer side.
+ * The element stays valid until @ref spsc_queue_release.
+ * @param q The queue
+ * @return pointer to the element or NULL if the queue is empty
+ */
+static inline void *spsc_queue_front(struct spsc_queue *q)
+{
+  uint32_t tail = q->tail;
+  if (__atomic_load_n(&q->head, __ATOMIC_ACQUIRE) == tail) {
+    return NULL;
+  }
+  return q->buf + (tail & q->mask) * q->elt_size;
+}
+
+/**
+ * @brief Free the element obtained with @ref spsc_queue_front
+ * @param q The queue
+ */
+static inline void spsc_queue_release(struct spsc_queue *q)
+{
+  __atomic_store_n(&q->tail, q->tail + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Copy and remove the oldest element, consumer side
+ * @param q The queue
+ * @param elt destination
+ * @return false if the queue was empty
+ */
+static inline bool spsc_queue_pop(struct spsc_queue *q, void *elt)
+{
+  void *src = spsc_queue_front(q);
+  if (src == NULL) {
+    return false;
+  }
+  memcpy(elt, src, q->elt_size);
+  spsc_queue_release(q);
+  return true;
+}
+
+/**
+ * @brief Number of elements waiting in the queue, may be outdated when read
+ * from the other side
+ * @param q The queue
+ * @return number of elements
+ */
+static inline uint32_t spsc_queue_count(const struct spsc_queue *q)
+{
+  return __atomic_load_n(&q->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file utils/state_history.h
+ * Fixed size history of filter snapshots keyed by timestamp, to fuse
+ * delayed measurements at the time they were taken.
+ *
+ * After each propagation step the filter stores a snapshot (state,
+ * covariance and the inputs used for the step) with the time of the step.
+ * When a measurement arrives late, the snapshot valid at the measurement
+ * time is found with @ref state_history_find, the measurement is fused in
+ * it and the following snapshots are recomputed up to the present with
+ * @ref state_history_replay. The newest snapshot is then the corrected
+ * current state.
+ * Memory is bounded by the number of snapshots, and so is the cost of a
+ * replay. Measurements older than the history are reported as such and
+ * left to the caller.
+ *
+ * The buffers are provided by the user, the number of elements must be
+ * a power of two:
+ * @code
+ * static struct my_snapshot snapshots[64];
+ * static uint32_t stamps[64];
+ * static struct state_history history;
+ * state_history_init(&history, snapshots, stamps, 64, sizeof(struct my_snapshot));
+ * @endcode
+ * Timestamps are in usec (e.g. ABI stamps) and may wrap around.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+struct state_history {
+  uint32_t head;      ///< total number of pushed elements, the newest is at head - 1
+  uint32_t nb;        ///< number of valid elements
+  uint32_t mask;      ///< number of elements - 1
+  uint32_t elt_size;  ///< size of one element in bytes
+  uint8_t *buf;       ///< element storage
+  uint32_t *stamps;   ///< timestamp of each element
+};
+
+/**
+ * Replay function, recompute an element from the previous one
+ * @param elt element to update, holding the inputs of its step
+ * @param prev previous element, already up to date
+ * @param user user data given to @ref state_history_replay
+ */
+typedef void (*state_history_step_fn)(void *elt, const void *prev, void *user);
+
+/**
+ * @brief Initialize a history
+ * @param h The history
+ * @param buf storage for nb elements
+ * @param stamps storage for nb timestamps
+ * @param nb number of elements, must be a power of two
+ * @param elt_size size of one element in bytes
+ * @return false if nb is not a power of two
+ */
+static inline bool state_history_init(struct state_history *h, void *buf, uint32_t *stamps,
+                                      uint32_t nb, uint32_t elt_size)
+{
+  if (nb == 0 || (nb & (nb - 1)) != 0) {
+    return false;
+  }
+  h->head = 0;
+  h->nb = 0;
+  h->mask = nb - 1;
+  h->elt_size = elt_size;
+  h->buf = (uint8_t *)buf;
+  h->stamps = stamps;
+  return true;
+}
+
+/**
+ * @brief Drop all elements, e.g. after a filter reset
+ * @param h The history
+ */
+static inline void state_history_reset(struct state_history *h)
+{
+  h->nb = 0;
+}
+
+/**
+ * @brief Number of valid elements
+ * @param h The history
+ * @return number of elements
+ */
+static inline uint32_t state_history_count(const struct state_history *h)
+{
+  return h->nb;
+}
+
+/**
+ * @brief Get an element
+ * @param h The history
+ * @param i element index, from 0 (oldest) to count - 1 (newest)
+ * @return pointer to the element
+ */
+static inline void *state_history_get(const struct state_history *h, uint32_t i)
+{
+  return h->buf + ((h->head - h->nb + i) & h->mask) * h->elt_size;
+}
+
+/**
+ * @brief Get the timestamp of an element
+ * @param h The history
+ * @param i element index, from 0 (oldest) to count - 1 (newest)
+ * @return timestamp
+ */
+static inline uint32_t state_history_stamp(const struct state_history *h, uint32_t i)
+{
+  return h->stamps[(h->head - h->nb + i) & h->mask];
+}
+
+/**
+ * @brief Add a new element, the oldest one is overwritten when the history is full
+ * @param h The history
+ * @param stamp timestamp of the element, not older than the previous one
+ * @return pointer to the element to fill
+ */
+static inline void *state_history_push(struct state_history *h, uint32_t stamp)
+{
+  uint32_t idx = h->head & h->mask;
+  h->stamps[idx] = stamp;
+  h->head++;
+  if (h->nb <= h->mask) {
+    h->nb++;
+  }
+  return h->buf + idx * h->elt_size;
+}
+
+/**
+ * @brief Find the element valid at a given time, i.e. the newest one not after stamp
+ * @param h The history
+ * @param stamp timestamp to look for
+ * @return element index, or -1 if the history is empty or stamp is older than all elements
+ */
+static inline int32_t state_history_find(const struct state_history *h, uint32_t stamp)
+{
+  if (h->nb == 0 || (int32_t)(stamp - state_history_stamp(h, 0)) < 0) {
+    return -1;
+  }
+  // binary search of the last element with stamp <= given stamp
+  uint32_t lo = 0, hi = h->nb - 1;
+  while (lo < hi) {
+    uint32_t mid = (lo + hi + 1) / 2;
+    if ((int32_t)(stamp - state_history_stamp(h, mid)) >= 0) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  return (int32_t)lo;
+}
+
+/**
+ * @brief Recompute the elements after i up to the newest one
+ * @param h The history
+ * @param i index of the first element, already up to date
+ * @param step function computing an element from the previous one
+ * @param user user data passed to step
+ * @return number of replayed steps
+ */
+static inline uint32_t state_history_replay(struct state_history *h, uint32_t i,
+    state_history_step_fn step, void *user)
+{
+  uint32_t n = 0;
+  for (uint32_t j = i + 1; j < h->nb; j++, n++) {
+    step(state_history_get(h, j), state_history_get(h, j - 1), user);
+  }
+  return n;
+}
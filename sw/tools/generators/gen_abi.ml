@@ -34,7 +34,8 @@ type fields = field list
 type message = {
   name : string;
   id : int;
-  fields : fields
+  fields : fields;
+  deferred : string option (* policy when sent from another thread *)
 }
 
 module Syntax = struct
@@ -49,7 +50,19 @@ module Syntax = struct
           and _type = ExtXml.attrib field "type" in
           (_name, _type))
         (Xml.children xml) in
-    { id = id; name = name; fields = fields }
+    let deferred =
+      match ExtXml.attrib_opt xml "deferred" with
+      | None -> None
+      | Some "drop" -> Some "ABI_DEFERRED_DROP"
+      | Some "overwrite" -> Some "ABI_DEFERRED_OVERWRITE"
+      | Some d -> failwith (sprintf "Unknown deferred policy '%s' for message %s" d name) in
+    (* arguments are copied to be delivered later, pointers are not allowed *)
+    if deferred <> None then
+      List.iter (fun (n, t) ->
+        if String.contains t '*' then
+          failwith (sprintf "Deferred message %s can't have pointer field '%s'" name n)
+      ) fields;
+    { id = id; name = name; fields = fields; deferred = deferred }
 
   let check_single_ids = fun msgs ->
     let tab = Array.make 256 false (* TODO remove limitation to 256 msg not needed here *)
@@ -137,6 +150,18 @@ module Gen_onboard = struct
     Printf.fprintf h "\nstatic inline void AbiSendMsg%s" name;
     print_args h msg.fields;
     Printf.fprintf h " {\n";
+    begin match msg.deferred with
+    | None -> ()
+    | Some policy ->
+        Printf.fprintf h "#if ABI_DEFERRED\n";
+        Printf.fprintf h "  if (!abi_deferred_is_main_thread()) {\n";
+        Printf.fprintf h "    struct abi_args_%s args = { " name;
+        Printf.fprintf h "%s };\n" (String.concat ", " (List.map fst msg.fields));
+        Printf.fprintf h "    abi_deferred_push(ABI_%s_ID, sender_id, %s, &args, sizeof(args));\n" name policy;
+        Printf.fprintf h "    return;\n";
+        Printf.fprintf h "  }\n";
+        Printf.fprintf h "#endif\n"
+    end;
     Printf.fprintf h "  abi_event* e;\n";
     Printf.fprintf h "  ABI_FOREACH(abi_queues[ABI_%s_ID],e) {\n" name;
     Printf.fprintf h "    if (e->id == ABI_BROADCAST || e->id == sender_id) {\n";
@@ -155,6 +180,43 @@ module Gen_onboard = struct
       print_msg_send h msg
     ) messages
 
+  (* Print arguments structures of deferred messages *)
+  let print_deferred_args = fun h messages ->
+    let deferred = List.filter (fun msg -> msg.deferred <> None) messages in
+    Printf.fprintf h "\n/* Arguments of deferred messages */\n";
+    List.iter (fun msg ->
+      Printf.fprintf h "struct abi_args_%s {\n" (String.capitalize_ascii msg.name);
+      List.iter (fun (n, t) -> Printf.fprintf h "  %s %s;\n" t n) msg.fields;
+      Printf.fprintf h "};\n"
+    ) deferred;
+    Printf.fprintf h "\nunion abi_deferred_args {\n";
+    Printf.fprintf h "  uint8_t none;\n";
+    List.iter (fun msg ->
+      let name = String.capitalize_ascii msg.name in
+      Printf.fprintf h "  struct abi_args_%s %s;\n" name name
+    ) deferred;
+    Printf.fprintf h "};\n"
+
+  (* Print dispatch function of deferred messages, called from the main thread *)
+  let print_deferred_dispatch = fun h messages ->
+    let deferred = List.filter (fun msg -> msg.deferred <> None) messages in
+    Printf.fprintf h "\n/* Deliver a deferred message to its subscribers */\n";
+    Printf.fprintf h "static inline void abi_deferred_dispatch_msg(uint8_t msg_id, uint8_t sender_id, union abi_deferred_args *args) {\n";
+    Printf.fprintf h "  switch (msg_id) {\n";
+    List.iter (fun msg ->
+      let name = String.capitalize_ascii msg.name in
+      Printf.fprintf h "    case ABI_%s_ID:\n" name;
+      Printf.fprintf h "      AbiSendMsg%s(sender_id%s);\n" name
+        (String.concat "" (List.map (fun (n, _) -> sprintf ", args->%s.%s" name n) msg.fields));
+      Printf.fprintf h "      break;\n"
+    ) deferred;
+    Printf.fprintf h "    default:\n";
+    Printf.fprintf h "      (void)sender_id;\n";
+    Printf.fprintf h "      (void)args;\n";
+    Printf.fprintf h "      break;\n";
+    Printf.fprintf h "  }\n";
+    Printf.fprintf h "}\n"
+
 end (* module Gen_onboard *)
 
 
@@ -183,6 +245,7 @@ let () =
     Printf.fprintf h "#ifndef ABI_MESSAGES_H\n";
     Printf.fprintf h "#define ABI_MESSAGES_H\n\n";
     Printf.fprintf h "#include \"modules/core/abi_common.h\"\n";
+    Printf.fprintf h "#include \"modules/core/abi_deferred.h\"\n";
 
     (** Print Messages IDs *)
     let highest_id = Gen_onboard.print_message_id h messages in
@@ -193,9 +256,15 @@ let () =
     (** Print Messages callbacks definition *)
     Gen_onboard.print_callbacks h messages;
 
+    (** Print arguments of deferred messages *)
+    Gen_onboard.print_deferred_args h messages;
+
     (** Print Bind and Send functions for all messages *)
     Gen_onboard.print_bind_send h messages;
 
+    (** Print dispatch function of deferred messages *)
+    Gen_onboard.print_deferred_dispatch h messages;
+
     Printf.fprintf h "\n#endif // ABI_MESSAGES_H\n"
   with
       Xml.Error (msg, pos) -> failwith (sprintf "%s:%d : %s\n" filename (Xml.line pos) (Xml.error_msg msg))
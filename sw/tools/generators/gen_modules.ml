@@ -199,7 +199,37 @@ let print_init_functions = fun out modules ->
   lprintf out "}\n"
 
 
+(* Index of a periodic function for the timing probes *)
+let timing_index = fun functions_modulo periodic ->
+  let rec find = fun i l ->
+    match l with
+    | [] -> failwith "Gen_modules: periodic function not found"
+    | ((p, _, _), _) :: l' -> if p == periodic then i else find (i + 1) l'
+  in
+  find 0 functions_modulo
+
+(* Encapsulate a periodic function call with timing probes *)
+let lprintf_timed = fun out idx s cond ->
+  lprintf_with_cond out (sprintf "MODULES_TIMING_START(%d); %s; MODULES_TIMING_STOP(%d)" idx s idx) cond
+
+(* Print the number and names of the timed periodic functions *)
+let print_timing_names = fun out functions_modulo ->
+  fprintf out "\n";
+  fprintf out "#include \"modules/core/task_timing.h\"\n";
+  fprintf out "#define MODULES_TIMING_NB %d\n" (List.length functions_modulo);
+  fprintf out "#if defined MODULES_C && USE_TASK_TIMING\n";
+  fprintf out "const char *modules_timing_names[] = {\n";
+  List.iter (fun ((p, name, _), _) ->
+    let f = p.Module.fname in
+    let f = try String.sub f 0 (String.index f '(') with Not_found -> f in
+    fprintf out "  \"%s:%s\",\n" name f
+  ) functions_modulo;
+  fprintf out "  NULL\n";
+  fprintf out "};\n";
+  fprintf out "#endif\n"
+
 let print_periodic = fun out functions_modulo (task, modules) ->
+  let all_functions = functions_modulo in
   (* filter for a given task *)
   let functions_modulo = List.filter (fun m ->
     let (_, name, _), _ = m in
@@ -249,16 +279,17 @@ let print_periodic = fun out functions_modulo (task, modules) ->
   fprintf out "\n";
   List.iter (fun ((periodic, name, delay), (p, m)) ->
     if (List.exists (fun _module -> _module.Module.name = name) modules) then begin
+      let idx = timing_index all_functions periodic in
       let p, f = get_period_and_freq periodic.Module.period_freq in
       if f = "(MODULES_FREQUENCY)" then
         begin
           match periodic.Module.autorun with
           | Module.Lock ->
-              lprintf_with_cond out periodic.Module.call periodic.Module.cond
+              lprintf_timed out idx periodic.Module.call periodic.Module.cond
           | _ ->
               lprintf out "if (%s == MODULES_RUN) {\n" (get_status_name periodic.Module.fname name);
               right ();
-              lprintf_with_cond out periodic.Module.call periodic.Module.cond;
+              lprintf_timed out idx periodic.Module.call periodic.Module.cond;
               left ();
               lprintf out "}\n"
         end
@@ -270,7 +301,7 @@ let print_periodic = fun out functions_modulo (task, modules) ->
           in
           lprintf out "if (i%d == (uint32_t)(%ff * PRESCALER_%d)%s) {\n" m delay m run;
           right ();
-          lprintf_with_cond out periodic.Module.call periodic.Module.cond;
+          lprintf_timed out idx periodic.Module.call periodic.Module.cond;
           left ();
           lprintf out "}\n"
         end;
@@ -378,6 +409,7 @@ let parse_modules out modules =
   let functions_modulo = get_functions_modulos modules in
   print_function_prescalers out functions_modulo;
   print_status out modules;
+  print_timing_names out functions_modulo;
   fprintf out "\n";
   print_init_functions out modules;
   print_periodic_functions out functions_modulo modules;
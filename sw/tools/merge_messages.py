@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2026 The Paparazzi Team
+#
+# This file is part of paparazzi.
+#
+# paparazzi is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2, or (at your option)
+# any later version.
+#
+# paparazzi is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with paparazzi; see the file COPYING.  If not, see
+# <http://www.gnu.org/licenses/>.
+
+"""
+Merge the messages of conf/messages_extra.xml into the pprzlink messages.xml
+
+The extra messages are copied verbatim at the end of the class with the same
+name, the rest of the base file (DOCTYPE, comments, formatting) is kept as is.
+A relative DTD path of the DOCTYPE is made absolute, so that the merged file
+can still be validated from another directory.
+
+Every extra message must have an explicit id. A message already defined in the
+base file (e.g. merged upstream in pprzlink) is kept from the base file, an id
+already used in the class is an error.
+
+usage: merge_messages.py base.xml extra.xml output.xml
+"""
+
+import os
+import re
+import sys
+import xml.etree.ElementTree as ET
+
+
+def message_text(extra_text, name):
+    """ Source text of a message of the extra file, with its indentation """
+    m = re.search(r'[ \t]*<message\s+name="%s"(?:[^>]*/>|.*?</message>)' % re.escape(name), extra_text, re.S)
+    return m.group(0)
+
+
+def insert_in_class(base_text, class_name, text):
+    """ Insert text before the closing tag of a class of the base file """
+    m = re.search(r'<msg_class\s+name="%s"' % re.escape(class_name), base_text)
+    end = base_text.index('</msg_class>', m.end())
+    # keep the indentation of the closing tag
+    line_start = base_text.rindex('\n', 0, end) + 1
+    if base_text[line_start:end].strip() == '':
+        end = line_start
+    return base_text[:end] + text + '\n' + base_text[end:]
+
+
+def absolute_doctype(base_text, base_dir):
+    """ Make the DTD path of the DOCTYPE absolute """
+    def repl(m):
+        dtd = m.group(2)
+        if not os.path.isabs(dtd) and '://' not in dtd:
+            dtd = os.path.join(os.path.abspath(base_dir), dtd)
+        return '%s"%s"' % (m.group(1), dtd)
+    return re.sub(r'(<!DOCTYPE\s+\w+\s+SYSTEM\s+)"([^"]+)"', repl, base_text, count=1)
+
+
+def merge(base_text, base_dir, extra_text):
+    base = ET.fromstring(base_text)
+    extra = ET.fromstring(extra_text)
+    classes = {c.get('name'): c for c in base.findall('msg_class')}
+    for extra_class in extra.findall('msg_class'):
+        name = extra_class.get('name')
+        if name not in classes:
+            sys.exit(f"merge_messages: unknown class '{name}' in extra messages")
+        msg_class = classes[name]
+        names = {m.get('name') for m in msg_class.iter('message')}
+        ids = {int(m.get('id')) for m in msg_class.iter('message')}
+        for msg in extra_class.findall('message'):
+            msg_name = msg.get('name')
+            if msg_name in names:
+                print(f"merge_messages: {name}.{msg_name} already defined, extra definition ignored",
+                      file=sys.stderr)
+                continue
+            if msg.get('id') is None:
+                sys.exit(f"merge_messages: {name}.{msg_name} has no id")
+            if int(msg.get('id')) in ids:
+                sys.exit(f"merge_messages: id {msg.get('id')} of {name}.{msg_name} already used")
+            ids.add(int(msg.get('id')))
+            names.add(msg_name)
+            base_text = insert_in_class(base_text, name, message_text(extra_text, msg_name))
+    return absolute_doctype(base_text, base_dir)
+
+
+def main():
+    if len(sys.argv) != 4:
+        sys.exit(__doc__)
+    with open(sys.argv[1], 'r') as f:
+        base_text = f.read()
+    with open(sys.argv[2], 'r') as f:
+        extra_text = f.read()
+    merged = merge(base_text, os.path.dirname(sys.argv[1]), extra_text)
+    with open(sys.argv[3], 'w') as f:
+        f.write(merged)
+
+
+if __name__ == '__main__':
+    main()
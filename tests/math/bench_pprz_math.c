@@ -0,0 +1,434 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file bench_pprz_math.c
+ * @brief Micro-benchmarks of the Paparazzi math library on the host.
+ *
+ * Build and run with `make bench` (the math sources are compiled in with
+ * BENCH_CFLAGS, -O2 by default, instead of using the unoptimized shared lib).
+ *
+ * Each kernel works on a small rotating set of inputs. One sample is the mean
+ * time of a batch of calls, the batch size being calibrated so that a sample
+ * lasts at least BENCH_MIN_SAMPLE_NS. After a warm up, BENCH_SAMPLES samples are
+ * taken and the min, median, 90th percentile and the median absolute deviation
+ * (in percent of the median) are reported, all in nanoseconds per call.
+ *
+ * Usage: bench_pprz_math [-c | -j] [-n samples] [filter]
+ *   -c          CSV output: name,group,ns_min,ns_median,ns_p90,mad_pct
+ *   -j          one JSON object per line with the same fields
+ *   -n samples  number of samples per kernel
+ *   filter      only run kernels whose name or group contains this string
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+#include "std.h"
+#include "math/pprz_algebra_int.h"
+#include "math/pprz_algebra_float.h"
+#include "math/pprz_algebra_double.h"
+#include "math/pprz_trig_int.h"
+#include "math/pprz_geodetic_int.h"
+#include "math/pprz_geodetic_float.h"
+#include "math/pprz_geodetic_double.h"
+#include "math/pprz_matrix_decomp_float.h"
+#include "math/pprz_matrix_decomp_fixed_float.h"
+#include "math/wls/wls_alloc.h"
+
+/** Default number of samples per kernel */
+#ifndef BENCH_SAMPLES
+#define BENCH_SAMPLES 101
+#endif
+
+/** Minimum duration of a sample in ns */
+#ifndef BENCH_MIN_SAMPLE_NS
+#define BENCH_MIN_SAMPLE_NS 20000.
+#endif
+
+/** Number of inputs of each kernel, power of 2 */
+#define BENCH_NB_IN 64
+#define BENCH_IDX(_i) ((_i) & (BENCH_NB_IN - 1))
+
+/** Number of points of the batch geodetic kernels */
+#define BENCH_NB_PTS 16
+
+/*
+ * Inputs and outputs, global so that the calls can not be optimized out
+ */
+static struct Int32Quat qi[BENCH_NB_IN], qi_out;
+static struct FloatQuat qf[BENCH_NB_IN], qf_out;
+static struct DoubleQuat qd[BENCH_NB_IN], qd_out;
+static struct Int32RMat ri[BENCH_NB_IN], ri_out;
+static struct FloatRMat rf[BENCH_NB_IN], rf_out;
+static struct FloatRates wf[BENCH_NB_IN];
+static struct FloatVect3 vf[BENCH_NB_IN], vf_out;
+static struct DoubleRMat rd[BENCH_NB_IN], rd_out;
+static struct Int32Eulers ei_out;
+static struct FloatEulers ef_out;
+static struct DoubleEulers ed_out;
+static int32_t angle_i[BENCH_NB_IN], trig_i_out;
+static float angle_f[BENCH_NB_IN], trig_f_out;
+
+static struct LtpDef_i ltp_i;
+static struct LtpDef_f ltp_f;
+static struct LtpDef_d ltp_d;
+static struct EcefCoor_i ecef_i[BENCH_NB_IN];
+static struct EcefCoor_f ecef_f[BENCH_NB_IN];
+static struct EcefCoor_d ecef_d[BENCH_NB_IN];
+static struct LlaCoor_f lla_f[BENCH_NB_IN];
+static struct LlaCoor_d lla_d[BENCH_NB_IN];
+static struct EnuCoor_f enu_f[BENCH_NB_IN];
+static struct EnuCoor_i enu_i_out[BENCH_NB_PTS];
+static struct EnuCoor_f enu_f_out;
+static struct EnuCoor_d enu_d_out;
+static struct LlaCoor_i lla_i_out;
+static struct LlaCoor_f lla_f_out;
+static struct LlaCoor_d lla_d_out;
+static struct UtmCoor_f utm_f_out;
+
+#define DECOMP_N 6
+static float spd[BENCH_NB_IN][DECOMP_N][DECOMP_N];
+static float decomp_out[3][DECOMP_N][DECOMP_N];
+static float decomp_w[DECOMP_N];
+
+#define ALLOC_N_U 4
+#define ALLOC_N_V 4
+static float alloc_v[BENCH_NB_IN][ALLOC_N_V];
+static float alloc_B[ALLOC_N_V][ALLOC_N_U];
+static float alloc_u[ALLOC_N_U];
+
+/** xorshift, so that the inputs are the same on every run */
+static uint32_t bench_rand_state = 2463534242u;
+static float bench_randf(float min, float max)
+{
+  bench_rand_state ^= bench_rand_state << 13;
+  bench_rand_state ^= bench_rand_state >> 17;
+  bench_rand_state ^= bench_rand_state << 5;
+  return min + (max - min) * (float)(bench_rand_state >> 8) / (float)(1 << 24);
+}
+
+static void bench_init_inputs(void)
+{
+  for (int i = 0; i < BENCH_NB_IN; i++) {
+    struct FloatEulers e = { bench_randf(-1.f, 1.f), bench_randf(-1.f, 1.f), bench_randf(-3.f, 3.f) };
+    float_quat_of_eulers(&qf[i], &e);
+    float_rmat_of_eulers(&rf[i], &e);
+    QUAT_BFP_OF_REAL(qi[i], qf[i]);
+    RMAT_BFP_OF_REAL(ri[i], rf[i]);
+    QUAT_COPY(qd[i], qf[i]);
+    RMAT_COPY(rd[i], rf[i]);
+    angle_f[i] = bench_randf(-M_PI, M_PI);
+    RATES_ASSIGN(wf[i], bench_randf(-5.f, 5.f), bench_randf(-5.f, 5.f), bench_randf(-5.f, 5.f));
+    VECT3_ASSIGN(vf[i], bench_randf(-10.f, 10.f), bench_randf(-10.f, 10.f), bench_randf(-10.f, 10.f));
+    angle_i[i] = ANGLE_BFP_OF_REAL(angle_f[i]);
+
+    lla_f[i].lat = RadOfDeg(43.6052765 + bench_randf(-0.1f, 0.1f));
+    lla_f[i].lon = RadOfDeg(1.4427764 + bench_randf(-0.1f, 0.1f));
+    lla_f[i].alt = 180.f + bench_randf(-100.f, 500.f);
+    LLA_COPY(lla_d[i], lla_f[i]);
+    ecef_of_lla_d(&ecef_d[i], &lla_d[i]);
+    VECT3_COPY(ecef_f[i], ecef_d[i]);
+    ecef_i[i].x = rint(CM_OF_M(ecef_d[i].x));
+    ecef_i[i].y = rint(CM_OF_M(ecef_d[i].y));
+    ecef_i[i].z = rint(CM_OF_M(ecef_d[i].z));
+
+    /* symmetric positive definite M = B*B^T + I */
+    float B[DECOMP_N][DECOMP_N];
+    for (int j = 0; j < DECOMP_N; j++) {
+      for (int k = 0; k < DECOMP_N; k++) {
+        B[j][k] = bench_randf(-1.f, 1.f);
+      }
+    }
+    for (int j = 0; j < DECOMP_N; j++) {
+      for (int k = 0; k < DECOMP_N; k++) {
+        spd[i][j][k] = (j == k) ? 1.f : 0.f;
+        for (int l = 0; l < DECOMP_N; l++) {
+          spd[i][j][k] += B[j][l] * B[k][l];
+        }
+      }
+    }
+
+    /* part of the objectives saturate the actuators */
+    for (int j = 0; j < ALLOC_N_V; j++) {
+      alloc_v[i][j] = bench_randf(-1.f, 1.f) * ((i % 4 == 0) ? 3.f : 1.f);
+    }
+  }
+
+  struct LlaCoor_f ref_f = { RadOfDeg(43.6052765), RadOfDeg(1.4427764), 180.f };
+  struct LlaCoor_d ref_d;
+  LLA_COPY(ref_d, ref_f);
+  ltp_def_from_lla_f(&ltp_f, &ref_f);
+  ltp_def_from_lla_d(&ltp_d, &ref_d);
+  struct EcefCoor_i ref_i = { rint(CM_OF_M(ltp_d.ecef.x)), rint(CM_OF_M(ltp_d.ecef.y)), rint(CM_OF_M(ltp_d.ecef.z)) };
+  ltp_def_from_ecef_i(&ltp_i, &ref_i);
+  for (int i = 0; i < BENCH_NB_IN; i++) {
+    enu_of_lla_point_f(&enu_f[i], &ltp_f, &lla_f[i]);
+  }
+
+  /* quad X, with thrust and yaw */
+  const float B_init[ALLOC_N_V][ALLOC_N_U] = {
+    { -1.f,  1.f,  1.f, -1.f },
+    {  1.f,  1.f, -1.f, -1.f },
+    {  0.5f, -0.5f, 0.5f, -0.5f },
+    {  1.f,  1.f,  1.f,  1.f }
+  };
+  memcpy(alloc_B, B_init, sizeof(alloc_B));
+}
+
+/*
+ * Kernels, called with an increasing index
+ */
+static void k_int32_quat_comp(int i) { int32_quat_comp(&qi_out, &qi[BENCH_IDX(i)], &qi[BENCH_IDX(i + 1)]); }
+static void k_float_quat_comp(int i) { float_quat_comp(&qf_out, &qf[BENCH_IDX(i)], &qf[BENCH_IDX(i + 1)]); }
+static void k_double_quat_comp(int i) { double_quat_comp(&qd_out, &qd[BENCH_IDX(i)], &qd[BENCH_IDX(i + 1)]); }
+static void k_int32_rmat_comp(int i) { int32_rmat_comp(&ri_out, &ri[BENCH_IDX(i)], &ri[BENCH_IDX(i + 1)]); }
+static void k_float_rmat_comp(int i) { float_rmat_comp(&rf_out, &rf[BENCH_IDX(i)], &rf[BENCH_IDX(i + 1)]); }
+static void k_double_rmat_comp(int i) { double_rmat_comp(&rd_out, &rd[BENCH_IDX(i)], &rd[BENCH_IDX(i + 1)]); }
+static void k_int32_eulers_of_quat(int i) { int32_eulers_of_quat(&ei_out, &qi[BENCH_IDX(i)]); }
+static void k_float_eulers_of_quat(int i) { float_eulers_of_quat(&ef_out, &qf[BENCH_IDX(i)]); }
+static void k_double_eulers_of_quat(int i) { double_eulers_of_quat(&ed_out, &qd[BENCH_IDX(i)]); }
+static void k_int32_rmat_of_quat(int i) { int32_rmat_of_quat(&ri_out, &qi[BENCH_IDX(i)]); }
+static void k_float_rmat_of_quat(int i) { float_rmat_of_quat(&rf_out, &qf[BENCH_IDX(i)]); }
+static void k_float_quat_vmult(int i) { float_quat_vmult(&vf_out, &qf[BENCH_IDX(i)], &vf[BENCH_IDX(i + 1)]); }
+static void k_float_quat_integrate(int i) { qf_out = qf[BENCH_IDX(i)]; float_quat_integrate(&qf_out, &wf[BENCH_IDX(i)], 0.002f); }
+
+static void k_pprz_itrig_sin(int i) { trig_i_out += pprz_itrig_sin(angle_i[BENCH_IDX(i)]); }
+static void k_int32_atan2(int i) { trig_i_out += int32_atan2(angle_i[BENCH_IDX(i)], angle_i[BENCH_IDX(i + 1)]); }
+static void k_sinf(int i) { trig_f_out += sinf(angle_f[BENCH_IDX(i)]); }
+static void k_atan2f(int i) { trig_f_out += atan2f(angle_f[BENCH_IDX(i)], angle_f[BENCH_IDX(i + 1)]); }
+
+static void k_enu_of_ecef_point_i(int i) { enu_of_ecef_point_i(&enu_i_out[0], &ltp_i, &ecef_i[BENCH_IDX(i)]); }
+static void k_enu_of_ecef_point_f(int i) { enu_of_ecef_point_f(&enu_f_out, &ltp_f, &ecef_f[BENCH_IDX(i)]); }
+static void k_enu_of_ecef_point_d(int i) { enu_of_ecef_point_d(&enu_d_out, &ltp_d, &ecef_d[BENCH_IDX(i)]); }
+static void k_enu_of_ecef_points_i(int i) { enu_of_ecef_points_i(enu_i_out, &ltp_i, &ecef_i[BENCH_IDX(i * BENCH_NB_PTS)], BENCH_NB_PTS); }
+static void k_enu_of_lla_point_f(int i) { enu_of_lla_point_f(&enu_f_out, &ltp_f, &lla_f[BENCH_IDX(i)]); }
+static void k_enu_of_lla_point_d(int i) { enu_of_lla_point_d(&enu_d_out, &ltp_d, &lla_d[BENCH_IDX(i)]); }
+static void k_lla_of_ecef_i(int i) { lla_of_ecef_i(&lla_i_out, &ecef_i[BENCH_IDX(i)]); }
+static void k_lla_of_ecef_f(int i) { lla_of_ecef_f(&lla_f_out, &ecef_f[BENCH_IDX(i)]); }
+static void k_lla_of_ecef_d(int i) { lla_of_ecef_d(&lla_d_out, &ecef_d[BENCH_IDX(i)]); }
+static void k_lla_of_enu_point_f(int i) { lla_of_enu_point_f(&lla_f_out, &ltp_f, &enu_f[BENCH_IDX(i)]); }
+static void k_lla_of_enu_via_ecef_f(int i)
+{
+  struct EcefCoor_f ecef;
+  ecef_of_enu_point_f(&ecef, &ltp_f, &enu_f[BENCH_IDX(i)]);
+  lla_of_ecef_f(&lla_f_out, &ecef);
+}
+static void k_utm_of_lla_f(int i) { utm_f_out.zone = 0; utm_of_lla_f(&utm_f_out, &lla_f[BENCH_IDX(i)]); }
+
+static void k_pprz_cholesky_float(int i)
+{
+  MAKE_MATRIX_PTR(in, spd[BENCH_IDX(i)], DECOMP_N);
+  MAKE_MATRIX_PTR(out, decomp_out[0], DECOMP_N);
+  pprz_cholesky_float(out, in, DECOMP_N);
+}
+static void k_pprz_cholesky_float_6(int i) { pprz_cholesky_float_6(&decomp_out[0][0][0], &spd[BENCH_IDX(i)][0][0]); }
+static void k_pprz_qr_float(int i)
+{
+  MAKE_MATRIX_PTR(in, spd[BENCH_IDX(i)], DECOMP_N);
+  MAKE_MATRIX_PTR(Q, decomp_out[0], DECOMP_N);
+  MAKE_MATRIX_PTR(R, decomp_out[1], DECOMP_N);
+  pprz_qr_float(Q, R, in, DECOMP_N, DECOMP_N);
+}
+static void k_pprz_qr_float_6(int i) { pprz_qr_float_6(&decomp_out[0][0][0], &decomp_out[1][0][0], &spd[BENCH_IDX(i)][0][0]); }
+static void k_pprz_svd_float(int i)
+{
+  /* the input is overwritten by U */
+  memcpy(decomp_out[0], spd[BENCH_IDX(i)], sizeof(decomp_out[0]));
+  MAKE_MATRIX_PTR(a, decomp_out[0], DECOMP_N);
+  MAKE_MATRIX_PTR(v, decomp_out[1], DECOMP_N);
+  pprz_svd_float(a, decomp_w, v, DECOMP_N, DECOMP_N);
+}
+
+static void bench_alloc(int i, int (*alloc)(float *, float *, float *, float *, float **, float *, float *,
+                        float *, float *, float *, float, int, int, int))
+{
+  float umin[ALLOC_N_U] = { -1.f, -1.f, -1.f, -1.f };
+  float umax[ALLOC_N_U] = { 1.f, 1.f, 1.f, 1.f };
+  float Wv[ALLOC_N_V] = { 100.f, 100.f, 1.f, 10.f };
+  float Wu[ALLOC_N_U] = { 1.f, 1.f, 1.f, 1.f };
+  float up[ALLOC_N_U] = { 0.f, 0.f, 0.f, 0.f };
+  float *B[ALLOC_N_V] = { alloc_B[0], alloc_B[1], alloc_B[2], alloc_B[3] };
+  for (int j = 0; j < ALLOC_N_U; j++) {
+    alloc_u[j] = 0.f;
+  }
+  alloc(alloc_u, alloc_v[BENCH_IDX(i)], umin, umax, B, NULL, NULL, Wv, Wu, up, 10000.f, 100, ALLOC_N_U, ALLOC_N_V);
+}
+static void k_wls_alloc(int i) { bench_alloc(i, wls_alloc); }
+static void k_wls_alloc_qr(int i) { bench_alloc(i, wls_alloc_qr); }
+
+struct bench_kernel {
+  const char *name;
+  const char *group;
+  void (*run)(int i);
+};
+
+static const struct bench_kernel kernels[] = {
+  { "int32_quat_comp", "algebra", k_int32_quat_comp },
+  { "float_quat_comp", "algebra", k_float_quat_comp },
+  { "double_quat_comp", "algebra", k_double_quat_comp },
+  { "int32_rmat_comp", "algebra", k_int32_rmat_comp },
+  { "float_rmat_comp", "algebra", k_float_rmat_comp },
+  { "double_rmat_comp", "algebra", k_double_rmat_comp },
+  { "int32_eulers_of_quat", "algebra", k_int32_eulers_of_quat },
+  { "float_eulers_of_quat", "algebra", k_float_eulers_of_quat },
+  { "double_eulers_of_quat", "algebra", k_double_eulers_of_quat },
+  { "int32_rmat_of_quat", "algebra", k_int32_rmat_of_quat },
+  { "float_rmat_of_quat", "algebra", k_float_rmat_of_quat },
+  { "float_quat_vmult", "algebra", k_float_quat_vmult },
+  { "float_quat_integrate", "algebra", k_float_quat_integrate },
+  { "pprz_itrig_sin", "trig", k_pprz_itrig_sin },
+  { "int32_atan2", "trig", k_int32_atan2 },
+  { "sinf", "trig", k_sinf },
+  { "atan2f", "trig", k_atan2f },
+  { "enu_of_ecef_point_i", "geodetic", k_enu_of_ecef_point_i },
+  { "enu_of_ecef_point_f", "geodetic", k_enu_of_ecef_point_f },
+  { "enu_of_ecef_point_d", "geodetic", k_enu_of_ecef_point_d },
+  { "enu_of_ecef_points_i/16", "geodetic", k_enu_of_ecef_points_i },
+  { "enu_of_lla_point_f", "geodetic", k_enu_of_lla_point_f },
+  { "enu_of_lla_point_d", "geodetic", k_enu_of_lla_point_d },
+  { "lla_of_ecef_i", "geodetic", k_lla_of_ecef_i },
+  { "lla_of_ecef_f", "geodetic", k_lla_of_ecef_f },
+  { "lla_of_ecef_d", "geodetic", k_lla_of_ecef_d },
+  { "lla_of_enu_point_f", "geodetic", k_lla_of_enu_point_f },
+  { "lla_of_enu_via_ecef_f", "geodetic", k_lla_of_enu_via_ecef_f },
+  { "utm_of_lla_f", "geodetic", k_utm_of_lla_f },
+  { "pprz_cholesky_float/6", "decomp", k_pprz_cholesky_float },
+  { "pprz_cholesky_float_6", "decomp", k_pprz_cholesky_float_6 },
+  { "pprz_qr_float/6", "decomp", k_pprz_qr_float },
+  { "pprz_qr_float_6", "decomp", k_pprz_qr_float_6 },
+  { "pprz_svd_float/6", "decomp", k_pprz_svd_float },
+  { "wls_alloc/4x4", "alloc", k_wls_alloc },
+  { "wls_alloc_qr/4x4", "alloc", k_wls_alloc_qr },
+};
+
+static double bench_now_ns(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+/** Mean time of a batch of calls in ns */
+static double bench_sample(const struct bench_kernel *k, int batch)
+{
+  double t0 = bench_now_ns();
+  for (int i = 0; i < batch; i++) {
+    k->run(i);
+  }
+  return (bench_now_ns() - t0) / batch;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+  double da = *(const double *)a, db = *(const double *)b;
+  return (da > db) - (da < db);
+}
+
+struct bench_result {
+  double min, median, p90, mad_pct;
+};
+
+static void bench_run(const struct bench_kernel *k, int nb_samples, struct bench_result *res)
+{
+  /* calibrate the batch size, which also warms up caches and branch predictors */
+  int batch = BENCH_NB_IN;
+  while (batch < (1 << 24) && bench_sample(k, batch) * batch < BENCH_MIN_SAMPLE_NS) {
+    batch *= 2;
+  }
+
+  double samples[nb_samples];
+  for (int s = 0; s < nb_samples; s++) {
+    samples[s] = bench_sample(k, batch);
+  }
+  qsort(samples, nb_samples, sizeof(double), cmp_double);
+  res->min = samples[0];
+  res->median = samples[nb_samples / 2];
+  res->p90 = samples[(nb_samples * 9) / 10];
+
+  double dev[nb_samples];
+  for (int s = 0; s < nb_samples; s++) {
+    dev[s] = fabs(samples[s] - res->median);
+  }
+  qsort(dev, nb_samples, sizeof(double), cmp_double);
+  res->mad_pct = 100. * dev[nb_samples / 2] / res->median;
+}
+
+enum bench_format { BENCH_TEXT, BENCH_CSV, BENCH_JSON };
+
+int main(int argc, char **argv)
+{
+  enum bench_format format = BENCH_TEXT;
+  int nb_samples = BENCH_SAMPLES;
+  const char *filter = NULL;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-c") == 0) {
+      format = BENCH_CSV;
+    } else if (strcmp(argv[i], "-j") == 0) {
+      format = BENCH_JSON;
+    } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      nb_samples = atoi(argv[++i]);
+    } else if (argv[i][0] == '-') {
+      fprintf(stderr, "usage: %s [-c | -j] [-n samples] [filter]\n", argv[0]);
+      return 1;
+    } else {
+      filter = argv[i];
+    }
+  }
+  if (nb_samples < 1) {
+    nb_samples = 1;
+  }
+
+  bench_init_inputs();
+
+  if (format == BENCH_CSV) {
+    printf("name,group,ns_min,ns_median,ns_p90,mad_pct\n");
+  } else if (format == BENCH_TEXT) {
+    printf("%-26s %-9s %10s %10s %10s %8s\n", "kernel", "group", "min ns", "median ns", "p90 ns", "mad %");
+  }
+
+  for (unsigned int i = 0; i < sizeof(kernels) / sizeof(kernels[0]); i++) {
+    const struct bench_kernel *k = &kernels[i];
+    if (filter != NULL && strstr(k->name, filter) == NULL && strstr(k->group, filter) == NULL) {
+      continue;
+    }
+    struct bench_result res;
+    bench_run(k, nb_samples, &res);
+    switch (format) {
+      case BENCH_CSV:
+        printf("%s,%s,%.2f,%.2f,%.2f,%.2f\n", k->name, k->group, res.min, res.median, res.p90, res.mad_pct);
+        break;
+      case BENCH_JSON:
+        printf("{\"name\": \"%s\", \"group\": \"%s\", \"ns_min\": %.2f, \"ns_median\": %.2f, \"ns_p90\": %.2f, "
+               "\"mad_pct\": %.2f}\n", k->name, k->group, res.min, res.median, res.p90, res.mad_pct);
+        break;
+      default:
+        printf("%-26s %-9s %10.2f %10.2f %10.2f %8.2f\n", k->name, k->group, res.min, res.median, res.p90, res.mad_pct);
+        break;
+    }
+    fflush(stdout);
+  }
+
+  return 0;
+}
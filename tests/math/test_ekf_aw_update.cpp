@@ -0,0 +1,248 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_ekf_aw_update.cpp
+ * Check the covariance propagation of the EKF_AW filter against the dense
+ * L Q L^T and its sequential scalar updates against the batch update
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#define KF_TIME_USEC() 0
+#include "modules/meteo/ekf_aw_cov.h"
+
+extern "C" {
+#include "tap.h"
+}
+
+#define NS EKF_AW_COV_SIZE  // states: V_body, wind, offset
+#define NM 7  // measurements: V_gnd, accel_filt, V_pitot
+
+/* simple deterministic noise in [-1, 1] */
+static double noise(void)
+{
+  static uint32_t seed = 4242;
+  seed = seed * 1103515245 + 12345;
+  return ((seed >> 8) & 0xFFFF) / 32768. - 1.;
+}
+
+/** Batch update in double: K = P G^T (G P G^T + R)^-1, dx = K y, P = (I - K G) P */
+static bool batch_update(double P[NS][NS], double G[NM][NS], double R[NM], double y[NM], double dx[NS])
+{
+  double PGt[NS][NM], S[NM][2 * NM];
+  for (int i = 0; i < NS; i++) {
+    for (int j = 0; j < NM; j++) {
+      PGt[i][j] = 0.;
+      for (int k = 0; k < NS; k++) {
+        PGt[i][j] += P[i][k] * G[j][k];
+      }
+    }
+  }
+  for (int i = 0; i < NM; i++) {
+    for (int j = 0; j < NM; j++) {
+      S[i][j] = i == j ? R[i] : 0.;
+      S[i][NM + j] = i == j ? 1. : 0.;
+      for (int k = 0; k < NS; k++) {
+        S[i][j] += G[i][k] * PGt[k][j];
+      }
+    }
+  }
+  /* Gauss-Jordan inverse, S is symmetric positive definite */
+  for (int c = 0; c < NM; c++) {
+    double d = S[c][c];
+    if (d <= 0.) {
+      return false;
+    }
+    for (int j = 0; j < 2 * NM; j++) {
+      S[c][j] /= d;
+    }
+    for (int i = 0; i < NM; i++) {
+      if (i != c) {
+        double f = S[i][c];
+        for (int j = 0; j < 2 * NM; j++) {
+          S[i][j] -= f * S[c][j];
+        }
+      }
+    }
+  }
+  double K[NS][NM];
+  for (int i = 0; i < NS; i++) {
+    dx[i] = 0.;
+    for (int j = 0; j < NM; j++) {
+      K[i][j] = 0.;
+      for (int k = 0; k < NM; k++) {
+        K[i][j] += PGt[i][k] * S[k][NM + j];
+      }
+      dx[i] += K[i][j] * y[j];
+    }
+  }
+  double Pn[NS][NS];
+  for (int i = 0; i < NS; i++) {
+    for (int j = 0; j < NS; j++) {
+      Pn[i][j] = P[i][j];
+      for (int k = 0; k < NM; k++) {
+        Pn[i][j] -= K[i][k] * PGt[j][k];
+      }
+    }
+  }
+  memcpy(P, Pn, sizeof(Pn));
+  return true;
+}
+
+/** Generated propagation against the dense L diag(Q) L^T in double, L as in ekf_aw.cpp */
+static double propagation_error(void)
+{
+  float Q_diag[EKF_AW_Q_SIZE];
+  for (int i = 0; i < EKF_AW_Q_SIZE; i++) {
+    Q_diag[i] = 1e-3 * (1.5 + noise());
+  }
+  const float u = 15.f * noise(), v = 3.f * noise(), w = 5.f * noise();
+  double L[NS][EKF_AW_Q_SIZE] = {{0}};
+  L[0][0] = 1;
+  L[0][4] = -w;
+  L[0][5] = v;
+  L[1][1] = 1;
+  L[1][3] = w;
+  L[1][5] = -u;
+  L[2][2] = 1;
+  L[2][3] = -v;
+  L[2][4] = u;
+  for (int i = 3; i < NS; i++) {
+    L[i][i + 3] = 1;
+  }
+
+  KfSymMatrix<NS> P;
+  for (int i = 0; i < NS * (NS + 1) / 2; i++) {
+    P.data[i] = noise();  // previous covariance, not propagated
+  }
+  ekf_aw_propagate_cov(P, Q_diag, u, v, w);
+
+  double max_err = 0.;
+  for (int i = 0; i < NS; i++) {
+    for (int j = i; j < NS; j++) {
+      double LQLt = 0.;
+      for (int k = 0; k < EKF_AW_Q_SIZE; k++) {
+        LQLt += L[i][k] * Q_diag[k] * L[j][k];
+      }
+      max_err = fmax(max_err, fabs(LQLt - P(i, j)));
+    }
+  }
+  return max_err;
+}
+
+int main()
+{
+  note("running ekf_aw sequential update tests");
+  plan(5);
+
+  double max_err_prop = 0.;
+  for (int t = 0; t < 100; t++) {
+    max_err_prop = fmax(max_err_prop, propagation_error());
+  }
+  note("max covariance propagation error %g", max_err_prop);
+  ok(max_err_prop < 1e-6, "generated covariance propagation matches L Q L^T");
+
+  double max_err_dx = 0., max_err_P = 0., max_offset_dx = 0.;
+  bool all_ok = true, all_pos = true;
+  for (int t = 0; t < 200; t++) {
+    /* random positive definite covariance P = A A^T + diag */
+    double A[NS][NS], P[NS][NS];
+    for (int i = 0; i < NS; i++) {
+      for (int j = 0; j < NS; j++) {
+        A[i][j] = 0.3 * noise();
+      }
+    }
+    for (int i = 0; i < NS; i++) {
+      for (int j = 0; j < NS; j++) {
+        P[i][j] = i == j ? 0.05 : 0.;
+        for (int k = 0; k < NS; k++) {
+          P[i][j] += A[i][k] * A[j][k];
+        }
+      }
+    }
+
+    /* observation structure of the filter: V_gnd = R_ltp V_body + wind, accel model + offset, pitot = u */
+    double G[NM][NS] = {{0}};
+    for (int i = 0; i < 3; i++) {
+      for (int j = 0; j < 3; j++) {
+        G[i][j] = noise();
+        G[3 + i][j] = 0.2 * noise();
+      }
+      G[i][3 + i] = 1.;
+      G[3 + i][6 + i] = 1.;
+    }
+    G[6][0] = 1.;
+    double R[NM], y[NM];
+    for (int i = 0; i < NM; i++) {
+      R[i] = 0.01 + 0.1 * fabs(noise());
+      y[i] = noise();
+    }
+
+    EKF_Aw_Kf kf, kf_no_offset;
+    const float P0_diag[NS] = {0};
+    kf.init(NULL, P0_diag);
+    for (int i = 0; i < NS; i++) {
+      for (int j = i; j < NS; j++) {
+        kf.P(i, j) = P[i][j];
+      }
+    }
+    kf_no_offset = kf;
+    kf_no_offset.nb_est = EKF_AW_k_x_index;
+
+    double dx[NS];
+    all_ok &= batch_update(P, G, R, y, dx);
+
+    float H[NM][NS], Rf[NM], yf[NM];
+    for (int m = 0; m < NM; m++) {
+      for (int j = 0; j < NS; j++) {
+        H[m][j] = G[m][j];
+      }
+      Rf[m] = R[m];
+      yf[m] = y[m];
+    }
+    all_ok &= kf.update(H, yf, Rf, NM) == NM;
+    all_ok &= kf_no_offset.update(H, yf, Rf, NM) == NM;
+    float dxf[NS], dxf_no_offset[NS];
+    kf.reset_error(dxf);
+    kf_no_offset.reset_error(dxf_no_offset);
+
+    for (int i = 0; i < NS; i++) {
+      max_err_dx = fmax(max_err_dx, fabs(dx[i] - dxf[i]));
+      for (int j = i; j < NS; j++) {
+        max_err_P = fmax(max_err_P, fabs(P[i][j] - kf.P(i, j)));
+      }
+      all_pos &= kf_no_offset.P(i, i) > 0.f;
+    }
+    for (int i = 6; i < NS; i++) {
+      max_offset_dx = fmax(max_offset_dx, fabs(dxf_no_offset[i]));
+    }
+  }
+
+  ok(all_ok, "all measurements are fused");
+  note("max state correction error %g, max covariance error %g", max_err_dx, max_err_P);
+  ok(max_err_dx < 1e-4, "sequential state correction matches the batch update");
+  ok(max_err_P < 1e-5, "sequential Joseph covariance matches the batch update");
+  ok(max_offset_dx == 0. && all_pos, "offset not corrected when not estimated, covariance diagonal stays positive");
+
+  done_testing();
+}
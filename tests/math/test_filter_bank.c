@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi. See LICENCE file.
+ */
+
+/**
+ * @file test_filter_bank.c
+ * Check that the filter banks of filter_bank.h give bit identical outputs
+ * to independent single channel filters.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tap.h"
+#include "filters/filter_bank.h"
+
+#define NB_CHANNELS 7     // odd number, not a multiple of a vector width
+#define NB_SAMPLES 5000
+#define SAMPLE_FREQ 500
+#define SAMPLE_TIME (1.f / SAMPLE_FREQ)
+
+/* the banks are declared at file scope like in the firmware */
+static FIRST_ORDER_LOW_PASS_BANK(fo_bank, NB_CHANNELS);
+static BUTTERWORTH_2_LOW_PASS_BANK(bw2_bank, NB_CHANNELS);
+static SECOND_ORDER_NOTCH_FILTER_BANK(notch_bank, NB_CHANNELS);
+
+static float randf(float min, float max)
+{
+  return min + (max - min) * (float)rand() / (float)RAND_MAX;
+}
+
+/* noisy sum of sines, different on each channel */
+static void input(float *in, int n)
+{
+  for (int k = 0; k < NB_CHANNELS; k++) {
+    in[k] = 3.f * sinf(0.01f * n * (k + 1)) + sinf(0.7f * n + k) + randf(-0.5f, 0.5f);
+  }
+}
+
+static void test_first_order(void)
+{
+  struct FirstOrderLowPass filters[NB_CHANNELS];
+  srand(1);
+  for (int k = 0; k < NB_CHANNELS; k++) {
+    const float tau = randf(0.002f, 0.2f), value = randf(-1.f, 1.f);
+    init_first_order_low_pass(&filters[k], tau, SAMPLE_TIME, value);
+    init_first_order_low_pass_bank_channel(&fo_bank, k, tau, SAMPLE_TIME, value);
+  }
+  bool same = true;
+  for (int n = 0; n < NB_SAMPLES && same; n++) {
+    float in[NB_CHANNELS], out[NB_CHANNELS], ref[NB_CHANNELS];
+    input(in, n);
+    update_first_order_low_pass_bank(&fo_bank, in, out);
+    for (int k = 0; k < NB_CHANNELS; k++) {
+      ref[k] = update_first_order_low_pass(&filters[k], in[k]);
+    }
+    same = memcmp(out, ref, sizeof(out)) == 0 && memcmp(fo_bank.last_out, ref, sizeof(ref)) == 0;
+  }
+  ok(same, "first order low pass bank is bit identical to %d filters", NB_CHANNELS);
+}
+
+static void test_butterworth_2(void)
+{
+  Butterworth2LowPass filters[NB_CHANNELS];
+  srand(2);
+  for (int k = 0; k < NB_CHANNELS; k++) {
+    const float tau = randf(0.002f, 0.2f), value = randf(-1.f, 1.f);
+    init_butterworth_2_low_pass(&filters[k], tau, SAMPLE_TIME, value);
+    init_butterworth_2_low_pass_bank_channel(&bw2_bank, k, tau, SAMPLE_TIME, value);
+  }
+  bool same = true;
+  for (int n = 0; n < NB_SAMPLES && same; n++) {
+    float in[NB_CHANNELS], out[NB_CHANNELS], ref[NB_CHANNELS], ref1[NB_CHANNELS];
+    input(in, n);
+    update_butterworth_2_low_pass_bank(&bw2_bank, in, out);
+    for (int k = 0; k < NB_CHANNELS; k++) {
+      ref[k] = update_butterworth_2_low_pass(&filters[k], in[k]);
+      ref1[k] = filters[k].o[1];
+    }
+    same = memcmp(out, ref, sizeof(out)) == 0 && memcmp(bw2_bank.o0, ref, sizeof(ref)) == 0 &&
+           memcmp(bw2_bank.o1, ref1, sizeof(ref1)) == 0;
+  }
+  ok(same, "butterworth 2 low pass bank is bit identical to %d filters", NB_CHANNELS);
+}
+
+static void test_notch(void)
+{
+  struct SecondOrderNotchFilter filters[NB_CHANNELS];
+  srand(3);
+  for (int k = 0; k < NB_CHANNELS; k++) {
+    const float freq = randf(10.f, 200.f), bw = randf(5.f, 50.f);
+    notch_filter_init(&filters[k], freq, bw, SAMPLE_FREQ);
+    notch_filter_bank_init_channel(&notch_bank, k, freq, bw, SAMPLE_FREQ);
+  }
+  bool same = true;
+  for (int n = 0; n < NB_SAMPLES && same; n++) {
+    float in[NB_CHANNELS], out[NB_CHANNELS], ref[NB_CHANNELS];
+    input(in, n);
+    // track a moving frequency half way
+    if (n == NB_SAMPLES / 2) {
+      for (int k = 0; k < NB_CHANNELS; k++) {
+        const float freq = randf(10.f, 200.f);
+        notch_filter_set_filter_frequency(&filters[k], freq);
+        notch_filter_bank_set_filter_frequency(&notch_bank, k, freq, SAMPLE_FREQ);
+      }
+    }
+    notch_filter_bank_update(&notch_bank, in, out);
+    for (int k = 0; k < NB_CHANNELS; k++) {
+      notch_filter_update(&filters[k], &in[k], &ref[k]);
+    }
+    same = memcmp(out, ref, sizeof(out)) == 0;
+  }
+  ok(same, "notch filter bank is bit identical to %d filters", NB_CHANNELS);
+}
+
+int main()
+{
+  note("running filter bank tests");
+  plan(3);
+
+  test_first_order();
+  test_butterworth_2();
+  test_notch();
+
+  done_testing();
+}
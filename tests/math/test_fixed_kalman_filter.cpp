@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi. See LICENCE file.
+ */
+
+/**
+ * @file test_fixed_kalman_filter.cpp
+ * Compare the fixed size Kalman filter with the generic linear Kalman filter
+ */
+
+#include <math.h>
+
+#define KF_TIME_USEC() 0
+#include "filters/fixed_kalman_filter.h"
+
+extern "C" {
+#include "tap.h"
+#include "filters/linear_kalman_filter.h"
+}
+
+FIXED_KF_C_WRAPPER(kf4, 4)
+
+#define DT 0.1f
+
+/* simple deterministic noise in [-1, 1] */
+static float noise(void)
+{
+  static uint32_t seed = 12345;
+  seed = seed * 1103515245 + 12345;
+  return ((seed >> 8) & 0xFFFF) / 32768.f - 1.f;
+}
+
+int main()
+{
+  note("running fixed kalman filter tests");
+  plan(7);
+
+  /* constant velocity model in 2D, states px vx py vy, positions observed */
+  const float F[4][4] = {{1, DT, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, DT}, {0, 0, 0, 1}};
+  const float H[2][4] = {{1, 0, 0, 0}, {0, 0, 1, 0}};
+  const float Q[4] = {0.001f, 0.01f, 0.001f, 0.01f};
+  const float R[2] = {0.5f, 0.5f};
+  const float P0[4] = {1.f, 1.f, 1.f, 1.f};
+
+  struct linear_kalman_filter lkf;
+  linear_kalman_filter_init(&lkf, 4, 1, 2);
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 4; j++) {
+      lkf.A[i][j] = F[i][j];
+      lkf.C[i % 2][j] = H[i % 2][j];
+    }
+    lkf.P[i][i] = P0[i];
+    lkf.Q[i][i] = Q[i];
+  }
+  lkf.R[0][0] = R[0];
+  lkf.R[1][1] = R[1];
+  kf4_init(NULL, P0);
+
+  float U[1] = {0.f};
+  float x[4];
+  float max_dx = 0.f, max_dp = 0.f;
+  for (int k = 0; k < 100; k++) {
+    float t = k * DT;
+    float Y[2] = {2.f * t + 0.7f * noise(), 1.f - 0.5f * t + 0.7f * noise()};
+
+    linear_kalman_filter_predict(&lkf, U);
+    linear_kalman_filter_update(&lkf, Y);
+
+    kf4_predict(F, Q, true);
+    kf4_get_state(x);
+    float innov[2] = {Y[0] - x[0], Y[1] - x[2]};
+    kf4_update(H, innov, R, 2);
+
+    kf4_get_state(x);
+    for (int i = 0; i < 4; i++) {
+      max_dx = fmaxf(max_dx, fabsf(x[i] - lkf.X[i]));
+      for (int j = 0; j < 4; j++) {
+        max_dp = fmaxf(max_dp, fabsf(kf4_get_cov(i, j) - lkf.P[i][j]));
+      }
+    }
+  }
+  ok(max_dx < 1e-4f, "sequential update state matches batch update, max error %g", max_dx);
+  ok(max_dp < 1e-5f, "covariance matches batch update, max error %g", max_dp);
+  ok(fabsf(x[1] - 2.f) < 0.2f && fabsf(x[3] + 0.5f) < 0.2f, "velocities estimated (%f %f)", x[1], x[3]);
+
+  /* sparse and dense scalar updates are identical */
+  FixedKalmanFilter<4> a, b;
+  const float h[4] = {0.f, 2.f, 0.f, -1.f};
+  const uint8_t idx[2] = {1, 3};
+  const float val[2] = {2.f, -1.f};
+  a.init(NULL, P0);
+  b.init(NULL, P0);
+  a.P(1, 3) = b.P(1, 3) = 0.3f;
+  a.update_scalar(h, 0.4f, 0.1f);
+  b.update_sparse(idx, val, 2, 0.4f, 0.1f);
+  bool same = true;
+  for (int i = 0; i < 4; i++) {
+    same &= (a.x[i] == b.x[i]);
+    for (int j = i; j < 4; j++) {
+      same &= (a.P(i, j) == b.P(i, j));
+    }
+  }
+  ok(same, "sparse update equals dense update");
+
+  /* error state is taken and reset */
+  float dx[4];
+  a.reset_error(dx);
+  ok(dx[1] != 0.f && a.x[1] == 0.f, "reset error state");
+
+  /* non positive innovation variance is rejected */
+  ok(!a.update_scalar(h, 1.f, -100.f) && a.timing.nb_rejected == 1, "measurement rejected");
+
+  struct kf_timing timing = kf4_get_timing();
+  ok(timing.nb_predict == 100 && timing.nb_update == 200, "counters %u predictions %u updates",
+     timing.nb_predict, timing.nb_update);
+
+  done_testing();
+}
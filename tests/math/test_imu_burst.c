@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi. See LICENCE file.
+ */
+
+/**
+ * @file test_imu_burst.c
+ * Test the fixed point scaling and the coning/sculling corrections of the
+ * IMU burst processing against the division path and analytic motions.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "tap.h"
+#include "modules/imu/imu_burst.h"
+
+#define DT (1. / 1000.)   // gyro and accel sample period (s)
+#define NB_SAMPLES 8      // samples per burst
+#define NB_SUB 32         // integration steps per sample of the reference
+
+/* double precision quaternion helpers, q = [w x y z] */
+static void quat_mul(double r[4], const double a[4], const double b[4])
+{
+  r[0] = a[0] * b[0] - a[1] * b[1] - a[2] * b[2] - a[3] * b[3];
+  r[1] = a[0] * b[1] + a[1] * b[0] + a[2] * b[3] - a[3] * b[2];
+  r[2] = a[0] * b[2] - a[1] * b[3] + a[2] * b[0] + a[3] * b[1];
+  r[3] = a[0] * b[3] + a[1] * b[2] - a[2] * b[1] + a[3] * b[0];
+}
+
+/* coning motion: the body x axis describes a cone of half angle CONE_A at CONE_W rad/s */
+#define CONE_A 0.1
+#define CONE_W (2. * M_PI * 20.)
+
+static void cone_quat(double q[4], double t)
+{
+  q[0] = cos(CONE_A / 2.);
+  q[1] = sin(CONE_A / 2.) * cos(CONE_W * t);
+  q[2] = sin(CONE_A / 2.) * sin(CONE_W * t);
+  q[3] = 0.;
+}
+
+/* body rates of the coning motion, w = 2 q* dq/dt */
+static void cone_rate(double w[3], double t)
+{
+  double q[4], qc[4], dq[4] = { 0., -sin(CONE_A / 2.) * CONE_W * sin(CONE_W * t),
+                                sin(CONE_A / 2.) * CONE_W * cos(CONE_W * t), 0.
+                              };
+  cone_quat(q, t);
+  qc[0] = q[0]; qc[1] = -q[1]; qc[2] = -q[2]; qc[3] = -q[3];
+  double r[4];
+  quat_mul(r, qc, dq);
+  w[0] = 2. * r[1]; w[1] = 2. * r[2]; w[2] = 2. * r[3];
+}
+
+/* delta angle of a gyro sample ending at t, midpoint rule */
+static void cone_delta(struct FloatVect3 *d, double t)
+{
+  double s[3] = { 0., 0., 0. };
+  for (int k = 0; k < NB_SUB; k++) {
+    double w[3];
+    cone_rate(w, t - DT + (k + 0.5) * DT / NB_SUB);
+    s[0] += w[0]; s[1] += w[1]; s[2] += w[2];
+  }
+  d->x = s[0] * DT / NB_SUB;
+  d->y = s[1] * DT / NB_SUB;
+  d->z = s[2] * DT / NB_SUB;
+}
+
+static void test_coning(void)
+{
+  note("--- Coning correction on a %.0fHz coning motion of %.2f rad", CONE_W / (2. * M_PI), CONE_A);
+  double max_err = 0., max_err_corr = 0.;
+  for (int b = 0; b < 50; b++) {
+    const double t0 = 0.0013 * b;
+    struct FloatVect3 alpha = { 0.f, 0.f, 0.f }, beta = { 0.f, 0.f, 0.f }, prev;
+    cone_delta(&prev, t0);
+    for (int i = 1; i <= NB_SAMPLES; i++) {
+      struct FloatVect3 d;
+      cone_delta(&d, t0 + i * DT);
+      imu_coning_update(&alpha, &beta, &prev, &d);
+    }
+
+    /* rotation vector of q(t0)* q(t1) */
+    double q0[4], q1[4], dq[4];
+    cone_quat(q0, t0);
+    cone_quat(q1, t0 + NB_SAMPLES * DT);
+    q0[1] = -q0[1]; q0[2] = -q0[2]; q0[3] = -q0[3];
+    quat_mul(dq, q0, q1);
+    const double n = sqrt(dq[1] * dq[1] + dq[2] * dq[2] + dq[3] * dq[3]);
+    const double s = 2. * atan2(n, dq[0]) / n;
+    const double phi[3] = { s * dq[1], s * dq[2], s * dq[3] };
+
+    const double e[3] = { alpha.x - phi[0], alpha.y - phi[1], alpha.z - phi[2] };
+    const double ec[3] = { e[0] + beta.x, e[1] + beta.y, e[2] + beta.z };
+    max_err = fmax(max_err, sqrt(e[0] * e[0] + e[1] * e[1] + e[2] * e[2]));
+    max_err_corr = fmax(max_err_corr, sqrt(ec[0] * ec[0] + ec[1] * ec[1] + ec[2] * ec[2]));
+  }
+  note("rotation vector error %g rad without correction, %g rad with coning correction", max_err, max_err_corr);
+  ok(max_err_corr < 0.05 * max_err, "coning correction removes more than 95%% of the error");
+}
+
+/* sculling motion: oscillation of SCUL_A rad around x with a specific force along y in phase */
+#define SCUL_A 0.05
+#define SCUL_F 10.
+#define SCUL_W (2. * M_PI * 25.)
+
+static double scul_angle(double t) { return SCUL_A * sin(SCUL_W * t); }
+
+/* delta angle and delta velocity of a sample ending at t, both in body frame */
+static void scul_delta(struct FloatVect3 *da, struct FloatVect3 *dv, double t)
+{
+  da->x = scul_angle(t) - scul_angle(t - DT);
+  da->y = 0.f;
+  da->z = 0.f;
+  double v = 0.;
+  for (int k = 0; k < NB_SUB; k++) {
+    v += SCUL_F * sin(SCUL_W * (t - DT + (k + 0.5) * DT / NB_SUB));
+  }
+  dv->x = 0.f;
+  dv->y = v * DT / NB_SUB;
+  dv->z = 0.f;
+}
+
+static void test_sculling(void)
+{
+  note("--- Sculling correction on a %.0fHz sculling motion", SCUL_W / (2. * M_PI));
+  double max_err = 0., max_err_corr = 0.;
+  for (int b = 0; b < 50; b++) {
+    const double t0 = 0.0011 * b;
+    struct FloatVect3 alpha = { 0.f, 0.f, 0.f }, v = { 0.f, 0.f, 0.f }, scul = { 0.f, 0.f, 0.f };
+    struct FloatVect3 da_prev, dv_prev;
+    scul_delta(&da_prev, &dv_prev, t0);
+    for (int i = 1; i <= NB_SAMPLES; i++) {
+      struct FloatVect3 da, dv;
+      scul_delta(&da, &dv, t0 + i * DT);
+      imu_sculling_update(&alpha, &v, &scul, &da_prev, &dv_prev, &da, &dv);
+    }
+    struct FloatVect3 rot, corr;
+    VECT3_CROSS_PRODUCT(rot, alpha, v);
+    VECT3_SUM_SCALED(corr, v, rot, 0.5f);
+    VECT3_ADD(corr, scul);
+
+    /* velocity change in the body frame at t0 */
+    double ref[3] = { 0., 0., 0. };
+    const int nb = NB_SAMPLES * NB_SUB * 4;
+    for (int k = 0; k < nb; k++) {
+      const double t = t0 + (k + 0.5) * NB_SAMPLES * DT / nb;
+      const double a = scul_angle(t) - scul_angle(t0);
+      const double f = SCUL_F * sin(SCUL_W * t);
+      ref[1] += cos(a) * f;
+      ref[2] += sin(a) * f;
+    }
+    ref[1] *= NB_SAMPLES * DT / nb;
+    ref[2] *= NB_SAMPLES * DT / nb;
+
+    max_err = fmax(max_err, sqrt((v.y - ref[1]) * (v.y - ref[1]) + (v.z - ref[2]) * (v.z - ref[2])));
+    max_err_corr = fmax(max_err_corr, sqrt(corr.x * corr.x + (corr.y - ref[1]) * (corr.y - ref[1]) +
+                                           (corr.z - ref[2]) * (corr.z - ref[2])));
+  }
+  note("velocity error %g m/s without correction, %g m/s with rotation and sculling correction", max_err, max_err_corr);
+  ok(max_err_corr < 0.05 * max_err, "sculling correction removes more than 95%% of the error");
+}
+
+static void test_scale(void)
+{
+  note("--- Fixed point scale against the integer division");
+  const int32_t scales[][2] = { { 4359, 1000 }, { 4905, 1000 }, { 1, 30 }, { 3, 7 }, { -8738, 10000 }, { 61, 16 } };
+  srand(7);
+  int max_diff = 0;
+  double max_err = 0., max_err_div = 0., mean_err = 0.;
+  bool sym = true;
+  int nb = 0;
+  for (unsigned s = 0; s < sizeof(scales) / sizeof(scales[0]); s++) {
+    const int32_t q = imu_scale_q(scales[s][0], scales[s][1]);
+    for (int i = 0; i < 10000; i++, nb++) {
+      const int32_t x = (rand() % 65536) - 32768;
+      const int32_t div = x * scales[s][0] / scales[s][1];
+      const int32_t fix = imu_scale_apply(x, q);
+      const double exact = (double)x * scales[s][0] / scales[s][1];
+      max_diff = Max(max_diff, abs(fix - div));
+      max_err = fmax(max_err, fabs(fix - exact));
+      max_err_div = fmax(max_err_div, fabs(div - exact));
+      mean_err += fix - exact;
+      sym = sym && (imu_scale_apply(-x, q) == -fix);
+    }
+  }
+  mean_err /= nb;
+  note("max difference with the division %d, max error %g (division %g), mean error %g", max_diff, max_err,
+       max_err_div, mean_err);
+  ok(max_diff <= 1 && max_err < 1., "fixed point scale within one unit of the division and of the exact value");
+  ok(sym && fabs(mean_err) < 0.01, "fixed point scale rounding is symmetric and unbiased");
+}
+
+int main()
+{
+  note("running imu burst tests");
+  plan(4);
+
+  test_coning();
+  test_sculling();
+  test_scale();
+
+  done_testing();
+}
@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_ins_float_invariant_gen.c
+ * Compare the generated model, correction and propagation of the invariant
+ * filter (ins_float_invariant_gen.h) with the hand-written invariant_model,
+ * error_output and runge_kutta_4_float on random states.
+ *
+ * The module source is included to reach its static functions, built with
+ * the default INS_INV_CODEGEN=FALSE. The flight plan and the GPS functions
+ * are stubbed.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "tap.h"
+
+#define BOARD_CONFIG "std.h"
+#define INS_TYPE_H "modules/ins/ins_float_invariant.h"
+#define GENERATED_FLIGHT_PLAN_H
+#define NAV_LAT0 0
+#define NAV_LON0 0
+#define NAV_ALT0 0
+#define NAV_MSL0 0
+#include "modules/ins/ins_float_invariant.c"
+#include "modules/ins/ins_float_invariant_gen.h"
+
+struct GpsState gps;
+struct LlaCoor_i lla_int_from_gps(struct GpsState *gps_s __attribute__((unused))) { struct LlaCoor_i c = {0}; return c; }
+struct EcefCoor_i ecef_int_from_gps(struct GpsState *gps_s __attribute__((unused))) { struct EcefCoor_i c = {0}; return c; }
+struct EcefCoor_f ecef_vel_float_from_gps(struct GpsState *gps_s __attribute__((unused))) { struct EcefCoor_f c = {0}; return c; }
+
+#define NB_STATES 1000
+
+static float randf(float min, float max)
+{
+  return min + (max - min) * (float)rand() / (float)RAND_MAX;
+}
+
+static void rand_vect(struct FloatVect3 *v, float r)
+{
+  v->x = randf(-r, r);
+  v->y = randf(-r, r);
+  v->z = randf(-r, r);
+}
+
+/* state around the nominal one, quaternion not exactly normalized and
+ * accel sensitivity on both sides of its limits */
+static void rand_state(struct inv_state *s)
+{
+  struct FloatEulers e = { randf(-1.f, 1.f), randf(-1.f, 1.f), randf(-3.f, 3.f) };
+  float_quat_of_eulers(&s->quat, &e);
+  QUAT_SMUL(s->quat, s->quat, randf(0.99f, 1.01f));
+  rand_vect((struct FloatVect3 *)&s->bias, 0.05f);
+  rand_vect((struct FloatVect3 *)&s->speed, 20.f);
+  rand_vect((struct FloatVect3 *)&s->pos, 200.f);
+  s->hb = randf(-5.f, 5.f);
+  s->as = randf(0.4f, 1.6f);
+}
+
+static void rand_command(struct inv_command *c)
+{
+  rand_vect((struct FloatVect3 *)&c->rates, 2.f);
+  rand_vect(&c->accel, 3.f);
+  c->accel.z -= 9.81f;
+}
+
+static void rand_corr(struct inv_correction_gains *corr)
+{
+  rand_vect(&corr->LE, 0.1f);
+  rand_vect(&corr->ME, 1.f);
+  rand_vect(&corr->NE, 1.f);
+  rand_vect(&corr->OE, 0.01f);
+  corr->RE = randf(-0.1f, 0.1f);
+  corr->SE = randf(-1.f, 1.f);
+}
+
+/** largest error relative to the magnitude of the reference */
+static float max_rel_error(const float *ref, const float *val, int n)
+{
+  float err = 0.f;
+  for (int i = 0; i < n; i++) {
+    err = Max(err, fabsf(val[i] - ref[i]) / (1.f + fabsf(ref[i])));
+  }
+  return err;
+}
+
+static void test_model(void)
+{
+  srand(1);
+  float err = 0.f;
+  for (int n = 0; n < NB_STATES; n++) {
+    struct inv_state s, sd, sd_gen;
+    struct inv_command c;
+    rand_state(&s);
+    rand_command(&c);
+    rand_corr(&ins_float_inv.corr);
+    invariant_model((float *)&sd, (float *)&s, INV_STATE_DIM, (float *)&c, INV_COMMAND_DIM);
+    ins_float_invariant_gen_model(&sd_gen, &s, &c, &ins_float_inv.corr);
+    err = Max(err, max_rel_error((float *)&sd, (float *)&sd_gen, INV_STATE_DIM));
+  }
+  note("model max relative error %g", err);
+  ok(err < 1e-5, "ins_float_invariant_gen_model matches invariant_model");
+}
+
+static void test_correction(void)
+{
+  srand(2);
+  float err = 0.f;
+  for (int n = 0; n < NB_STATES; n++) {
+    struct InsFloatInv *ins = &ins_float_inv;
+    rand_state(&ins->state);
+    rand_command(&ins->cmd);
+    rand_vect((struct FloatVect3 *)&ins->meas.pos_gps, 200.f);
+    rand_vect((struct FloatVect3 *)&ins->meas.speed_gps, 20.f);
+    rand_vect(&ins->meas.mag, 1.f);
+    ins->meas.baro_alt = randf(-200.f, 200.f);
+    rand_vect(&ins->mag_h, 1.f);
+    ins->gains.lv = randf(0.f, 10.f);
+    ins->gains.lb = randf(0.f, 10.f);
+    ins->gains.mv = randf(0.f, 10.f);
+    ins->gains.mvz = randf(0.f, 10.f);
+    ins->gains.mh = randf(0.f, 1.f);
+    ins->gains.nx = randf(0.f, 1.f);
+    ins->gains.nxz = randf(0.f, 1.f);
+    ins->gains.nh = randf(0.f, 1.f);
+    ins->gains.ov = randf(0.f, 10.f);
+    ins->gains.ob = randf(0.f, 10.f);
+    ins->gains.rv = randf(0.f, 10.f);
+    ins->gains.rh = randf(0.f, 10.f);
+    ins->gains.sh = randf(0.f, 1.f);
+
+    /* the position and speed errors are used until the first GPS fix */
+    ins_gps_fix_once = false;
+    error_output(ins);
+
+    struct FloatVect3 Ev, Ex;
+    VECT3_DIFF(Ev, ins->state.speed, ins->meas.speed_gps);
+    VECT3_DIFF(Ex, ins->state.pos, ins->meas.pos_gps);
+    const float Eh = ins->state.pos.z - ins->state.hb - ins->meas.baro_alt;
+    struct inv_correction_gains corr;
+    ins_float_invariant_gen_correction(&corr, &ins->state, &ins->cmd, &ins->meas.mag, &ins->mag_h,
+                                       &Ev, &Ex, Eh, &ins->gains);
+    err = Max(err, max_rel_error((float *)&ins->corr, (float *)&corr, sizeof(corr) / sizeof(float)));
+  }
+  note("correction max relative error %g", err);
+  ok(err < 1e-5, "ins_float_invariant_gen_correction matches error_output");
+}
+
+static void test_propagation(void)
+{
+  srand(3);
+  const float dt = 1.f / 512.f;
+  float err = 0.f;
+  for (int n = 0; n < NB_STATES; n++) {
+    struct inv_state s, s_rk, s_gen;
+    struct inv_command c;
+    rand_state(&s);
+    rand_command(&c);
+    rand_corr(&ins_float_inv.corr);
+    runge_kutta_4_float((float *)&s_rk, (float *)&s, INV_STATE_DIM, (float *)&c, INV_COMMAND_DIM,
+                        invariant_model, dt);
+    s_gen = s;
+    ins_float_invariant_gen_propagate(&s_gen, &c, &ins_float_inv.corr, dt);
+    err = Max(err, max_rel_error((float *)&s_rk, (float *)&s_gen, INV_STATE_DIM));
+  }
+  note("propagation max relative error %g", err);
+  ok(err < 1e-6, "ins_float_invariant_gen_propagate matches runge_kutta_4_float with invariant_model");
+}
+
+int main()
+{
+  note("running invariant filter generated code tests");
+  plan(3);
+
+  test_model();
+  test_correction();
+  test_propagation();
+
+  done_testing();
+}
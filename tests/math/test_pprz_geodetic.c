@@ -28,10 +28,12 @@
  */
 
 #include "tap.h"
+#include <stdlib.h>
 
 #include "math/pprz_geodetic_int.h"
 #include "math/pprz_geodetic_float.h"
 #include "math/pprz_geodetic_double.h"
+#include "math/pprz_geodetic_wmm2020.h"
 
 /*
  * toulouse lat 43.6052765, lon 1.4427764, alt 180.123019274324 -> x 4624497.0 y 116475.0 z 4376563.0
@@ -376,10 +378,199 @@ static void test_lla_of_ecef(void)
   cmp_ok(lla_i.alt, "==", lla_ref_i.alt, "altitude (int) matches reference");
 }
 
+static void test_local_conversions(void)
+{
+  const int n = 21 * 21 * 3;
+  struct LlaCoor_f ref_lla_f = { RadOfDeg(43.6052765), RadOfDeg(1.4427764), 180.123 };
+  struct LlaCoor_d ref_lla_d = { ref_lla_f.lat, ref_lla_f.lon, ref_lla_f.alt };
+
+  note("--- Compare local conversions with double and batch with scalar versions on %d points in 20km range", n);
+  struct LtpDef_f ltp_def_f;
+  ltp_def_from_lla_f(&ltp_def_f, &ref_lla_f);
+  struct LtpDef_d ltp_def_d;
+  ltp_def_from_lla_d(&ltp_def_d, &ref_lla_d);
+
+  struct LlaCoor_f lla_f[n];
+  struct LlaCoor_d lla_d[n];
+  int k = 0;
+  for (int i = -10; i <= 10; i++) {
+    for (int j = -10; j <= 10; j++) {
+      for (int h = -1; h <= 1; h++, k++) {
+        lla_f[k].lat = ref_lla_f.lat + RadOfDeg(0.018 * i);
+        lla_f[k].lon = ref_lla_f.lon + RadOfDeg(0.025 * j);
+        lla_f[k].alt = ref_lla_f.alt + 500.f * h;
+        /* double points are the exact same as the float ones */
+        lla_d[k].lat = lla_f[k].lat;
+        lla_d[k].lon = lla_f[k].lon;
+        lla_d[k].alt = lla_f[k].alt;
+      }
+    }
+  }
+
+  /* direct float expansion against double */
+  float max_err_f = 0.f;
+  for (k = 0; k < n; k++) {
+    struct NedCoor_d ned;
+    ned_of_lla_point_d(&ned, &ltp_def_d, &lla_d[k]);
+    struct NedCoor_f ned_f;
+    ned_of_lla_point_f(&ned_f, &ltp_def_f, &lla_f[k]);
+    max_err_f = Max(max_err_f, fabs(ned.x - ned_f.x));
+    max_err_f = Max(max_err_f, fabs(ned.y - ned_f.y));
+    max_err_f = Max(max_err_f, fabs(ned.z - ned_f.z));
+  }
+  note("ned_of_lla_point_f max error %f m", max_err_f);
+  ok(max_err_f < 0.01, "ned_of_lla_point_f max error is below 1cm");
+
+  /* int batch against int scalar */
+  struct LtpDef_i ltp_def_i;
+  struct EcefCoor_i ref_ecef_i = { 462449700, 11647500, 437656300 };
+  ltp_def_from_ecef_i(&ltp_def_i, &ref_ecef_i);
+  struct EcefCoor_i ecef_i[n];
+  struct EnuCoor_i enu_i[n];
+  for (k = 0; k < n; k++) {
+    ecef_i[k].x = ref_ecef_i.x + 137 * (k % 101) - 5000 * (k % 7);
+    ecef_i[k].y = ref_ecef_i.y - 211 * (k % 89) + 7000 * (k % 5);
+    ecef_i[k].z = ref_ecef_i.z + 173 * (k % 97) - 3000 * (k % 11);
+  }
+  enu_of_ecef_points_i(enu_i, &ltp_def_i, ecef_i, n);
+  int nb_diff = 0;
+  for (k = 0; k < n; k++) {
+    struct EnuCoor_i enu;
+    enu_of_ecef_point_i(&enu, &ltp_def_i, &ecef_i[k]);
+    nb_diff += (enu.x != enu_i[k].x) || (enu.y != enu_i[k].y) || (enu.z != enu_i[k].z);
+  }
+  ok(nb_diff == 0, "enu_of_ecef_points_i matches enu_of_ecef_point_i");
+
+  /* direct local to LLA against the path through ECEF, errors measured in double */
+  float max_err_lla = 0.f, max_err_ecef = 0.f;
+  for (k = 0; k < n; k++) {
+    struct NedCoor_d ned;
+    ned_of_lla_point_d(&ned, &ltp_def_d, &lla_d[k]);
+    struct NedCoor_f ned_in = { ned.x, ned.y, ned.z };
+    struct LlaCoor_f lla_direct, lla_ecef;
+    lla_of_ned_point_f(&lla_direct, &ltp_def_f, &ned_in);
+    struct EcefCoor_f ecef;
+    ecef_of_ned_point_f(&ecef, &ltp_def_f, &ned_in);
+    lla_of_ecef_f(&lla_ecef, &ecef);
+    struct LlaCoor_d lla_out_d = { lla_direct.lat, lla_direct.lon, lla_direct.alt };
+    struct NedCoor_d ned_out;
+    ned_of_lla_point_d(&ned_out, &ltp_def_d, &lla_out_d);
+    max_err_lla = Max(max_err_lla, fabs(ned.x - ned_out.x));
+    max_err_lla = Max(max_err_lla, fabs(ned.y - ned_out.y));
+    max_err_lla = Max(max_err_lla, fabs(ned.z - ned_out.z));
+    lla_out_d = (struct LlaCoor_d) { lla_ecef.lat, lla_ecef.lon, lla_ecef.alt };
+    ned_of_lla_point_d(&ned_out, &ltp_def_d, &lla_out_d);
+    max_err_ecef = Max(max_err_ecef, fabs(ned.x - ned_out.x));
+    max_err_ecef = Max(max_err_ecef, fabs(ned.y - ned_out.y));
+    max_err_ecef = Max(max_err_ecef, fabs(ned.z - ned_out.z));
+  }
+  note("lla_of_ned_point_f max error %f m, through ECEF max error %f m", max_err_lla, max_err_ecef);
+  ok(max_err_lla < 0.05, "lla_of_ned_point_f max error is below 5cm");
+}
+
+/** error in m of a float LLA point against a local double point */
+static double lla_f_error(struct LtpDef_d *def, struct LlaCoor_f *lla, struct EnuCoor_d *enu)
+{
+  struct LlaCoor_d lla_d = { lla->lat, lla->lon, lla->alt };
+  struct EnuCoor_d e;
+  enu_of_lla_point_d(&e, def, &lla_d);
+  return sqrt((e.x - enu->x) * (e.x - enu->x) + (e.y - enu->y) * (e.y - enu->y) + (e.z - enu->z) * (e.z - enu->z));
+}
+
+static void test_lla_of_enu_long_range(void)
+{
+  note("--- Compare lla_of_enu_point_f with double on random points up to 500km");
+  srand(42);
+  const float ranges[] = { 1e3, 2e4, 1e5, 3e5, 5e5 };
+  double max_err = 0., max_excess = 0., max_err_ecef = 0.;
+  for (unsigned r = 0; r < sizeof(ranges) / sizeof(ranges[0]); r++) {
+    for (int i = 0; i < 500; i++) {
+      /* origin is the same in float and double */
+      struct LlaCoor_f ref_f = { RadOfDeg(140. * rand() / RAND_MAX - 70.), RadOfDeg(360. * rand() / RAND_MAX - 180.),
+                                 1000. * rand() / RAND_MAX };
+      struct LlaCoor_d ref_d = { ref_f.lat, ref_f.lon, ref_f.alt };
+      struct LtpDef_f def_f;
+      ltp_def_from_lla_f(&def_f, &ref_f);
+      struct LtpDef_d def_d;
+      ltp_def_from_lla_d(&def_d, &ref_d);
+      struct EnuCoor_f enu_f = { ranges[r] * (2. * rand() / RAND_MAX - 1.), ranges[r] * (2. * rand() / RAND_MAX - 1.),
+                                 3000. * rand() / RAND_MAX };
+      struct EnuCoor_d enu_d = { enu_f.x, enu_f.y, enu_f.z };
+
+      /* exact result rounded to float is the best we can get */
+      struct EcefCoor_d ecef_d;
+      ecef_of_enu_point_d(&ecef_d, &def_d, &enu_d);
+      struct LlaCoor_d lla_d;
+      lla_of_ecef_d(&lla_d, &ecef_d);
+      struct LlaCoor_f lla_round = { lla_d.lat, lla_d.lon, lla_d.alt };
+      const double err_round = lla_f_error(&def_d, &lla_round, &enu_d);
+
+      struct LlaCoor_f lla;
+      lla_of_enu_point_f(&lla, &def_f, &enu_f);
+      const double err = lla_f_error(&def_d, &lla, &enu_d);
+      max_err = Max(max_err, err);
+      max_excess = Max(max_excess, err - err_round);
+
+      struct EcefCoor_f ecef_f;
+      ecef_of_enu_point_f(&ecef_f, &def_f, &enu_f);
+      lla_of_ecef_f(&lla, &ecef_f);
+      max_err_ecef = Max(max_err_ecef, lla_f_error(&def_d, &lla, &enu_d));
+    }
+  }
+  note("lla_of_enu_point_f max error %f m (%f m above float rounding), through ECEF max error %f m",
+       max_err, max_excess, max_err_ecef);
+  ok(max_err < 1. && max_err < max_err_ecef, "lla_of_enu_point_f max error below 1m and below the ECEF path");
+  ok(max_excess < 0.5, "lla_of_enu_point_f within 0.5m of the float rounding of the exact result");
+}
+
+static void test_wmm2020(void)
+{
+  note("--- Compare the single precision and cached WMM with the double precision model");
+  const float date = 2024.5f;
+  double gha[MAXCOEFF];
+  int16_t nmax = extrapsh(date, GEO_EPOCH, NMAX_1, NMAX_2, gha);
+  float gh[WMM2020_NB_COEFF];
+  wmm2020_extrapsh_f(gh, date);
+
+  /* positions in degrees and km, including close to the poles and the date line */
+  const double pos[][3] = {
+    { 43.6052765, 1.4427764, 0.18 }, { 0., 0., 0. }, { -45., 170., 10. },
+    { 80., -100., 1. }, { -89.9999, 30., 0. }, { 52., -179.5, 3. }
+  };
+  double max_err = 0.;
+  for (unsigned i = 0; i < sizeof(pos) / sizeof(pos[0]); i++) {
+    double x, y, z;
+    mag_calc(1, pos[i][0], pos[i][1], pos[i][2], nmax, gha, &x, &y, &z, IEXT, EXT_COEFF1, EXT_COEFF2, EXT_COEFF3);
+    struct LlaCoor_f lla = { RadOfDeg(pos[i][0]), RadOfDeg(pos[i][1]), pos[i][2] * 1000. };
+    struct FloatVect3 f;
+    wmm2020_mag_calc_f(&f, gh, &lla);
+    double err = sqrt((x - f.x) * (x - f.x) + (y - f.y) * (y - f.y) + (z - f.z) * (z - f.z)) / sqrt(x * x + y * y + z * z);
+    max_err = Max(max_err, err);
+  }
+  note("wmm2020_mag_calc_f max relative error %g", max_err);
+  ok(max_err < 1e-5, "wmm2020_mag_calc_f matches mag_calc");
+
+  /* long range track with a slow climb */
+  struct Wmm2020Cache cache;
+  wmm2020_cache_init(&cache, date, RadOfDeg(1.f), 1000.f);
+  float max_err_cache = 0.f;
+  for (int i = 0; i < 2000; i++) {
+    struct LlaCoor_f lla = { RadOfDeg(40.f + 0.005f * i), RadOfDeg(-5.f + 0.007f * i), 500.f + i };
+    struct FloatVect3 f, fc, diff;
+    wmm2020_mag_calc_f(&f, gh, &lla);
+    wmm2020_cache_get(&cache, &fc, &lla);
+    VECT3_DIFF(diff, fc, f);
+    max_err_cache = Max(max_err_cache, float_vect3_norm(&diff) / float_vect3_norm(&f));
+  }
+  note("wmm2020_cache_get max relative error %g with %u evaluations", max_err_cache, cache.nb_eval);
+  ok(max_err_cache < 5e-4, "cached field interpolation within 5e-4");
+  ok(cache.nb_eval < 30, "cache only evaluated when changing cell or altitude");
+}
+
 int main()
 {
   note("runing geodetic math tests");
-  plan(13);
+  plan(21);
 
   test_ecef_of_ned_int();
   test_enu_of_ecef_int();
@@ -387,6 +578,9 @@ int main()
   test_ecef_to_enu_to_ecef_float();
   test_lla_of_utm();
   test_lla_of_ecef();
+  test_local_conversions();
+  test_lla_of_enu_long_range();
+  test_wmm2020();
 
   done_testing();
 }
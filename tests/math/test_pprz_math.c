@@ -34,7 +34,7 @@
 int main()
 {
   note("running algebra math tests");
-  plan(3);
+  plan(6);
 
   /* test int32_vect2_normalize */
   struct Int32Vect2 v = {2300, -4200};
@@ -57,6 +57,35 @@ int main()
   ok((fabs(quat_zxy.qi - 0.9266) < 0.01 && fabs(quat_zxy.qx - -0.2317) < 0.01 && fabs(quat_zxy.qy - 0.1165) < 0.01) && fabs(quat_zxy.qz - 0.2722),
      "float_quat_of_eulers_zxy(float_eulers_of_quat_zxy(0.9266,   -0.2317,    0.1165,    0.2722)) returned [%f, %f, %f, %f]", quat_zxy.qi, quat_zxy.qx, quat_zxy.qy, quat_zxy.qz);
 
+  /*test float_quat_slerp*/
+  struct FloatQuat q_start, q_end, q_mid;
+  struct FloatEulers e_start = {0., 0., 0.2};
+  struct FloatEulers e_end = {0., 0., 0.6};
+  struct FloatEulers e_mid;
+  float_quat_of_eulers(&q_start, &e_start);
+  float_quat_of_eulers(&q_end, &e_end);
+  float_quat_slerp(&q_mid, &q_start, &q_end, 0.25);
+  float_eulers_of_quat(&e_mid, &q_mid);
+  ok((fabs(e_mid.phi) < 0.001 && fabs(e_mid.theta) < 0.001 && fabs(e_mid.psi - 0.3) < 0.001),
+     "float_quat_slerp(psi=0.2, psi=0.6, 0.25) returned [%f, %f, %f]", e_mid.phi, e_mid.theta, e_mid.psi);
+
+  /*test the inline rotation kernels against each other*/
+  struct FloatEulers e_rot = {0.3, -0.2, 1.1};
+  struct FloatQuat q_rot, q_comp, q_inplace;
+  struct FloatRMat r_rot;
+  struct FloatVect3 v_in = {1., -2., 3.}, v_quat, v_rmat;
+  float_quat_of_eulers(&q_rot, &e_rot);
+  float_rmat_of_quat(&r_rot, &q_rot);
+  float_quat_vmult(&v_quat, &q_rot, &v_in);
+  float_rmat_vmult(&v_rmat, &r_rot, &v_in);
+  ok((fabs(v_quat.x - v_rmat.x) < 1e-5 && fabs(v_quat.y - v_rmat.y) < 1e-5 && fabs(v_quat.z - v_rmat.z) < 1e-5),
+     "float_quat_vmult and float_rmat_of_quat agree, [%f, %f, %f]", v_quat.x, v_quat.y, v_quat.z);
+
+  float_quat_comp(&q_comp, &q_rot, &q_mid);
+  q_inplace = q_rot;
+  float_quat_comp(&q_inplace, &q_inplace, &q_mid);
+  ok((q_comp.qi == q_inplace.qi && q_comp.qx == q_inplace.qx && q_comp.qy == q_inplace.qy && q_comp.qz == q_inplace.qz),
+     "float_quat_comp in place returned [%f, %f, %f, %f]", q_inplace.qi, q_inplace.qx, q_inplace.qy, q_inplace.qz);
 
   done_testing();
 }
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_pprz_matrix_decomp.c
+ * @brief Tests for the fixed size matrix decompositions.
+ *
+ * Using libtap to create a TAP (TestAnythingProtocol) producer:
+ * https://github.com/zorgnax/libtap
+ *
+ */
+
+#include "tap.h"
+#include <math.h>
+#include "math/pprz_matrix_decomp_float.h"
+#include "math/pprz_matrix_decomp_fixed_float.h"
+#include "math/RANSAC.h"
+
+/** max abs difference between A*B and C, square n x n */
+static float mat_mul_error(const float *A, const float *B, const float *C, int n)
+{
+  float err = 0.f;
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      float s = 0.f;
+      for (int k = 0; k < n; k++) {
+        s += A[i * n + k] * B[k * n + j];
+      }
+      err = fmaxf(err, fabsf(s - C[i * n + j]));
+    }
+  }
+  return err;
+}
+
+int main()
+{
+  note("running fixed size matrix decomposition tests");
+  plan(5);
+
+  /* symmetric positive definite 6x6 matrix M = B*B^T + I */
+  float B[6][6], M[6][6], I6[6][6];
+  for (int i = 0; i < 6; i++) {
+    for (int j = 0; j < 6; j++) {
+      B[i][j] = sinf(1.f + 3.1f * i + 0.7f * j * j + 0.3f * i * j);
+    }
+  }
+  for (int i = 0; i < 6; i++) {
+    for (int j = 0; j < 6; j++) {
+      M[i][j] = (i == j) ? 1.f : 0.f;
+      I6[i][j] = M[i][j];
+      for (int k = 0; k < 6; k++) {
+        M[i][j] += B[i][k] * B[j][k];
+      }
+    }
+  }
+
+  /* test pprz_cholesky_inv_float_6 */
+  float Minv[6][6];
+  bool spd = pprz_cholesky_inv_float_6(&Minv[0][0], &M[0][0]);
+  float err = mat_mul_error(&M[0][0], &Minv[0][0], &I6[0][0], 6);
+  ok(spd && err < 1e-4, "pprz_cholesky_inv_float_6: M*inv(M) = I, error %g", err);
+
+  /* test pprz_qr_float_5 */
+  float Q[5][5], R[5][5], A5[5][5];
+  for (int i = 0; i < 5; i++) {
+    for (int j = 0; j < 5; j++) {
+      A5[i][j] = B[i][j];
+    }
+  }
+  pprz_qr_float_5(&Q[0][0], &R[0][0], &A5[0][0]);
+  err = mat_mul_error(&Q[0][0], &R[0][0], &A5[0][0], 5);
+  bool upper = true;
+  for (int i = 1; i < 5; i++) {
+    for (int j = 0; j < i; j++) {
+      upper &= (R[i][j] == 0.f);
+    }
+  }
+  ok(upper && err < 1e-5, "pprz_qr_float_5: Q*R = A, error %g", err);
+
+  /* test the streaming least squares with a noiseless overdetermined system */
+  float Rl[3][3], z[3], p[3];
+  pprz_lsq_init_float_3(&Rl[0][0], z);
+  for (int k = 0; k < 50; k++) {
+    float row[3] = {cosf(k), sinf(0.3f * k), 1.f};
+    pprz_lsq_add_row_float_3(&Rl[0][0], z, row, 2.f * row[0] - 1.f * row[1] + 0.5f);
+  }
+  pprz_lsq_solve_float_3(p, &Rl[0][0], z);
+  ok(fabsf(p[0] - 2.f) < 1e-4 && fabsf(p[1] + 1.f) < 1e-4 && fabsf(p[2] - 0.5f) < 1e-4,
+     "pprz_lsq_float_3: fit [2, -1, 0.5] returned [%f, %f, %f]", p[0], p[1], p[2]);
+
+  /* test fit_linear_model without bias */
+  float samples[20][2], targets[20], params[3], fit_error;
+  for (int k = 0; k < 20; k++) {
+    samples[k][0] = k;
+    samples[k][1] = (k * 7) % 5;
+    targets[k] = 0.5f * samples[k][0] + 2.f * samples[k][1];
+  }
+  fit_linear_model(targets, 2, samples, 20, false, params, &fit_error);
+  ok(fabsf(params[0] - 0.5f) < 1e-4 && fabsf(params[1] - 2.f) < 1e-4 && params[2] == 0.f && fit_error < 1e-4,
+     "fit_linear_model: [0.5, 2, 0] returned [%f, %f, %f], error %f", params[0], params[1], params[2], fit_error);
+
+  /* test the adaptive RANSAC with 30% gross outliers */
+  float rs[100][2], rt[100], rp[3], r_err;
+  int r_inliers;
+  for (int k = 0; k < 100; k++) {
+    rs[k][0] = (k % 10) * 3.f;
+    rs[k][1] = (k / 10) * 2.f;
+    rt[k] = 1.5f * rs[k][0] - 0.5f * rs[k][1] + 4.f;
+    if (k % 10 < 3) {
+      rt[k] += 50.f + k;
+    }
+  }
+  int r_it = RANSAC_linear_model_adaptive(3, 200, RANSAC_CONFIDENCE, 1.f, rt, 2, rs, 100, true, rp, &r_err, &r_inliers);
+  ok(fabsf(rp[0] - 1.5f) < 1e-3 && fabsf(rp[1] + 0.5f) < 1e-3 && fabsf(rp[2] - 4.f) < 1e-3 && r_inliers == 70 && r_it < 200,
+     "RANSAC_linear_model_adaptive: [1.5, -0.5, 4] returned [%f, %f, %f], %d inliers, %d iterations",
+     rp[0], rp[1], rp[2], r_inliers, r_it);
+
+  done_testing();
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi.
+ *
+ * paparazzi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * paparazzi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with paparazzi; see the file COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_pprz_rls.c
+ * @brief Tests for the recursive least squares estimator.
+ *
+ * Using libtap to create a TAP (TestAnythingProtocol) producer:
+ * https://github.com/zorgnax/libtap
+ *
+ */
+
+#include "tap.h"
+#include <math.h>
+#include <stdlib.h>
+#include "math/pprz_rls_float.h"
+
+static float rnd(float a)
+{
+  return a * (2.f * (float)rand() / (float)RAND_MAX - 1.f);
+}
+
+int main()
+{
+  note("running recursive least squares tests");
+  plan(6);
+  srand(42);
+
+  /* linear model y = 3 - 0.5 t with noise */
+  struct RlsFloat rls;
+  rls_float_init(&rls, 2, 1.f, 1000.f);
+  for (int i = 0; i < 500; i++) {
+    float t = rnd(20.f);
+    float phi[2] = { 1.f, t };
+    rls_float_update(&rls, phi, 3.f - 0.5f * t + rnd(0.1f));
+  }
+  ok(fabsf(rls.theta[0] - 3.f) < 0.02f && fabsf(rls.theta[1] + 0.5f) < 0.002f,
+     "linear fit, got %f %f", rls.theta[0], rls.theta[1]);
+
+  /* tracking a change of the parameters with forgetting */
+  rls_float_init(&rls, 2, 0.99f, 1000.f);
+  for (int i = 0; i < 1000; i++) {
+    float t = rnd(20.f);
+    float phi[2] = { 1.f, t };
+    float b = i < 500 ? 3.f : 4.f;
+    rls_float_update(&rls, phi, b - 0.5f * t);
+  }
+  ok(fabsf(rls.theta[0] - 4.f) < 0.01f, "tracks a parameter change, got %f", rls.theta[0]);
+
+  /* no excitation: covariance stays bounded with forgetting */
+  for (int i = 0; i < 5000; i++) {
+    float phi[2] = { 1.f, 0.f };
+    rls_float_update(&rls, phi, 4.f);
+  }
+  ok(rls.P[1][1] <= 1000.f / 0.99f && isfinite(rls.theta[1]), "bounded covariance, P11 %f", rls.P[1][1]);
+
+  /* axis aligned ellipsoid */
+  struct FloatVect3 c = { 0.3f, -0.2f, 0.1f }, r = { 1.1f, 0.9f, 1.05f };
+  struct FloatVect3 ce, re;
+  rls_float_init(&rls, 6, 1.f, 100.f);
+  ok(!rls_float_ellipsoid_get(&rls, &ce, &re), "no ellipsoid before any sample");
+  for (int i = 0; i < 2000; i++) {
+    struct FloatVect3 u = { rnd(1.f), rnd(1.f), rnd(1.f) };
+    float n = float_vect3_norm(&u);
+    if (n < 0.1f) {
+      continue;
+    }
+    struct FloatVect3 v = {
+      c.x + r.x * u.x / n + rnd(0.005f),
+      c.y + r.y * u.y / n + rnd(0.005f),
+      c.z + r.z * u.z / n + rnd(0.005f)
+    };
+    rls_float_ellipsoid_update(&rls, &v);
+  }
+  bool valid = rls_float_ellipsoid_get(&rls, &ce, &re);
+  ok(valid && fabsf(ce.x - c.x) < 0.01f && fabsf(ce.y - c.y) < 0.01f && fabsf(ce.z - c.z) < 0.01f,
+     "ellipsoid center, got %f %f %f", ce.x, ce.y, ce.z);
+  ok(valid && fabsf(re.x - r.x) < 0.01f && fabsf(re.y - r.y) < 0.01f && fabsf(re.z - r.z) < 0.01f,
+     "ellipsoid radii, got %f %f %f", re.x, re.y, re.z);
+
+  done_testing();
+}
@@ -75,14 +75,56 @@ static void test_pos_lla_i(void)
   }
 }
 
+static void test_snapshot(void)
+{
+  struct NedCoor_f pos = {1.f, 2.f, -3.f};
+  struct NedCoor_f speed = {0.5f, 0.f, 0.f};
+  struct FloatEulers eulers = {0.1f, -0.2f, 1.f};
+  struct FloatRates rates = {0.f, 0.f, 0.3f};
+  struct LtpDef_i ltp_def;
+  struct LlaCoor_i lla_ref = {.lat = 429720000, .lon = 11460000, .alt = 180000};
+  ltp_def_from_lla_i(&ltp_def, &lla_ref);
+  stateSetLocalOrigin_i(&ltp_def);
+  stateSetPositionNed_f(&pos);
+  stateSetSpeedNed_f(&speed);
+  stateSetNedToBodyEulers_f(&eulers);
+  stateSetBodyRates_f(&rates);
+
+  struct StateSnapshot snapshot;
+  stateGetSnapshot(&snapshot);
+  ok(!snapshot.attitude_valid && !snapshot.local_pos_valid, "state snapshot is empty before publication");
+
+  // not published without a consumer
+  stateSnapshotPublish(1000);
+  stateGetSnapshot(&snapshot);
+  ok(snapshot.timestamp == 0 && !snapshot.attitude_valid, "state snapshot is not published without a consumer");
+
+  stateSnapshotRegister();
+  stateSnapshotPublish(1234);
+  stateGetSnapshot(&snapshot);
+  ok(snapshot.timestamp == 1234 && snapshot.attitude_valid && snapshot.local_pos_valid && snapshot.global_pos_valid &&
+     fabsf(snapshot.ned_pos.z - pos.z) < 1e-6 && fabsf(snapshot.ned_speed.x - speed.x) < 1e-6 &&
+     fabsf(snapshot.ned_to_body_eulers.psi - eulers.psi) < 1e-5 && fabsf(snapshot.body_rates.r - rates.r) < 1e-6,
+     "state snapshot matches the published state");
+
+  // further state updates are not visible until the next publication
+  pos.x = 10.f;
+  stateSetPositionNed_f(&pos);
+  stateGetSnapshot(&snapshot);
+  ok(fabsf(snapshot.ned_pos.x - 1.f) < 1e-6, "state snapshot is not modified by state updates");
+}
+
 int main()
 {
   note("\n *** running state interface tests ***");
-  plan(1);
+  plan(5);
 
   stateInit();
 
   test_pos_lla_i();
 
+  stateInit();
+  test_snapshot();
+
   done_testing();
 }
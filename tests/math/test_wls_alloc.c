@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi. See LICENCE file.
+ */
+
+/**
+ * @file test_wls_alloc.c
+ * Compare the active set allocator with incremental QR updates (wls_alloc_qr)
+ * with the reference implementation (wls_alloc) on random feasible and
+ * saturated problems.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "tap.h"
+#include "std.h"
+#include "math/wls/wls_alloc.h"
+
+#define NB_PROBLEMS 500
+#define N_U WLS_N_U
+#define N_V WLS_N_V
+
+static float randf(float min, float max)
+{
+  return min + (max - min) * (float)rand() / (float)RAND_MAX;
+}
+
+struct alloc_problem {
+  float B[N_V][N_U];
+  float v[N_V];
+  float umin[N_U];
+  float umax[N_U];
+  float Wv[N_V];
+  float Wu[N_U];
+  float up[N_U];
+};
+
+/* random effectiveness, bounds and weights, the objective is B*u for a random u scaled by v_scale */
+static void random_problem(struct alloc_problem *p, float v_scale)
+{
+  float u[N_U];
+  for (int j = 0; j < N_U; j++) {
+    p->umin[j] = randf(-1.f, 0.f);
+    p->umax[j] = randf(0.5f, 1.f);
+    p->Wu[j] = randf(0.5f, 2.f);
+    p->up[j] = randf(p->umin[j], 0.f);
+    u[j] = randf(p->umin[j], p->umax[j]);
+  }
+  for (int i = 0; i < N_V; i++) {
+    p->Wv[i] = randf(1.f, 100.f);
+    p->v[i] = 0.f;
+    for (int j = 0; j < N_U; j++) {
+      p->B[i][j] = randf(-1.f, 1.f);
+      p->v[i] += v_scale * p->B[i][j] * u[j];
+    }
+  }
+}
+
+static int solve(struct alloc_problem *p, float *u, int (*alloc)(float *, float *, float *, float *, float **,
+                 float *, float *, float *, float *, float *, float, int, int, int))
+{
+  float *B[N_V];
+  float v[N_V];
+  for (int i = 0; i < N_V; i++) {
+    B[i] = p->B[i];
+    v[i] = p->v[i];
+  }
+  for (int j = 0; j < N_U; j++) {
+    u[j] = 0.f;
+  }
+  return alloc(u, v, p->umin, p->umax, B, NULL, NULL, p->Wv, p->Wu, p->up, 10000.f, 100, N_U, N_V);
+}
+
+/*
+ * run both allocators on random problems, return the number of problems with at least one saturated actuator
+ * and the largest residual of the objective
+ */
+static int compare(float v_scale, const char *name, float *residual)
+{
+  srand(42);
+  float max_diff = 0.f, max_res = 0.f;
+  bool bounds = true, converged = true;
+  int nb_sat = 0;
+  for (int n = 0; n < NB_PROBLEMS; n++) {
+    struct alloc_problem p;
+    random_problem(&p, v_scale);
+    float u[N_U], u_qr[N_U];
+    int iter = solve(&p, u, wls_alloc);
+    int iter_qr = solve(&p, u_qr, wls_alloc_qr);
+    converged = converged && iter <= 100 && iter_qr <= 100;
+
+    bool sat = false;
+    for (int j = 0; j < N_U; j++) {
+      max_diff = Max(max_diff, fabsf(u_qr[j] - u[j]));
+      bounds = bounds && u_qr[j] >= p.umin[j] && u_qr[j] <= p.umax[j];
+      sat = sat || u[j] == p.umin[j] || u[j] == p.umax[j];
+    }
+    nb_sat += sat ? 1 : 0;
+    for (int i = 0; i < N_V; i++) {
+      float bu = 0.f;
+      for (int j = 0; j < N_U; j++) {
+        bu += p.B[i][j] * u_qr[j];
+      }
+      max_res = Max(max_res, fabsf(bu - p.v[i]));
+    }
+  }
+  note("%s problems: %d/%d with saturated actuators, max difference %g, max residual %g", name, nb_sat,
+       NB_PROBLEMS, max_diff, max_res);
+  ok(converged && bounds, "%s problems: wls_alloc_qr converges within the bounds", name);
+  ok(max_diff < 1e-4, "%s problems: wls_alloc_qr gives the same solution as wls_alloc", name);
+  *residual = max_res;
+  return nb_sat;
+}
+
+int main()
+{
+  note("running wls allocation tests");
+  plan(6);
+
+  float res;
+  compare(1.f, "feasible", &res);
+  ok(res < 1e-3, "feasible problems: the objective is met, residual %g", res);
+  // objectives out of reach: the objective is only partially met
+  int nb_sat = compare(3.f, "saturated", &res);
+  ok(nb_sat > NB_PROBLEMS / 2, "saturated problems: most problems saturate (%d/%d)", nb_sat, NB_PROBLEMS);
+
+  done_testing();
+}
@@ -36,6 +36,9 @@
 // dummy variables
 extern int nav_catapult_nav_catapult_highrate_module_status;
 
+#include "modules/core/task_timing.h"
+#define MODULES_TIMING_NB 0
+
 static inline void modules_mcu_init(void) {}
 static inline void modules_core_init(void) {}
 static inline void modules_sensors_init(void) {}
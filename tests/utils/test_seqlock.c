@@ -0,0 +1,32 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi. See LICENCE file.
+ */
+
+#include "tap.h"
+#include "seqlock.h"
+
+int main()
+{
+  note("running seqlock tests");
+  plan(5);
+
+  struct seqlock lock;
+  seqlock_init(&lock);
+
+  uint32_t seq = seqlock_read_begin(&lock);
+  ok(!seqlock_read_retry(&lock, seq), "read without concurrent write is consistent");
+
+  seqlock_write_begin(&lock);
+  uint32_t seq_writing = seqlock_read_begin(&lock);
+  ok(seqlock_read_retry(&lock, seq_writing), "read started during a write must be retried");
+  seqlock_write_end(&lock);
+  ok(seqlock_read_retry(&lock, seq), "read overlapping a write must be retried");
+
+  seq = seqlock_read_begin(&lock);
+  ok(!seqlock_read_retry(&lock, seq), "read after a write is consistent");
+  ok(seq == 2, "sequence incremented twice per write, got %u", seq);
+
+  done_testing();
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2026 Paparazzi Team
+ *
+ * This file is part of paparazzi. See LICENCE file.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include "tap.h"
+#include "spsc_queue.h"
+
+#define NB_TRANSFER 100000
+
+static struct spsc_queue queue;
+static uint32_t buf[16];
+
+static void *producer(void *arg __attribute__((unused)))
+{
+  for (uint32_t i = 0; i < NB_TRANSFER;) {
+    if (spsc_queue_push(&queue, &i)) {
+      i++;
+    } else {
+      sched_yield();
+    }
+  }
+  return NULL;
+}
+
+int main()
+{
+  note("running spsc_queue tests");
+  plan(9);
+
+  ok(!spsc_queue_init(&queue, buf, 12, sizeof(uint32_t)), "size must be a power of two");
+  ok(spsc_queue_init(&queue, buf, 4, sizeof(uint32_t)), "init with 4 elements");
+
+  uint32_t v, i;
+  ok(!spsc_queue_pop(&queue, &v), "empty queue");
+  for (i = 0; i < 5; i++) {
+    spsc_queue_push(&queue, &i);
+  }
+  ok(spsc_queue_count(&queue) == 4 && queue.overruns == 1, "full queue drops and counts overruns");
+  ok(spsc_queue_pop(&queue, &v) && v == 0, "first in first out, got %u", v);
+  i = 10;
+  ok(spsc_queue_push(&queue, &i), "push after pop");
+  uint32_t sum = 0;
+  while (spsc_queue_pop(&queue, &v)) {
+    sum += v;
+  }
+  ok(sum == 1 + 2 + 3 + 10, "wrap around, sum %u", sum);
+
+  /* concurrent transfer, elements must arrive in order without loss */
+  spsc_queue_init(&queue, buf, 16, sizeof(uint32_t));
+  pthread_t thread;
+  pthread_create(&thread, NULL, producer, NULL);
+  uint32_t expected = 0;
+  bool in_order = true;
+  while (expected < NB_TRANSFER) {
+    if (spsc_queue_pop(&queue, &v)) {
+      in_order &= (v == expected);
+      expected++;
+    } else {
+      sched_yield();
+    }
+  }
+  pthread_join(thread, NULL);
+  ok(in_order, "concurrent transfer in order");
+  ok(spsc_queue_count(&queue) == 0, "queue empty after transfer");
+
+  done_testing();
+}